@@ -1013,6 +1013,151 @@ void QTextDecoder::toUnicode(QString *target, const char *chars, int len)
 }
 
 
+/*!
+    \since 5.5
+
+    Converts bytes from \a chars to Unicode, writing at most \a bufferSize
+    characters to \a buffer, and returns the number of characters written.
+    \a len is the number of bytes available in \a chars.
+
+    The number of bytes that were read is stored in \a bytesRead; it is
+    less than \a len if the remaining bytes might not fit into \a buffer.
+    Pass them again in the next call. Bytes read are never returned again:
+    if they end with part of a multi-byte sequence, the decoder remembers
+    it and completes the sequence in the next call.
+
+    For UTF-8, a buffer of \a len + 1 characters is always enough to read
+    all of \a chars; for Latin-1, \a len characters are enough. Other
+    codecs may produce more than one character per byte; if not even the
+    characters for the first byte fit, no bytes are read.
+
+    Unlike the other overloads, this function does not allocate memory for
+    UTF-8 and Latin-1, which makes it suitable for decoding large streams
+    in fixed-size chunks.
+
+    \sa appendToUnicode()
+*/
+int QTextDecoder::toUnicode(QChar *buffer, int bufferSize, const char *chars, int len, int *bytesRead)
+{
+    return qt_textCodecToUnicode(c, buffer, bufferSize, chars, len, &state, bytesRead);
+}
+
+/*!
+    \since 5.5
+
+    Converts the first \a len bytes in \a chars to Unicode and appends
+    the result to \a target.
+
+    For UTF-8 and Latin-1, the text is decoded directly into \a target,
+    without a temporary string. \a target grows like it does in
+    QString::append() and, for UTF-8, keeps its capacity as if
+    QString::reserve() had been called, so appending to the same string
+    repeatedly does not reallocate once it is big enough.
+
+    \sa toUnicode()
+*/
+void QTextDecoder::appendToUnicode(QString *target, const char *chars, int len)
+{
+    Q_ASSERT(target);
+    qt_textCodecAppendToUnicode(c, target, chars, len, &state);
+}
+
+// Decodes as many bytes as are sure to fit into buffer, see
+// QTextDecoder::toUnicode() above
+int qt_textCodecToUnicode(const QTextCodec *codec, QChar *buffer, int bufferSize,
+                          const char *chars, int len, QTextCodec::ConverterState *state,
+                          int *bytesRead)
+{
+    Q_ASSERT(bytesRead);
+    int n;
+    switch (codec->mibEnum()) {
+    case 106: // utf8, one character per byte and one more for the state
+        n = qMin(len, bufferSize - 1);
+        if (n < 0 || (n == 0 && len > 0)) {
+            *bytesRead = 0;
+            return 0;
+        }
+        *bytesRead = n;
+        return QUtf8::convertToUnicode(buffer, chars, n, state) - buffer;
+    case 4: // latin1
+        n = qMax(qMin(len, bufferSize), 0);
+        qt_from_latin1(reinterpret_cast<ushort *>(buffer), chars, n);
+        *bytesRead = n;
+        return n;
+    default:
+        break;
+    }
+
+    if (state->d || (state->flags & QTextCodec::FreeFunction)) {
+        // The codec keeps its state outside of the converter state (ICU,
+        // iconv), so a failed attempt cannot be undone. ICU produces at most
+        // two characters per byte.
+        n = qMin(len, bufferSize / 2);
+        if (n < 0 || (n == 0 && len > 0)) {
+            *bytesRead = 0;
+            return 0;
+        }
+        const QString result = codec->toUnicode(chars, n, state);
+        int size = result.size();
+        if (Q_UNLIKELY(size > bufferSize)) {
+            qWarning("QTextDecoder::toUnicode: %s produced too many characters", codec->name().constData());
+            size = bufferSize;
+        }
+        memcpy(buffer, result.constData(), size * sizeof(QChar));
+        *bytesRead = n;
+        return size;
+    }
+
+    // Some codecs produce several characters per byte (TSCII up to three),
+    // so decode with a copy of the state and only keep the result if it fits.
+    // Otherwise try again with proportionally fewer bytes.
+    n = qMin(len, bufferSize);
+    while (n > 0) {
+        QTextCodec::ConverterState trial(state->flags);
+        trial.remainingChars = state->remainingChars;
+        trial.invalidChars = state->invalidChars;
+        memcpy(trial.state_data, state->state_data, sizeof(trial.state_data));
+
+        const QString result = codec->toUnicode(chars, n, &trial);
+        const int size = result.size();
+        if (size <= bufferSize) {
+            // take over anything the codec set up, even if it is owned by the state
+            state->flags = trial.flags;
+            state->remainingChars = trial.remainingChars;
+            state->invalidChars = trial.invalidChars;
+            memcpy(state->state_data, trial.state_data, sizeof(state->state_data));
+            state->d = trial.d;
+            trial.flags &= ~QTextCodec::FreeFunction;
+            trial.d = 0;
+
+            memcpy(buffer, result.constData(), size * sizeof(QChar));
+            *bytesRead = n;
+            return size;
+        }
+        n = qMin(n - 1, int(qint64(n) * bufferSize / size));
+    }
+    *bytesRead = 0;
+    return 0;
+}
+
+void qt_textCodecAppendToUnicode(const QTextCodec *codec, QString *target, const char *chars, int len,
+                                 QTextCodec::ConverterState *state)
+{
+    switch (codec->mibEnum()) {
+    case 106: // utf8
+        static_cast<const QUtf8Codec*>(codec)->convertToUnicode(target, chars, len, state);
+        break;
+    case 4: { // latin1
+        const int oldSize = target->size();
+        target->resize(oldSize + len);
+        qt_from_latin1(reinterpret_cast<ushort *>(target->data()) + oldSize, chars, len);
+        break;
+    }
+    default:
+        target->append(codec->toUnicode(chars, len, state));
+    }
+}
+
 /*!
     \overload
 
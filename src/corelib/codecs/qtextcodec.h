@@ -146,6 +146,8 @@ public:
     QString toUnicode(const char* chars, int len);
     QString toUnicode(const QByteArray &ba);
     void toUnicode(QString *target, const char *chars, int len);
+    int toUnicode(QChar *buffer, int bufferSize, const char *chars, int len, int *bytesRead);
+    void appendToUnicode(QString *target, const char *chars, int len);
     bool hasFailure() const;
 private:
     const QTextCodec *c;
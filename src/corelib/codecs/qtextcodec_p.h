@@ -75,6 +75,13 @@ struct QTextCodecUnalignedPointer
 
 bool qTextCodecNameMatch(const char *a, const char *b);
 
+// decoding without temporary strings, see QTextDecoder
+int qt_textCodecToUnicode(const QTextCodec *codec, QChar *buffer, int bufferSize,
+                          const char *chars, int len, QTextCodec::ConverterState *state,
+                          int *bytesRead);
+void qt_textCodecAppendToUnicode(const QTextCodec *codec, QString *target, const char *chars, int len,
+                                 QTextCodec::ConverterState *state);
+
 #else
 
 class QTextCodec
@@ -46,9 +46,46 @@ enum { Endian = 0, Data = 1 };
 
 static const uchar utf8bom[] = { 0xef, 0xbb, 0xbf };
 
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+// Skips over the leading blocks of 32 ASCII characters, if the CPU can do
+// AVX2. The SSE2 code below deals with the rest.
+QT_FUNCTION_TARGET(AVX2)
+static void avx2EncodeAscii(uchar *&dst, const ushort *&src, const ushort *end)
+{
+    for ( ; end - src >= 32; src += 32, dst += 32) {
+        const __m256i data1 = _mm256_loadu_si256((const __m256i *)src);
+        const __m256i data2 = _mm256_loadu_si256((const __m256i *)src + 1);
+        if (!_mm256_testz_si256(_mm256_or_si256(data1, data2), _mm256_set1_epi16(short(0xff80))))
+            return;
+
+        // packing works on each 128-bit lane, so put the quadwords back in order
+        const __m256i packed = _mm256_packus_epi16(data1, data2);
+        _mm256_storeu_si256((__m256i *)dst, _mm256_permute4x64_epi64(packed, 0xd8));
+    }
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void avx2DecodeAscii(ushort *&dst, const uchar *&src, const uchar *end)
+{
+    for ( ; end - src >= 32; src += 32, dst += 32) {
+        const __m256i data = _mm256_loadu_si256((const __m256i *)src);
+        if (_mm256_movemask_epi8(data))
+            return;
+
+        _mm256_storeu_si256((__m256i *)dst, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(data)));
+        _mm256_storeu_si256((__m256i *)dst + 1, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(data, 1)));
+    }
+}
+#endif
+
 #if defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_SSE2)
 static inline bool simdEncodeAscii(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end)
 {
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (end - src >= 32 && qCpuHasFeature(AVX2))
+        avx2EncodeAscii(dst, src, end);
+#endif
+
     // do sixteen characters at a time
     for ( ; end - src >= 16; src += 16, dst += 16) {
         __m128i data1 = _mm_loadu_si128((__m128i*)src);
@@ -88,6 +125,11 @@ static inline bool simdEncodeAscii(uchar *&dst, const ushort *&nextAscii, const
 
 static inline bool simdDecodeAscii(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
 {
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (end - src >= 32 && qCpuHasFeature(AVX2))
+        avx2DecodeAscii(dst, src, end);
+#endif
+
     // do sixteen characters at a time
     for ( ; end - src >= 16; src += 16, dst += 16) {
         __m128i data = _mm_loadu_si128((__m128i*)src);
@@ -294,13 +336,6 @@ QString QUtf8::convertToUnicode(const char *chars, int len)
 
 QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::ConverterState *state)
 {
-    bool headerdone = false;
-    ushort replacement = QChar::ReplacementCharacter;
-    int need = 0;
-    int invalid = 0;
-    int res;
-    uchar ch = 0;
-
     // See above for buffer requirements for stateless decoding. However, that
     // fails if the state is not empty. The following situations can add to the
     // requirements:
@@ -311,9 +346,26 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     //   1 of 2 bytes       invalid continuation        +1 (need to insert replacement and restart)
     //   2 of 3 bytes       same                        +1 (same)
     //   3 of 4 bytes       same                        +1 (same)
-    QString result(need + len + 1, Qt::Uninitialized);
+    QString result(len + 1, Qt::Uninitialized);
+    QChar *end = convertToUnicode(result.data(), chars, len, state);
+    result.truncate(end - result.constData());
+    return result;
+}
 
-    ushort *dst = reinterpret_cast<ushort *>(const_cast<QChar *>(result.constData()));
+/*
+    Decodes into \a buffer, which must have room for \a len + 1 characters,
+    and returns the end of the decoded data. Incomplete sequences at the end
+    of \a chars are kept in \a state.
+*/
+QChar *QUtf8::convertToUnicode(QChar *buffer, const char *chars, int len, QTextCodec::ConverterState *state)
+{
+    bool headerdone = false;
+    ushort replacement = QChar::ReplacementCharacter;
+    int invalid = 0;
+    int res;
+    uchar ch = 0;
+
+    ushort *dst = reinterpret_cast<ushort *>(buffer);
     const uchar *src = reinterpret_cast<const uchar *>(chars);
     const uchar *end = src + len;
 
@@ -345,7 +397,7 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
                 // copy to our state and return
                 state->remainingChars = remainingCharsCount + newCharsToCopy;
                 memcpy(&state->state_data[0], remainingCharsData, state->remainingChars);
-                return QString();
+                return buffer;
             } else if (!headerdone && res >= 0) {
                 // eat the UTF-8 BOM
                 headerdone = true;
@@ -390,7 +442,6 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
             *dst++ = QChar::ReplacementCharacter;
     }
 
-    result.truncate(dst - (ushort *)result.unicode());
     if (state) {
         state->invalidChars += invalid;
         if (headerdone)
@@ -403,7 +454,7 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
             state->remainingChars = 0;
         }
     }
-    return result;
+    return reinterpret_cast<QChar *>(dst);
 }
 
 QByteArray QUtf16::convertFromUnicode(const QChar *uc, int len, QTextCodec::ConverterState *state, DataEndianness e)
@@ -662,7 +713,18 @@ QByteArray QUtf8Codec::convertFromUnicode(const QChar *uc, int len, ConverterSta
 
 void QUtf8Codec::convertToUnicode(QString *target, const char *chars, int len, ConverterState *state) const
 {
-    *target += QUtf8::convertToUnicode(chars, len, state);
+    // decode in place, without a temporary string; reserving keeps resize()
+    // from giving the memory back, so that appending chunk after chunk
+    // doesn't reallocate
+    const int oldSize = target->size();
+    const int needed = oldSize + len + 1;
+    int capacity = target->capacity();
+    if (capacity < needed)
+        capacity = qMax(needed, 2 * capacity);
+    target->reserve(capacity);
+    target->resize(needed);
+    QChar *end = QUtf8::convertToUnicode(target->data() + oldSize, chars, len, state);
+    target->resize(end - target->constData());
 }
 
 QString QUtf8Codec::convertToUnicode(const char *chars, int len, ConverterState *state) const
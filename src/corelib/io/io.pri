@@ -23,6 +23,8 @@ HEADERS +=  \
         io/qnoncontiguousbytedevice_p.h \
         io/qprocess.h \
         io/qprocess_p.h \
+        io/qprocesspool.h \
+        io/qprocesspool_p.h \
         io/qtextstream.h \
         io/qtextstream_p.h \
         io/qtemporarydir.h \
@@ -41,6 +43,7 @@ HEADERS +=  \
         io/qtldurl_p.h \
         io/qsettings.h \
         io/qsettings_p.h \
+        io/qsettingsbinary_p.h \
         io/qfsfileengine_p.h \
         io/qfsfileengine_iterator_p.h \
         io/qfilesystemwatcher.h \
@@ -50,6 +53,7 @@ HEADERS +=  \
         io/qfilesystemengine_p.h \
         io/qfilesystemmetadata_p.h \
         io/qfilesystemiterator_p.h \
+        io/qdirtraversal_p.h \
         io/qfileselector.h \
         io/qfileselector_p.h \
         io/qloggingcategory.h \
@@ -72,6 +76,7 @@ SOURCES += \
         io/qlockfile.cpp \
         io/qnoncontiguousbytedevice.cpp \
         io/qprocess.cpp \
+        io/qprocesspool.cpp \
         io/qstorageinfo.cpp \
         io/qtextstream.cpp \
         io/qtemporarydir.cpp \
@@ -85,6 +90,7 @@ SOURCES += \
         io/qurlquery.cpp \
         io/qurlrecode.cpp \
         io/qsettings.cpp \
+        io/qsettingsbinary.cpp \
         io/qfsfileengine.cpp \
         io/qfsfileengine_iterator.cpp \
         io/qfilesystemwatcher.cpp \
@@ -137,6 +143,7 @@ win32 {
                 io/qlockfile_unix.cpp \
                 io/qprocess_unix.cpp \
                 io/qfilesystemiterator_unix.cpp \
+                io/qdirtraversal_unix.cpp \
 
         !nacl:mac: {
             SOURCES += io/qsettings_mac.cpp
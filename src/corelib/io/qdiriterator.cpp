@@ -77,6 +77,14 @@
     enables iterating through all subdirectories of the assigned path,
     following all symbolic links. Symbolic link loops (e.g., "link" => "." or
     "link" => "..") are automatically detected and ignored.
+
+    \value ParallelTraversal When combined with Subdirectories, the
+    directories are read by a pool of threads while the entries found so far
+    are returned by next(). This is considerably faster for large trees,
+    especially on storage that can serve several requests at once. The order
+    of the entries differs from run to run. The flag is ignored for
+    directories that are not on the native file system and on platforms other
+    than Linux and the BSDs. This enum value was introduced in Qt 5.5.
 */
 
 #include "qdiriterator.h"
@@ -92,6 +100,7 @@
 #include <QtCore/private/qfilesystemmetadata_p.h>
 #include <QtCore/private/qfilesystemengine_p.h>
 #include <QtCore/private/qfileinfo_p.h>
+#include <QtCore/private/qdirtraversal_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -133,6 +142,9 @@ public:
 #ifndef QT_NO_FILESYSTEMITERATOR
     QDirIteratorPrivateIteratorStack<QFileSystemIterator> nativeIterators;
 #endif
+#ifndef QT_NO_DIRTRAVERSAL
+    QScopedPointer<QDirTraversal> traversal;
+#endif
 
     QFileInfo currentFileInfo;
     QFileInfo nextFileInfo;
@@ -164,6 +176,15 @@ QDirIteratorPrivate::QDirIteratorPrivate(const QFileSystemEntry &entry, const QS
         engine.reset(QFileSystemEngine::resolveEntryAndCreateLegacyEngine(dirEntry, metaData));
     QFileInfo fileInfo(new QFileInfoPrivate(dirEntry, metaData));
 
+#ifndef QT_NO_DIRTRAVERSAL
+    if (!engine && (flags & QDirIterator::ParallelTraversal)
+        && (flags & QDirIterator::Subdirectories)) {
+        traversal.reset(new QDirTraversal(dirEntry, this->filters, flags));
+        advance();
+        return;
+    }
+#endif
+
     // Populate fields for hasNext() and next()
     pushDirectory(fileInfo);
     advance();
@@ -236,6 +257,22 @@ void QDirIteratorPrivate::advance()
             delete it;
         }
     } else {
+#ifndef QT_NO_DIRTRAVERSAL
+        if (traversal) {
+            // the workers have already descended into the subdirectories
+            QFileSystemEntry nextEntry;
+            QFileSystemMetaData nextMetaData;
+            while (traversal->next(nextEntry, nextMetaData)) {
+                QFileInfo info(new QFileInfoPrivate(nextEntry, nextMetaData));
+                if (matchesFilters(nextEntry.fileName(), info)) {
+                    currentFileInfo = nextFileInfo;
+                    nextFileInfo = info;
+                    return;
+                }
+            }
+            traversal.reset();
+        }
+#endif
 #ifndef QT_NO_FILESYSTEMITERATOR
         QFileSystemEntry nextEntry;
         QFileSystemMetaData nextMetaData;
@@ -492,6 +529,10 @@ bool QDirIterator::hasNext() const
 {
     if (d->engine)
         return !d->fileEngineIterators.isEmpty();
+#ifndef QT_NO_DIRTRAVERSAL
+    else if (d->traversal)
+        return true;
+#endif
     else
 #ifndef QT_NO_FILESYSTEMITERATOR
         return !d->nativeIterators.isEmpty();
@@ -0,0 +1,138 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QDIRTRAVERSAL_P_H
+#define QDIRTRAVERSAL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+
+// The parallel traversal needs openat() and friends and relies on entries
+// being hidden by name only; elsewhere QDirIterator::ParallelTraversal is
+// ignored.
+#if defined(QT_NO_FILESYSTEMITERATOR) || defined(QT_NO_THREAD) || !defined(Q_OS_UNIX) \
+    || defined(Q_OS_DARWIN) || defined(Q_OS_QNX) || defined(Q_OS_NACL)
+#  define QT_NO_DIRTRAVERSAL
+#endif
+
+#ifndef QT_NO_DIRTRAVERSAL
+
+#include <QtCore/qdir.h>
+#include <QtCore/qdiriterator.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qqueue.h>
+#include <QtCore/qset.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qwaitcondition.h>
+
+#include <QtCore/private/qfilesystementry_p.h>
+#include <QtCore/private/qfilesystemmetadata_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QDirTraversalJob;
+
+// Walks a directory tree on the threads of a private thread pool. Every
+// directory is read by a job of its own, which opens it relative to its
+// parent's descriptor and queues the jobs for its subdirectories. The
+// entries are handed to the consuming thread in batches through a bounded
+// queue, so the workers pause when the consumer falls behind.
+class QDirTraversal
+{
+public:
+    QDirTraversal(const QFileSystemEntry &root, QDir::Filters filters,
+                  QDirIterator::IteratorFlags flags);
+    ~QDirTraversal();
+
+    bool next(QFileSystemEntry &entry, QFileSystemMetaData &metaData);
+
+private:
+    friend class QDirTraversalJob;
+
+    enum {
+        BatchSize = 256,
+        MaximumQueuedBatches = 64,
+        MaximumOpenDirectories = 256
+    };
+
+    struct Entry
+    {
+        QFileSystemEntry entry;
+        QFileSystemMetaData metaData;
+    };
+    typedef QVector<Entry> Batch;
+
+    bool push(Batch &batch);
+    void jobFinished();
+    bool visit(quint64 device, quint64 inode);
+
+    const QDir::Filters filters;
+    const QDirIterator::IteratorFlags iteratorFlags;
+
+    QMutex mutex;
+    QWaitCondition notEmpty;
+    QWaitCondition notFull;
+    QQueue<Batch> batches;
+    int pendingJobs;
+    bool cancelled;
+
+    // used by the consuming thread only
+    Batch currentBatch;
+    int currentIndex;
+
+    // directories already entered, when following symbolic links
+    QMutex visitedMutex;
+    QSet<QPair<quint64, quint64> > visited;
+
+    QAtomicInt openDirectories;
+    QThreadPool pool;
+
+    Q_DISABLE_COPY(QDirTraversal)
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_DIRTRAVERSAL
+
+#endif // QDIRTRAVERSAL_P_H
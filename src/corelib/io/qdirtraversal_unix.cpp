@@ -0,0 +1,346 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplatformdefs.h"
+#include "qdirtraversal_p.h"
+
+#ifndef QT_NO_DIRTRAVERSAL
+
+#include <QtCore/qrunnable.h>
+#include <QtCore/qthread.h>
+#include <QtCore/private/qcore_unix_p.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+
+QT_BEGIN_NAMESPACE
+
+static inline int qt_fstatat(int fd, const char *name, QT_STATBUF *statBuffer, int flags)
+{
+#if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+    return ::fstatat64(fd, name, statBuffer, flags);
+#else
+    return ::fstatat(fd, name, statBuffer, flags);
+#endif
+}
+
+// An open directory, kept open while the jobs for its subdirectories
+// still need to open them relative to it.
+class QDirTraversalHandle
+{
+public:
+    QDirTraversalHandle(QAtomicInt *openDirectories, QT_DIR *dir)
+        : openDirectories(openDirectories), dir(dir), ref(1)
+    {
+        openDirectories->ref();
+    }
+
+    int fd() const { return ::dirfd(dir); }
+    void addRef() { ref.ref(); }
+    void release()
+    {
+        if (!ref.deref()) {
+            QT_CLOSEDIR(dir);
+            openDirectories->deref();
+            delete this;
+        }
+    }
+
+private:
+    QAtomicInt *openDirectories;
+    QT_DIR *dir;
+    QAtomicInt ref;
+};
+
+class QDirTraversalJob : public QRunnable
+{
+public:
+    QDirTraversalJob(QDirTraversal *traversal, QDirTraversalHandle *parent, const QByteArray &name,
+                     const QFileSystemEntry::NativePath &path, int depth)
+        : traversal(traversal), parent(parent), name(name), path(path), depth(depth)
+    {
+    }
+
+    ~QDirTraversalJob()
+    {
+        if (parent)
+            parent->release();
+    }
+
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    QT_DIR *openDirectory();
+    bool shouldDescend(int fd, const QT_DIRENT &entry) const;
+    void descend(QDirTraversalHandle *handle, const QByteArray &childName,
+                 const QFileSystemEntry &child);
+
+    QDirTraversal *traversal;
+    QDirTraversalHandle *parent;
+    QByteArray name;                    // relative to parent, if any
+    QFileSystemEntry::NativePath path;  // ends with a slash
+    int depth;
+};
+
+QT_DIR *QDirTraversalJob::openDirectory()
+{
+    int fd;
+    if (parent) {
+        EINTR_LOOP(fd, ::openat(parent->fd(), name.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+        parent->release();
+        parent = 0;
+    } else {
+        fd = qt_safe_open(path.constData(), O_RDONLY | O_DIRECTORY);
+    }
+    if (fd == -1)
+        return 0;
+
+    QT_DIR *dir = ::fdopendir(fd);
+    if (!dir)
+        qt_safe_close(fd);
+    return dir;
+}
+
+void QDirTraversalJob::run()
+{
+    QT_DIR *dir = openDirectory();
+    if (!dir) {
+        // like QFileSystemIterator, list nothing for unreadable directories
+        traversal->jobFinished();
+        return;
+    }
+    QDirTraversalHandle *handle = new QDirTraversalHandle(&traversal->openDirectories, dir);
+
+    QDirTraversal::Batch batch;
+    batch.reserve(QDirTraversal::BatchSize);
+    while (QT_DIRENT *dirEntry = QT_READDIR(dir)) {
+        batch.resize(batch.size() + 1);
+        QDirTraversal::Entry &entry = batch.last();
+        entry.entry = QFileSystemEntry(path + QByteArray(dirEntry->d_name), QFileSystemEntry::FromNativePath());
+        entry.metaData.fillFromDirEnt(*dirEntry);
+
+        if (shouldDescend(handle->fd(), *dirEntry))
+            descend(handle, QByteArray(dirEntry->d_name), entry.entry);
+
+        if (batch.size() == QDirTraversal::BatchSize) {
+            if (!traversal->push(batch))
+                break;
+            batch.reserve(QDirTraversal::BatchSize);
+        }
+    }
+    if (!batch.isEmpty())
+        traversal->push(batch);
+
+    handle->release();
+    traversal->jobFinished();
+}
+
+// Mirrors QDirIteratorPrivate::checkAndPushDirectory(), using the type
+// from readdir() where possible and fstatat() relative to the directory
+// being read where not.
+bool QDirTraversalJob::shouldDescend(int fd, const QT_DIRENT &entry) const
+{
+    const char *fileName = entry.d_name;
+
+    // Never follow . and ..
+    if (fileName[0] == '.' && (!fileName[1] || (fileName[1] == '.' && !fileName[2])))
+        return false;
+
+    // No hidden directories unless requested
+    const QDir::Filters filters = traversal->filters;
+    if (fileName[0] == '.' && !(filters & QDir::AllDirs) && !(filters & QDir::Hidden))
+        return false;
+
+    const bool followSymlinks = traversal->iteratorFlags & QDirIterator::FollowSymlinks;
+    QT_STATBUF statBuffer;
+    bool statBufferValid = false;
+
+#if defined(_DIRENT_HAVE_D_TYPE) || defined(Q_OS_BSD4)
+    switch (entry.d_type) {
+    case DT_DIR:
+        break;
+    case DT_LNK:
+        // Follow symlinks only when asked
+        if (!followSymlinks)
+            return false;
+        break;
+    case DT_UNKNOWN:
+        if (qt_fstatat(fd, fileName, &statBuffer, AT_SYMLINK_NOFOLLOW) != 0)
+            return false;
+        if (S_ISLNK(statBuffer.st_mode) && !followSymlinks)
+            return false;
+        statBufferValid = !S_ISLNK(statBuffer.st_mode);
+        break;
+    default:
+        // Never follow non-directory entries
+        return false;
+    }
+#else
+    if (qt_fstatat(fd, fileName, &statBuffer, AT_SYMLINK_NOFOLLOW) != 0)
+        return false;
+    if (S_ISLNK(statBuffer.st_mode) && !followSymlinks)
+        return false;
+    statBufferValid = !S_ISLNK(statBuffer.st_mode);
+#endif
+
+    if (!followSymlinks)
+        return !statBufferValid || S_ISDIR(statBuffer.st_mode);
+
+    // Stop link loops
+    if (!statBufferValid && qt_fstatat(fd, fileName, &statBuffer, 0) != 0)
+        return false;
+    return S_ISDIR(statBuffer.st_mode) && traversal->visit(statBuffer.st_dev, statBuffer.st_ino);
+}
+
+void QDirTraversalJob::descend(QDirTraversalHandle *handle, const QByteArray &childName,
+                               const QFileSystemEntry &child)
+{
+    // Keeping a directory open for its subdirectories saves looking up
+    // the whole path again, but the number of directories waiting for
+    // their jobs to run is only limited by the size of the tree.
+    QDirTraversalHandle *childParent = 0;
+    if (traversal->openDirectories.load() < QDirTraversal::MaximumOpenDirectories) {
+        handle->addRef();
+        childParent = handle;
+    }
+
+    QDirTraversalJob *job = new QDirTraversalJob(traversal, childParent, childName,
+                                                 child.nativeFilePath() + '/', depth + 1);
+    {
+        QMutexLocker locker(&traversal->mutex);
+        if (traversal->cancelled) {
+            locker.unlock();
+            delete job;
+            return;
+        }
+        ++traversal->pendingJobs;
+    }
+    // deeper directories first, which keeps the number of pending jobs
+    // and open directories low
+    traversal->pool.start(job, depth + 1);
+}
+
+QDirTraversal::QDirTraversal(const QFileSystemEntry &root, QDir::Filters filters,
+                             QDirIterator::IteratorFlags flags)
+    : filters(filters),
+      iteratorFlags(flags),
+      pendingJobs(1),
+      cancelled(false),
+      currentIndex(0)
+{
+    // directory reads block on I/O rather than on the CPU
+    pool.setMaxThreadCount(qMax(QThread::idealThreadCount(), 2));
+
+    QFileSystemEntry::NativePath path = root.nativeFilePath();
+    if (!path.endsWith('/'))
+        path.append('/');
+
+    if (flags & QDirIterator::FollowSymlinks) {
+        QT_STATBUF statBuffer;
+        if (QT_STAT(path.constData(), &statBuffer) == 0)
+            visit(statBuffer.st_dev, statBuffer.st_ino);
+    }
+
+    pool.start(new QDirTraversalJob(this, 0, QByteArray(), path, 0));
+}
+
+QDirTraversal::~QDirTraversal()
+{
+    {
+        QMutexLocker locker(&mutex);
+        cancelled = true;
+        notFull.wakeAll();
+    }
+    pool.clear();
+    pool.waitForDone();
+}
+
+// Returns the next entry found, waiting for the workers if necessary, or
+// false when the whole tree has been listed.
+bool QDirTraversal::next(QFileSystemEntry &entry, QFileSystemMetaData &metaData)
+{
+    if (currentIndex == currentBatch.size()) {
+        QMutexLocker locker(&mutex);
+        while (batches.isEmpty() && pendingJobs)
+            notEmpty.wait(&mutex);
+        if (batches.isEmpty())
+            return false;
+        currentBatch.swap(batches.head());
+        batches.dequeue();
+        currentIndex = 0;
+        notFull.wakeOne();
+    }
+
+    const Entry &current = currentBatch.at(currentIndex++);
+    entry = current.entry;
+    metaData = current.metaData;
+    return true;
+}
+
+// Hands a batch of entries to the consumer and leaves \a batch empty.
+// Returns false if the traversal is being cancelled.
+bool QDirTraversal::push(Batch &batch)
+{
+    QMutexLocker locker(&mutex);
+    while (batches.size() >= MaximumQueuedBatches && !cancelled)
+        notFull.wait(&mutex);
+    if (cancelled)
+        return false;
+
+    batches.enqueue(Batch());
+    batches.last().swap(batch);
+    notEmpty.wakeOne();
+    return true;
+}
+
+void QDirTraversal::jobFinished()
+{
+    QMutexLocker locker(&mutex);
+    if (!--pendingJobs)
+        notEmpty.wakeAll();
+}
+
+// Returns true if the directory has not been entered before.
+bool QDirTraversal::visit(quint64 device, quint64 inode)
+{
+    const QPair<quint64, quint64> key(device, inode);
+    QMutexLocker locker(&visitedMutex);
+    if (visited.contains(key))
+        return false;
+    visited.insert(key);
+    return true;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_DIRTRAVERSAL
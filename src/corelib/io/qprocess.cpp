@@ -435,6 +435,32 @@ void QProcessPrivate::Channel::clear()
     process = 0;
 }
 
+/*!
+    \internal
+    Returns room for \a bytes at the end of the channel's sink, or of its
+    buffer if it has no sink.
+*/
+char *QProcessPrivate::Channel::reserve(qint64 bytes)
+{
+    if (!sink)
+        return buffer.reserve(bytes);
+    const int size = sink->size();
+    sink->resize(size + int(bytes));
+    return sink->data() + size;
+}
+
+/*!
+    \internal
+    Gives back \a bytes of the room returned by reserve().
+*/
+void QProcessPrivate::Channel::chop(qint64 bytes)
+{
+    if (sink)
+        sink->chop(int(bytes));
+    else
+        buffer.chop(bytes);
+}
+
 /*! \fn bool QProcessPrivate::startDetached(const QString &program, const QStringList &arguments, const QString &workingDirectory, qint64 *pid)
 
 \internal
@@ -824,6 +850,8 @@ QProcessPrivate::QProcessPrivate()
 #ifdef Q_OS_UNIX
     serial = 0;
 #endif
+    childProcessSetupEnabled = true;
+    keepChannelNotifiers = false;
 }
 
 /*!
@@ -860,11 +888,12 @@ void QProcessPrivate::cleanup()
     sequenceNumber = 0;
     dying = false;
 
-    if (stdoutChannel.notifier) {
+    // kept notifiers are disabled by closeChannel() below
+    if (stdoutChannel.notifier && !keepChannelNotifiers) {
         delete stdoutChannel.notifier;
         stdoutChannel.notifier = 0;
     }
-    if (stderrChannel.notifier) {
+    if (stderrChannel.notifier && !keepChannelNotifiers) {
         delete stderrChannel.notifier;
         stderrChannel.notifier = 0;
     }
@@ -910,10 +939,10 @@ bool QProcessPrivate::tryReadFromChannel(Channel *channel)
     if (available == 0)
         available = 1;      // always try to read at least one byte
 
-    char *ptr = channel->buffer.reserve(available);
+    char *ptr = channel->reserve(available);
     qint64 readBytes = readFromChannel(channel, ptr, available);
     if (readBytes <= 0)
-        channel->buffer.chop(available);
+        channel->chop(available);
     if (readBytes == -2) {
         // EWOULDBLOCK
         return false;
@@ -943,11 +972,11 @@ bool QProcessPrivate::tryReadFromChannel(Channel *channel)
 #endif
 
     if (channel->closed) {
-        channel->buffer.chop(readBytes);
+        channel->chop(readBytes);
         return false;
     }
 
-    channel->buffer.chop(available - readBytes);
+    channel->chop(available - readBytes);
 
     bool didRead = false;
     bool isStdout = channel == &stdoutChannel;
@@ -1123,9 +1152,12 @@ bool QProcessPrivate::_q_startupNotification()
     processError = QProcess::FailedToStart;
     emit q->error(processError);
 #ifdef Q_OS_UNIX
-    // make sure the process manager removes this entry
-    waitForDeadChild();
-    findExitCode();
+    // make sure the process manager removes this entry; a child that
+    // posix_spawn() failed to start was never registered
+    if (pid) {
+        waitForDeadChild();
+        findExitCode();
+    }
 #endif
     cleanup();
     return false;
@@ -1182,6 +1214,9 @@ QProcess::~QProcess()
     d->findExitCode();
 #endif
     d->cleanup();
+#ifdef Q_OS_UNIX
+    d->releaseChannelNotifiers();
+#endif
 }
 
 /*!
@@ -1267,6 +1302,46 @@ void QProcess::setInputChannelMode(InputChannelMode mode)
     d->inputChannelMode = mode;
 }
 
+/*!
+    \since 5.5
+
+    Returns \c true if setupChildProcess() is called in the child process
+    before the program is executed; otherwise returns \c false. The default
+    is \c true.
+
+    \sa setChildProcessSetupEnabled()
+*/
+bool QProcess::isChildProcessSetupEnabled() const
+{
+    Q_D(const QProcess);
+    return d->childProcessSetupEnabled;
+}
+
+/*!
+    \since 5.5
+
+    If \a enabled is \c false, setupChildProcess() is not called in the
+    child process. This setting will be used the next time start() is
+    called.
+
+    Without it, QProcess does not need to run any code in the child before
+    the program is executed, and on Unix it starts the child with
+    \e posix_spawn() instead of \e fork() where the C library supports
+    it, unless a working directory is set. Starting a process this way
+    does not copy the parent's page tables, so it is considerably faster
+    for parents with a large resident size.
+
+    Only disable it if the class does not reimplement setupChildProcess(),
+    or if its reimplementation is not needed.
+
+    \sa isChildProcessSetupEnabled(), setupChildProcess()
+*/
+void QProcess::setChildProcessSetupEnabled(bool enabled)
+{
+    Q_D(QProcess);
+    d->childProcessSetupEnabled = enabled;
+}
+
 /*!
     Returns the current read channel of the QProcess.
 
@@ -1866,6 +1941,12 @@ void QProcess::setProcessState(ProcessState state)
 
     \warning This function is called by QProcess on Unix and Mac OS X
     only. On Windows and QNX, it is not called.
+
+    \note This function is not called if setChildProcessSetupEnabled()
+    was called with \c false, which is the case for the processes started
+    by execute() and by QProcessPool.
+
+    \sa setChildProcessSetupEnabled()
 */
 void QProcess::setupChildProcess()
 {
@@ -2346,6 +2427,7 @@ QProcess::ExitStatus QProcess::exitStatus() const
 int QProcess::execute(const QString &program, const QStringList &arguments)
 {
     QProcess process;
+    process.setChildProcessSetupEnabled(false);
     process.setReadChannelMode(ForwardedChannels);
     process.start(program, arguments);
     if (!process.waitForFinished(-1))
@@ -2369,6 +2451,7 @@ int QProcess::execute(const QString &program, const QStringList &arguments)
 int QProcess::execute(const QString &command)
 {
     QProcess process;
+    process.setChildProcessSetupEnabled(false);
     process.setReadChannelMode(ForwardedChannels);
     process.start(command);
     if (!process.waitForFinished(-1))
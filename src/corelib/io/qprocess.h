@@ -149,6 +149,8 @@ public:
     void setProcessChannelMode(ProcessChannelMode mode);
     InputChannelMode inputChannelMode() const;
     void setInputChannelMode(InputChannelMode mode);
+    bool isChildProcessSetupEnabled() const;
+    void setChildProcessSetupEnabled(bool enabled);
 
     ProcessChannel readChannel() const;
     void setReadChannel(ProcessChannel channel);
@@ -66,6 +66,11 @@ typedef int Q_PIPE;
 
 #ifndef QT_NO_PROCESS
 
+// posix_spawn() is available
+#if defined(Q_OS_UNIX) && !defined(Q_OS_QNX) && !defined(Q_OS_ANDROID)
+#  define QPROCESS_HAVE_SPAWN
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QSocketNotifier;
@@ -241,7 +246,7 @@ public:
             // if you add "= 4" here, increase the number of bits below
         };
 
-        Channel() : process(0), notifier(0), type(Normal), closed(false), append(false)
+        Channel() : process(0), notifier(0), sink(0), type(Normal), closed(false), append(false)
         {
             pipe[0] = INVALID_Q_PIPE;
             pipe[1] = INVALID_Q_PIPE;
@@ -252,6 +257,9 @@ public:
 
         void clear();
 
+        char *reserve(qint64 bytes);
+        void chop(qint64 bytes);
+
         Channel &operator=(const QString &fileName)
         {
             clear();
@@ -284,6 +292,7 @@ public:
         };
 #endif
         QRingBuffer buffer;
+        QByteArray *sink; // if set, output is appended here instead of to buffer
         Q_PIPE pipe[2];
 
         unsigned type : 2;
@@ -305,6 +314,8 @@ public:
     QProcess::ProcessChannel processChannel;
     QProcess::ProcessChannelMode processChannelMode;
     QProcess::InputChannelMode inputChannelMode;
+    bool childProcessSetupEnabled;
+    bool keepChannelNotifiers; // reuse the stdout/stderr notifiers on the next start (Unix)
     QProcess::ProcessError processError;
     QProcess::ProcessState processState;
     QString workingDirectory;
@@ -347,6 +358,8 @@ public:
     void startProcess();
 #if defined(Q_OS_UNIX) && !defined(Q_OS_QNX)
     void execChild(const char *workingDirectory, char **path, char **argv, char **envp);
+    bool canSpawnChild(const char *workingDirectory) const;
+    pid_t spawnChild(char **path, char **argv, char **envp);
 #elif defined(Q_OS_QNX)
     pid_t spawnChild(const char *workingDirectory, char **argv, char **envp);
 #endif
@@ -371,6 +384,7 @@ public:
     bool crashed;
 #ifdef Q_OS_UNIX
     int serial;
+    void releaseChannelNotifiers();
 #endif
 
     bool waitForStarted(int msecs = 30000);
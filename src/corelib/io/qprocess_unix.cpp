@@ -105,6 +105,22 @@ QT_END_NAMESPACE
 #include <sys/neutrino.h>
 #endif
 
+#ifdef QPROCESS_HAVE_SPAWN
+#include <signal.h>
+#include <spawn.h>
+
+// posix_spawn() starts the child without copying the parent's page tables.
+// QProcess only uses it where it reports exec() failures back to the
+// caller, which glibc does since 2.24.
+#  if defined(Q_OS_DARWIN) || defined(Q_OS_FREEBSD)
+#    define QPROCESS_USE_SPAWN
+#  elif defined(__GLIBC__)
+#    if __GLIBC_PREREQ(2, 24)
+#      define QPROCESS_USE_SPAWN
+#    endif
+#  endif
+#endif
+
 QT_BEGIN_NAMESPACE
 
 // POSIX requires PIPE_BUF to be 512 or larger
@@ -371,9 +387,38 @@ void QProcessPrivate::destroyPipe(int *pipe)
 
 void QProcessPrivate::closeChannel(Channel *channel)
 {
+    // A kept notifier holds on to the descriptor it watches, so that
+    // openChannel() can move the next pipe onto it.
+    if (keepChannelNotifiers && channel->notifier && channel != &stdinChannel) {
+        channel->notifier->setEnabled(false);
+        if (channel->pipe[0] == channel->notifier->socket())
+            channel->pipe[0] = INVALID_Q_PIPE;
+    }
     destroyPipe(channel->pipe);
 }
 
+/*
+    Deletes the notifiers kept by closeChannel() along with their
+    descriptors.
+*/
+void QProcessPrivate::releaseChannelNotifiers()
+{
+    if (!keepChannelNotifiers)
+        return;
+    keepChannelNotifiers = false;
+
+    Channel *channels[] = { &stdoutChannel, &stderrChannel };
+    for (int i = 0; i < 2; ++i) {
+        Channel *channel = channels[i];
+        if (channel->notifier) {
+            if (channel->pipe[0] != channel->notifier->socket())
+                qt_safe_close(channel->notifier->socket());
+            delete channel->notifier;
+            channel->notifier = 0;
+        }
+    }
+}
+
 /*
     Create the pipes to a QProcessPrivate::Channel.
 
@@ -402,6 +447,19 @@ bool QProcessPrivate::openChannel(Channel &channel)
                 channel.notifier->setEnabled(false);
                 QObject::connect(channel.notifier, SIGNAL(activated(int)),
                                  q, SLOT(_q_canWrite()));
+            } else if (keepChannelNotifiers && channel.notifier) {
+                // Kept from the previous run: its descriptor becomes the
+                // read end of the new pipe.
+                const int fd = channel.notifier->socket();
+                if (qt_safe_dup2(channel.pipe[0], fd) == -1) {
+                    qt_safe_close(channel.pipe[0]);
+                    qt_safe_close(channel.pipe[1]);
+                    channel.pipe[0] = channel.pipe[1] = -1;
+                    return false;
+                }
+                qt_safe_close(channel.pipe[0]);
+                channel.pipe[0] = fd;
+                channel.notifier->setEnabled(true);
             } else {
                 channel.notifier = new QSocketNotifier(channel.pipe[0],
                                                        QSocketNotifier::Read, q);
@@ -672,6 +730,10 @@ void QProcessPrivate::startProcess()
     processManager()->lock();
 #if defined(Q_OS_QNX)
     pid_t childPid = spawnChild(workingDirPtr, argv, envp);
+#elif defined(QPROCESS_USE_SPAWN)
+    const bool spawned = canSpawnChild(workingDirPtr);
+    pid_t childPid = spawned ? spawnChild(path, argv, envp) : fork();
+    int lastForkErrno = errno;
 #else
     pid_t childPid = fork();
     int lastForkErrno = errno;
@@ -701,7 +763,12 @@ void QProcessPrivate::startProcess()
     // QProcess::waitForStarted() will fail, for childStartedPipe will be
     // '-1' and mess with the select() calls.
 #if !defined(Q_OS_QNX)
+#ifdef QPROCESS_USE_SPAWN
+    // a failure of posix_spawn() is reported later, like one of exec()
+    if (childPid < 0 && !spawned) {
+#else
     if (childPid < 0) {
+#endif
         // Cleanup, report error and return
 #if defined (QPROCESS_DEBUG)
         qDebug("fork failed: %s", qPrintable(qt_error_string(lastForkErrno)));
@@ -724,8 +791,16 @@ void QProcessPrivate::startProcess()
 
     // Register the child. In the mean time, we can get a SIGCHLD, so we need
     // to keep the lock held to avoid a race to catch the child.
+#ifdef QPROCESS_USE_SPAWN
+    // There is no child to register if posix_spawn() failed; pid stays 0.
+    if (childPid > 0) {
+        processManager()->add(childPid, q);
+        pid = Q_PID(childPid);
+    }
+#else
     processManager()->add(childPid, q);
     pid = Q_PID(childPid);
+#endif
     processManager()->unlock();
 
     // parent
@@ -897,7 +972,8 @@ void QProcessPrivate::execChild(const char *workingDir, char **path, char **argv
     }
 
     // this is a virtual call, and it base behavior is to do nothing.
-    q->setupChildProcess();
+    if (childProcessSetupEnabled)
+        q->setupChildProcess();
 
     // execute the process
     if (!envp) {
@@ -930,6 +1006,115 @@ void QProcessPrivate::execChild(const char *workingDir, char **path, char **argv
     qt_safe_close(childStartedPipe[1]);
     childStartedPipe[1] = -1;
 }
+
+#ifdef QPROCESS_USE_SPAWN
+/*
+    Starts a child with posix_spawn(), with the given file descriptors as
+    its standard channels; -1 leaves a channel as it is in the parent. The
+    program is tried at each location in \a path, or looked up in PATH if
+    \a path is null. Returns 0 or an errno value.
+*/
+static int qt_spawn_child(pid_t *childPid, char **path, char **argv, char **envp,
+                          int stdinFd, int stdoutFd, int stderrFd)
+{
+    posix_spawn_file_actions_t fileActions;
+    if (int error = posix_spawn_file_actions_init(&fileActions))
+        return error;
+
+    if (stdinFd != -1)
+        posix_spawn_file_actions_adddup2(&fileActions, stdinFd, STDIN_FILENO);
+    if (stdoutFd != -1)
+        posix_spawn_file_actions_adddup2(&fileActions, stdoutFd, STDOUT_FILENO);
+    if (stderrFd != -1)
+        posix_spawn_file_actions_adddup2(&fileActions, stderrFd, STDERR_FILENO);
+
+    // reset the signal that we ignored
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    sigset_t defaultSignals;
+    sigemptyset(&defaultSignals);
+    sigaddset(&defaultSignals, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attributes, &defaultSignals);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGDEF);
+
+    int error;
+    if (path) {
+        error = ENOENT;
+        for (char **arg = path; *arg && error; ++arg) {
+            argv[0] = *arg;
+#if defined (QPROCESS_DEBUG)
+            fprintf(stderr, "qt_spawn_child() searching / starting %s\n", argv[0]);
+#endif
+            error = posix_spawn(childPid, argv[0], &fileActions, &attributes, argv, envp);
+        }
+    } else {
+#if defined (QPROCESS_DEBUG)
+        fprintf(stderr, "qt_spawn_child() starting %s\n", argv[0]);
+#endif
+        error = posix_spawnp(childPid, argv[0], &fileActions, &attributes, argv, envp ? envp : environ);
+    }
+
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&fileActions);
+    return error;
+}
+#endif // QPROCESS_USE_SPAWN
+
+/*
+    Returns true if nothing needs to run in the child between fork() and
+    exec(), so that it can be started with posix_spawn(). A reimplemented
+    QProcess::setupChildProcess() can't be detected, so this is only the
+    case once QProcess::setChildProcessSetupEnabled() turned it off.
+*/
+bool QProcessPrivate::canSpawnChild(const char *workingDir) const
+{
+#ifdef QPROCESS_USE_SPAWN
+    return !childProcessSetupEnabled && !workingDir;
+#else
+    Q_UNUSED(workingDir);
+    return false;
+#endif
+}
+
+/*
+    Starts the child the way execChild() does, but with posix_spawn().
+    Returns the pid of the child, or -1 if it could not be started. Like a
+    child whose exec() fails, a failure is reported through
+    childStartedPipe, so that it reaches the caller the same way.
+*/
+pid_t QProcessPrivate::spawnChild(char **path, char **argv, char **envp)
+{
+#ifdef QPROCESS_USE_SPAWN
+    // copy the stdin socket if asked to
+    const int stdinFd = inputChannelMode != QProcess::ForwardedInputChannel ? stdinChannel.pipe[0] : -1;
+
+    // copy the stdout and stderr if asked to, merging them if asked to
+    int stdoutFd = -1;
+    int stderrFd = -1;
+    if (processChannelMode != QProcess::ForwardedChannels) {
+        if (processChannelMode != QProcess::ForwardedOutputChannel)
+            stdoutFd = stdoutChannel.pipe[1];
+        if (processChannelMode == QProcess::MergedChannels)
+            stderrFd = stdoutChannel.pipe[1];
+        else if (processChannelMode != QProcess::ForwardedErrorChannel)
+            stderrFd = stderrChannel.pipe[1];
+    }
+
+    // like execvp(), posix_spawnp() searches PATH if there is no environment
+    pid_t childPid = -1;
+    if (int error = qt_spawn_child(&childPid, envp ? path : 0, argv, envp, stdinFd, stdoutFd, stderrFd)) {
+        QString errorString = qt_error_string(error);
+        qt_safe_write(childStartedPipe[1], errorString.data(), errorString.length() * sizeof(QChar));
+        return -1;
+    }
+    return childPid;
+#else
+    Q_UNUSED(path);
+    Q_UNUSED(argv);
+    Q_UNUSED(envp);
+    return -1;
+#endif
+}
 #endif
 
 bool QProcessPrivate::processStarted()
@@ -0,0 +1,521 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qprocesspool.h"
+#include "qprocesspool_p.h"
+#include "qprocess_p.h"
+
+#ifndef QT_NO_PROCESS
+
+#include <qelapsedtimer.h>
+#include <qthread.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QProcessPool
+    \inmodule QtCore
+    \since 5.5
+
+    \brief The QProcessPool class runs a batch of external programs with
+    bounded concurrency and collects their output.
+
+    \ingroup io
+
+    \reentrant
+
+    QProcessPool is meant for workloads that run many short commands, for
+    example calling a compiler or a converter on every file of a
+    directory. Each call to start() queues a command and returns an
+    identifier for it. At most maximumConcurrency() commands run at the
+    same time; the others wait in the queue and are started as running
+    commands finish.
+
+    \snippet code/src_corelib_io_qprocesspool.cpp 0
+
+    When a command has finished, QProcessPool emits finished() with its
+    exit code, exit status and everything it wrote to its standard output
+    and standard error. The output is collected while the command runs;
+    there is no readyRead() notification and no way to write to the
+    standard input of a command, which is connected to the null device.
+    If a command cannot be started, error() is emitted for it instead.
+    Once the queue is empty and no command is running any more,
+    allFinished() is emitted.
+
+    The commands are run by QProcess objects, which are reused for the
+    next command once one has finished. Since nobody can reimplement
+    QProcess::setupChildProcess() for them, they are started with
+    \e posix_spawn() where the C library supports it, which is much faster
+    than \e fork() in a parent with a large resident size. The output of a
+    command is read straight into buffers that are reused as well, and
+    so are the socket notifiers that watch the output pipes. Set
+    outputBufferSize() to the output size you expect from a command, so
+    that the buffers don't need to grow. The buffers passed to finished()
+    can only be reused if they are not copied, so don't keep them if you
+    don't need them.
+
+    Commands inherit the working directory of the calling process, and,
+    unless setProcessEnvironment() was called, its environment too.
+
+    If there is no event loop, call waitForFinished() to run all queued
+    commands to completion.
+
+    \sa QProcess
+*/
+
+/*!
+    \fn void QProcessPool::finished(int id, int exitCode, QProcess::ExitStatus exitStatus, const QByteArray &standardOutput, const QByteArray &standardError)
+
+    This signal is emitted when the command \a id has finished. \a exitCode
+    is the exit code of the process (only valid for normal exits), and
+    \a exitStatus is the exit status. \a standardOutput and
+    \a standardError hold what the process wrote to the respective
+    channel; if the process channel mode merges or forwards a channel, the
+    corresponding buffer is empty.
+
+    \sa error(), allFinished()
+*/
+
+/*!
+    \fn void QProcessPool::error(int id, QProcess::ProcessError error)
+
+    This signal is emitted when the command \a id could not be started.
+    The \a error is always QProcess::FailedToStart; finished() is not
+    emitted for the command.
+*/
+
+/*!
+    \fn void QProcessPool::allFinished()
+
+    This signal is emitted when the last running command has finished, or
+    failed to start, and no more commands are queued.
+*/
+
+/*!
+    \internal
+*/
+QProcessPoolPrivate::QProcessPoolPrivate()
+    : processChannelMode(QProcess::SeparateChannels),
+      maximumConcurrency(qMax(1, QThread::idealThreadCount())),
+      outputBufferSize(4096),
+      running(0),
+      nextId(0),
+      starting(false)
+{
+}
+
+/*!
+    \internal
+*/
+QProcessPoolPrivate::~QProcessPoolPrivate()
+{
+    qDeleteAll(runners);
+}
+
+/*!
+    \internal
+
+    Starts queued commands as long as there is room for them. Emits
+    allFinished() if that leaves the pool idle after \a finishing a command,
+    or because all commands taken from the queue failed to start.
+*/
+void QProcessPoolPrivate::startQueuedCommands(bool finishing)
+{
+    Q_Q(QProcessPool);
+
+    // commands queued or finished from slots connected to error() are
+    // picked up by the loop below
+    if (starting)
+        return;
+    starting = true;
+
+    bool dequeued = false;
+    while (!queue.isEmpty() && running < maximumConcurrency) {
+        Runner *runner = 0;
+        for (int i = 0; i < runners.size(); ++i) {
+            if (runners.at(i)->id == Idle) {
+                runner = runners.at(i);
+                break;
+            }
+        }
+        if (!runner) {
+            runner = new Runner;
+            runners.append(runner);
+        }
+
+        startCommand(runner, queue.dequeue());
+        dequeued = true;
+    }
+
+    starting = false;
+    if ((finishing || dequeued) && !running && queue.isEmpty())
+        emit q->allFinished();
+}
+
+/*
+    Empties \a buffer for the output of the next command. It keeps its
+    allocation unless it is shared.
+*/
+static void prepareBuffer(QByteArray *buffer, int size)
+{
+    if (buffer->isDetached() && buffer->capacity() >= size) {
+        buffer->resize(0);
+    } else {
+        *buffer = QByteArray();
+        if (size)
+            buffer->reserve(size);
+    }
+}
+
+/*!
+    \internal
+
+    Starts \a command on the process of \a runner, which is created the first
+    time. A failure to start is reported by the process, just like its exit.
+*/
+void QProcessPoolPrivate::startCommand(Runner *runner, const Command &command)
+{
+    Q_Q(QProcessPool);
+    if (!runner->process) {
+        runner->process = new QProcess(q);
+        runner->process->setChildProcessSetupEnabled(false);
+        runner->process->setStandardInputFile(QProcess::nullDevice());
+
+        // the output goes straight into the buffers of the runner, and the
+        // notifiers for it are kept for the next command
+        QProcessPrivate *d = static_cast<QProcessPrivate *>(QObjectPrivate::get(runner->process));
+        d->stdoutChannel.sink = &runner->standardOutput;
+        d->stderrChannel.sink = &runner->standardError;
+        d->keepChannelNotifiers = true;
+        QObject::connect(runner->process, SIGNAL(finished(int,QProcess::ExitStatus)),
+                         q, SLOT(_q_processDied()));
+        QObject::connect(runner->process, SIGNAL(error(QProcess::ProcessError)),
+                         q, SLOT(_q_processDied()));
+    }
+
+    // reuse the buffers of the previous command, unless they were kept
+    const bool readsOutput = processChannelMode != QProcess::ForwardedChannels
+            && processChannelMode != QProcess::ForwardedOutputChannel;
+    const bool readsError = processChannelMode == QProcess::SeparateChannels
+            || processChannelMode == QProcess::ForwardedOutputChannel;
+    prepareBuffer(&runner->standardOutput, readsOutput ? outputBufferSize : 0);
+    prepareBuffer(&runner->standardError, readsError ? outputBufferSize : 0);
+
+    runner->id = command.id;
+    ++running;
+    runner->process->setProcessChannelMode(processChannelMode);
+    runner->process->setProcessEnvironment(environment);
+    runner->process->start(command.program, command.arguments, QIODevice::ReadOnly);
+}
+
+/*!
+    \internal
+
+    Emits finished() for the command that \a runner has been running, and
+    starts the next one.
+*/
+void QProcessPoolPrivate::finishCommand(Runner *runner)
+{
+    Q_Q(QProcessPool);
+    const int id = runner->id;
+    QProcess *process = runner->process;
+
+    // Neither running nor idle while the signal is emitted: the buffers
+    // must not be reused if a command is started from a connected slot.
+    runner->id = Finishing;
+    --running;
+    emit q->finished(id, process->exitCode(), process->exitStatus(),
+                     runner->standardOutput, runner->standardError);
+    runner->id = Idle;
+
+    startQueuedCommands(true);
+}
+
+void QProcessPoolPrivate::_q_processDied()
+{
+    Q_Q(QProcessPool);
+    for (int i = 0; i < runners.size(); ++i) {
+        Runner *runner = runners.at(i);
+        if (runner->id < 0 || runner->process->state() != QProcess::NotRunning)
+            continue;
+
+        if (runner->process->error() == QProcess::FailedToStart) {
+            const int id = runner->id;
+            runner->id = Idle;
+            --running;
+            emit q->error(id, QProcess::FailedToStart);
+            startQueuedCommands(true);
+        } else {
+            finishCommand(runner);
+        }
+    }
+}
+
+bool QProcessPoolPrivate::waitForFinished(int msecs)
+{
+    QElapsedTimer stopWatch;
+    stopWatch.start();
+
+    while (running) {
+        Runner *runner = 0;
+        for (int i = 0; i < runners.size() && !runner; ++i) {
+            if (runners.at(i)->id >= 0)
+                runner = runners.at(i);
+        }
+        if (!runner)
+            break;
+
+        const int id = runner->id;
+        const int timeout = msecs < 0 ? -1 : qMax(0, msecs - int(stopWatch.elapsed()));
+        if (!runner->process->waitForFinished(timeout) && runner->id == id)
+            return false;
+    }
+    return true;
+}
+
+void QProcessPoolPrivate::cleanup()
+{
+    Q_Q(QProcessPool);
+    for (int i = 0; i < runners.size(); ++i) {
+        Runner *runner = runners.at(i);
+        if (runner->process) {
+            QObject::disconnect(runner->process, 0, q, 0);
+            if (runner->process->state() != QProcess::NotRunning) {
+                runner->process->kill();
+                runner->process->waitForFinished();
+            }
+            delete runner->process;
+            runner->process = 0;
+        }
+        runner->id = Idle;
+    }
+    running = 0;
+}
+
+/*!
+    Constructs a QProcessPool object with the given \a parent.
+*/
+QProcessPool::QProcessPool(QObject *parent)
+    : QObject(*new QProcessPoolPrivate, parent)
+{
+}
+
+/*!
+    Destroys the QProcessPool object. Queued commands are discarded, and
+    running ones are killed.
+*/
+QProcessPool::~QProcessPool()
+{
+    Q_D(QProcessPool);
+    d->queue.clear();
+    d->cleanup();
+}
+
+/*!
+    Returns the number of commands that are run at the same time. The
+    default is QThread::idealThreadCount().
+
+    \sa setMaximumConcurrency()
+*/
+int QProcessPool::maximumConcurrency() const
+{
+    Q_D(const QProcessPool);
+    return d->maximumConcurrency;
+}
+
+/*!
+    Sets the number of commands that are run at the same time to \a count.
+    If \a count is larger than before, queued commands are started right
+    away; if it is smaller, running commands are not affected.
+
+    \sa maximumConcurrency()
+*/
+void QProcessPool::setMaximumConcurrency(int count)
+{
+    Q_D(QProcessPool);
+    if (count < 1) {
+        qWarning("QProcessPool::setMaximumConcurrency: Concurrency must be at least 1");
+        return;
+    }
+    d->maximumConcurrency = count;
+    d->startQueuedCommands();
+}
+
+/*!
+    Returns the channel mode of the commands of the pool.
+
+    \sa setProcessChannelMode()
+*/
+QProcess::ProcessChannelMode QProcessPool::processChannelMode() const
+{
+    Q_D(const QProcessPool);
+    return d->processChannelMode;
+}
+
+/*!
+    Sets the channel mode of the commands started from now on to \a mode.
+    The default is QProcess::SeparateChannels.
+
+    \sa processChannelMode(), QProcess::setProcessChannelMode()
+*/
+void QProcessPool::setProcessChannelMode(QProcess::ProcessChannelMode mode)
+{
+    Q_D(QProcessPool);
+    d->processChannelMode = mode;
+}
+
+/*!
+    Returns the environment of the commands of the pool, or an empty
+    environment if setProcessEnvironment() has not been called.
+
+    \sa setProcessEnvironment()
+*/
+QProcessEnvironment QProcessPool::processEnvironment() const
+{
+    Q_D(const QProcessPool);
+    return d->environment;
+}
+
+/*!
+    Sets the environment of the commands started from now on to
+    \a environment.
+
+    \sa processEnvironment(), QProcess::setProcessEnvironment()
+*/
+void QProcessPool::setProcessEnvironment(const QProcessEnvironment &environment)
+{
+    Q_D(QProcessPool);
+    d->environment = environment;
+}
+
+/*!
+    Returns the number of bytes reserved for the standard output and the
+    standard error of each command before it is started.
+
+    \sa setOutputBufferSize()
+*/
+int QProcessPool::outputBufferSize() const
+{
+    Q_D(const QProcessPool);
+    return d->outputBufferSize;
+}
+
+/*!
+    Sets the number of bytes reserved for the standard output and the
+    standard error of each command to \a size. The buffers grow if a
+    command writes more than that. The default is 4096.
+
+    \sa outputBufferSize()
+*/
+void QProcessPool::setOutputBufferSize(int size)
+{
+    Q_D(QProcessPool);
+    d->outputBufferSize = qMax(0, size);
+}
+
+/*!
+    Queues the program \a program to be run with the command line
+    arguments \a arguments, and returns the identifier that finished() or
+    error() will report for it. The command is started right away if fewer
+    than maximumConcurrency() commands are running.
+
+    As with QProcess::start(), the program is looked up in the \c PATH of
+    the calling process if \a program doesn't contain a path.
+*/
+int QProcessPool::start(const QString &program, const QStringList &arguments)
+{
+    Q_D(QProcessPool);
+    QProcessPoolPrivate::Command command;
+    command.id = d->nextId++;
+    command.program = program;
+    command.arguments = arguments;
+    d->queue.enqueue(command);
+    d->startQueuedCommands();
+    return command.id;
+}
+
+/*!
+    Removes all commands that have not been started yet from the queue.
+    Running commands are not affected.
+*/
+void QProcessPool::clear()
+{
+    Q_D(QProcessPool);
+    d->queue.clear();
+}
+
+/*!
+    Returns the number of commands that are queued or running.
+
+    \sa runningCount()
+*/
+int QProcessPool::pendingCount() const
+{
+    Q_D(const QProcessPool);
+    return d->queue.size() + d->running;
+}
+
+/*!
+    Returns the number of commands that are running.
+
+    \sa pendingCount()
+*/
+int QProcessPool::runningCount() const
+{
+    Q_D(const QProcessPool);
+    return d->running;
+}
+
+/*!
+    Blocks until all queued and running commands have finished, and
+    returns \c true, or until \a msecs milliseconds have passed, and
+    returns \c false. If \a msecs is -1, this function will not time out.
+
+    The signals of the pool are emitted from within this function.
+
+    \warning Calling this function from the main (GUI) thread might cause
+    your user interface to freeze.
+
+    \sa QProcess::waitForFinished()
+*/
+bool QProcessPool::waitForFinished(int msecs)
+{
+    Q_D(QProcessPool);
+    return d->waitForFinished(msecs);
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qprocesspool.cpp"
+
+#endif // QT_NO_PROCESS
@@ -0,0 +1,91 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QPROCESSPOOL_H
+#define QPROCESSPOOL_H
+
+#include <QtCore/qobject.h>
+#include <QtCore/qprocess.h>
+
+QT_BEGIN_NAMESPACE
+
+
+#ifndef QT_NO_PROCESS
+
+class QProcessPoolPrivate;
+
+class Q_CORE_EXPORT QProcessPool : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QProcessPool(QObject *parent = 0);
+    ~QProcessPool();
+
+    int maximumConcurrency() const;
+    void setMaximumConcurrency(int count);
+
+    QProcess::ProcessChannelMode processChannelMode() const;
+    void setProcessChannelMode(QProcess::ProcessChannelMode mode);
+
+    QProcessEnvironment processEnvironment() const;
+    void setProcessEnvironment(const QProcessEnvironment &environment);
+
+    int outputBufferSize() const;
+    void setOutputBufferSize(int size);
+
+    int start(const QString &program, const QStringList &arguments = QStringList());
+    void clear();
+
+    int pendingCount() const;
+    int runningCount() const;
+
+    bool waitForFinished(int msecs = 30000);
+
+Q_SIGNALS:
+    void finished(int id, int exitCode, QProcess::ExitStatus exitStatus,
+                  const QByteArray &standardOutput, const QByteArray &standardError);
+    void error(int id, QProcess::ProcessError error);
+    void allFinished();
+
+private:
+    Q_DECLARE_PRIVATE(QProcessPool)
+    Q_DISABLE_COPY(QProcessPool)
+
+    Q_PRIVATE_SLOT(d_func(), void _q_processDied())
+};
+
+#endif // QT_NO_PROCESS
+
+QT_END_NAMESPACE
+
+#endif // QPROCESSPOOL_H
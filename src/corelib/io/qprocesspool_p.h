@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QPROCESSPOOL_P_H
+#define QPROCESSPOOL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "QtCore/qprocesspool.h"
+#include "QtCore/qqueue.h"
+#include "QtCore/qvector.h"
+#include "private/qobject_p.h"
+
+#ifndef QT_NO_PROCESS
+
+QT_BEGIN_NAMESPACE
+
+class QProcessPoolPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QProcessPool)
+public:
+    enum { Idle = -1, Finishing = -2 };
+
+    struct Command
+    {
+        int id;
+        QString program;
+        QStringList arguments;
+    };
+
+    // One running command. Runners are kept when their command finishes,
+    // so that the process and the output buffers can be used again for the
+    // next one.
+    struct Runner
+    {
+        Runner() : id(Idle), process(0) {}
+
+        int id; // or Idle, or Finishing while finished() is emitted
+        QProcess *process;
+        QByteArray standardOutput;
+        QByteArray standardError;
+    };
+
+    QProcessPoolPrivate();
+    ~QProcessPoolPrivate();
+
+    void startQueuedCommands(bool finishing = false);
+    void startCommand(Runner *runner, const Command &command);
+    void finishCommand(Runner *runner);
+    void cleanup();
+    bool waitForFinished(int msecs);
+
+    void _q_processDied();
+
+    QQueue<Command> queue;
+    QVector<Runner *> runners;
+    QProcessEnvironment environment;
+    QProcess::ProcessChannelMode processChannelMode;
+    int maximumConcurrency;
+    int outputBufferSize;
+    int running;
+    int nextId;
+    bool starting;
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_PROCESS
+
+#endif // QPROCESSPOOL_P_H
@@ -38,6 +38,7 @@
 #ifndef QT_NO_SETTINGS
 
 #include "qsettings_p.h"
+#include <private/qstringatom_p.h>
 #include "qcache.h"
 #include "qfile.h"
 #include "qdir.h"
@@ -65,6 +66,7 @@
 #ifndef QT_BOOTSTRAPPED
 #include "qsavefile.h"
 #include "qlockfile.h"
+#include "qsettingsbinary_p.h"
 #endif
 
 #ifdef Q_OS_VXWORKS
@@ -139,7 +141,7 @@ static QBasicMutex settingsGlobalMutex;
 static QSettings::Format globalDefaultFormat = QSettings::NativeFormat;
 
 QConfFile::QConfFile(const QString &fileName, bool _userPerms)
-    : name(fileName), size(0), ref(1), userPerms(_userPerms)
+    : name(fileName), size(0), binaryFile(0), ref(1), userPerms(_userPerms)
 {
     usedHashFunc()->insert(name, this);
 }
@@ -148,6 +150,9 @@ QConfFile::~QConfFile()
 {
     if (usedHashFunc())
         usedHashFunc()->remove(name);
+#ifndef QT_BOOTSTRAPPED
+    delete binaryFile;
+#endif
 }
 
 ParsedSettingsMap QConfFile::mergedKeyMap() const
@@ -914,7 +919,11 @@ void QConfFileSettingsPrivate::initFormat()
     caseSensitivity = IniCaseSensitivity;
 #endif
 
-    if (format > QSettings::IniFormat) {
+    if (format == QSettings::BinaryFormat) {
+        // the keys are kept in the order of the file's index
+        extension = QLatin1String(".qsettings");
+        caseSensitivity = Qt::CaseSensitive;
+    } else if (format > QSettings::BinaryFormat) {
         QMutexLocker locker(&settingsGlobalMutex);
         const CustomFormatVector *customFormatVector = customFormatVectorFunc();
 
@@ -932,7 +941,7 @@ void QConfFileSettingsPrivate::initFormat()
 void QConfFileSettingsPrivate::initAccess()
 {
     if (confFiles[spec]) {
-        if (format > QSettings::IniFormat) {
+        if (format > QSettings::BinaryFormat) {
             if (!readFunc)
                 setStatus(QSettings::AccessError);
         }
@@ -1345,7 +1354,7 @@ QString QConfFileSettingsPrivate::fileName() const
 
 bool QConfFileSettingsPrivate::isWritable() const
 {
-    if (format > QSettings::IniFormat && !writeFunc)
+    if (format > QSettings::BinaryFormat && !writeFunc)
         return false;
 
     QConfFile *confFile = confFiles[spec].data();
@@ -1361,6 +1370,13 @@ void QConfFileSettingsPrivate::syncConfFile(int confFileNo)
     bool readOnly = confFile->addedKeys.isEmpty() && confFile->removedKeys.isEmpty();
     bool ok;
 
+#ifndef QT_BOOTSTRAPPED
+    if (format == QSettings::BinaryFormat) {
+        syncBinaryConfFile(confFile);
+        return;
+    }
+#endif
+
     /*
         We can often optimize the read-only case, if the file on disk
         hasn't changed.
@@ -1519,6 +1535,190 @@ void QConfFileSettingsPrivate::syncConfFile(int confFileNo)
     }
 }
 
+#ifndef QT_BOOTSTRAPPED
+static void applyBinaryJournal(QConfFile *confFile, const QSettingsBinaryFile::Journal &journal)
+{
+    QSettingsBinaryFile *binaryFile = confFile->binaryFile;
+
+    for (int i = 0; i < journal.size(); ++i) {
+        const QSettingsBinaryFile::JournalEntry &entry = journal.at(i);
+        if (binaryFile)
+            binaryFile->take(binaryFile->indexOf(entry.key));
+        if (entry.operation == QSettingsBinaryFile::SetValue)
+            confFile->originalKeys.insert(QSettingsKey(entry.key, Qt::CaseSensitive), entry.value);
+        else
+            confFile->originalKeys.remove(QSettingsKey(entry.key, Qt::CaseSensitive));
+    }
+}
+
+static bool readBinaryEntry(QConfFile *confFile, int i)
+{
+    QSettingsBinaryFile *binaryFile = confFile->binaryFile;
+    if (i < 0 || binaryFile->isTaken(i))
+        return true;
+
+    QVariant value;
+    bool ok = binaryFile->valueAt(i, &value);
+    confFile->originalKeys.insert(QSettingsKey(binaryFile->keyAt(i), Qt::CaseSensitive), value);
+    binaryFile->take(i);
+    return ok;
+}
+
+/*
+    Brings the keys of a BinaryFormat file up to date. If the file still
+    holds the snapshot that we have mapped, only the journal records that
+    were appended since we last looked are read.
+*/
+void QConfFileSettingsPrivate::readBinaryConfFile(QConfFile *confFile)
+{
+    QSettingsBinaryFile::Journal journal;
+    if (confFile->binaryFile
+        && confFile->binaryFile->readAppendedJournal(confFile->name, &journal)) {
+        applyBinaryJournal(confFile, journal);
+        return;
+    }
+
+    delete confFile->binaryFile;
+    confFile->binaryFile = 0;
+    confFile->originalKeys.clear();
+
+    QFileInfo fileInfo(confFile->name);
+    if (fileInfo.size() == 0)
+        return;
+
+    QSettingsBinaryFile *binaryFile = new QSettingsBinaryFile;
+    if (!binaryFile->load(confFile->name, &journal)) {
+        delete binaryFile;
+        setStatus(fileInfo.isReadable() ? QSettings::FormatError : QSettings::AccessError);
+        return;
+    }
+    confFile->binaryFile = binaryFile;
+    applyBinaryJournal(confFile, journal);
+}
+
+void QConfFileSettingsPrivate::syncBinaryConfFile(QConfFile *confFile)
+{
+    bool readOnly = confFile->addedKeys.isEmpty() && confFile->removedKeys.isEmpty();
+
+    if (readOnly) {
+        QFileInfo fileInfo(confFile->name);
+        if (confFile->size == fileInfo.size() && confFile->timeStamp == fileInfo.lastModified())
+            return;
+    }
+
+    QLockFile lockFile(confFile->name + QLatin1String(".lock"));
+    if (!readOnly) {
+        if (!confFile->isWritable() || !lockFile.lock()) {
+            setStatus(QSettings::AccessError);
+            return;
+        }
+    }
+
+    QFileInfo fileInfo(confFile->name);
+    bool createFile = !fileInfo.exists();
+
+    if (confFile->size != fileInfo.size() || confFile->timeStamp != fileInfo.lastModified()) {
+        readBinaryConfFile(confFile);
+        confFile->size = fileInfo.size();
+        confFile->timeStamp = fileInfo.lastModified();
+    }
+
+    if (readOnly)
+        return;
+
+    /*
+        Our changes are appended to the file as journal records. As the
+        journal is read in full whenever the file is loaded, the file is
+        rewritten once the journal gets large compared to the snapshot.
+    */
+    QSettingsBinaryFile *binaryFile = confFile->binaryFile;
+    ParsedSettingsMap::const_iterator i;
+    bool ok = false;
+
+    if (binaryFile && binaryFile->isAppendable()) {
+        QByteArray records;
+        for (i = confFile->removedKeys.constBegin(); i != confFile->removedKeys.constEnd(); ++i)
+            records += QSettingsBinaryFile::journalRecord(QSettingsBinaryFile::RemoveValue, i.key());
+        for (i = confFile->addedKeys.constBegin(); i != confFile->addedKeys.constEnd(); ++i)
+            records += QSettingsBinaryFile::journalRecord(QSettingsBinaryFile::SetValue, i.key(), i.value());
+
+        if (binaryFile->journalSize() + records.size()
+                <= qMax(binaryFile->snapshotSize() / 4, qint64(16 * 1024))) {
+            QFile file(confFile->name);
+            if (file.open(QIODevice::WriteOnly | QIODevice::Append)
+                && file.size() == binaryFile->fileSize()) {
+                ok = (file.write(records) == records.size() && file.flush());
+            }
+        }
+
+        if (ok) {
+            binaryFile->appended(records.size());
+            for (i = confFile->removedKeys.constBegin(); i != confFile->removedKeys.constEnd(); ++i) {
+                binaryFile->take(binaryFile->indexOf(i.key()));
+                confFile->originalKeys.remove(i.key());
+            }
+            for (i = confFile->addedKeys.constBegin(); i != confFile->addedKeys.constEnd(); ++i) {
+                binaryFile->take(binaryFile->indexOf(i.key()));
+                confFile->originalKeys.insert(i.key(), i.value());
+            }
+        }
+    }
+
+    if (!ok) {
+        // write a new snapshot; the entries that were never decoded are copied as they are
+        ParsedSettingsMap mergedKeys = confFile->mergedKeyMap();
+        QMap<QString, QByteArray> entries;
+        if (binaryFile) {
+            for (int j = 0; j < binaryFile->count(); ++j) {
+                if (!binaryFile->isTaken(j))
+                    entries.insert(entries.constEnd(), binaryFile->keyAt(j), binaryFile->rawValueAt(j));
+            }
+        }
+        for (i = mergedKeys.constBegin(); i != mergedKeys.constEnd(); ++i)
+            entries.insert(i.key(), QSettingsBinaryFile::encodeValue(i.value()));
+
+        QSaveFile sf(confFile->name);
+        ok = sf.open(QIODevice::WriteOnly)
+             && QSettingsBinaryFile::writeSnapshot(&sf, entries)
+             && sf.commit();
+
+        if (ok) {
+            QSettingsBinaryFile *newBinaryFile = new QSettingsBinaryFile;
+            QSettingsBinaryFile::Journal journal;
+            if (newBinaryFile->load(confFile->name, &journal)) {
+                for (i = mergedKeys.constBegin(); i != mergedKeys.constEnd(); ++i)
+                    newBinaryFile->take(newBinaryFile->indexOf(i.key()));
+                delete binaryFile;
+                confFile->binaryFile = newBinaryFile;
+            } else {
+                // the old mapping still holds the entries that were not decoded
+                delete newBinaryFile;
+            }
+            confFile->originalKeys = mergedKeys;
+        }
+    }
+
+    if (ok) {
+        confFile->addedKeys.clear();
+        confFile->removedKeys.clear();
+
+        QFileInfo fileInfo(confFile->name);
+        confFile->size = fileInfo.size();
+        confFile->timeStamp = fileInfo.lastModified();
+
+        // If we have created the file, apply the file perms
+        if (createFile) {
+            QFile::Permissions perms = fileInfo.permissions() | QFile::ReadOwner | QFile::WriteOwner;
+            if (!confFile->userPerms)
+                perms |= QFile::ReadGroup | QFile::ReadOther;
+            QFile(confFile->name).setPermissions(perms);
+        }
+    } else {
+        setStatus(QSettings::AccessError);
+    }
+}
+#endif // QT_BOOTSTRAPPED
+
 enum { Space = 0x1, Special = 0x2 };
 
 static const char charTraits[256] =
@@ -1717,6 +1917,10 @@ bool QConfFileSettingsPrivate::readIniSection(const QSettingsKey &section, const
 
         QString key = section.originalCaseKey();
         bool keyIsLowercase = (iniUnescapedKey(data, lineStart, keyEnd, key) && sectionIsLowercase);
+#ifndef QT_BOOTSTRAPPED
+        if (qt_isInterning(QStringAtom::SettingsKeys))
+            key = QStringAtom::intern(key);
+#endif
 
         QString strValue;
         strValue.reserve(lineLen - (valueStart - lineStart));
@@ -1867,6 +2071,16 @@ bool QConfFileSettingsPrivate::writeIniFile(QIODevice &device, const ParsedSetti
 
 void QConfFileSettingsPrivate::ensureAllSectionsParsed(QConfFile *confFile) const
 {
+#ifndef QT_BOOTSTRAPPED
+    if (QSettingsBinaryFile *binaryFile = confFile->binaryFile) {
+        for (int i = 0; binaryFile->untaken() && i < binaryFile->count(); ++i) {
+            if (!readBinaryEntry(confFile, i))
+                setStatus(QSettings::FormatError);
+        }
+        return;
+    }
+#endif
+
     UnparsedSettingsMap::const_iterator i = confFile->unparsedIniSections.constBegin();
     const UnparsedSettingsMap::const_iterator end = confFile->unparsedIniSections.constEnd();
 
@@ -1880,6 +2094,25 @@ void QConfFileSettingsPrivate::ensureAllSectionsParsed(QConfFile *confFile) cons
 void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
                                                    const QSettingsKey &key) const
 {
+#ifndef QT_BOOTSTRAPPED
+    if (QSettingsBinaryFile *binaryFile = confFile->binaryFile) {
+        // a key, or a group prefix ending with a slash
+        bool ok = true;
+        if (!binaryFile->untaken()) {
+            return;
+        } else if (key.endsWith(QLatin1Char('/'))) {
+            for (int i = binaryFile->lowerBound(key);
+                 i < binaryFile->count() && binaryFile->keyStartsWith(i, key); ++i)
+                ok &= readBinaryEntry(confFile, i);
+        } else {
+            ok = readBinaryEntry(confFile, binaryFile->indexOf(key));
+        }
+        if (!ok)
+            setStatus(QSettings::FormatError);
+        return;
+    }
+#endif
+
     if (confFile->unparsedIniSections.isEmpty())
         return;
 
@@ -2389,6 +2622,9 @@ void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
                          API; on Unix, this means textual
                          configuration files in INI format.
     \value IniFormat  Store the settings in INI files.
+    \value BinaryFormat  Store the settings in an indexed binary file
+                         with the \c .qsettings extension. This value
+                         was introduced in Qt 5.5.
     \value InvalidFormat Special value returned by registerFormat().
     \omitvalue CustomFormat1
     \omitvalue CustomFormat2
@@ -2453,6 +2689,16 @@ void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
         potentially less compatible), call setIniCodec().
     \endlist
 
+    BinaryFormat is meant for applications with many settings. The keys
+    are kept sorted in an index, so that opening the file does not
+    require parsing it: values are only decoded when they are read.
+    Instead of rewriting the whole file, sync() appends the changes to
+    it, and the file is only rewritten when the appended changes have
+    grown large. Keys in BinaryFormat files are case sensitive on all
+    platforms, and values keep their QVariant type, as they are
+    stored with QDataStream. The files are not meant to be edited by
+    hand; they should only be replaced by renaming a new file over them.
+
     \sa registerFormat(), setPath()
 */
 
@@ -139,6 +139,8 @@ inline QString QSettingsGroup::toString() const
     return result;
 }
 
+class QSettingsBinaryFile;
+
 class Q_AUTOTEST_EXPORT QConfFile
 {
 public:
@@ -157,6 +159,7 @@ public:
     ParsedSettingsMap originalKeys;
     ParsedSettingsMap addedKeys;
     ParsedSettingsMap removedKeys;
+    QSettingsBinaryFile *binaryFile;
     QAtomicInt ref;
     QMutex mutex;
     bool userPerms;
@@ -292,6 +295,10 @@ private:
     void initFormat();
     void initAccess();
     void syncConfFile(int confFileNo);
+#ifndef QT_BOOTSTRAPPED
+    void syncBinaryConfFile(QConfFile *confFile);
+    void readBinaryConfFile(QConfFile *confFile);
+#endif
     bool writeIniFile(QIODevice &device, const ParsedSettingsMap &map);
 #ifdef Q_OS_MAC
     bool readPlistFile(const QString &fileName, ParsedSettingsMap *map) const;
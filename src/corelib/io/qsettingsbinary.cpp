@@ -0,0 +1,440 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsettingsbinary_p.h"
+
+#ifndef QT_NO_SETTINGS
+
+#include "qcoreapplication.h"
+#include "qdatastream.h"
+#include "qdatetime.h"
+#include "qendian.h"
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Layout of a QSettings::BinaryFormat file. All integers are stored in
+    little-endian byte order.
+
+    Header (32 bytes):
+        char magic[4]           "QSBF"
+        quint16 version         1
+        quint16 streamVersion   QDataStream version of the values
+        quint64 generation      changes whenever a new snapshot is written
+        quint32 count           number of keys
+        quint32 journalOffset   end of the snapshot
+        quint32 reserved[2]
+
+    Index (count entries of 16 bytes, sorted by key):
+        quint32 keyOffset
+        quint32 keyLength       in UTF-16 code units
+        quint32 valueOffset
+        quint32 valueSize
+
+    The index is followed by the keys in UTF-16 and the values, which are
+    QVariants streamed with QDataStream. The journal starts at
+    journalOffset; its records are aligned to 4 bytes:
+        quint32 payloadSize
+        quint8 operation        QSettingsBinaryFile::Operation
+        quint8 reserved
+        quint16 checksum        qChecksum() of the payload
+        payload:
+            quint32 keyLength
+            the key in UTF-16
+            the value, for SetValue
+
+    A record that is cut short or whose checksum does not match ends the
+    journal. It is what a writer that did not finish leaves behind, and the
+    next writer replaces the file with a new snapshot.
+*/
+
+static const char binaryMagic[4] = { 'Q', 'S', 'B', 'F' };
+
+enum {
+    BinaryVersion = 1,
+    StreamVersion = QDataStream::Qt_5_5,
+    HeaderSize = 32,
+    IndexEntrySize = 16,
+    RecordHeaderSize = 8
+};
+
+static inline quint32 readUInt32(const uchar *p)
+{
+    return qFromLittleEndian<quint32>(p);
+}
+
+static inline qint64 alignedRecordSize(qint64 payloadSize)
+{
+    return (RecordHeaderSize + payloadSize + 3) & ~Q_INT64_C(3);
+}
+
+static QString readKey(const uchar *p, int length)
+{
+    QString key(length, Qt::Uninitialized);
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    memcpy(key.data(), p, length * sizeof(ushort));
+#else
+    ushort *dest = reinterpret_cast<ushort *>(key.data());
+    for (int i = 0; i < length; ++i)
+        dest[i] = qFromLittleEndian<quint16>(p + 2 * i);
+#endif
+    return key;
+}
+
+static void writeKey(uchar *p, const QString &key)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    memcpy(p, key.constData(), key.size() * sizeof(ushort));
+#else
+    const ushort *src = key.utf16();
+    for (int i = 0; i < key.size(); ++i)
+        qToLittleEndian<quint16>(src[i], p + 2 * i);
+#endif
+}
+
+// same order as QString::operator<()
+static int compareKeys(const uchar *p, int length, const ushort *other, int otherLength)
+{
+    const int n = qMin(length, otherLength);
+    for (int i = 0; i < n; ++i) {
+        const ushort c = qFromLittleEndian<quint16>(p + 2 * i);
+        if (c != other[i])
+            return int(c) - int(other[i]);
+    }
+    return length - otherLength;
+}
+
+static bool decodeValue(const uchar *p, int size, int version, QVariant *value)
+{
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(p), size);
+    QDataStream stream(bytes);
+    stream.setVersion(version);
+    stream >> *value;
+    return stream.status() == QDataStream::Ok;
+}
+
+static quint64 newGeneration()
+{
+    static QBasicAtomicInt serial = Q_BASIC_ATOMIC_INITIALIZER(0);
+    return (quint64(QDateTime::currentMSecsSinceEpoch()) << 20)
+           ^ (quint64(QCoreApplication::applicationPid()) << 8)
+           ^ quint64(serial.fetchAndAddRelaxed(1));
+}
+
+QSettingsBinaryFile::QSettingsBinaryFile()
+    : data(0), streamVersion(StreamVersion), entryCount(0), untakenCount(0),
+      journalOffset(0), validSize(0), tornTail(false)
+{
+}
+
+QSettingsBinaryFile::~QSettingsBinaryFile()
+{
+}
+
+/*
+    Opens \a fileName and checks its snapshot. The keys and values are
+    left where they are; only the journal is decoded, into \a journal.
+    Returns \c false if the file is not a valid settings file.
+*/
+bool QSettingsBinaryFile::load(const QString &fileName, Journal *journal)
+{
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    qint64 size = file.size();
+#ifndef Q_OS_WIN
+    // on Windows, a file that is open cannot be replaced by QSaveFile
+    data = file.map(0, size);
+#endif
+    if (!data) {
+        contents = file.readAll();
+        file.close();
+        data = reinterpret_cast<const uchar *>(contents.constData());
+        size = contents.size();
+    }
+
+    if (size < HeaderSize || memcmp(data, binaryMagic, sizeof binaryMagic) != 0
+        || qFromLittleEndian<quint16>(data + 4) != BinaryVersion)
+        return false;
+
+    streamVersion = qFromLittleEndian<quint16>(data + 6);
+    const quint32 count = readUInt32(data + 16);
+    journalOffset = readUInt32(data + 20);
+    if (streamVersion > QDataStream::Qt_DefaultCompiledVersion
+        || journalOffset < HeaderSize || journalOffset > size
+        || count > quint64(journalOffset - HeaderSize) / IndexEntrySize)
+        return false;
+
+    for (quint32 i = 0; i < count; ++i) {
+        const uchar *entry = data + HeaderSize + i * IndexEntrySize;
+        const qint64 keyOffset = readUInt32(entry);
+        const qint64 keyLength = readUInt32(entry + 4);
+        const qint64 valueOffset = readUInt32(entry + 8);
+        const qint64 valueSize = readUInt32(entry + 12);
+        if (keyOffset + 2 * keyLength > journalOffset || valueOffset + valueSize > journalOffset)
+            return false;
+    }
+
+    entryCount = untakenCount = count;
+    taken.resize(count);
+    snapshot = QByteArray::fromRawData(reinterpret_cast<const char *>(data), journalOffset);
+    snapshotBuffer.setBuffer(&snapshot);
+    snapshotBuffer.open(QIODevice::ReadOnly);
+    snapshotStream.setDevice(&snapshotBuffer);
+    snapshotStream.setVersion(streamVersion);
+    validSize = journalOffset;
+    readJournal(data + journalOffset, size - journalOffset, journal);
+    return true;
+}
+
+/*
+    Reads the records that were appended to \a fileName since it was
+    loaded. Returns \c false if the file holds a different snapshot now, in
+    which case it has to be loaded again.
+*/
+bool QSettingsBinaryFile::readAppendedJournal(const QString &fileName, Journal *journal)
+{
+    if (tornTail)
+        return false;
+
+    QFile appendedFile(fileName);
+    if (!appendedFile.open(QIODevice::ReadOnly) || appendedFile.size() < validSize)
+        return false;
+
+    char header[HeaderSize];
+    if (appendedFile.read(header, HeaderSize) != HeaderSize
+        || memcmp(header, data, HeaderSize) != 0
+        || !appendedFile.seek(validSize))
+        return false;
+
+    const QByteArray appended = appendedFile.readAll();
+    readJournal(reinterpret_cast<const uchar *>(appended.constData()), appended.size(), journal);
+    return true;
+}
+
+void QSettingsBinaryFile::readJournal(const uchar *begin, qint64 size, Journal *journal)
+{
+    qint64 pos = 0;
+    while (size - pos >= RecordHeaderSize) {
+        const uchar *record = begin + pos;
+        const quint32 payloadSize = readUInt32(record);
+        const int operation = record[4];
+        if ((operation != SetValue && operation != RemoveValue) || payloadSize < 4
+            || alignedRecordSize(payloadSize) > size - pos)
+            break;
+
+        const uchar *payload = record + RecordHeaderSize;
+        if (qChecksum(reinterpret_cast<const char *>(payload), payloadSize)
+                != qFromLittleEndian<quint16>(record + 6))
+            break;
+        const quint32 keyLength = readUInt32(payload);
+        if (keyLength > (payloadSize - 4) / 2)
+            break;
+
+        JournalEntry entry;
+        entry.operation = Operation(operation);
+        entry.key = readKey(payload + 4, keyLength);
+        if (operation == SetValue
+            && !decodeValue(payload + 4 + 2 * keyLength, payloadSize - 4 - 2 * keyLength,
+                            streamVersion, &entry.value))
+            break;
+        journal->append(entry);
+        pos += alignedRecordSize(payloadSize);
+    }
+    validSize += pos;
+    tornTail = (pos != size);
+}
+
+/*
+    Returns \c true if new journal records can be appended to the file:
+    its journal must be intact, and its values streamed with the version
+    that journalRecord() uses.
+*/
+bool QSettingsBinaryFile::isAppendable() const
+{
+    return !tornTail && streamVersion == StreamVersion;
+}
+
+int QSettingsBinaryFile::compareKey(int i, const QString &key) const
+{
+    const uchar *entry = data + HeaderSize + i * IndexEntrySize;
+    return compareKeys(data + readUInt32(entry), readUInt32(entry + 4), key.utf16(), key.size());
+}
+
+int QSettingsBinaryFile::lowerBound(const QString &key) const
+{
+    int begin = 0;
+    int n = entryCount;
+    while (n > 0) {
+        const int half = n >> 1;
+        if (compareKey(begin + half, key) < 0) {
+            begin += half + 1;
+            n -= half + 1;
+        } else {
+            n = half;
+        }
+    }
+    return begin;
+}
+
+int QSettingsBinaryFile::indexOf(const QString &key) const
+{
+    const int i = lowerBound(key);
+    if (i < entryCount && compareKey(i, key) == 0)
+        return i;
+    return -1;
+}
+
+QString QSettingsBinaryFile::keyAt(int i) const
+{
+    const uchar *entry = data + HeaderSize + i * IndexEntrySize;
+    return readKey(data + readUInt32(entry), readUInt32(entry + 4));
+}
+
+bool QSettingsBinaryFile::keyStartsWith(int i, const QString &prefix) const
+{
+    const uchar *entry = data + HeaderSize + i * IndexEntrySize;
+    const int length = readUInt32(entry + 4);
+    return length >= prefix.size()
+           && compareKeys(data + readUInt32(entry), prefix.size(), prefix.utf16(), prefix.size()) == 0;
+}
+
+bool QSettingsBinaryFile::valueAt(int i, QVariant *value) const
+{
+    const uchar *entry = data + HeaderSize + i * IndexEntrySize;
+    const qint64 valueOffset = readUInt32(entry + 8);
+    snapshotBuffer.seek(valueOffset);
+    snapshotStream.resetStatus();
+    snapshotStream >> *value;
+    return snapshotStream.status() == QDataStream::Ok
+           && snapshotBuffer.pos() == valueOffset + readUInt32(entry + 12);
+}
+
+/*
+    Returns the encoded value of entry \a i without copying it. The data
+    stays valid as long as this object exists.
+*/
+QByteArray QSettingsBinaryFile::rawValueAt(int i) const
+{
+    const uchar *entry = data + HeaderSize + i * IndexEntrySize;
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(data + readUInt32(entry + 8)),
+                                   readUInt32(entry + 12));
+}
+
+QByteArray QSettingsBinaryFile::encodeValue(const QVariant &value)
+{
+    QByteArray result;
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setVersion(StreamVersion);
+    stream << value;
+    return result;
+}
+
+QByteArray QSettingsBinaryFile::journalRecord(Operation operation, const QString &key,
+                                              const QVariant &value)
+{
+    const QByteArray encoded = (operation == SetValue) ? encodeValue(value) : QByteArray();
+    const int payloadSize = 4 + 2 * key.size() + encoded.size();
+
+    QByteArray record(int(alignedRecordSize(payloadSize)), '\0');
+    uchar *p = reinterpret_cast<uchar *>(record.data());
+    uchar *payload = p + RecordHeaderSize;
+    qToLittleEndian<quint32>(payloadSize, p);
+    p[4] = uchar(operation);
+    qToLittleEndian<quint32>(key.size(), payload);
+    writeKey(payload + 4, key);
+    memcpy(payload + 4 + 2 * key.size(), encoded.constData(), encoded.size());
+    qToLittleEndian<quint16>(qChecksum(reinterpret_cast<const char *>(payload), payloadSize), p + 6);
+    return record;
+}
+
+/*
+    Writes a snapshot holding \a entries, which map the keys to values
+    encoded with encodeValue() or taken from rawValueAt(), to \a device.
+*/
+bool QSettingsBinaryFile::writeSnapshot(QIODevice *device, const QMap<QString, QByteArray> &entries)
+{
+    const quint32 count = entries.size();
+    const qint64 keysOffset = HeaderSize + qint64(count) * IndexEntrySize;
+    qint64 keysSize = 0;
+    qint64 valuesSize = 0;
+    QMap<QString, QByteArray>::const_iterator it;
+    for (it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        keysSize += 2 * it.key().size();
+        valuesSize += it.value().size();
+    }
+    const qint64 valuesOffset = keysOffset + keysSize;
+    const qint64 journalOffset = (valuesOffset + valuesSize + 3) & ~Q_INT64_C(3);
+    if (journalOffset > Q_INT64_C(0xffffffff) || keysOffset + keysSize > INT_MAX)
+        return false;
+
+    QByteArray head(int(keysOffset + keysSize), '\0');
+    uchar *p = reinterpret_cast<uchar *>(head.data());
+    memcpy(p, binaryMagic, sizeof binaryMagic);
+    qToLittleEndian<quint16>(BinaryVersion, p + 4);
+    qToLittleEndian<quint16>(StreamVersion, p + 6);
+    qToLittleEndian<quint64>(newGeneration(), p + 8);
+    qToLittleEndian<quint32>(count, p + 16);
+    qToLittleEndian<quint32>(quint32(journalOffset), p + 20);
+
+    uchar *entry = p + HeaderSize;
+    quint32 keyOffset = quint32(keysOffset);
+    quint32 valueOffset = quint32(valuesOffset);
+    for (it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        const QString &key = it.key();
+        qToLittleEndian<quint32>(keyOffset, entry);
+        qToLittleEndian<quint32>(key.size(), entry + 4);
+        qToLittleEndian<quint32>(valueOffset, entry + 8);
+        qToLittleEndian<quint32>(it.value().size(), entry + 12);
+        writeKey(p + keyOffset, key);
+        keyOffset += 2 * key.size();
+        valueOffset += it.value().size();
+        entry += IndexEntrySize;
+    }
+    if (device->write(head) != head.size())
+        return false;
+
+    for (it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        if (device->write(it.value()) != it.value().size())
+            return false;
+    }
+    const qint64 padding = journalOffset - valuesOffset - valuesSize;
+    return device->write("\0\0\0", padding) == padding;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_SETTINGS
@@ -0,0 +1,137 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSETTINGSBINARY_P_H
+#define QSETTINGSBINARY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbitarray.h>
+#include <QtCore/qbuffer.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+// A settings file in QSettings::BinaryFormat. The file starts with a
+// snapshot: a header, an index of the keys sorted by QString::operator<(),
+// the keys in UTF-16 and the values streamed with QDataStream. The snapshot
+// is mapped into memory and its values are only decoded when asked for.
+// Changes made after the snapshot was written are appended to the file as
+// checksummed journal records, which are read when the file is loaded.
+class QSettingsBinaryFile
+{
+public:
+    enum Operation {
+        SetValue = 1,
+        RemoveValue = 2
+    };
+
+    struct JournalEntry
+    {
+        Operation operation;
+        QString key;
+        QVariant value;
+    };
+    typedef QVector<JournalEntry> Journal;
+
+    QSettingsBinaryFile();
+    ~QSettingsBinaryFile();
+
+    bool load(const QString &fileName, Journal *journal);
+    bool readAppendedJournal(const QString &fileName, Journal *journal);
+
+    int count() const { return entryCount; }
+    int indexOf(const QString &key) const;
+    int lowerBound(const QString &key) const;
+    QString keyAt(int i) const;
+    bool keyStartsWith(int i, const QString &prefix) const;
+    bool valueAt(int i, QVariant *value) const;
+    QByteArray rawValueAt(int i) const;
+
+    // entries that are shadowed by the journal or already decoded by QSettings
+    bool isTaken(int i) const { return taken.testBit(i); }
+    void take(int i) { if (i >= 0 && !taken.testBit(i)) { taken.setBit(i); --untakenCount; } }
+    int untaken() const { return untakenCount; }
+
+    qint64 snapshotSize() const { return journalOffset; }
+    qint64 journalSize() const { return validSize - journalOffset; }
+    qint64 fileSize() const { return validSize; }
+    bool isAppendable() const;
+    void appended(qint64 size) { validSize += size; }
+
+    static QByteArray encodeValue(const QVariant &value);
+    static QByteArray journalRecord(Operation operation, const QString &key,
+                                    const QVariant &value = QVariant());
+    static bool writeSnapshot(QIODevice *device, const QMap<QString, QByteArray> &entries);
+
+private:
+    void readJournal(const uchar *begin, qint64 size, Journal *journal);
+    int compareKey(int i, const QString &key) const;
+
+    QFile file;
+    QByteArray contents;    // used when the file is not mapped
+    const uchar *data;
+    int streamVersion;
+    int entryCount;
+    int untakenCount;
+    qint64 journalOffset;
+    qint64 validSize;
+    bool tornTail;
+    QBitArray taken;
+
+    // reads the values of the snapshot
+    QByteArray snapshot;
+    mutable QBuffer snapshotBuffer;
+    mutable QDataStream snapshotStream;
+
+    Q_DISABLE_COPY(QSettingsBinaryFile)
+};
+
+QT_END_NAMESPACE
+
+#endif // QSETTINGSBINARY_P_H
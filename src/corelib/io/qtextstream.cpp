@@ -226,6 +226,9 @@ static const int QTEXTSTREAM_BUFFERSIZE = 16384;
 #include <locale.h>
 #endif
 #include "private/qlocale_p.h"
+#ifndef QT_NO_TEXTCODEC
+#include "private/qtextcodec_p.h"
+#endif
 
 #include <stdlib.h>
 #include <limits.h>
@@ -468,8 +471,8 @@ bool QTextStreamPrivate::fillReadBuffer(qint64 maxBytes)
 
     int oldReadBufferSize = readBuffer.size();
 #ifndef QT_NO_TEXTCODEC
-    // convert to unicode
-    readBuffer += codec->toUnicode(buf, bytesRead, &readConverterState);
+    // convert to unicode, straight into the buffer
+    qt_textCodecAppendToUnicode(codec, &readBuffer, buf, bytesRead, &readConverterState);
 #else
     readBuffer += QString::fromLatin1(QByteArray(buf, bytesRead).constData());
 #endif
@@ -760,7 +763,12 @@ inline void QTextStreamPrivate::consume(int size)
         readBufferOffset += size;
         if (readBufferOffset >= readBuffer.size()) {
             readBufferOffset = 0;
-            readBuffer.clear();
+            // keep the memory for the next fillReadBuffer(), unless
+            // something like readAll() made the buffer big
+            if (readBuffer.capacity() > 4 * QTEXTSTREAM_BUFFERSIZE)
+                readBuffer.clear();
+            else
+                readBuffer.resize(0);
             saveConverterState(device->pos());
         } else if (readBufferOffset > QTEXTSTREAM_BUFFERSIZE) {
             readBuffer = readBuffer.remove(0,readBufferOffset);
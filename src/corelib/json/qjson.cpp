@@ -33,6 +33,7 @@
 
 #include "qjson_p.h"
 #include <qalgorithms.h>
+#include <qfile.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -123,6 +124,43 @@ void Data::compact()
     compactionCounter = 0;
 }
 
+Data::~Data()
+{
+    if (ownsData)
+        free(rawData);
+    delete [] validatedBases;
+    delete mappedFile;
+}
+
+Data *Data::clone(Base *b, int reserve)
+{
+    int size = sizeof(Header) + b->size;
+    if (b == header->root() && isDetached() && alloc >= size + reserve)
+        return this;
+
+    // the copy is used without further checks, so whatever hasn't been
+    // looked at yet gets validated now
+    if (!isValidTree(b)) {
+        qWarning("QJson: Dropping invalid binary JSON data");
+        return new Data(reserve, b->is_object ? QJsonValue::Object : QJsonValue::Array);
+    }
+
+    if (reserve) {
+        if (reserve < 128)
+            reserve = 128;
+        size = qMax(size + reserve, size *2);
+    }
+    char *raw = (char *)malloc(size);
+    Q_CHECK_PTR(raw);
+    memcpy(raw + sizeof(Header), b, b->size);
+    Header *h = (Header *)raw;
+    h->tag = QJsonDocument::BinaryFormatTag;
+    h->version = 1;
+    Data *d = new Data(raw, size);
+    d->compactionCounter = (b == header->root()) ? compactionCounter : 0;
+    return d;
+}
+
 bool Data::valid() const
 {
     if (header->tag != QJsonDocument::BinaryFormatTag || header->version != 1u)
@@ -137,6 +175,61 @@ bool Data::valid() const
     return res;
 }
 
+/*
+    Only checks the header and the table of the root container. Nested
+    arrays and objects are checked by isValidBase() the first time a
+    QJsonValue refers to them.
+ */
+bool Data::validateLazily()
+{
+    if ((uint)alloc < sizeof(Header) + sizeof(Base))
+        return false;
+    if (header->tag != QJsonDocument::BinaryFormatTag || header->version != 1u)
+        return false;
+    Base *root = header->root();
+    const uint rootSize = root->size;
+    if (rootSize < sizeof(Base) || rootSize > alloc - sizeof(Header))
+        return false;
+
+    Q_ASSERT(!validatedBases);
+    validatedBases = new QAtomicInt[(alloc / sizeof(offset) + 31) / 32];
+    return isValidBase(root, root->is_object ? QJsonValue::Object : QJsonValue::Array);
+}
+
+bool Data::isValidBase(const Base *b, QJsonValue::Type type) const
+{
+    if (!validatedBases)
+        return true;
+    const uint off = offsetOf(b);
+    if (off + sizeof(Base) > uint(alloc) || b->is_object != (type == QJsonValue::Object)
+        || uint(b->size) < sizeof(Base) || uint(b->size) > alloc - off)
+        return false;
+
+    const uint idx = off / sizeof(offset);
+    const int bit = 1 << (idx & 31);
+    const bool aligned = !(off & (sizeof(offset) - 1));
+    if (aligned && (validatedBases[idx / 32].load() & bit))
+        return true;
+
+    bool res = false;
+    if (b->is_object)
+        res = static_cast<const Object *>(b)->isValid(false);
+    else
+        res = static_cast<const Array *>(b)->isValid(false);
+    if (res && aligned)
+        validatedBases[idx / 32].fetchAndOrRelaxed(bit);
+    return res;
+}
+
+bool Data::isValidTree(const Base *b) const
+{
+    if (!validatedBases)
+        return true;
+    if (b->is_object)
+        return static_cast<const Object *>(b)->isValid();
+    return static_cast<const Array *>(b)->isValid();
+}
+
 
 int Base::reserveSpace(uint dataSize, int posInTable, uint numItems, bool replace)
 {
@@ -195,7 +288,7 @@ int Object::indexOf(const QString &key, bool *exists)
     return min;
 }
 
-bool Object::isValid() const
+bool Object::isValid(bool recursive) const
 {
     if (tableOffset + length*sizeof(offset) > size)
         return false;
@@ -208,7 +301,7 @@ bool Object::isValid() const
         int s = e->size();
         if (table()[i] + s > tableOffset)
             return false;
-        if (!e->value.isValid(this))
+        if (!e->value.isValid(this, recursive))
             return false;
     }
     return true;
@@ -216,19 +309,35 @@ bool Object::isValid() const
 
 
 
-bool Array::isValid() const
+bool Array::isValid(bool recursive) const
 {
     if (tableOffset + length*sizeof(offset) > size)
         return false;
 
     for (uint i = 0; i < length; ++i) {
-        if (!at(i).isValid(this))
+        if (!at(i).isValid(this, recursive))
             return false;
     }
     return true;
 }
 
 
+#ifndef QT_BOOTSTRAPPED
+QString Entry::internedKey() const
+{
+    if (value.latinKey) {
+        const Latin1String k = shallowLatin1Key();
+        return QStringAtom::intern(QLatin1String(k.d->latin1, k.d->length));
+    }
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    const String k = shallowKey();
+    return QStringAtom::intern((const QChar *)k.d->utf16, k.d->length);
+#else
+    return QStringAtom::intern(shallowKey().toString());
+#endif
+}
+#endif
+
 bool Entry::operator ==(const QString &key) const
 {
     if (value.latinKey)
@@ -291,7 +400,7 @@ int Value::usedStorage(const Base *b) const
     return alignedSize(s);
 }
 
-bool Value::isValid(const Base *b) const
+bool Value::isValid(const Base *b, bool recursive) const
 {
     int offset = 0;
     switch (type) {
@@ -314,6 +423,10 @@ bool Value::isValid(const Base *b) const
         return true;
     if (offset + sizeof(uint) > b->tableOffset)
         return false;
+    // the size of nested arrays and objects is checked lazily against the
+    // end of the data by Data::isValidBase(), so we don't need to touch them
+    if (!recursive && (type == QJsonValue::Array || type == QJsonValue::Object))
+        return true;
 
     int s = usedStorage(b);
     if (!s)
@@ -352,6 +465,10 @@ int Value::requiredStorage(QJsonValue &v, bool *compressed)
             v.d->compact();
             v.base = static_cast<QJsonPrivate::Base *>(v.d->header->root());
         }
+        if (v.d && !v.d->isValidTree(v.base)) {
+            qWarning("QJson: Dropping invalid binary JSON data");
+            v = QJsonValue(v.t);
+        }
         return v.base ? v.base->size : sizeof(QJsonPrivate::Base);
     case QJsonValue::Undefined:
     case QJsonValue::Null:
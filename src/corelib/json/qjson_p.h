@@ -53,12 +53,17 @@
 #include <qstring.h>
 #include <qendian.h>
 #include <qnumeric.h>
+#ifndef QT_BOOTSTRAPPED
+#include <private/qstringatom_p.h>
+#endif
 
 #include <limits.h>
 #include <limits>
 
 QT_BEGIN_NAMESPACE
 
+class QFile;
+
 /*
   This defines a binary data structure for Json data. The data structure is optimised for fast reading
   and minimum allocations. The whole data structure can be mmap'ed and used directly.
@@ -537,7 +542,7 @@ public:
     }
     int indexOf(const QString &key, bool *exists);
 
-    bool isValid() const;
+    bool isValid(bool recursive = true) const;
 };
 
 
@@ -547,7 +552,7 @@ public:
     inline Value at(int i) const;
     inline Value &operator [](int i);
 
-    bool isValid() const;
+    bool isValid(bool recursive = true) const;
 };
 
 
@@ -576,7 +581,7 @@ public:
     Latin1String asLatin1String(const Base *b) const;
     Base *base(const Base *b) const;
 
-    bool isValid(const Base *b) const;
+    bool isValid(const Base *b, bool recursive = true) const;
 
     static int requiredStorage(QJsonValue &v, bool *compressed);
     static uint valueToStore(const QJsonValue &v, uint offset);
@@ -626,11 +631,18 @@ public:
     }
     QString key() const
     {
+#ifndef QT_BOOTSTRAPPED
+        if (qt_isInterning(QStringAtom::JsonObjectKeys))
+            return internedKey();
+#endif
         if (value.latinKey) {
             return shallowLatin1Key().toString();
         }
         return shallowKey().toString();
     }
+#ifndef QT_BOOTSTRAPPED
+    QString internedKey() const;
+#endif
 
     bool operator ==(const QString &key) const;
     inline bool operator !=(const QString &key) const { return !operator ==(key); }
@@ -720,13 +732,18 @@ public:
     };
     uint compactionCounter : 31;
     uint ownsData : 1;
+    // one bit per 4 byte offset, set once the array or object starting there
+    // has been checked. Only allocated for lazily validated data.
+    QAtomicInt *validatedBases;
+    // keeps the mapping alive for documents created with fromMappedFile()
+    QFile *mappedFile;
 
     inline Data(char *raw, int a)
-        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true)
+        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true), validatedBases(0), mappedFile(0)
     {
     }
     inline Data(int reserved, QJsonValue::Type valueType)
-        : rawData(0), compactionCounter(0), ownsData(true)
+        : rawData(0), compactionCounter(0), ownsData(true), validatedBases(0), mappedFile(0)
     {
         Q_ASSERT(valueType == QJsonValue::Array || valueType == QJsonValue::Object);
 
@@ -741,11 +758,13 @@ public:
         b->tableOffset = sizeof(Base);
         b->length = 0;
     }
-    inline ~Data()
-    { if (ownsData) free(rawData); }
+    ~Data();
 
     uint offsetOf(const void *ptr) const { return (uint)(((char *)ptr - rawData)); }
 
+    // data we don't own or haven't fully validated is never modified in place
+    bool isDetached() const { return ref.load() == 1 && ownsData && !validatedBases; }
+
     QJsonObject toObject(Object *o) const
     {
         return QJsonObject(const_cast<Data *>(this), o);
@@ -756,30 +775,13 @@ public:
         return QJsonArray(const_cast<Data *>(this), a);
     }
 
-    Data *clone(Base *b, int reserve = 0)
-    {
-        int size = sizeof(Header) + b->size;
-        if (b == header->root() && ref.load() == 1 && alloc >= size + reserve)
-            return this;
-
-        if (reserve) {
-            if (reserve < 128)
-                reserve = 128;
-            size = qMax(size + reserve, size *2);
-        }
-        char *raw = (char *)malloc(size);
-        Q_CHECK_PTR(raw);
-        memcpy(raw + sizeof(Header), b, b->size);
-        Header *h = (Header *)raw;
-        h->tag = QJsonDocument::BinaryFormatTag;
-        h->version = 1;
-        Data *d = new Data(raw, size);
-        d->compactionCounter = (b == header->root()) ? compactionCounter : 0;
-        return d;
-    }
+    Data *clone(Base *b, int reserve = 0);
 
     void compact();
     bool valid() const;
+    bool validateLazily();
+    bool isValidBase(const Base *b, QJsonValue::Type type) const;
+    bool isValidTree(const Base *b) const;
 
 private:
     Q_DISABLE_COPY(Data)
@@ -1126,7 +1126,7 @@ void QJsonArray::detach(uint reserve)
         d->ref.ref();
         return;
     }
-    if (reserve == 0 && d->ref.load() == 1)
+    if (reserve == 0 && d->isDetached())
         return;
 
     QJsonPrivate::Data *x = d->clone(a, reserve);
@@ -1159,7 +1159,10 @@ QDebug operator<<(QDebug dbg, const QJsonArray &a)
         return dbg;
     }
     QByteArray json;
-    QJsonPrivate::Writer::arrayToJson(a.a, json, 0, true);
+    if (!a.d->isValidTree(a.a))
+        json = "<invalid>";
+    else
+        QJsonPrivate::Writer::arrayToJson(a.a, json, 0, true);
     dbg.nospace() << "QJsonArray("
                   << json.constData() // print as utf-8 string without extra quotation marks
                   << ")";
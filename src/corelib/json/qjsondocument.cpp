@@ -38,6 +38,7 @@
 #include <qstringlist.h>
 #include <qvariant.h>
 #include <qdebug.h>
+#include <qfile.h>
 #include "qjsonwriter_p.h"
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
@@ -66,8 +67,8 @@ QT_BEGIN_NAMESPACE
     and isObject(). The array or object contained in the document can be retrieved using
     array() or object() and then read or manipulated.
 
-    A document can also be created from a stored binary representation using fromBinaryData() or
-    fromRawData().
+    A document can also be created from a stored binary representation using fromBinaryData(),
+    fromRawData() or fromMappedFile().
 
     \sa {JSON Support in Qt}, {JSON Save Game Example}
 */
@@ -149,12 +150,16 @@ QJsonDocument &QJsonDocument::operator =(const QJsonDocument &other)
 /*! \enum QJsonDocument::DataValidation
 
   This value is used to tell QJsonDocument whether to validate the binary data
-  when converting to a QJsonDocument using fromBinaryData() or fromRawData().
+  when converting to a QJsonDocument using fromBinaryData(), fromRawData() or
+  fromMappedFile().
 
   \value Validate Validate the data before using it. This is the default.
   \value BypassValidation Bypasses data validation. Only use if you received the
   data from a trusted place and know it's valid, as using of invalid data can crash
   the application.
+  \value ValidateLazily Only validate the header and the top-level array or object
+  up front. Nested arrays and objects are validated the first time they are accessed;
+  invalid ones are returned as undefined values. This value was introduced in Qt 5.5.
   */
 
 /*!
@@ -184,7 +189,8 @@ QJsonDocument QJsonDocument::fromRawData(const char *data, int size, DataValidat
     QJsonPrivate::Data *d = new QJsonPrivate::Data((char *)data, size);
     d->ownsData = false;
 
-    if (validation != BypassValidation && !d->valid()) {
+    if (validation == ValidateLazily ? !d->validateLazily()
+                                     : (validation != BypassValidation && !d->valid())) {
         delete d;
         return QJsonDocument();
     }
@@ -241,7 +247,67 @@ QJsonDocument QJsonDocument::fromBinaryData(const QByteArray &data, DataValidati
     memcpy(raw, data.constData(), size);
     QJsonPrivate::Data *d = new QJsonPrivate::Data(raw, size);
 
-    if (validation != BypassValidation && !d->valid()) {
+    if (validation == ValidateLazily ? !d->validateLazily()
+                                     : (validation != BypassValidation && !d->valid())) {
+        delete d;
+        return QJsonDocument();
+    }
+
+    return QJsonDocument(d);
+}
+
+/*!
+ \since 5.5
+
+ Creates a QJsonDocument from the binary encoded JSON document stored in
+ the file \a fileName, as written by toBinaryData(). The file is mapped
+ into memory instead of being read, so opening even large documents is
+ fast and only the parts that are accessed get paged in. The mapping
+ stays alive as long as any QJsonDocument, QJsonObject or QJsonArray
+ references the data. Modifying the document works on a copy, the file
+ is never written to.
+
+ \a validation decides how the data is checked. By default only the
+ header and the top-level container are validated when the file is
+ opened, and nested arrays and objects are validated when they are first
+ accessed. If the file cannot be opened or mapped, or the data is not
+ valid, the method returns a null document.
+
+ \sa fromBinaryData(), fromRawData(), DataValidation
+ */
+QJsonDocument QJsonDocument::fromMappedFile(const QString &fileName, DataValidation validation)
+{
+    QFile *file = new QFile(fileName);
+    if (!file->open(QIODevice::ReadOnly)) {
+        delete file;
+        return QJsonDocument();
+    }
+
+    QJsonPrivate::Header h;
+    QJsonPrivate::Base root;
+    if (file->read((char *)&h, sizeof(h)) != sizeof(h)
+        || file->read((char *)&root, sizeof(root)) != sizeof(root)
+        || h.tag != QJsonDocument::BinaryFormatTag || h.version != 1u
+        || root.size >= (uint)QJsonPrivate::Value::MaxSize
+        || sizeof(QJsonPrivate::Header) + root.size > (quint64)file->size()) {
+        delete file;
+        return QJsonDocument();
+    }
+
+    // closing the file would unmap it, so the data keeps the QFile around
+    const int size = sizeof(QJsonPrivate::Header) + root.size;
+    uchar *map = file->map(0, size);
+    if (!map) {
+        delete file;
+        return QJsonDocument();
+    }
+
+    QJsonPrivate::Data *d = new QJsonPrivate::Data((char *)map, size);
+    d->ownsData = false;
+    d->mappedFile = file;
+
+    if (validation == ValidateLazily ? !d->validateLazily()
+                                     : (validation != BypassValidation && !d->valid())) {
         delete d;
         return QJsonDocument();
     }
@@ -335,7 +401,7 @@ QByteArray QJsonDocument::toJson() const
 #ifndef QT_JSON_READONLY
 QByteArray QJsonDocument::toJson(JsonFormat format) const
 {
-    if (!d)
+    if (!d || !d->isValidTree(d->header->root()))
         return QByteArray();
 
     QByteArray json;
@@ -566,10 +632,13 @@ QDebug operator<<(QDebug dbg, const QJsonDocument &o)
         return dbg;
     }
     QByteArray json;
-    if (o.d->header->root()->isArray())
-        QJsonPrivate::Writer::arrayToJson(static_cast<QJsonPrivate::Array *>(o.d->header->root()), json, 0, true);
+    QJsonPrivate::Base *root = o.d->header->root();
+    if (!o.d->isValidTree(root))
+        json = "<invalid>";
+    else if (root->isArray())
+        QJsonPrivate::Writer::arrayToJson(static_cast<QJsonPrivate::Array *>(root), json, 0, true);
     else
-        QJsonPrivate::Writer::objectToJson(static_cast<QJsonPrivate::Object *>(o.d->header->root()), json, 0, true);
+        QJsonPrivate::Writer::objectToJson(static_cast<QJsonPrivate::Object *>(root), json, 0, true);
     dbg.nospace() << "QJsonDocument("
                   << json.constData() // print as utf-8 string without extra quotation marks
                   << ")";
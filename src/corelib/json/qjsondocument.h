@@ -89,7 +89,8 @@ public:
 
     enum DataValidation {
         Validate,
-        BypassValidation
+        BypassValidation,
+        ValidateLazily
     };
 
     static QJsonDocument fromRawData(const char *data, int size, DataValidation validation = Validate);
@@ -98,6 +99,8 @@ public:
     static QJsonDocument fromBinaryData(const QByteArray &data, DataValidation validation  = Validate);
     QByteArray toBinaryData() const;
 
+    static QJsonDocument fromMappedFile(const QString &fileName, DataValidation validation = ValidateLazily);
+
     static QJsonDocument fromVariant(const QVariant &variant);
     QVariant toVariant() const;
 
@@ -1050,7 +1050,7 @@ void QJsonObject::detach(uint reserve)
         d->ref.ref();
         return;
     }
-    if (reserve == 0 && d->ref.load() == 1)
+    if (reserve == 0 && d->isDetached())
         return;
 
     QJsonPrivate::Data *x = d->clone(o, reserve);
@@ -1116,7 +1116,10 @@ QDebug operator<<(QDebug dbg, const QJsonObject &o)
         return dbg;
     }
     QByteArray json;
-    QJsonPrivate::Writer::objectToJson(o.o, json, 0, true);
+    if (!o.d->isValidTree(o.o))
+        json = "<invalid>";
+    else
+        QJsonPrivate::Writer::objectToJson(o.o, json, 0, true);
     dbg.nospace() << "QJsonObject("
                   << json.constData() // print as utf-8 string without extra quotation marks
                   << ")";
@@ -38,7 +38,8 @@
 #include <qdebug.h>
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
-#include "private/qutfcodec_p.h"
+#include "private/qlocale_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -238,6 +239,109 @@ enum {
     Quote = 0x22
 };
 
+/*
+    Fast paths for the loops the parser spends most of its time in:
+    skipping whitespace and copying the plain ASCII characters of strings,
+    which need neither unescaping nor UTF-8 decoding. They look at 16 or 32
+    bytes at a time where the CPU supports it. Like qt_from_latin1(), they
+    use the instructions enabled at compile time: most runs are short, and
+    calling out to a function selected at runtime costs more than it saves.
+*/
+
+static inline bool isWhitespace(char c)
+{
+    return c == Space || c == Tab || c == LineFeed || c == Return;
+}
+
+static inline bool isPlainAscii(char c)
+{
+    return c != Quote && c != '\\' && uchar(c) < 0x80;
+}
+
+#ifdef __SSE2__
+// returns a bit for each byte of chunk that is whitespace
+static inline uint whitespaceMask(__m128i chunk)
+{
+#  ifdef __SSSE3__
+    // indexed by the low nibble of a byte, the table holds the whitespace
+    // character with that nibble, so only whitespace looks up to itself
+    const __m128i table = _mm_setr_epi8(Space, 0, 0, 0, 0, 0, 0, 0,
+                                        0, Tab, LineFeed, 0, 0, Return, 0, 0);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_shuffle_epi8(table, chunk), chunk));
+#  else
+    const __m128i spaces = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(Space)),
+                                        _mm_cmpeq_epi8(chunk, _mm_set1_epi8(Tab)));
+    const __m128i newlines = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(LineFeed)),
+                                          _mm_cmpeq_epi8(chunk, _mm_set1_epi8(Return)));
+    return _mm_movemask_epi8(_mm_or_si128(spaces, newlines));
+#  endif
+}
+
+// returns a bit for each byte of chunk that ends a run of plain ASCII
+static inline uint specialCharMask(__m128i chunk)
+{
+    const __m128i quotes = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(Quote));
+    const __m128i backslashes = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
+    // the sign bit is set for the bytes of UTF-8 sequences
+    return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(quotes, backslashes), chunk));
+}
+#endif
+
+static inline const char *skipWhitespace(const char *json, const char *end)
+{
+#ifdef __SSE2__
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const uint mask = ~whitespaceMask(chunk) & 0xffff;
+        if (mask)
+            return json + _bit_scan_forward(mask);
+    }
+#endif
+    while (json < end && isWhitespace(*json))
+        ++json;
+    return json;
+}
+
+// returns the end of the run of plain ASCII characters starting at json
+static inline const char *plainAsciiEnd(const char *json, const char *end)
+{
+#ifdef __AVX2__
+    for ( ; end - json >= 32; json += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(json));
+        const __m256i quotes = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(Quote));
+        const __m256i backslashes = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'));
+        const uint mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(quotes, backslashes), chunk));
+        if (mask)
+            return json + _bit_scan_forward(mask);
+    }
+#endif
+#ifdef __SSE2__
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const uint mask = specialCharMask(chunk);
+        if (mask)
+            return json + _bit_scan_forward(mask);
+    }
+#endif
+    while (json < end && isPlainAscii(*json))
+        ++json;
+    return json;
+}
+
+void qt_from_latin1(ushort *dst, const char *str, size_t size);
+
+// writes the ASCII characters as little endian UTF-16
+static void widenAscii(char *dst, const char *str, int size)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    qt_from_latin1(reinterpret_cast<ushort *>(dst), str, size);
+#else
+    QJsonPrivate::qle_ushort *out = reinterpret_cast<QJsonPrivate::qle_ushort *>(dst);
+    for (int i = 0; i < size; ++i)
+        out[i] = uchar(str[i]);
+#endif
+}
+
 void Parser::eatBOM()
 {
     // eat UTF-8 byte order mark
@@ -251,16 +355,9 @@ void Parser::eatBOM()
 
 bool Parser::eatSpace()
 {
-    while (json < end) {
-        if (*json > Space)
-            break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
-            break;
-        ++json;
-    }
+    if (json < end && *json > Space)
+        return true;
+    json = skipWhitespace(json, end);
     return (json < end);
 }
 
@@ -667,63 +764,46 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
     val->type = QJsonValue::Double;
 
     const char *start = json;
-    bool isInt = true;
-
-    // minus
-    if (json < end && *json == '-')
-        ++json;
-
-    // int = zero / ( digit1-9 *DIGIT )
-    if (json < end && *json == '0') {
-        ++json;
-    } else {
-        while (json < end && *json >= '0' && *json <= '9')
-            ++json;
-    }
-
-    // frac = decimal-point 1*DIGIT
-    if (json < end && *json == '.') {
-        isInt = false;
-        ++json;
-        while (json < end && *json >= '0' && *json <= '9')
-            ++json;
-    }
-
-    // exp = e [ minus / plus ] 1*DIGIT
-    if (json < end && (*json == 'e' || *json == 'E')) {
-        isInt = false;
-        ++json;
-        if (json < end && (*json == '-' || *json == '+'))
-            ++json;
-        while (json < end && *json >= '0' && *json <= '9')
-            ++json;
-    }
+    bool isInt = scanNumber(json, end);
 
     if (json >= end) {
         lastError = QJsonParseError::TerminationByNumber;
         return false;
     }
 
-    QByteArray number(start, json - start);
-    DEBUG << "numberstring" << number;
+    DEBUG << "numberstring" << QByteArray(start, json - start);
 
     if (isInt) {
-        bool ok;
-        int n = number.toInt(&ok);
-        if (ok && n < (1<<25) && n > -(1<<25)) {
-            val->int_value = n;
-            val->latinOrIntValue = true;
-            END;
-            return true;
+        // up to 9 digits cannot overflow, and most integers are short
+        const char *digit = start;
+        const bool negative = (*digit == '-');
+        if (negative)
+            ++digit;
+        if (digit < json && json - digit <= 9) {
+            int n = 0;
+            for ( ; digit < json; ++digit)
+                n = n * 10 + (*digit - '0');
+            if (negative)
+                n = -n;
+            if (n < (1<<25) && n > -(1<<25)) {
+                val->int_value = n;
+                val->latinOrIntValue = true;
+                END;
+                return true;
+            }
         }
     }
 
+    QVarLengthArray<char, 64> number(int(json - start) + 1);
+    memcpy(number.data(), start, json - start);
+    number[int(json - start)] = '\0';
+
     bool ok;
     union {
         quint64 ui;
         double d;
     };
-    d = number.toDouble(&ok);
+    d = QLocaleData::bytearrayToDouble(number.constData(), &ok);
 
     if (!ok) {
         lastError = QJsonParseError::IllegalNumber;
@@ -765,80 +845,6 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
 
         unescaped = %x20-21 / %x23-5B / %x5D-10FFFF
  */
-static inline bool addHexDigit(char digit, uint *result)
-{
-    *result <<= 4;
-    if (digit >= '0' && digit <= '9')
-        *result |= (digit - '0');
-    else if (digit >= 'a' && digit <= 'f')
-        *result |= (digit - 'a') + 10;
-    else if (digit >= 'A' && digit <= 'F')
-        *result |= (digit - 'A') + 10;
-    else
-        return false;
-    return true;
-}
-
-static inline bool scanEscapeSequence(const char *&json, const char *end, uint *ch)
-{
-    ++json;
-    if (json >= end)
-        return false;
-
-    DEBUG << "scan escape" << (char)*json;
-    uint escaped = *json++;
-    switch (escaped) {
-    case '"':
-        *ch = '"'; break;
-    case '\\':
-        *ch = '\\'; break;
-    case '/':
-        *ch = '/'; break;
-    case 'b':
-        *ch = 0x8; break;
-    case 'f':
-        *ch = 0xc; break;
-    case 'n':
-        *ch = 0xa; break;
-    case 'r':
-        *ch = 0xd; break;
-    case 't':
-        *ch = 0x9; break;
-    case 'u': {
-        *ch = 0;
-        if (json > end - 4)
-            return false;
-        for (int i = 0; i < 4; ++i) {
-            if (!addHexDigit(*json, ch))
-                return false;
-            ++json;
-        }
-        return true;
-    }
-    default:
-        // this is not as strict as one could be, but allows for more Json files
-        // to be parsed correctly.
-        *ch = escaped;
-        return true;
-    }
-    return true;
-}
-
-static inline bool scanUtf8Char(const char *&json, const char *end, uint *result)
-{
-    const uchar *&src = reinterpret_cast<const uchar *&>(json);
-    const uchar *uend = reinterpret_cast<const uchar *>(end);
-    uchar b = *src++;
-    int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, result, src, uend);
-    if (res < 0) {
-        // decoding error, backtrack the character we read above
-        --json;
-        return false;
-    }
-
-    return true;
-}
-
 bool Parser::parseString(bool *latin1)
 {
     *latin1 = true;
@@ -851,6 +857,18 @@ bool Parser::parseString(bool *latin1)
     int stringPos = reserveSpace(2);
     BEGIN << "parse string stringPos=" << stringPos << json;
     while (json < end) {
+        const char *run = plainAsciiEnd(json, end);
+        if (run != json) {
+            const int length = int(run - json);
+            const int pos = reserveSpace(length);
+            memcpy(data + pos, json, length);
+            json = run;
+            if (json - start >= 0x8000) {
+                *latin1 = false;
+                break;
+            }
+            continue;
+        }
         uint ch = 0;
         if (*json == '"')
             break;
@@ -899,6 +917,14 @@ bool Parser::parseString(bool *latin1)
     current = outStart + sizeof(int);
 
     while (json < end) {
+        const char *run = plainAsciiEnd(json, end);
+        if (run != json) {
+            const int length = int(run - json);
+            const int pos = reserveSpace(2 * length);
+            widenAscii(data + pos, json, length);
+            json = run;
+            continue;
+        }
         uint ch = 0;
         if (*json == '"')
             break;
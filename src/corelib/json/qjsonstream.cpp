@@ -0,0 +1,1368 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Copyright (C) 2013 Intel Corporation
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qjsonstream.h"
+#include "qjsonarray.h"
+#include "qjsonobject.h"
+#include "qjsonparser_p.h"
+#include "qjsonwriter_p.h"
+#include "qvarlengtharray.h"
+#include "private/qlocale_p.h"
+
+QT_BEGIN_NAMESPACE
+
+using namespace QJsonPrivate;
+
+// same limit as in the parser, it keeps readValue() from overflowing the stack
+static const int nestingLimit = 1024;
+
+enum {
+    ReadChunkSize = 65536,
+    WriteBufferSize = 16384
+};
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum State {
+        BetweenDocuments,   // StartDocument is next, if there is more data
+        InDocument,         // a value is next, possibly inside a container
+        DocumentDone        // the top-level value is complete, EndDocument is next
+    };
+
+    QJsonStreamReaderPrivate() : device(0) { init(); }
+    void init();
+
+    QIODevice *device;
+    QByteArray buffer;
+    int pos;
+    qint64 bufferOffset;        // offset of buffer[0] in the input
+    bool dataComplete;          // nothing will follow the data in the buffer
+    bool atEndOfInput;
+
+    State state;
+    QVarLengthArray<char, 32> containers;   // '{' or '[' per open container
+    bool afterElement;          // the innermost container has an element already
+
+    QJsonStreamReader::TokenType type;
+    QString name;
+    QString text;
+    double number;
+    bool boolean;
+
+    QJsonStreamReader::Error error;
+    QJsonParseError::ParseError parseError;
+    QString customErrorString;
+
+    bool needData;
+
+    bool fetchData(int keepFrom);
+    bool inputFinished() const;
+
+    QJsonStreamReader::TokenType scan();
+    QJsonStreamReader::TokenType scanValue(const char *json, const char *end);
+    bool scanString(const char *&json, const char *end, QString *out);
+    QJsonStreamReader::TokenType endContainer(const char *json, QJsonStreamReader::TokenType token);
+    QJsonStreamReader::TokenType commitScalar(const char *json, QJsonStreamReader::TokenType token);
+    QJsonStreamReader::TokenType requestData(QJsonParseError::ParseError reason);
+    QJsonStreamReader::TokenType raise(const char *json, QJsonParseError::ParseError error);
+};
+
+void QJsonStreamReaderPrivate::init()
+{
+    buffer.clear();
+    pos = 0;
+    bufferOffset = 0;
+    dataComplete = false;
+    atEndOfInput = false;
+    state = BetweenDocuments;
+    containers.clear();
+    afterElement = false;
+    type = QJsonStreamReader::NoToken;
+    name.clear();
+    text.clear();
+    number = 0;
+    boolean = false;
+    error = QJsonStreamReader::NoError;
+    parseError = QJsonParseError::NoError;
+    customErrorString.clear();
+    needData = false;
+}
+
+/*
+    Appends the next chunk of the device to the buffer, dropping the data
+    before \a keepFrom. Returns \c false if no data could be read.
+*/
+bool QJsonStreamReaderPrivate::fetchData(int keepFrom)
+{
+    if (!device)
+        return false;
+    if (keepFrom > 0) {
+        buffer.remove(0, keepFrom);
+        bufferOffset += keepFrom;
+        pos -= keepFrom;
+    }
+    const int oldSize = buffer.size();
+    buffer.resize(oldSize + ReadChunkSize);
+    const qint64 bytesRead = device->read(buffer.data() + oldSize, ReadChunkSize);
+    buffer.resize(oldSize + int(qMax(bytesRead, qint64(0))));
+    return bytesRead > 0;
+}
+
+bool QJsonStreamReaderPrivate::inputFinished() const
+{
+    if (device)
+        return !device->isSequential() && device->atEnd();
+    return dataComplete;
+}
+
+static inline bool isSpace(char c)
+{
+    return c == 0x20 || c == 0x09 || c == 0x0a || c == 0x0d;
+}
+
+static inline bool eatSpace(const char *&json, const char *end)
+{
+    while (json < end && isSpace(*json))
+        ++json;
+    return json < end;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::requestData(QJsonParseError::ParseError reason)
+{
+    needData = true;
+    parseError = reason;
+    return QJsonStreamReader::Invalid;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::raise(const char *json, QJsonParseError::ParseError e)
+{
+    error = QJsonStreamReader::NotWellFormedError;
+    parseError = e;
+    pos = json - buffer.constData();
+    return QJsonStreamReader::Invalid;
+}
+
+/*
+    Reads the next token starting at pos. The state is only changed once
+    a token has been read completely; if the buffer ends before, needData
+    is set and the caller retries from the same position with more data.
+*/
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::scan()
+{
+    const char *json = buffer.constData() + pos;
+    const char *end = buffer.constData() + buffer.size();
+
+    switch (state) {
+    case DocumentDone:
+        state = BetweenDocuments;
+        return QJsonStreamReader::EndDocument;
+
+    case BetweenDocuments:
+        // eat UTF-8 byte order mark
+        if (bufferOffset + pos == 0 && json < end && uchar(*json) == 0xef) {
+            if (end - json < 3)
+                return requestData(QJsonParseError::IllegalValue);
+            if (uchar(json[1]) == 0xbb && uchar(json[2]) == 0xbf)
+                json += 3;
+        }
+        if (!eatSpace(json, end))
+            return requestData(QJsonParseError::NoError);
+        pos = json - buffer.constData();
+        state = InDocument;
+        return QJsonStreamReader::StartDocument;
+
+    case InDocument:
+        break;
+    }
+
+    if (containers.isEmpty()) {
+        if (!eatSpace(json, end))
+            return requestData(QJsonParseError::IllegalValue);
+        return scanValue(json, end);
+    }
+
+    name.clear();
+    if (containers.last() == '{') {
+        if (!eatSpace(json, end))
+            return requestData(QJsonParseError::UnterminatedObject);
+        if (*json == '}')
+            return endContainer(json + 1, QJsonStreamReader::EndObject);
+        if (afterElement) {
+            if (*json != ',')
+                return raise(json, QJsonParseError::UnterminatedObject);
+            ++json;
+            if (!eatSpace(json, end))
+                return requestData(QJsonParseError::UnterminatedObject);
+            if (*json == '}')
+                return raise(json, QJsonParseError::MissingObject);
+        }
+        if (*json != '"')
+            return raise(json, QJsonParseError::UnterminatedObject);
+        ++json;
+        if (!scanString(json, end, &name))
+            return QJsonStreamReader::Invalid;
+        if (!eatSpace(json, end))
+            return requestData(QJsonParseError::UnterminatedObject);
+        if (*json != ':')
+            return raise(json, QJsonParseError::MissingNameSeparator);
+        ++json;
+        if (!eatSpace(json, end))
+            return requestData(QJsonParseError::UnterminatedObject);
+        return scanValue(json, end);
+    }
+
+    if (!eatSpace(json, end))
+        return requestData(QJsonParseError::UnterminatedArray);
+    if (*json == ']')
+        return endContainer(json + 1, QJsonStreamReader::EndArray);
+    if (afterElement) {
+        if (*json != ',')
+            return raise(json, QJsonParseError::MissingValueSeparator);
+        ++json;
+        if (!eatSpace(json, end))
+            return requestData(QJsonParseError::UnterminatedArray);
+    }
+    return scanValue(json, end);
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::endContainer(const char *json, QJsonStreamReader::TokenType token)
+{
+    pos = json - buffer.constData();
+    containers.removeLast();
+    if (containers.isEmpty())
+        state = DocumentDone;
+    afterElement = true;
+    return token;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::commitScalar(const char *json, QJsonStreamReader::TokenType token)
+{
+    pos = json - buffer.constData();
+    if (containers.isEmpty())
+        state = DocumentDone;
+    afterElement = true;
+    return token;
+}
+
+/*
+    value = false / null / true / object / array / number / string
+*/
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::scanValue(const char *json, const char *end)
+{
+    switch (*json) {
+    case '{':
+    case '[':
+        if (containers.size() >= nestingLimit)
+            return raise(json, QJsonParseError::DeepNesting);
+        containers.append(*json);
+        afterElement = false;
+        pos = json + 1 - buffer.constData();
+        return *json == '{' ? QJsonStreamReader::StartObject : QJsonStreamReader::StartArray;
+    case '"':
+        ++json;
+        if (!scanString(json, end, &text))
+            return QJsonStreamReader::Invalid;
+        return commitScalar(json, QJsonStreamReader::String);
+    case 't':
+    case 'f':
+    case 'n': {
+        static const char literals[][6] = { "true", "false", "null" };
+        const int literal = *json == 't' ? 0 : *json == 'f' ? 1 : 2;
+        const int length = literal == 1 ? 5 : 4;
+        if (end - json < length) {
+            if (inputFinished())
+                return raise(json, QJsonParseError::IllegalValue);
+            return requestData(QJsonParseError::IllegalValue);
+        }
+        if (memcmp(json, literals[literal], length) != 0)
+            return raise(json, QJsonParseError::IllegalValue);
+        boolean = literal == 0;
+        return commitScalar(json + length, literal == 2 ? QJsonStreamReader::Null : QJsonStreamReader::Bool);
+    }
+    case ']':
+        return raise(json, QJsonParseError::MissingObject);
+    default:
+        break;
+    }
+
+    const char *start = json;
+    scanNumber(json, end);
+    if (json >= end) {
+        if (!inputFinished())
+            return requestData(QJsonParseError::TerminationByNumber);
+        if (!containers.isEmpty())
+            return raise(json, QJsonParseError::TerminationByNumber);
+    }
+    if (json == start)
+        return raise(json, QJsonParseError::IllegalValue);
+
+    QVarLengthArray<char, 64> numberString(int(json - start) + 1);
+    memcpy(numberString.data(), start, json - start);
+    numberString[int(json - start)] = '\0';
+    bool ok;
+    number = QLocaleData::bytearrayToDouble(numberString.constData(), &ok);
+    if (!ok)
+        return raise(start, QJsonParseError::IllegalNumber);
+    return commitScalar(json, QJsonStreamReader::Double);
+}
+
+/*
+    Reads the string starting at \a json, which is just after the opening
+    quote, into \a out and moves \a json past the closing quote.
+*/
+bool QJsonStreamReaderPrivate::scanString(const char *&json, const char *end, QString *out)
+{
+    // make sure the whole string is in the buffer
+    const char *stringEnd = json;
+    while (stringEnd < end && *stringEnd != '"') {
+        if (*stringEnd == '\\' && ++stringEnd == end)
+            break;
+        ++stringEnd;
+    }
+    if (stringEnd >= end) {
+        if (inputFinished())
+            raise(end, QJsonParseError::UnterminatedString);
+        else
+            requestData(QJsonParseError::UnterminatedString);
+        return false;
+    }
+
+    // a string never has more UTF-16 code units than UTF-8 code units
+    out->resize(int(stringEnd - json));
+    ushort *begin = reinterpret_cast<ushort *>(out->data());
+    ushort *dst = begin;
+    while (json < stringEnd) {
+        uint ch;
+        if (uchar(*json) < 0x80 && *json != '\\') {
+            ch = uchar(*json++);
+        } else if (*json == '\\') {
+            if (!scanEscapeSequence(json, stringEnd, &ch)) {
+                raise(json, QJsonParseError::IllegalEscapeSequence);
+                return false;
+            }
+        } else if (!scanUtf8Char(json, stringEnd, &ch)) {
+            raise(json, QJsonParseError::IllegalUTF8String);
+            return false;
+        }
+        if (QChar::requiresSurrogates(ch)) {
+            *dst++ = QChar::highSurrogate(ch);
+            *dst++ = QChar::lowSurrogate(ch);
+        } else {
+            *dst++ = ushort(ch);
+        }
+    }
+    out->resize(int(dst - begin));
+    json = stringEnd + 1;
+    return true;
+}
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.5
+
+    \brief The QJsonStreamReader class provides a fast parser for reading
+    JSON text via a simple streaming API.
+
+    QJsonStreamReader is the streaming counterpart of
+    QJsonDocument::fromJson(). Instead of building a complete document
+    before the caller sees anything, it reads the JSON text incrementally
+    from a QIODevice, or from data added with addData(), and reports it as
+    a stream of tokens. Only the current token is kept in memory, so
+    files much larger than the available memory can be processed.
+
+    The basic concept is the same as with QXmlStreamReader: readNext()
+    reads the next token and returns its type(), and functions like
+    name(), text() or doubleValue() give access to the token's data.
+
+    \snippet code/src_corelib_json_qjsonstream.cpp 0
+
+    Every top-level value is enclosed in a StartDocument and an EndDocument
+    token. Unlike QJsonDocument, QJsonStreamReader accepts any value at
+    the top level, as well as any number of top-level values following
+    each other, separated by whitespace. This makes it suitable for
+    reading log files that contain one JSON object per line. Values inside
+    an object carry the name of the member in name().
+
+    Parts of the stream can be converted into a QJsonValue with
+    readValue(), and skipped with skipCurrentValue().
+
+    If the device does not provide more data yet, for example because it
+    is a network socket, readNext() returns Invalid and error() is
+    PrematureEndOfDocumentError. Reading can continue once more data is
+    available. For other errors, the offset of the error is given by
+    characterOffset(), and no more tokens are read.
+
+    Strings and numbers are parsed by the same code as in
+    QJsonDocument::fromJson(), with the same results, and the same
+    errors are reported; errorString() returns the message of the
+    corresponding QJsonParseError.
+
+    \sa QJsonStreamWriter, QJsonDocument, QXmlStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token the reader just read.
+
+    \value NoToken The reader has not yet read anything, or has reached
+    the end of the data.
+
+    \value Invalid An error has occurred, reported in error() and
+    errorString().
+
+    \value StartDocument The reader is about to read a top-level value.
+
+    \value EndDocument The reader has read a complete top-level value.
+
+    \value StartObject The reader reports the start of an object. If the
+    object is a member of another object, name() returns its name.
+
+    \value EndObject The reader reports the end of an object.
+
+    \value StartArray The reader reports the start of an array.
+
+    \value EndArray The reader reports the end of an array.
+
+    \value String The reader reports a string, available in text().
+
+    \value Double The reader reports a number, available in doubleValue().
+
+    \value Bool The reader reports \c true or \c false, available in
+    boolValue().
+
+    \value Null The reader reports \c null.
+*/
+
+/*!
+    \enum QJsonStreamReader::Error
+
+    This enum specifies different error cases.
+
+    \value NoError No error has occurred.
+
+    \value CustomError A custom error has been raised with raiseError().
+
+    \value NotWellFormedError The parser internally raised an error due
+    to the read JSON text not being well-formed. errorString() describes
+    the error.
+
+    \value PrematureEndOfDocumentError The input stream ended before a
+    well-formed value was parsed. Reading can continue once more data
+    has been added with addData() or the device has more data available.
+*/
+
+/*!
+    Constructs a stream reader.
+
+    \sa setDevice(), addData()
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Creates a new stream reader that reads from \a device.
+
+    \sa setDevice(), clear()
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Creates a new stream reader that reads from \a data.
+
+    \a data is considered complete, so that a number at the end of it
+    is not mistaken for an incomplete one.
+
+    \sa addData(), clear()
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    Q_D(QJsonStreamReader);
+    d->buffer = data;
+    d->dataComplete = true;
+}
+
+/*!
+    Destructs the reader.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the current device to \a device. Setting the device resets
+    the stream to its initial state.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamReader);
+    d->init();
+    d->device = device;
+}
+
+/*!
+    Returns the current device associated with the QJsonStreamReader,
+    or 0 if no device has been assigned.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->device;
+}
+
+/*!
+    Adds more \a data for the reader to read. This function does nothing
+    if the reader has a device().
+
+    \sa readNext(), clear()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    Q_D(QJsonStreamReader);
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    // drop what has been read already
+    if (d->pos > 0) {
+        d->buffer.remove(0, d->pos);
+        d->bufferOffset += d->pos;
+        d->pos = 0;
+    }
+    d->buffer += data;
+    d->dataComplete = false;
+    d->atEndOfInput = false;
+}
+
+/*!
+    Removes any device() or data from the reader and resets its
+    internal state to the initial state.
+
+    \sa addData()
+*/
+void QJsonStreamReader::clear()
+{
+    Q_D(QJsonStreamReader);
+    d->init();
+    d->device = 0;
+}
+
+/*!
+    Returns \c true if the reader has read until the end of the data
+    available, or if an error() has occurred and reading has been
+    aborted. Otherwise, it returns \c false.
+
+    \sa hasError(), error(), device(), QIODevice::atEnd()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->atEndOfInput || d->error != NoError;
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    With one exception, once an error() is reported by readNext(),
+    further reading of the JSON stream is not possible. Then atEnd()
+    returns \c true, hasError() returns \c true, and this function
+    returns QJsonStreamReader::Invalid.
+
+    The exception is when error() returns PrematureEndOfDocumentError.
+    This error is reported when the end of the data is reached in the
+    middle of a value. To recover from that error, add more data by
+    calling addData(), or wait for the device to have more data, and
+    call readNext() again.
+
+    \sa tokenType(), tokenString()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    Q_D(QJsonStreamReader);
+    if (d->error == NotWellFormedError || d->error == CustomError)
+        return Invalid;
+    d->error = NoError;
+    d->parseError = QJsonParseError::NoError;
+
+    for (;;) {
+        const int start = d->pos;
+        d->needData = false;
+        const TokenType type = d->scan();
+        if (!d->needData) {
+            d->type = type;
+            d->atEndOfInput = false;
+            return type;
+        }
+
+        d->pos = start;
+        if (d->fetchData(start))
+            continue;
+
+        if (d->state == QJsonStreamReaderPrivate::BetweenDocuments) {
+            d->parseError = QJsonParseError::NoError;
+            d->atEndOfInput = true;
+            d->type = NoToken;
+        } else {
+            d->error = PrematureEndOfDocumentError;
+            d->type = Invalid;
+        }
+        return d->type;
+    }
+}
+
+/*!
+    Reads the value the reader is positioned at and returns it. If the
+    current token is StartObject or StartArray, the whole object or
+    array is read and the reader is positioned at the corresponding
+    EndObject or EndArray token. If the current token is StartDocument,
+    the top-level value is read.
+
+    Returns an undefined QJsonValue if the current token does not start
+    a value or if an error occurs.
+
+    \sa value(), skipCurrentValue()
+*/
+QJsonValue QJsonStreamReader::readValue()
+{
+    switch (tokenType()) {
+    case StartDocument:
+        readNext();
+        return readValue();
+    case StartObject: {
+        QJsonObject object;
+        while (readNext() != EndObject) {
+            if (hasError())
+                return QJsonValue(QJsonValue::Undefined);
+            const QString key = name();
+            const QJsonValue member = readValue();
+            if (hasError())
+                return QJsonValue(QJsonValue::Undefined);
+            object.insert(key, member);
+        }
+        return object;
+    }
+    case StartArray: {
+        QJsonArray array;
+        while (readNext() != EndArray) {
+            if (hasError())
+                return QJsonValue(QJsonValue::Undefined);
+            const QJsonValue element = readValue();
+            if (hasError())
+                return QJsonValue(QJsonValue::Undefined);
+            array.append(element);
+        }
+        return array;
+    }
+    default:
+        return value();
+    }
+}
+
+/*!
+    Reads until the end of the current value, skipping any nested
+    values. If the current token is StartDocument, the top-level value
+    is skipped.
+
+    \sa readValue()
+*/
+void QJsonStreamReader::skipCurrentValue()
+{
+    if (isStartDocument())
+        readNext();
+    if (!isStartObject() && !isStartArray())
+        return;
+    int nesting = 1;
+    while (nesting && readNext() != Invalid) {
+        if (isStartObject() || isStartArray())
+            ++nesting;
+        else if (isEndObject() || isEndArray())
+            --nesting;
+    }
+}
+
+/*!
+    Returns the type of the current token.
+
+    The current token can also be queried with the convenience functions
+    isStartDocument(), isEndDocument(), isStartObject(), isEndObject(),
+    isStartArray(), isEndArray(), isString(), isDouble(), isBool() and
+    isNull().
+
+    \sa tokenString()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    Q_D(const QJsonStreamReader);
+    if (d->error == NotWellFormedError || d->error == CustomError)
+        return Invalid;
+    return d->type;
+}
+
+static const char QJsonStreamReader_tokenTypeString[] =
+    "NoToken\0"
+    "Invalid\0"
+    "StartDocument\0"
+    "EndDocument\0"
+    "StartObject\0"
+    "EndObject\0"
+    "StartArray\0"
+    "EndArray\0"
+    "String\0"
+    "Double\0"
+    "Bool\0"
+    "Null\0";
+
+static const short QJsonStreamReader_tokenTypeString_indices[] = {
+    0, 8, 16, 30, 42, 54, 64, 75, 84, 91, 98, 103, 0
+};
+
+/*!
+    Returns the reader's current token as string.
+
+    \sa tokenType()
+*/
+QString QJsonStreamReader::tokenString() const
+{
+    return QLatin1String(QJsonStreamReader_tokenTypeString +
+                         QJsonStreamReader_tokenTypeString_indices[tokenType()]);
+}
+
+/*!
+    Returns the number of objects and arrays the reader is currently in.
+    Inside a top-level object, the depth is 1.
+*/
+int QJsonStreamReader::depth() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->containers.size();
+}
+
+/*!
+    Returns the current character offset in the input, starting with 0.
+    The offset is counted in bytes of the UTF-8 encoded input. After an
+    error, it is the offset of the error.
+*/
+qint64 QJsonStreamReader::characterOffset() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->bufferOffset + d->pos;
+}
+
+/*!
+    Returns the name of the current value if it is a member of an object,
+    otherwise an empty string.
+*/
+QString QJsonStreamReader::name() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->name;
+}
+
+/*!
+    Returns the current string if the token is String, otherwise an
+    empty string.
+*/
+QString QJsonStreamReader::text() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == String ? d->text : QString();
+}
+
+/*!
+    Returns the current number if the token is Double, otherwise 0.
+*/
+double QJsonStreamReader::doubleValue() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Double ? d->number : 0;
+}
+
+/*!
+    Returns the current value if the token is Bool, otherwise \c false.
+*/
+bool QJsonStreamReader::boolValue() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Bool && d->boolean;
+}
+
+/*!
+    Returns the current token as a QJsonValue if it is a String, Double,
+    Bool or Null token, otherwise an undefined QJsonValue.
+
+    \sa readValue()
+*/
+QJsonValue QJsonStreamReader::value() const
+{
+    Q_D(const QJsonStreamReader);
+    switch (d->type) {
+    case String:
+        return QJsonValue(d->text);
+    case Double:
+        return QJsonValue(d->number);
+    case Bool:
+        return QJsonValue(d->boolean);
+    case Null:
+        return QJsonValue(QJsonValue::Null);
+    default:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+}
+
+/*!
+    Raises a custom error with an optional error \a message.
+
+    \sa error(), errorString()
+*/
+void QJsonStreamReader::raiseError(const QString &message)
+{
+    Q_D(QJsonStreamReader);
+    d->error = CustomError;
+    d->customErrorString = message;
+    d->type = Invalid;
+}
+
+/*!
+    Returns the error message that was set with raiseError(), or the
+    message of the QJsonParseError describing what is wrong with the
+    input.
+
+    \sa error(), characterOffset(), QJsonParseError::errorString()
+*/
+QString QJsonStreamReader::errorString() const
+{
+    Q_D(const QJsonStreamReader);
+    if (d->error == CustomError)
+        return d->customErrorString;
+    if (d->error == NoError)
+        return QString();
+    QJsonParseError parseError;
+    parseError.error = d->parseError;
+    parseError.offset = int(characterOffset());
+    return parseError.errorString();
+}
+
+/*!
+    Returns the type of the current error, or NoError if no error occurred.
+
+    \sa errorString(), raiseError()
+*/
+QJsonStreamReader::Error QJsonStreamReader::error() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->error;
+}
+
+
+class QJsonStreamWriterPrivate
+{
+public:
+    struct Level {
+        bool isObject;
+        bool hasElements;
+    };
+
+    QJsonStreamWriterPrivate()
+        : device(0), array(0), compact(false), hasError(false), documents(0)
+    { }
+
+    QIODevice *device;
+    QByteArray *array;
+    QByteArray buffer;
+    bool compact;
+    bool hasError;
+    int documents;
+    QVarLengthArray<Level, 32> levels;
+
+    inline QByteArray &out() { return array ? *array : buffer; }
+    void flush();
+    inline void flushIfNeeded() { if (device && buffer.size() >= WriteBufferSize) flush(); }
+
+    void writeIndent(int depth);
+    bool beginValue(const QString *name);
+    void endValue();
+    bool startContainer(const QString *name, bool isObject);
+    void endContainer(bool isObject);
+    void writeValue(const QString *name, const QJsonValue &value);
+};
+
+void QJsonStreamWriterPrivate::flush()
+{
+    if (!device || buffer.isEmpty())
+        return;
+    if (device->write(buffer) != buffer.size())
+        hasError = true;
+    buffer.resize(0);
+}
+
+void QJsonStreamWriterPrivate::writeIndent(int depth)
+{
+    QByteArray &json = out();
+    for (int i = 0; i < depth; ++i)
+        json.append("    ", 4);
+}
+
+/*
+    Writes what precedes a value: the separator, the indentation and, in
+    objects, the name. Returns \c false if the value cannot be written.
+*/
+bool QJsonStreamWriterPrivate::beginValue(const QString *name)
+{
+    if (levels.isEmpty()) {
+        if (name) {
+            qWarning("QJsonStreamWriter: only members of an object can have a name");
+            return false;
+        }
+        // separate top-level values, indented ones end with a newline anyway
+        if (documents && compact)
+            out() += '\n';
+        return true;
+    }
+
+    Level &level = levels.last();
+    if (level.isObject != (name != 0)) {
+        if (level.isObject)
+            qWarning("QJsonStreamWriter: the members of an object need a name");
+        else
+            qWarning("QJsonStreamWriter: only members of an object can have a name");
+        return false;
+    }
+
+    QByteArray &json = out();
+    if (level.hasElements)
+        json += compact ? "," : ",\n";
+    level.hasElements = true;
+    if (!compact)
+        writeIndent(levels.size());
+    if (name) {
+        json += '"';
+        json += Writer::escapedString(*name);
+        json += compact ? "\":" : "\": ";
+    }
+    return true;
+}
+
+void QJsonStreamWriterPrivate::endValue()
+{
+    if (levels.isEmpty()) {
+        if (!compact)
+            out() += '\n';
+        ++documents;
+    }
+    flushIfNeeded();
+}
+
+bool QJsonStreamWriterPrivate::startContainer(const QString *name, bool isObject)
+{
+    if (!beginValue(name))
+        return false;
+    out() += isObject ? (compact ? "{" : "{\n") : (compact ? "[" : "[\n");
+    const Level level = { isObject, false };
+    levels.append(level);
+    return true;
+}
+
+void QJsonStreamWriterPrivate::endContainer(bool isObject)
+{
+    if (levels.isEmpty() || levels.last().isObject != isObject) {
+        if (isObject)
+            qWarning("QJsonStreamWriter::writeEndObject: there is no object to end");
+        else
+            qWarning("QJsonStreamWriter::writeEndArray: there is no array to end");
+        return;
+    }
+    const bool hasElements = levels.last().hasElements;
+    levels.removeLast();
+    QByteArray &json = out();
+    if (hasElements && !compact)
+        json += '\n';
+    if (!compact)
+        writeIndent(levels.size());
+    json += isObject ? '}' : ']';
+    endValue();
+}
+
+void QJsonStreamWriterPrivate::writeValue(const QString *name, const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Object: {
+        if (!startContainer(name, true))
+            return;
+        const QJsonObject object = value.toObject();
+        for (QJsonObject::const_iterator it = object.begin(); it != object.end(); ++it) {
+            const QString key = it.key();
+            writeValue(&key, it.value());
+        }
+        endContainer(true);
+        return;
+    }
+    case QJsonValue::Array: {
+        if (!startContainer(name, false))
+            return;
+        const QJsonArray array = value.toArray();
+        for (QJsonArray::const_iterator it = array.begin(); it != array.end(); ++it)
+            writeValue(0, *it);
+        endContainer(false);
+        return;
+    }
+    default:
+        break;
+    }
+
+    if (!beginValue(name))
+        return;
+    QByteArray &json = out();
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        json += value.toBool() ? "true" : "false";
+        break;
+    case QJsonValue::Double:
+        Writer::doubleToJson(value.toDouble(), json);
+        break;
+    case QJsonValue::String:
+        json += '"';
+        json += Writer::escapedString(value.toString());
+        json += '"';
+        break;
+    default:
+        json += "null";
+        break;
+    }
+    endValue();
+}
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.5
+
+    \brief The QJsonStreamWriter class provides a JSON writer with a
+    simple streaming API.
+
+    QJsonStreamWriter is the counterpart to QJsonStreamReader for writing
+    JSON. Instead of building a QJsonDocument and converting it with
+    QJsonDocument::toJson(), values are written one by one to a
+    QIODevice or a QByteArray, so the whole document never needs to be
+    kept in memory.
+
+    Objects and arrays are started with writeStartObject() and
+    writeStartArray() and ended with writeEndObject() and writeEndArray().
+    Members of an object are written with the overloads that take the
+    member's name, elements of arrays and top-level values with the ones
+    that don't. Any QJsonValue, including objects and arrays, can be
+    written with writeValue().
+
+    \snippet code/src_corelib_json_qjsonstream.cpp 1
+
+    The output is the same as the one of QJsonDocument::toJson() in the
+    format() set with setFormat(), which is QJsonDocument::Indented by
+    default. Several top-level values can be written to the same stream;
+    they are separated by newlines, so that the output can be read back
+    with QJsonStreamReader.
+
+    Output to a device is buffered. The buffer is written to the device
+    whenever a top-level value is complete or the buffer is full, when
+    flush() or writeEndDocument() are called, and when the writer is
+    destroyed.
+
+    \sa QJsonStreamReader, QJsonDocument
+*/
+
+/*!
+    Constructs a stream writer.
+
+    \sa setDevice()
+*/
+QJsonStreamWriter::QJsonStreamWriter()
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+}
+
+/*!
+    Constructs a stream writer that writes into \a device.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+    Q_D(QJsonStreamWriter);
+    d->device = device;
+    d->buffer.reserve(WriteBufferSize);
+}
+
+/*!
+    Constructs a stream writer that appends to \a array.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *array)
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+    Q_D(QJsonStreamWriter);
+    d->array = array;
+}
+
+/*!
+    Destroys the writer, after writing any buffered output to the device.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+    Q_D(QJsonStreamWriter);
+    d->flush();
+}
+
+/*!
+    Sets the current device to \a device. Buffered output is written to
+    the previous device first.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamWriter);
+    if (device == d->device)
+        return;
+    d->flush();
+    d->device = device;
+    d->array = 0;
+    d->buffer.reserve(WriteBufferSize);
+}
+
+/*!
+    Returns the current device associated with the QJsonStreamWriter,
+    or 0 if no device has been assigned.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->device;
+}
+
+/*!
+    Sets the \a format of the output. Changing the format in the middle
+    of a top-level value produces inconsistent indentation.
+
+    \sa format(), QJsonDocument::toJson()
+*/
+void QJsonStreamWriter::setFormat(QJsonDocument::JsonFormat format)
+{
+    Q_D(QJsonStreamWriter);
+    d->compact = format == QJsonDocument::Compact;
+}
+
+/*!
+    Returns the format of the output. The default is
+    QJsonDocument::Indented.
+
+    \sa setFormat()
+*/
+QJsonDocument::JsonFormat QJsonStreamWriter::format() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->compact ? QJsonDocument::Compact : QJsonDocument::Indented;
+}
+
+/*!
+    Starts an object that is an element of the current array, or a
+    top-level value.
+
+    \sa writeEndObject()
+*/
+void QJsonStreamWriter::writeStartObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->startContainer(0, true);
+}
+
+/*!
+    \overload
+
+    Starts an object that is the member \a name of the current object.
+*/
+void QJsonStreamWriter::writeStartObject(const QString &name)
+{
+    Q_D(QJsonStreamWriter);
+    d->startContainer(&name, true);
+}
+
+/*!
+    Ends the current object.
+
+    \sa writeStartObject()
+*/
+void QJsonStreamWriter::writeEndObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->endContainer(true);
+}
+
+/*!
+    Starts an array that is an element of the current array, or a
+    top-level value.
+
+    \sa writeEndArray()
+*/
+void QJsonStreamWriter::writeStartArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->startContainer(0, false);
+}
+
+/*!
+    \overload
+
+    Starts an array that is the member \a name of the current object.
+*/
+void QJsonStreamWriter::writeStartArray(const QString &name)
+{
+    Q_D(QJsonStreamWriter);
+    d->startContainer(&name, false);
+}
+
+/*!
+    Ends the current array.
+
+    \sa writeStartArray()
+*/
+void QJsonStreamWriter::writeEndArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->endContainer(false);
+}
+
+/*!
+    Writes \a value as an element of the current array, or as a
+    top-level value. Undefined values are written as \c null.
+*/
+void QJsonStreamWriter::writeValue(const QJsonValue &value)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeValue(0, value);
+}
+
+/*!
+    \overload
+
+    Writes \a value as the member \a name of the current object.
+*/
+void QJsonStreamWriter::writeValue(const QString &name, const QJsonValue &value)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeValue(&name, value);
+}
+
+/*!
+    Ends all open objects and arrays and writes the buffered output to
+    the device.
+*/
+void QJsonStreamWriter::writeEndDocument()
+{
+    Q_D(QJsonStreamWriter);
+    while (!d->levels.isEmpty())
+        d->endContainer(d->levels.last().isObject);
+    d->flush();
+}
+
+/*!
+    Writes the current token of \a reader. This makes it easy to copy
+    parts of a JSON stream, or to change its format.
+
+    StartDocument, EndDocument, Invalid and NoToken are ignored.
+*/
+void QJsonStreamWriter::writeCurrentToken(const QJsonStreamReader &reader)
+{
+    Q_D(QJsonStreamWriter);
+    const bool inObject = !d->levels.isEmpty() && d->levels.last().isObject;
+    const QString name = inObject ? reader.name() : QString();
+    const QString *namePointer = inObject ? &name : 0;
+    switch (reader.tokenType()) {
+    case QJsonStreamReader::StartObject:
+        d->startContainer(namePointer, true);
+        break;
+    case QJsonStreamReader::EndObject:
+        d->endContainer(true);
+        break;
+    case QJsonStreamReader::StartArray:
+        d->startContainer(namePointer, false);
+        break;
+    case QJsonStreamReader::EndArray:
+        d->endContainer(false);
+        break;
+    case QJsonStreamReader::String:
+    case QJsonStreamReader::Double:
+    case QJsonStreamReader::Bool:
+    case QJsonStreamReader::Null:
+        d->writeValue(namePointer, reader.value());
+        break;
+    default:
+        break;
+    }
+}
+
+/*!
+    Writes the buffered output to the device.
+*/
+void QJsonStreamWriter::flush()
+{
+    Q_D(QJsonStreamWriter);
+    d->flush();
+}
+
+/*!
+    Returns \c true if writing to the device failed; otherwise returns
+    \c false.
+*/
+bool QJsonStreamWriter::hasError() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->hasError;
+}
+
+QT_END_NAMESPACE
@@ -113,6 +113,11 @@ QJsonValue::QJsonValue(QJsonPrivate::Data *data, QJsonPrivate::Base *base, const
     }
     case Array:
     case Object:
+        if (!data->isValidBase(v.base(base), t)) {
+            t = Undefined;
+            dbl = 0;
+            break;
+        }
         d = data;
         this->base = v.base(base);
         break;
@@ -35,6 +35,7 @@
 #include "qjsonwriter_p.h"
 #include "qjson_p.h"
 #include "private/qutfcodec_p.h"
+#include <qlocale.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -48,7 +49,7 @@ static inline uchar hexdig(uint u)
     return (u < 0xa ? '0' + u : 'a' + u - 0xa);
 }
 
-static QByteArray escapedString(const QString &s)
+QByteArray Writer::escapedString(const QString &s)
 {
     const uchar replacement = '?';
     QByteArray ba(s.length(), Qt::Uninitialized);
@@ -120,17 +121,12 @@ static void valueToJson(const QJsonPrivate::Base *b, const QJsonPrivate::Value &
     case QJsonValue::Bool:
         json += v.toBoolean() ? "true" : "false";
         break;
-    case QJsonValue::Double: {
-        const double d = v.toDouble(b);
-        if (qIsFinite(d)) // +2 to format to ensure the expected precision
-            json += QByteArray::number(d, 'g', std::numeric_limits<double>::digits10 + 2); // ::digits10 is 15
-        else
-            json += "null"; // +INF || -INF || NaN (see RFC4627#section2.4)
+    case QJsonValue::Double:
+        Writer::doubleToJson(v.toDouble(b), json);
         break;
-    }
     case QJsonValue::String:
         json += '"';
-        json += escapedString(v.toString(b));
+        json += Writer::escapedString(v.toString(b));
         json += '"';
         break;
     case QJsonValue::Array:
@@ -186,7 +182,7 @@ static void objectContentToJson(const QJsonPrivate::Object *o, QByteArray &json,
         QJsonPrivate::Entry *e = o->entryAt(i);
         json += indentString;
         json += '"';
-        json += escapedString(e->key());
+        json += Writer::escapedString(e->key());
         json += compact ? "\":" : "\": ";
         valueToJson(o, e->value, json, indent, compact);
 
@@ -200,6 +196,14 @@ static void objectContentToJson(const QJsonPrivate::Object *o, QByteArray &json,
     }
 }
 
+void Writer::doubleToJson(double d, QByteArray &json)
+{
+    if (qIsFinite(d)) // the shortest representation that reads back the same
+        json += QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
+    else
+        json += "null"; // +INF || -INF || NaN (see RFC4627#section2.4)
+}
+
 void Writer::objectToJson(const QJsonPrivate::Object *o, QByteArray &json, int indent, bool compact)
 {
     json.reserve(json.size() + (o ? (int)o->size : 16));
@@ -56,6 +56,7 @@
 #include <qthreadpool.h>
 #include <qthreadstorage.h>
 #include <private/qthread_p.h>
+#include <private/qmutex_p.h>
 #endif
 #include <qelapsedtimer.h>
 #include <qlibraryinfo.h>
@@ -716,6 +717,13 @@ void QCoreApplication::init()
 
     QLoggingRegistry::instance()->init();
 
+#ifndef QT_NO_THREAD
+    if (lcMutexContention().isDebugEnabled()) {
+        QMutexContentionStatistics::setEnabled(true);
+        qAddPostRoutine(QMutexContentionStatistics::report);
+    }
+#endif
+
 #ifndef QT_NO_QOBJECT
     // use the event dispatcher created by the app programmer (if any)
     if (!QCoreApplicationPrivate::eventDispatcher)
@@ -45,6 +45,7 @@
 #include <private/qcore_unix_p.h>
 
 #include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -139,6 +140,56 @@ QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
         qFatal("QEventDispatcherUNIXPrivate(): Can not continue without a thread pipe");
 
     sn_highest = -1;
+
+    // select() is limited to descriptors below FD_SETSIZE and costs O(highest fd) per
+    // wake up; processes with many sockets can pick poll() or epoll() instead
+    backend = SelectBackend;
+#ifdef QT_EVENTDISPATCHER_UNIX_POLL
+    const QByteArray requestedBackend = qgetenv("QT_EVENTDISPATCHER_UNIX_BACKEND");
+    if (requestedBackend == "poll") {
+        backend = PollBackend;
+    } else if (requestedBackend == "epoll") {
+#  ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+        backend = EpollBackend;
+#  else
+        qWarning("QEventDispatcherUNIX: epoll is not available on this platform, using poll");
+        backend = PollBackend;
+#  endif
+    } else if (!requestedBackend.isEmpty() && requestedBackend != "select") {
+        qWarning("QEventDispatcherUNIX: Unknown backend '%s', using select",
+                 requestedBackend.constData());
+    }
+#endif
+
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    epoll_fd = -1;
+    if (backend == EpollBackend) {
+#  ifdef EPOLL_CLOEXEC
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+#  else
+        epoll_fd = epoll_create(64);
+        if (epoll_fd != -1)
+            ::fcntl(epoll_fd, F_SETFD, FD_CLOEXEC);
+#  endif
+        epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u64 = 0;
+        ev.data.fd = thread_pipe[0];
+        if (epoll_fd == -1 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, thread_pipe[0], &ev) == -1) {
+            perror("QEventDispatcherUNIXPrivate(): Unable to create epoll instance, using poll");
+            if (epoll_fd != -1)
+                qt_safe_close(epoll_fd);
+            epoll_fd = -1;
+            backend = PollBackend;
+        }
+    }
+#endif
+#ifdef QT_EVENTDISPATCHER_UNIX_POLL
+    if (backend == PollBackend) {
+        pollfd wakeUpFd = { thread_pipe[0], POLLIN, 0 };
+        pollfds.append(wakeUpFd);
+    }
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
@@ -159,8 +210,16 @@ QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
         close(thread_pipe[1]);
 #endif
 
-    // cleanup timers
-    qDeleteAll(timerList);
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    if (epoll_fd != -1)
+        qt_safe_close(epoll_fd);
+#endif
+#ifdef QT_EVENTDISPATCHER_UNIX_POLL
+    for (QHash<int, QSockNotFd>::const_iterator it = sn_fds.constBegin(); it != sn_fds.constEnd(); ++it) {
+        for (int type = 0; type < 3; ++type)
+            delete it->notifiers[type];
+    }
+#endif
 }
 
 int QEventDispatcherUNIXPrivate::doSelect(QEventLoop::ProcessEventsFlags flags, timespec *timeout)
@@ -170,6 +229,11 @@ int QEventDispatcherUNIXPrivate::doSelect(QEventLoop::ProcessEventsFlags flags,
     // needed in QEventDispatcherUNIX::select()
     timerList.updateCurrentTime();
 
+#ifdef QT_EVENTDISPATCHER_UNIX_POLL
+    if (backend != SelectBackend)
+        return doPoll(flags, timeout);
+#endif
+
     int nsel;
     do {
         // Process timers and socket notifiers - the common UNIX stuff
@@ -275,32 +339,348 @@ int QEventDispatcherUNIXPrivate::processThreadWakeUp(int nsel)
     if (nsel > 0 && FD_ISSET(thread_pipe[0], &sn_vec[0].select_fds)) {
         // some other thread woke us up... consume the data on the thread pipe so that
         // select doesn't immediately return next time
+        consumeThreadWakeUp();
+        return 1;
+    }
+    return 0;
+}
+
+void QEventDispatcherUNIXPrivate::consumeThreadWakeUp()
+{
 #if defined(Q_OS_VXWORKS)
-        char c[16];
-        ::read(thread_pipe[0], c, sizeof(c));
-        ::ioctl(thread_pipe[0], FIOFLUSH, 0);
+    char c[16];
+    ::read(thread_pipe[0], c, sizeof(c));
+    ::ioctl(thread_pipe[0], FIOFLUSH, 0);
 #else
 #  ifndef QT_NO_EVENTFD
-        if (thread_pipe[1] == -1) {
-            // eventfd
-            eventfd_t value;
-            eventfd_read(thread_pipe[0], &value);
-        } else
+    if (thread_pipe[1] == -1) {
+        // eventfd
+        eventfd_t value;
+        eventfd_read(thread_pipe[0], &value);
+    } else
 #  endif
-        {
-            char c[16];
-            while (::read(thread_pipe[0], c, sizeof(c)) > 0) {
+    {
+        char c[16];
+        while (::read(thread_pipe[0], c, sizeof(c)) > 0) {
+        }
+    }
+#endif
+    if (!wakeUps.testAndSetRelease(1, 0)) {
+        // hopefully, this is dead code
+        qWarning("QEventDispatcherUNIX: internal error, wakeUps.testAndSetRelease(1, 0) failed!");
+    }
+}
+
+void QEventDispatcherUNIXPrivate::markPending(QSockNot *sn)
+{
+    // We choose a random activation order to be more fair under high load.
+    // If a constant order is used and a peer early in the list can
+    // saturate the IO, it might grab our attention completely.
+    // Also, if we're using a straight list, the callback routines may
+    // delete other entries from the list before those other entries are
+    // processed.
+    if (!sn->pending) {
+        if (sn_pending_list.isEmpty()) {
+            sn_pending_list.append(sn);
+        } else {
+            sn_pending_list.insert((qrand() & 0xff) %
+                                   (sn_pending_list.size()+1), sn);
+        }
+        sn->pending = true;
+    }
+}
+
+#ifdef QT_EVENTDISPATCHER_UNIX_POLL
+static inline int timespecToMsecs(const timespec *ts)
+{
+    if (!ts)
+        return -1;
+    // round up, waking up before the next timer is due would just spin
+    const qint64 msecs = qint64(ts->tv_sec) * 1000 + (ts->tv_nsec + 999999) / 1000000;
+    return int(qMin(msecs, qint64(INT_MAX)));
+}
+
+static inline void markSocketNotifiersPending(QEventDispatcherUNIXPrivate *d, const QSockNotFd &snFd,
+                                              bool readable, bool writable, bool exceptional)
+{
+    // same semantics as select(): errors and hang-ups make a descriptor readable and writable
+    if (readable && snFd.notifiers[0])
+        d->markPending(snFd.notifiers[0]);
+    if (writable && snFd.notifiers[1])
+        d->markPending(snFd.notifiers[1]);
+    if (exceptional && snFd.notifiers[2])
+        d->markPending(snFd.notifiers[2]);
+}
+
+static void disableInvalidSocketNotifiers(QSockNot *const *invalid, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        static const char *t[] = { "Read", "Write", "Exception" };
+        QSocketNotifier *notifier = invalid[i]->obj;
+        qWarning("QSocketNotifier: Invalid socket %d and type '%s', disabling...",
+                 invalid[i]->fd, t[notifier->type()]);
+        notifier->setEnabled(false);
+    }
+}
+
+int QEventDispatcherUNIXPrivate::doPoll(QEventLoop::ProcessEventsFlags flags, timespec *timeout)
+{
+    Q_Q(QEventDispatcherUNIX);
+
+    const bool includeNotifiers = !(flags & QEventLoop::ExcludeSocketNotifiers);
+    int msecs = timespecToMsecs(timeout);
+    int nevents = 0;
+    int nsel;
+
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    if (backend == EpollBackend && includeNotifiers) {
+        // descriptors found closed when their notifiers changed, see updatePollFd()
+        if (!epoll_invalid.isEmpty()) {
+            QVarLengthArray<QSockNot *, 4> invalid;
+            for (int i = 0; i < epoll_invalid.size(); ++i) {
+                QHash<int, QSockNotFd>::const_iterator it = sn_fds.constFind(epoll_invalid.at(i));
+                if (it == sn_fds.constEnd())
+                    continue;
+                for (int type = 0; type < 3; ++type) {
+                    if (it->notifiers[type])
+                        invalid.append(it->notifiers[type]);
+                }
             }
+            disableInvalidSocketNotifiers(invalid.constData(), invalid.size());
+            epoll_invalid.clear();
+        }
+
+        if (!epoll_always_ready.isEmpty())
+            msecs = 0;
+
+        // level-triggered, so anything that does not fit is reported on the next call
+        epoll_events.resize(qMin(sn_fds.size() + 1, 1024));
+        do {
+            nsel = epoll_wait(epoll_fd, epoll_events.data(), epoll_events.size(), msecs);
+        } while (nsel == -1 && errno == EINTR);
+        if (nsel == -1)
+            perror("epoll_wait");
+
+        for (int i = 0; i < nsel; ++i) {
+            const epoll_event &ev = epoll_events.at(i);
+            if (ev.data.fd == thread_pipe[0]) {
+                consumeThreadWakeUp();
+                ++nevents;
+                continue;
+            }
+
+            QHash<int, QSockNotFd>::const_iterator it = sn_fds.constFind(ev.data.fd);
+            if (it == sn_fds.constEnd())
+                continue;
+            markSocketNotifiersPending(this, *it,
+                                       ev.events & (EPOLLIN | EPOLLHUP | EPOLLERR),
+                                       ev.events & (EPOLLOUT | EPOLLHUP | EPOLLERR),
+                                       ev.events & EPOLLPRI);
         }
+
+        for (int i = 0; i < epoll_always_ready.size(); ++i) {
+            QHash<int, QSockNotFd>::const_iterator it = sn_fds.constFind(epoll_always_ready.at(i));
+            if (it != sn_fds.constEnd())
+                markSocketNotifiersPending(this, *it, true, true, false);
+        }
+
+        return nevents + q->activateSocketNotifiers();
+    }
 #endif
-        if (!wakeUps.testAndSetRelease(1, 0)) {
-            // hopefully, this is dead code
-            qWarning("QEventDispatcherUNIX: internal error, wakeUps.testAndSetRelease(1, 0) failed!");
+
+    // the poll() backend, or just waiting for a wake up when socket notifiers are excluded
+    pollfd wakeUpFd = { thread_pipe[0], POLLIN, 0 };
+    pollfd *fds = &wakeUpFd;
+    int nfds = 1;
+    if (backend == PollBackend) {
+        fds = pollfds.data();
+        if (includeNotifiers)
+            nfds = pollfds.size();
+    }
+
+    do {
+        nsel = ::poll(fds, nfds, msecs);
+    } while (nsel == -1 && (errno == EINTR || errno == EAGAIN));
+    if (nsel == -1) {
+        perror("poll");
+        nsel = 0;
+    }
+
+    if (nsel > 0 && (fds[0].revents & POLLIN)) {
+        consumeThreadWakeUp();
+        ++nevents;
+        --nsel;
+    }
+
+    QVarLengthArray<QSockNot *, 4> invalid;
+    for (int i = 1; i < nfds && nsel > 0; ++i) {
+        const short revents = fds[i].revents;
+        if (!revents)
+            continue;
+        --nsel;
+
+        QHash<int, QSockNotFd>::const_iterator it = sn_fds.constFind(fds[i].fd);
+        if (it == sn_fds.constEnd())
+            continue;
+        if (revents & POLLNVAL) {
+            for (int type = 0; type < 3; ++type) {
+                if (it->notifiers[type])
+                    invalid.append(it->notifiers[type]);
+            }
+            continue;
         }
-        return 1;
+        markSocketNotifiersPending(this, *it,
+                                   revents & (POLLIN | POLLHUP | POLLERR),
+                                   revents & (POLLOUT | POLLHUP | POLLERR),
+                                   revents & POLLPRI);
     }
-    return 0;
+
+    // disabling a notifier unregisters it, so this cannot be done while walking pollfds
+    disableInvalidSocketNotifiers(invalid.constData(), invalid.size());
+
+    return nevents + q->activateSocketNotifiers();
+}
+
+void QEventDispatcherUNIXPrivate::registerSocketNotifierFd(QSocketNotifier *notifier)
+{
+    const int sockfd = notifier->socket();
+    const int type = notifier->type();
+
+    QSockNotFd &snFd = sn_fds[sockfd];
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    // a new entry means a new descriptor, even if a closed one had the same number
+    if (snFd.isEmpty())
+        epoll_invalid.removeOne(sockfd);
+#endif
+    if (QSockNot *old = snFd.notifiers[type]) {
+        static const char *t[] = { "Read", "Write", "Exception" };
+        qWarning("QSocketNotifier: Multiple socket notifiers for "
+                 "same socket %d and type %s", sockfd, t[type]);
+        if (old->pending)
+            sn_pending_list.removeAll(old);
+        delete old;
+    }
+
+    QSockNot *sn = new QSockNot;
+    sn->obj = notifier;
+    sn->fd = sockfd;
+    sn->pending = false;
+    snFd.notifiers[type] = sn;
+
+    updatePollFd(sockfd, snFd);
+}
+
+void QEventDispatcherUNIXPrivate::unregisterSocketNotifierFd(QSocketNotifier *notifier)
+{
+    const int sockfd = notifier->socket();
+    QHash<int, QSockNotFd>::iterator it = sn_fds.find(sockfd);
+    if (it == sn_fds.end())
+        return;
+
+    QSockNot *&sn = it->notifiers[notifier->type()];
+    if (!sn || sn->obj != notifier) // not found
+        return;
+
+    if (sn->pending)
+        sn_pending_list.removeAll(sn);
+    delete sn;
+    sn = 0;
+
+    if (!updatePollFd(sockfd, *it)) {
+        static const char *t[] = { "Read", "Write", "Exception" };
+        qWarning("QSocketNotifier: Invalid socket %d and type '%s', disabling...",
+                 sockfd, t[notifier->type()]);
+    }
+    if (it->isEmpty()) {
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+        // the number may be reused before doPoll() gets to it
+        epoll_invalid.removeOne(sockfd);
+#endif
+        sn_fds.erase(it);
+    }
+}
+
+QSockNot *QEventDispatcherUNIXPrivate::findSocketNotifierFd(QSocketNotifier *notifier) const
+{
+    QHash<int, QSockNotFd>::const_iterator it = sn_fds.constFind(notifier->socket());
+    if (it == sn_fds.constEnd())
+        return 0;
+    QSockNot *sn = it->notifiers[notifier->type()];
+    return (sn && sn->obj == notifier) ? sn : 0;
+}
+
+// brings the kernel's interest set for fd in line with the notifiers in snFd;
+// returns false if epoll found that the descriptor has been closed
+bool QEventDispatcherUNIXPrivate::updatePollFd(int fd, QSockNotFd &snFd)
+{
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    if (backend == EpollBackend) {
+        epoll_event ev;
+        ev.events = (snFd.notifiers[0] ? uint(EPOLLIN) : 0u)
+                  | (snFd.notifiers[1] ? uint(EPOLLOUT) : 0u)
+                  | (snFd.notifiers[2] ? uint(EPOLLPRI) : 0u);
+        ev.data.u64 = 0;
+        ev.data.fd = fd;
+        if (ev.events == snFd.events || epoll_invalid.contains(fd))
+            return true;
+
+        const int op = !ev.events ? EPOLL_CTL_DEL : (snFd.events ? EPOLL_CTL_MOD : EPOLL_CTL_ADD);
+        bool valid = true;
+        if (epoll_always_ready.contains(fd)) {
+            if (!ev.events)
+                epoll_always_ready.removeOne(fd);
+        } else if (epoll_ctl(epoll_fd, op, fd, &ev) == -1) {
+            if (op == EPOLL_CTL_ADD && errno == EPERM) {
+                // regular files can't be watched by epoll, but select() and poll() report
+                // them as always ready
+                epoll_always_ready.append(fd);
+            } else if (op == EPOLL_CTL_MOD && errno == ENOENT
+                       && epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0) {
+                // the descriptor was closed and the number reused, which took it out
+                // of the interest set; select() and poll() can't tell either
+            } else if (errno == EBADF || errno == ENOENT) {
+                // closing a descriptor silently takes it out of the interest set, so
+                // this is the first we hear of a notifier that outlived its descriptor
+                valid = false;
+                ev.events = 0;
+                if (op != EPOLL_CTL_DEL)
+                    epoll_invalid.append(fd);
+            } else {
+                qErrnoWarning("QSocketNotifier: Unable to watch socket %d with epoll", fd);
+            }
+        }
+        snFd.events = ev.events;
+        return valid;
+    }
+#endif
+
+    const short events = (snFd.notifiers[0] ? POLLIN : 0)
+                       | (snFd.notifiers[1] ? POLLOUT : 0)
+                       | (snFd.notifiers[2] ? POLLPRI : 0);
+    if (snFd.pollIndex == -1) {
+        if (!events)
+            return true;
+        pollfd pfd = { fd, events, 0 };
+        snFd.pollIndex = pollfds.size();
+        pollfds.append(pfd);
+    } else if (events) {
+        pollfds[snFd.pollIndex].events = events;
+    } else {
+        // move the last entry into the freed slot
+        const int last = pollfds.size() - 1;
+        if (snFd.pollIndex != last) {
+            const pollfd moved = pollfds.at(last);
+            pollfds[snFd.pollIndex] = moved;
+            QHash<int, QSockNotFd>::iterator it = sn_fds.find(moved.fd);
+            Q_ASSERT(it != sn_fds.end());
+            it->pollIndex = snFd.pollIndex;
+        }
+        pollfds.resize(last);
+        snFd.pollIndex = -1;
+    }
+    return true;
 }
+#endif // QT_EVENTDISPATCHER_UNIX_POLL
 
 QEventDispatcherUNIX::QEventDispatcherUNIX(QObject *parent)
     : QAbstractEventDispatcher(*new QEventDispatcherUNIXPrivate, parent)
@@ -396,7 +776,6 @@ QSockNotType::QSockNotType()
 {
     FD_ZERO(&select_fds);
     FD_ZERO(&enabled_fds);
-    FD_ZERO(&pending_fds);
 }
 
 QSockNotType::~QSockNotType()
@@ -412,11 +791,13 @@ QSockNotType::~QSockNotType()
 void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
 {
     Q_ASSERT(notifier);
+    Q_D(QEventDispatcherUNIX);
     int sockfd = notifier->socket();
     int type = notifier->type();
 #ifndef QT_NO_DEBUG
     if (sockfd < 0
-        || unsigned(sockfd) >= FD_SETSIZE) {
+        || (d->backend == QEventDispatcherUNIXPrivate::SelectBackend
+            && unsigned(sockfd) >= FD_SETSIZE)) {
         qWarning("QSocketNotifier: Internal error");
         return;
     } else if (notifier->thread() != thread()
@@ -426,7 +807,13 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
     }
 #endif
 
-    Q_D(QEventDispatcherUNIX);
+#ifdef QT_EVENTDISPATCHER_UNIX_POLL
+    if (d->backend != QEventDispatcherUNIXPrivate::SelectBackend) {
+        d->registerSocketNotifierFd(notifier);
+        return;
+    }
+#endif
+
     QSockNotType::List &list = d->sn_vec[type].list;
     fd_set *fds  = &d->sn_vec[type].enabled_fds;
     QSockNot *sn;
@@ -434,7 +821,7 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
     sn = new QSockNot;
     sn->obj = notifier;
     sn->fd = sockfd;
-    sn->queue = &d->sn_vec[type].pending_fds;
+    sn->pending = false;
 
     int i;
     for (i = 0; i < list.size(); ++i) {
@@ -456,11 +843,13 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
 {
     Q_ASSERT(notifier);
+    Q_D(QEventDispatcherUNIX);
     int sockfd = notifier->socket();
     int type = notifier->type();
 #ifndef QT_NO_DEBUG
     if (sockfd < 0
-        || unsigned(sockfd) >= FD_SETSIZE) {
+        || (d->backend == QEventDispatcherUNIXPrivate::SelectBackend
+            && unsigned(sockfd) >= FD_SETSIZE)) {
         qWarning("QSocketNotifier: Internal error");
         return;
     } else if (notifier->thread() != thread()
@@ -470,7 +859,13 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
     }
 #endif
 
-    Q_D(QEventDispatcherUNIX);
+#ifdef QT_EVENTDISPATCHER_UNIX_POLL
+    if (d->backend != QEventDispatcherUNIXPrivate::SelectBackend) {
+        d->unregisterSocketNotifierFd(notifier);
+        return;
+    }
+#endif
+
     QSockNotType::List &list = d->sn_vec[type].list;
     fd_set *fds  =  &d->sn_vec[type].enabled_fds;
     QSockNot *sn = 0;
@@ -484,8 +879,8 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
         return;
 
     FD_CLR(sockfd, fds);                        // clear fd bit
-    FD_CLR(sockfd, sn->queue);
-    d->sn_pending_list.removeAll(sn);                // remove from activation list
+    if (sn->pending)
+        d->sn_pending_list.removeAll(sn);            // remove from activation list
     list.removeAt(i);                                // remove notifier found above
     delete sn;
 
@@ -502,18 +897,27 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
 void QEventDispatcherUNIX::setSocketNotifierPending(QSocketNotifier *notifier)
 {
     Q_ASSERT(notifier);
+    Q_D(QEventDispatcherUNIX);
     int sockfd = notifier->socket();
     int type = notifier->type();
 #ifndef QT_NO_DEBUG
     if (sockfd < 0
-        || unsigned(sockfd) >= FD_SETSIZE) {
+        || (d->backend == QEventDispatcherUNIXPrivate::SelectBackend
+            && unsigned(sockfd) >= FD_SETSIZE)) {
         qWarning("QSocketNotifier: Internal error");
         return;
     }
     Q_ASSERT(notifier->thread() == thread() && thread() == QThread::currentThread());
 #endif
 
-    Q_D(QEventDispatcherUNIX);
+#ifdef QT_EVENTDISPATCHER_UNIX_POLL
+    if (d->backend != QEventDispatcherUNIXPrivate::SelectBackend) {
+        if (QSockNot *sn = d->findSocketNotifierFd(notifier))
+            d->markPending(sn);
+        return;
+    }
+#endif
+
     QSockNotType::List &list = d->sn_vec[type].list;
     QSockNot *sn = 0;
     int i;
@@ -525,21 +929,7 @@ void QEventDispatcherUNIX::setSocketNotifierPending(QSocketNotifier *notifier)
     if (i == list.size()) // not found
         return;
 
-    // We choose a random activation order to be more fair under high load.
-    // If a constant order is used and a peer early in the list can
-    // saturate the IO, it might grab our attention completely.
-    // Also, if we're using a straight list, the callback routines may
-    // delete other entries from the list before those other entries are
-    // processed.
-    if (! FD_ISSET(sn->fd, sn->queue)) {
-        if (d->sn_pending_list.isEmpty()) {
-            d->sn_pending_list.append(sn);
-        } else {
-            d->sn_pending_list.insert((qrand() & 0xff) %
-                                      (d->sn_pending_list.size()+1), sn);
-        }
-        FD_SET(sn->fd, sn->queue);
-    }
+    d->markPending(sn);
 }
 
 int QEventDispatcherUNIX::activateTimers()
@@ -560,8 +950,8 @@ int QEventDispatcherUNIX::activateSocketNotifiers()
     QEvent event(QEvent::SockAct);
     while (!d->sn_pending_list.isEmpty()) {
         QSockNot *sn = d->sn_pending_list.takeFirst();
-        if (FD_ISSET(sn->fd, sn->queue)) {
-            FD_CLR(sn->fd, sn->queue);
+        if (sn->pending) {
+            sn->pending = false;
             QCoreApplication::sendEvent(sn->obj, &event);
             ++n_act;
         }
@@ -47,6 +47,8 @@
 
 #include "QtCore/qabstracteventdispatcher.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qvector.h"
 #include "private/qabstracteventdispatcher_p.h"
 #include "private/qcore_unix_p.h"
 #include "private/qpodlist_p.h"
@@ -60,15 +62,40 @@
 #  endif
 #endif
 
+#if !defined(Q_OS_VXWORKS) && !defined(Q_OS_NACL) && !defined(Q_OS_INTEGRITY) && !defined(Q_OS_BLACKBERRY)
+#  define QT_EVENTDISPATCHER_UNIX_POLL
+#  include <poll.h>
+#  if defined(Q_OS_LINUX)
+#    define QT_EVENTDISPATCHER_UNIX_EPOLL
+#    include <sys/epoll.h>
+#  endif
+#endif
+
 QT_BEGIN_NAMESPACE
 
 struct QSockNot
 {
     QSocketNotifier *obj;
     int fd;
-    fd_set *queue;
+    bool pending;
 };
 
+#ifdef QT_EVENTDISPATCHER_UNIX_POLL
+// per-descriptor state used by the poll() and epoll() backends
+struct QSockNotFd
+{
+    QSockNotFd() : pollIndex(-1), events(0)
+    { notifiers[0] = notifiers[1] = notifiers[2] = 0; }
+
+    bool isEmpty() const
+    { return !notifiers[0] && !notifiers[1] && !notifiers[2]; }
+
+    QSockNot *notifiers[3]; // read, write and exception
+    int pollIndex;          // index into pollfds, poll() backend only
+    quint32 events;         // events registered with epoll, epoll() backend only
+};
+#endif
+
 class QSockNotType
 {
 public:
@@ -80,8 +107,6 @@ public:
     List list;
     fd_set select_fds;
     fd_set enabled_fds;
-    fd_set pending_fds;
-
 };
 
 class QEventDispatcherUNIXPrivate;
@@ -139,11 +164,29 @@ public:
     QEventDispatcherUNIXPrivate();
     ~QEventDispatcherUNIXPrivate();
 
+    enum Backend {
+        SelectBackend,
+        PollBackend,
+        EpollBackend
+    };
+
     int doSelect(QEventLoop::ProcessEventsFlags flags, timespec *timeout);
     virtual int initThreadWakeUp() FINAL_EXCEPT_BLACKBERRY;
     virtual int processThreadWakeUp(int nsel) FINAL_EXCEPT_BLACKBERRY;
+    void consumeThreadWakeUp();
+
+    void markPending(QSockNot *sn);
+
+#ifdef QT_EVENTDISPATCHER_UNIX_POLL
+    int doPoll(QEventLoop::ProcessEventsFlags flags, timespec *timeout);
+    void registerSocketNotifierFd(QSocketNotifier *notifier);
+    void unregisterSocketNotifierFd(QSocketNotifier *notifier);
+    bool updatePollFd(int fd, QSockNotFd &snFd);
+    QSockNot *findSocketNotifierFd(QSocketNotifier *notifier) const;
+#endif
 
     bool mainThread;
+    Backend backend;
 
     // note for eventfd(7) support:
     // if thread_pipe[1] is -1, then eventfd(7) is in use and is stored in thread_pipe[0]
@@ -159,6 +202,21 @@ public:
     // pending socket notifiers list
     QSockNotType::List sn_pending_list;
 
+#ifdef QT_EVENTDISPATCHER_UNIX_POLL
+    // socket notifiers by descriptor, used instead of sn_vec by the poll() and epoll() backends
+    QHash<int, QSockNotFd> sn_fds;
+    // poll() backend: the thread pipe followed by one entry per descriptor in sn_fds
+    QVector<pollfd> pollfds;
+#endif
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    int epoll_fd;
+    // descriptors epoll refuses (regular files); like select(), they are always ready
+    QVector<int> epoll_always_ready;
+    // descriptors found closed while they still had notifiers, disabled by doPoll()
+    QVector<int> epoll_invalid;
+    QVarLengthArray<epoll_event, 64> epoll_events;
+#endif
+
     QAtomicInt wakeUps;
     QAtomicInt interrupt; // bool
 };
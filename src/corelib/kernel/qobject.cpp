@@ -119,7 +119,17 @@ static int *queuedConnectionTypes(const QArgumentType *argumentTypes, int argc)
     return types.take();
 }
 
-static QBasicMutex _q_ObjectMutexPool[131];
+// The mutexes can't be owned by the objects, as the mutex of an object may
+// still be locked by other threads while the object is being destroyed.
+// Every mutex gets a cache line of its own, so that threads emitting
+// signals of unrelated objects don't slow each other down.
+struct QSignalSlotMutex
+{
+    enum { CacheLineSize = 64 };
+    QBasicMutex mutex;
+    char padding[CacheLineSize - sizeof(QBasicMutex)];
+};
+static QSignalSlotMutex _q_ObjectMutexPool[257];
 
 /**
  * \internal
@@ -128,7 +138,7 @@ static QBasicMutex _q_ObjectMutexPool[131];
 static inline QMutex *signalSlotLock(const QObject *o)
 {
     return static_cast<QMutex *>(&_q_ObjectMutexPool[
-        uint(quintptr(o)) % sizeof(_q_ObjectMutexPool)/sizeof(QBasicMutex)]);
+        uint(quintptr(o)) % (sizeof(_q_ObjectMutexPool)/sizeof(QSignalSlotMutex))].mutex);
 }
 
 // ### Qt >= 5.6, remove qt_add/removeObject
@@ -270,30 +280,114 @@ static void computeOffsets(const QMetaObject *metaobject, int *signalOffset, int
     QObjectPrivate::signalIndex (not QMetaObject::indexOfSignal).
     Negative index means connections to all signals.
 
-    This vector is protected by the object mutex (signalSlotMutexes())
+    This vector is modified with the object mutex (signalSlotLock()) locked.
+    QMetaObject::activate() reads it without locking, after announcing
+    itself in inUse: connections are only unlinked from the lists, and
+    replaced arrays are only freed, while no one is using them (see
+    tryLockExclusive()). Appending to a list is safe while it is read.
 
     Each Connection is also part of a 'senders' linked list. The mutex
     of the receiver must be locked when touching the pointers of this
     linked list.
 */
-class QObjectConnectionListVector : public QVector<QObjectPrivate::ConnectionList>
+class QObjectConnectionListVector
 {
 public:
+    enum { Exclusive = -0x40000000 };
+
     bool orphaned; //the QObject owner of this vector has been destroyed while the vector was inUse
     bool dirty; //some Connection have been disconnected (their receiver is 0) but not removed from the list yet
-    int inUse; //number of functions that are currently accessing this object or its connections
+    QAtomicInt inUse; //number of functions that are currently accessing this object or its connections
     QObjectPrivate::ConnectionList allsignals;
 
     QObjectConnectionListVector()
-        : QVector<QObjectPrivate::ConnectionList>(), orphaned(false), dirty(false), inUse(0)
+        : orphaned(false), dirty(false), inUse(0), lists(0), retiredLists(0)
     { }
 
+    ~QObjectConnectionListVector()
+    {
+        delete lists.load();
+        freeRetiredLists();
+    }
+
+    int count() const
+    {
+        const Lists *l = lists.loadAcquire();
+        return l ? l->count : 0;
+    }
+
+    const QObjectPrivate::ConnectionList &at(int at) const
+    {
+        Q_ASSERT(at >= 0 && at < count());
+        return lists.loadAcquire()->lists[at];
+    }
+
     QObjectPrivate::ConnectionList &operator[](int at)
     {
         if (at < 0)
             return allsignals;
-        return QVector<QObjectPrivate::ConnectionList>::operator[](at);
+        Q_ASSERT(at < count());
+        return lists.load()->lists[at];
+    }
+
+    // grows the vector to \a size lists, it never shrinks
+    void resize(int size)
+    {
+        Lists *old = lists.load();
+        if (old && old->count >= size)
+            return;
+        Lists *l = new Lists(size);
+        for (int i = 0; old && i < old->count; ++i) {
+            l->lists[i].first.store(old->lists[i].first.load());
+            l->lists[i].last.store(old->lists[i].last.load());
+        }
+        lists.storeRelease(l);
+
+        // the old array may still be read by an emitting thread
+        if (old && tryLockExclusive()) {
+            delete old;
+            unlockExclusive();
+        } else if (old) {
+            old->retired = retiredLists;
+            retiredLists = old;
+        }
     }
+
+    bool hasRetiredLists() const { return retiredLists; }
+
+    // Must be called while being exclusive
+    void freeRetiredLists()
+    {
+        while (Lists *l = retiredLists) {
+            retiredLists = l->retired;
+            delete l;
+        }
+    }
+
+    // Returns \c true if no one is using the vector, and keeps readers out of it
+    // until unlockExclusive() is called. The object mutex must be locked.
+    bool tryLockExclusive() { return inUse.testAndSetAcquire(0, Exclusive); }
+    void unlockExclusive() { inUse.fetchAndAddRelease(-Exclusive); }
+
+private:
+    struct Lists
+    {
+        explicit Lists(int count)
+            : count(count), lists(new QObjectPrivate::ConnectionList[count]), retired(0)
+        { }
+        ~Lists() { delete [] lists; }
+
+        int count;
+        QObjectPrivate::ConnectionList *lists;
+        Lists *retired;
+    private:
+        Q_DISABLE_COPY(Lists)
+    };
+
+    QAtomicPointer<Lists> lists;
+    Lists *retiredLists; // replaced arrays that may still be in use
+
+    Q_DISABLE_COPY(QObjectConnectionListVector)
 };
 
 // Used by QAccessibleWidget
@@ -304,7 +398,7 @@ bool QObjectPrivate::isSender(const QObject *receiver, const char *signal) const
     if (signal_index < 0)
         return false;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
+    if (const QObjectConnectionListVector *connectionLists = this->connectionLists.load()) {
         if (signal_index < connectionLists->count()) {
             const QObjectPrivate::Connection *c =
                 connectionLists->at(signal_index).first;
@@ -328,7 +422,7 @@ QObjectList QObjectPrivate::receiverList(const char *signal) const
     if (signal_index < 0)
         return returnValue;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
+    if (const QObjectConnectionListVector *connectionLists = this->connectionLists.load()) {
         if (signal_index < connectionLists->count()) {
             const QObjectPrivate::Connection *c = connectionLists->at(signal_index).first;
 
@@ -367,16 +461,19 @@ void QObjectPrivate::addConnection(int signal, Connection *c)
     Q_ASSERT(c->sender == q_ptr);
     if (!connectionLists)
         connectionLists = new QObjectConnectionListVector();
+    QObjectConnectionListVector *connectionLists = this->connectionLists.load();
     if (signal >= connectionLists->count())
         connectionLists->resize(signal + 1);
 
+    // emitting threads may be walking the list, so c must be complete before it is linked
+    c->receiverThreadData.store(QObjectPrivate::get(c->receiver)->threadData);
     ConnectionList &connectionList = (*connectionLists)[signal];
-    if (connectionList.last) {
-        connectionList.last->nextConnectionList = c;
+    if (Connection *last = connectionList.last.load()) {
+        last->nextConnectionList.storeRelease(c);
     } else {
-        connectionList.first = c;
+        connectionList.first.storeRelease(c);
     }
-    connectionList.last = c;
+    connectionList.last.storeRelease(c);
 
     cleanConnectionLists();
 
@@ -395,9 +492,11 @@ void QObjectPrivate::addConnection(int signal, Connection *c)
 
 void QObjectPrivate::cleanConnectionLists()
 {
-    if (connectionLists->dirty && !connectionLists->inUse) {
+    QObjectConnectionListVector *connectionLists = this->connectionLists.load();
+    if ((connectionLists->dirty || connectionLists->hasRetiredLists())
+        && connectionLists->tryLockExclusive()) {
         // remove broken connections
-        for (int signal = -1; signal < connectionLists->count(); ++signal) {
+        for (int signal = -1; connectionLists->dirty && signal < connectionLists->count(); ++signal) {
             QObjectPrivate::ConnectionList &connectionList =
                 (*connectionLists)[signal];
 
@@ -406,16 +505,16 @@ void QObjectPrivate::cleanConnectionLists()
             // at the end of the cleanup.
             QObjectPrivate::Connection *last = 0;
 
-            QObjectPrivate::Connection **prev = &connectionList.first;
-            QObjectPrivate::Connection *c = *prev;
+            QAtomicPointer<QObjectPrivate::Connection> *prev = &connectionList.first;
+            QObjectPrivate::Connection *c = prev->load();
             while (c) {
-                if (c->receiver) {
+                if (c->receiver.load()) {
                     last = c;
                     prev = &c->nextConnectionList;
-                    c = *prev;
+                    c = prev->load();
                 } else {
-                    QObjectPrivate::Connection *next = c->nextConnectionList;
-                    *prev = next;
+                    QObjectPrivate::Connection *next = c->nextConnectionList.load();
+                    prev->store(next);
                     c->deref();
                     c = next;
                 }
@@ -423,9 +522,11 @@ void QObjectPrivate::cleanConnectionLists()
 
             // Correct the connection list's last pointer.
             // As conectionList.last could equal last, this could be a noop
-            connectionList.last = last;
+            connectionList.last.store(last);
         }
         connectionLists->dirty = false;
+        connectionLists->freeRetiredLists();
+        connectionLists->unlockExclusive();
     }
 }
 
@@ -460,11 +561,17 @@ QMetaCallEvent::~QMetaCallEvent()
 {
     if (types_) {
         for (int i = 0; i < nargs_; ++i) {
-            if (types_[i] && args_[i])
+            if (!types_[i] || !args_[i])
+                continue;
+            if (i > 0 && i <= InlineArgumentCount && args_[i] == &inlineData_[i - 1])
+                QMetaType::destruct(types_[i], args_[i]);
+            else
                 QMetaType::destroy(types_[i], args_[i]);
         }
-        free(types_);
-        free(args_);
+        if (types_ != inlineTypes_) {
+            free(types_);
+            free(args_);
+        }
     }
 #ifndef QT_NO_THREAD
     if (semaphore_)
@@ -488,6 +595,122 @@ void QMetaCallEvent::placeMetaCall(QObject *object)
     }
 }
 
+/*!
+    \internal
+
+    Copies the \a nargs - 1 arguments in \a argv, which have the types
+    listed in \a argumentTypes, into the event. Calls with few arguments
+    keep their argument lists in the event, and small arguments are
+    copied into it instead of onto the heap.
+
+    The event must have been constructed without arguments.
+ */
+void QMetaCallEvent::copyArguments(int nargs, const int *argumentTypes, void **argv)
+{
+    Q_ASSERT(!types_ && !args_);
+    if (nargs <= InlineArgumentCount + 1) {
+        types_ = inlineTypes_;
+        args_ = inlineArgs_;
+    } else {
+        types_ = (int *) malloc(nargs*sizeof(int));
+        Q_CHECK_PTR(types_);
+        args_ = (void **) malloc(nargs*sizeof(void *));
+        Q_CHECK_PTR(args_);
+    }
+    nargs_ = nargs;
+    types_[0] = 0; // return type
+    args_[0] = 0; // return value
+
+    for (int n = 1; n < nargs; ++n) {
+        const int type = argumentTypes[n-1];
+        types_[n] = type;
+        if (n <= InlineArgumentCount && QMetaType::sizeOf(type) <= int(sizeof(InlineArgument)))
+            args_[n] = QMetaType::construct(type, &inlineData_[n-1], argv[n]);
+        else
+            args_[n] = QMetaType::create(type, argv[n]);
+    }
+}
+
+/*!
+    \internal
+
+    Queued calls are allocated from memory that the receiving thread
+    recycles: events deleted by a thread are collected in its
+    QThreadData, and a thread posting to an object living there takes
+    all of them into a cache of its own when it runs out. This way,
+    emitting a queued signal in one thread and delivering it in another
+    does not need the heap once both have warmed up.
+
+    A thread keeps at most QThreadData::MaxRecycledMetaCallEvents blocks
+    for others to take; after a burst of queued calls, the blocks beyond
+    that go back to the heap.
+ */
+void *QMetaCallEvent::allocate(size_t size, QThreadData *receiverThreadData)
+{
+    // subclasses have a different size
+    QThreadData *data = size == sizeof(QMetaCallEvent) ? QThreadData::current(false) : 0;
+    if (data) {
+        QRecycledBlock *block = data->metaCallEventCache;
+        if (!block && receiverThreadData) {
+            block = receiverThreadData->recycledMetaCallEvents.fetchAndStoreAcquire(0);
+            if (block)
+                receiverThreadData->recycledMetaCallEventCount.store(0);
+        }
+        if (block) {
+            data->metaCallEventCache = block->next;
+            return block;
+        }
+    }
+    return ::operator new(size);
+}
+
+/*!
+    \internal
+ */
+void *QMetaCallEvent::operator new(size_t size)
+{
+    return allocate(size, QThreadData::current(false));
+}
+
+/*!
+    \internal
+
+    Allocates a queued call to an object living in the thread of
+    \a receiverThreadData.
+ */
+void *QMetaCallEvent::operator new(size_t size, QThreadData *receiverThreadData)
+{
+    return allocate(size, receiverThreadData);
+}
+
+/*!
+    \internal
+ */
+void QMetaCallEvent::operator delete(void *ptr, size_t size)
+{
+    QThreadData *data = size == sizeof(QMetaCallEvent) ? QThreadData::current(false) : 0;
+    // only this thread adds to the count, other threads reset it
+    if (!data || data->recycledMetaCallEventCount.load() >= QThreadData::MaxRecycledMetaCallEvents) {
+        ::operator delete(ptr);
+        return;
+    }
+    data->recycledMetaCallEventCount.ref();
+
+    QRecycledBlock *block = static_cast<QRecycledBlock *>(ptr);
+    QRecycledBlock *head = data->recycledMetaCallEvents.load();
+    do {
+        block->next = head;
+    } while (!data->recycledMetaCallEvents.testAndSetRelease(head, block, head));
+}
+
+/*!
+    \internal
+ */
+void QMetaCallEvent::operator delete(void *ptr, QThreadData *)
+{
+    operator delete(ptr, sizeof(QMetaCallEvent));
+}
+
 /*!
     \class QSignalBlocker
     \brief Exception-safe wrapper around QObject::blockSignals()
@@ -929,16 +1152,16 @@ QObject::~QObject()
         QMutexLocker locker(signalSlotMutex);
 
         // disconnect all receivers
-        if (d->connectionLists) {
-            ++d->connectionLists->inUse;
-            int connectionListsCount = d->connectionLists->count();
+        if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+            connectionLists->inUse.ref();
+            int connectionListsCount = connectionLists->count();
             for (int signal = -1; signal < connectionListsCount; ++signal) {
                 QObjectPrivate::ConnectionList &connectionList =
-                    (*d->connectionLists)[signal];
+                    (*connectionLists)[signal];
 
-                while (QObjectPrivate::Connection *c = connectionList.first) {
-                    if (!c->receiver) {
-                        connectionList.first = c->nextConnectionList;
+                while (QObjectPrivate::Connection *c = connectionList.first.load()) {
+                    if (!c->receiver.load()) {
+                        connectionList.first.store(c->nextConnectionList.load());
                         c->deref();
                         continue;
                     }
@@ -946,33 +1169,33 @@ QObject::~QObject()
                     QMutex *m = signalSlotLock(c->receiver);
                     bool needToUnlock = QOrderedMutexLocker::relock(signalSlotMutex, m);
 
-                    if (c->receiver) {
+                    if (c->receiver.load()) {
                         *c->prev = c->next;
                         if (c->next) c->next->prev = c->prev;
                     }
-                    c->receiver = 0;
+                    c->receiver.store(0);
                     if (needToUnlock)
                         m->unlock();
 
-                    connectionList.first = c->nextConnectionList;
+                    connectionList.first.store(c->nextConnectionList.load());
 
                     // The destroy operation must happen outside the lock
-                    if (c->isSlotObject) {
-                        c->isSlotObject = false;
+                    if (c->isSlotObject && c->slotObj) {
+                        QtPrivate::QSlotObjectBase *slotObj = c->slotObj;
+                        c->slotObj = 0;
                         locker.unlock();
-                        c->slotObj->destroyIfLastRef();
+                        slotObj->destroyIfLastRef();
                         locker.relock();
                     }
                     c->deref();
                 }
             }
 
-            if (!--d->connectionLists->inUse) {
-                delete d->connectionLists;
-            } else {
-                d->connectionLists->orphaned = true;
-            }
-            d->connectionLists = 0;
+            // an activate() further up the stack may still use the vector
+            connectionLists->orphaned = true;
+            if (!connectionLists->inUse.deref())
+                delete connectionLists;
+            d->connectionLists.store(0);
         }
 
         /* Disconnect all senders:
@@ -1001,15 +1224,15 @@ QObject::~QObject()
                 m->unlock();
                 continue;
             }
-            node->receiver = 0;
-            QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists;
+            node->receiver.store(0);
+            QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists.load();
             if (senderLists)
                 senderLists->dirty = true;
 
             QtPrivate::QSlotObjectBase *slotObj = Q_NULLPTR;
             if (node->isSlotObject) {
                 slotObj = node->slotObj;
-                node->isSlotObject = false;
+                node->slotObj = 0;
             }
 
             node = node->next;
@@ -1044,7 +1267,7 @@ QObjectPrivate::Connection::~Connection()
         if (v != &DIRECT_CONNECTION_ONLY)
             delete [] v;
     }
-    if (isSlotObject)
+    if (isSlotObject && slotObj)
         slotObj->destroyIfLastRef();
 }
 
@@ -1500,6 +1723,10 @@ void QObject::moveToThread(QThread *targetThread)
 
     locker.unlock();
 
+    // until now, emitting in other threads took the locked path for this object;
+    // currentData must be kept alive so that its address is not reused meanwhile
+    d_func()->setReceiverThreadData_helper(targetData);
+
     // now currentData can commit suicide if it wants to
     currentData->deref();
 }
@@ -1553,6 +1780,20 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
     }
 }
 
+void QObjectPrivate::setReceiverThreadData_helper(QThreadData *targetData)
+{
+    {
+        QMutexLocker locker(signalSlotLock(q_func()));
+        for (Connection *c = senders; c; c = c->next)
+            c->receiverThreadData.storeRelease(targetData);
+    }
+
+    for (int i = 0; i < children.size(); ++i) {
+        QObject *child = children.at(i);
+        child->d_func()->setReceiverThreadData_helper(targetData);
+    }
+}
+
 void QObjectPrivate::_q_reregisterTimers(void *pointer)
 {
     Q_Q(QObject);
@@ -2409,10 +2650,10 @@ int QObject::receivers(const char *signal) const
         }
 
         QMutexLocker locker(signalSlotLock(this));
-        if (d->connectionLists) {
-            if (signal_index < d->connectionLists->count()) {
+        if (const QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+            if (signal_index < connectionLists->count()) {
                 const QObjectPrivate::Connection *c =
-                    d->connectionLists->at(signal_index).first;
+                    connectionLists->at(signal_index).first;
                 while (c) {
                     receivers += c->receiver ? 1 : 0;
                     c = c->nextConnectionList;
@@ -2460,10 +2701,10 @@ bool QObject::isSignalConnected(const QMetaMethod &signal) const
         return d->isSignalConnected(signalIndex);
 
     QMutexLocker locker(signalSlotLock(this));
-    if (d->connectionLists) {
-        if (signalIndex < uint(d->connectionLists->count())) {
+    if (const QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        if (signalIndex < uint(connectionLists->count())) {
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signalIndex).first;
+                connectionLists->at(signalIndex).first;
             while (c) {
                 if (c->receiver)
                     return true;
@@ -3237,7 +3478,7 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
                                signalSlotLock(receiver));
 
     if (type & Qt::UniqueConnection) {
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
         if (connectionLists && connectionLists->count() > signal_index) {
             const QObjectPrivate::Connection *c2 =
                 (*connectionLists)[signal_index].first;
@@ -3262,7 +3503,7 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     c->connectionType = type;
     c->isSlotObject = false;
     c->argumentTypes.store(types);
-    c->nextConnectionList = 0;
+    c->nextConnectionList.store(0);
     c->callFunction = callFunction;
 
     QObjectPrivate::get(s)->addConnection(signal_index, c.data());
@@ -3334,12 +3575,13 @@ bool QMetaObjectPrivate::disconnectHelper(QObjectPrivate::Connection *c,
             if (needToUnlock)
                 receiverMutex->unlock();
 
-            c->receiver = 0;
+            c->receiver.store(0);
 
-            if (c->isSlotObject) {
-                c->isSlotObject = false;
+            if (c->isSlotObject && c->slotObj) {
+                QtPrivate::QSlotObjectBase *slotObj = c->slotObj;
+                c->slotObj = 0;
                 senderMutex->unlock();
-                c->slotObj->destroyIfLastRef();
+                slotObj->destroyIfLastRef();
                 senderMutex->lock();
             }
 
@@ -3370,12 +3612,12 @@ bool QMetaObjectPrivate::disconnect(const QObject *sender,
     QMutex *senderMutex = signalSlotLock(sender);
     QMutexLocker locker(senderMutex);
 
-    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
     if (!connectionLists)
         return false;
 
     // prevent incoming connections changing the connectionLists while unlocked
-    ++connectionLists->inUse;
+    connectionLists->inUse.ref();
 
     bool success = false;
     if (signal_index < 0) {
@@ -3397,9 +3639,7 @@ bool QMetaObjectPrivate::disconnect(const QObject *sender,
         }
     }
 
-    --connectionLists->inUse;
-    Q_ASSERT(connectionLists->inUse >= 0);
-    if (connectionLists->orphaned && !connectionLists->inUse)
+    if (!connectionLists->inUse.deref() && connectionLists->orphaned)
         delete connectionLists;
 
     locker.unlock();
@@ -3514,6 +3754,32 @@ void QMetaObject::connectSlotsByName(QObject *o)
     }
 }
 
+/*!
+    \internal
+
+    Calls the slot of the connection \a c, which is not a slot object, directly.
+    No mutex may be locked.
+*/
+static void callMethod(QObject *receiver, const QObjectPrivate::Connection *c, void **argv)
+{
+    const QObjectPrivate::StaticMetaCallFunction callFunction = c->callFunction;
+    const int method_relative = c->method_relative;
+    const int method = method_relative + c->method_offset;
+
+    if (qt_signal_spy_callback_set.slot_begin_callback != 0)
+        qt_signal_spy_callback_set.slot_begin_callback(receiver, method, argv);
+
+    if (callFunction && c->method_offset <= receiver->metaObject()->methodOffset()) {
+        //we compare the vtable to make sure we are not in the destructor of the object.
+        callFunction(receiver, QMetaObject::InvokeMetaMethod, method_relative, argv);
+    } else {
+        QMetaObject::metacall(receiver, QMetaObject::InvokeMetaMethod, method, argv);
+    }
+
+    if (qt_signal_spy_callback_set.slot_end_callback != 0)
+        qt_signal_spy_callback_set.slot_end_callback(receiver, method);
+}
+
 /*!
     \internal
 
@@ -3539,37 +3805,29 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     int nargs = 1; // include return type
     while (argumentTypes[nargs-1])
         ++nargs;
-    int *types = (int *) malloc(nargs*sizeof(int));
-    Q_CHECK_PTR(types);
-    void **args = (void **) malloc(nargs*sizeof(void *));
-    Q_CHECK_PTR(args);
-    types[0] = 0; // return type
-    args[0] = 0; // return value
 
-    if (nargs > 1) {
-        for (int n = 1; n < nargs; ++n)
-            types[n] = argumentTypes[n-1];
+    QThreadData *receiverThreadData = QObjectPrivate::get(c->receiver)->threadData;
+    QMetaCallEvent *ev = c->isSlotObject ?
+        new (receiverThreadData) QMetaCallEvent(c->slotObj, sender, signal) :
+        new (receiverThreadData) QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal);
 
+    if (nargs > 1) {
         locker.unlock();
-        for (int n = 1; n < nargs; ++n)
-            args[n] = QMetaType::create(types[n], argv[n]);
+        ev->copyArguments(nargs, argumentTypes, argv);
         locker.relock();
 
         if (!c->receiver) {
             locker.unlock();
             // we have been disconnected while the mutex was unlocked
-            for (int n = 1; n < nargs; ++n)
-                QMetaType::destroy(types[n], args[n]);
-            free(types);
-            free(args);
+            delete ev;
             locker.relock();
             return;
         }
+    } else {
+        // just the return value, which slots may write to
+        ev->copyArguments(nargs, argumentTypes, argv);
     }
 
-    QMetaCallEvent *ev = c->isSlotObject ?
-        new QMetaCallEvent(c->slotObj, sender, signal, nargs, types, args) :
-        new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal, nargs, types, args);
     QCoreApplication::postEvent(c->receiver, ev);
 }
 
@@ -3609,34 +3867,39 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
     }
 
     Qt::HANDLE currentThreadId = QThread::currentThreadId();
+    // not created here: a thread without data has no receivers living in it
+    QThreadData *currentThreadData = QThreadData::current(false);
 
     {
-    QMutexLocker locker(signalSlotLock(sender));
+    QMutex *signalSlotMutex = signalSlotLock(sender);
     struct ConnectionListsRef {
         QObjectConnectionListVector *connectionLists;
-        ConnectionListsRef(QObjectConnectionListVector *connectionLists) : connectionLists(connectionLists)
+        ConnectionListsRef(QObjectConnectionListVector *connectionLists, QMutex *mutex)
+            : connectionLists(connectionLists)
         {
-            if (connectionLists)
-                ++connectionLists->inUse;
+            if (!connectionLists)
+                return;
+
+            if (connectionLists->inUse.fetchAndAddAcquire(1) < 0) {
+                // the lists are being cleaned up, wait for that to finish
+                connectionLists->inUse.deref();
+                QMutexLocker locker(mutex);
+                connectionLists->inUse.ref();
+            }
         }
         ~ConnectionListsRef()
         {
             if (!connectionLists)
                 return;
 
-            --connectionLists->inUse;
-            Q_ASSERT(connectionLists->inUse >= 0);
-            if (connectionLists->orphaned) {
-                if (!connectionLists->inUse)
-                    delete connectionLists;
-            }
+            if (!connectionLists->inUse.deref() && connectionLists->orphaned)
+                delete connectionLists;
         }
 
         QObjectConnectionListVector *operator->() const { return connectionLists; }
     };
-    ConnectionListsRef connectionLists = sender->d_func()->connectionLists;
+    ConnectionListsRef connectionLists(sender->d_func()->connectionLists.load(), signalSlotMutex);
     if (!connectionLists.connectionLists) {
-        locker.unlock();
         if (qt_signal_spy_callback_set.signal_end_callback != 0)
             qt_signal_spy_callback_set.signal_end_callback(sender, signal_index);
         return;
@@ -3649,96 +3912,83 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
         list = &connectionLists->allsignals;
 
     do {
-        QObjectPrivate::Connection *c = list->first;
+        QObjectPrivate::Connection *c = list->first.loadAcquire();
         if (!c) continue;
         // We need to check against last here to ensure that signals added
         // during the signal emission are not emitted in this emission.
-        QObjectPrivate::Connection *last = list->last;
+        QObjectPrivate::Connection *last = list->last.loadAcquire();
 
         do {
-            if (!c->receiver)
+            QObject * const receiver = c->receiver.loadAcquire();
+            if (!receiver)
                 continue;
 
-            QObject * const receiver = c->receiver;
-            const bool receiverInSameThread = currentThreadId == receiver->d_func()->threadData->threadId;
+            // Receivers living in this thread can be called directly without locking:
+            // they cannot be destroyed or moved to another thread during the call,
+            // and the connection stays valid while the lists are in use.
+            if (currentThreadData && c->receiverThreadData.loadAcquire() == currentThreadData
+                && !c->isSlotObject
+                && c->connectionType != Qt::QueuedConnection
+                && c->connectionType != Qt::BlockingQueuedConnection) {
+                QConnectionSenderSwitcher sw(receiver, sender, signal_index);
+                callMethod(receiver, c, argv ? argv : empty_argv);
+            } else {
+                QMutexLocker locker(signalSlotMutex);
+                // we may have been disconnected before the mutex was locked
+                if (!c->receiver.load())
+                    continue;
 
-            // determine if this connection should be sent immediately or
-            // put into the event queue
-            if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
-                || (c->connectionType == Qt::QueuedConnection)) {
-                queued_activate(sender, signal_index, c, argv ? argv : empty_argv, locker);
-                continue;
+                const bool receiverInSameThread = currentThreadId == receiver->d_func()->threadData->threadId;
+
+                // determine if this connection should be sent immediately or
+                // put into the event queue
+                if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
+                    || (c->connectionType == Qt::QueuedConnection)) {
+                    queued_activate(sender, signal_index, c, argv ? argv : empty_argv, locker);
+                    continue;
 #ifndef QT_NO_THREAD
-            } else if (c->connectionType == Qt::BlockingQueuedConnection) {
-                locker.unlock();
-                if (receiverInSameThread) {
-                    qWarning("Qt: Dead lock detected while activating a BlockingQueuedConnection: "
-                    "Sender is %s(%p), receiver is %s(%p)",
-                    sender->metaObject()->className(), sender,
-                    receiver->metaObject()->className(), receiver);
-                }
-                QSemaphore semaphore;
-                QMetaCallEvent *ev = c->isSlotObject ?
-                    new QMetaCallEvent(c->slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
-                    new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore);
-                QCoreApplication::postEvent(receiver, ev);
-                semaphore.acquire();
-                locker.relock();
-                continue;
+                } else if (c->connectionType == Qt::BlockingQueuedConnection) {
+                    if (receiverInSameThread) {
+                        qWarning("Qt: Dead lock detected while activating a BlockingQueuedConnection: "
+                        "Sender is %s(%p), receiver is %s(%p)",
+                        sender->metaObject()->className(), sender,
+                        receiver->metaObject()->className(), receiver);
+                    }
+                    QSemaphore semaphore;
+                    QMetaCallEvent *ev = c->isSlotObject ?
+                        new QMetaCallEvent(c->slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
+                        new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore);
+                    locker.unlock();
+                    QCoreApplication::postEvent(receiver, ev);
+                    semaphore.acquire();
+                    continue;
 #endif
-            }
-
-            QConnectionSenderSwitcher sw;
-
-            if (receiverInSameThread) {
-                sw.switchSender(receiver, sender, signal_index);
-            }
-            const QObjectPrivate::StaticMetaCallFunction callFunction = c->callFunction;
-            const int method_relative = c->method_relative;
-            if (c->isSlotObject) {
-                c->slotObj->ref();
-                QScopedPointer<QtPrivate::QSlotObjectBase, QSlotObjectBaseDeleter> obj(c->slotObj);
-                locker.unlock();
-                obj->call(receiver, argv ? argv : empty_argv);
-
-                // Make sure the slot object gets destroyed before the mutex is locked again, as the
-                // destructor of the slot object might also lock a mutex from the signalSlotLock() mutex pool,
-                // and that would deadlock if the pool happens to return the same mutex.
-                obj.reset();
-
-                locker.relock();
-            } else if (callFunction && c->method_offset <= receiver->metaObject()->methodOffset()) {
-                //we compare the vtable to make sure we are not in the destructor of the object.
-                locker.unlock();
-                if (qt_signal_spy_callback_set.slot_begin_callback != 0)
-                    qt_signal_spy_callback_set.slot_begin_callback(receiver, c->method(), argv ? argv : empty_argv);
-
-                callFunction(receiver, QMetaObject::InvokeMetaMethod, method_relative, argv ? argv : empty_argv);
-
-                if (qt_signal_spy_callback_set.slot_end_callback != 0)
-                    qt_signal_spy_callback_set.slot_end_callback(receiver, c->method());
-                locker.relock();
-            } else {
-                const int method = method_relative + c->method_offset;
-                locker.unlock();
-
-                if (qt_signal_spy_callback_set.slot_begin_callback != 0) {
-                    qt_signal_spy_callback_set.slot_begin_callback(receiver,
-                                                                method,
-                                                                argv ? argv : empty_argv);
                 }
 
-                metacall(receiver, QMetaObject::InvokeMetaMethod, method, argv ? argv : empty_argv);
+                QConnectionSenderSwitcher sw;
 
-                if (qt_signal_spy_callback_set.slot_end_callback != 0)
-                    qt_signal_spy_callback_set.slot_end_callback(receiver, method);
-
-                locker.relock();
+                if (receiverInSameThread) {
+                    sw.switchSender(receiver, sender, signal_index);
+                }
+                if (c->isSlotObject) {
+                    c->slotObj->ref();
+                    QScopedPointer<QtPrivate::QSlotObjectBase, QSlotObjectBaseDeleter> obj(c->slotObj);
+                    locker.unlock();
+                    obj->call(receiver, argv ? argv : empty_argv);
+
+                    // Make sure the slot object gets destroyed before the mutex is locked again, as the
+                    // destructor of the slot object might also lock a mutex from the signalSlotLock() mutex pool,
+                    // and that would deadlock if the pool happens to return the same mutex.
+                    obj.reset();
+                } else {
+                    locker.unlock();
+                    callMethod(receiver, c, argv ? argv : empty_argv);
+                }
             }
 
             if (connectionLists->orphaned)
                 break;
-        } while (c != last && (c = c->nextConnectionList) != 0);
+        } while (c != last && (c = c->nextConnectionList.loadAcquire()) != 0);
 
         if (connectionLists->orphaned)
             break;
@@ -3992,14 +4242,14 @@ void QObject::dumpObjectInfo()
     // first, look for connections where this object is the sender
     qDebug("  SIGNALS OUT");
 
-    if (d->connectionLists) {
-        for (int signal_index = 0; signal_index < d->connectionLists->count(); ++signal_index) {
+    if (const QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        for (int signal_index = 0; signal_index < connectionLists->count(); ++signal_index) {
             const QMetaMethod signal = QMetaObjectPrivate::signal(metaObject(), signal_index);
             qDebug("        signal: %s", signal.methodSignature().constData());
 
             // receivers
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signal_index).first;
+                connectionLists->at(signal_index).first;
             while (c) {
                 if (!c->receiver) {
                     qDebug("          <Disconnected receiver>");
@@ -4011,11 +4261,12 @@ void QObject::dumpObjectInfo()
                     c = c->nextConnectionList;
                     continue;
                 }
-                const QMetaObject *receiverMetaObject = c->receiver->metaObject();
+                const QObject *receiver = c->receiver.load();
+                const QMetaObject *receiverMetaObject = receiver->metaObject();
                 const QMetaMethod method = receiverMetaObject->method(c->method());
                 qDebug("          --> %s::%s %s",
                        receiverMetaObject->className(),
-                       c->receiver->objectName().isEmpty() ? "unnamed" : qPrintable(c->receiver->objectName()),
+                       receiver->objectName().isEmpty() ? "unnamed" : qPrintable(receiver->objectName()),
                        method.methodSignature().constData());
                 c = c->nextConnectionList;
             }
@@ -4604,7 +4855,7 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
                                signalSlotLock(receiver));
 
     if (type & Qt::UniqueConnection) {
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
         if (connectionLists && connectionLists->count() > signal_index) {
             const QObjectPrivate::Connection *c2 =
                 (*connectionLists)[signal_index].first;
@@ -4661,24 +4912,28 @@ bool QObject::disconnect(const QMetaObject::Connection &connection)
     QMutex *senderMutex = signalSlotLock(c->sender);
     QMutex *receiverMutex = signalSlotLock(c->receiver);
 
+    QtPrivate::QSlotObjectBase *slotObj = Q_NULLPTR;
     {
         QOrderedMutexLocker locker(senderMutex, receiverMutex);
 
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(c->sender)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(c->sender)->connectionLists.load();
         Q_ASSERT(connectionLists);
         connectionLists->dirty = true;
 
         *c->prev = c->next;
         if (c->next)
             c->next->prev = c->prev;
-        c->receiver = 0;
+        c->receiver.store(0);
+
+        if (c->isSlotObject) {
+            slotObj = c->slotObj;
+            c->slotObj = 0;
+        }
     }
 
     // destroy the QSlotObject, if possible
-    if (c->isSlotObject) {
-        c->slotObj->destroyIfLastRef();
-        c->isSlotObject = false;
-    }
+    if (slotObj)
+        slotObj->destroyIfLastRef();
 
     const_cast<QMetaObject::Connection &>(connection).d_ptr = 0;
     c->deref(); // has been removed from the QMetaObject::Connection object
@@ -116,16 +116,22 @@ public:
     };
 
     typedef void (*StaticMetaCallFunction)(QObject *, QMetaObject::Call, int, void **);
+    // Connections are read without locking by QMetaObject::activate(), so the
+    // fields that change after the connection was added to the lists are atomic.
+    // isSlotObject never changes; a disconnected slot object has slotObj set to 0.
     struct Connection
     {
         QObject *sender;
-        QObject *receiver;
+        QAtomicPointer<QObject> receiver;
+        // the threadData of the receiver, used by activate() to detect
+        // receivers living in the emitting thread without locking
+        QAtomicPointer<QThreadData> receiverThreadData;
         union {
             StaticMetaCallFunction callFunction;
             QtPrivate::QSlotObjectBase *slotObj;
         };
         // The next pointer for the singly-linked ConnectionList
-        Connection *nextConnectionList;
+        QAtomicPointer<Connection> nextConnectionList;
         //senders linked list
         Connection *next;
         Connection **prev;
@@ -137,7 +143,7 @@ public:
         ushort connectionType : 3; // 0 == auto, 1 == direct, 2 == queued, 4 == blocking
         ushort isSlotObject : 1;
         ushort ownArgumentTypes : 1;
-        Connection() : nextConnectionList(0), ref_(2), ownArgumentTypes(true) {
+        Connection() : receiverThreadData(0), nextConnectionList(0), ref_(2), ownArgumentTypes(true) {
             //ref_ is 2 for the use in the internal lists, and for the use in QMetaObject::Connection
         }
         ~Connection();
@@ -153,8 +159,8 @@ public:
     // ConnectionList is a singly-linked list
     struct ConnectionList {
         ConnectionList() : first(0), last(0) {}
-        Connection *first;
-        Connection *last;
+        QAtomicPointer<Connection> first;
+        QAtomicPointer<Connection> last;
     };
 
     struct Sender
@@ -172,6 +178,7 @@ public:
     void setParent_helper(QObject *);
     void moveToThread_helper();
     void setThreadData_helper(QThreadData *currentData, QThreadData *targetData);
+    void setReceiverThreadData_helper(QThreadData *targetData);
     void _q_reregisterTimers(void *pointer);
 
     bool isSender(const QObject *receiver, const char *signal) const;
@@ -218,7 +225,7 @@ public:
     ExtraData *extraData;    // extra data set by the user
     QThreadData *threadData; // id of the thread that owns the object
 
-    QObjectConnectionListVector *connectionLists;
+    QAtomicPointer<QObjectConnectionListVector> connectionLists;
 
     Connection *senders;     // linked list of connections connected to this object
     Sender *currentSender;   // object currently activating the object
@@ -376,7 +383,16 @@ public:
 
     virtual void placeMetaCall(QObject *object);
 
+    void copyArguments(int nargs, const int *argumentTypes, void **argv);
+
+    static void *operator new(size_t size);
+    static void *operator new(size_t size, QThreadData *receiverThreadData);
+    static void operator delete(void *ptr, size_t size);
+    static void operator delete(void *ptr, QThreadData *receiverThreadData);
+
 private:
+    static void *allocate(size_t size, QThreadData *receiverThreadData);
+
     QtPrivate::QSlotObjectBase *slotObj_;
     const QObject *sender_;
     int signalId_;
@@ -387,6 +403,19 @@ private:
     QObjectPrivate::StaticMetaCallFunction callFunction_;
     ushort method_offset_;
     ushort method_relative_;
+
+    // storage for the arguments of calls with few and small arguments,
+    // used by copyArguments()
+    enum { InlineArgumentCount = 4 };
+    union InlineArgument {
+        void *pointer;
+        qint64 integer;
+        long double real;
+        char data[2 * sizeof(void *)];
+    };
+    int inlineTypes_[InlineArgumentCount + 1];
+    void *inlineArgs_[InlineArgumentCount + 1];
+    InlineArgument inlineData_[InlineArgumentCount];
 };
 
 class QBoolBlocker
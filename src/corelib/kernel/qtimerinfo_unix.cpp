@@ -56,6 +56,7 @@ Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
  */
 
 QTimerInfoList::QTimerInfoList()
+    : deadCount(0), nextSequence(0)
 {
 #if (_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC) && !defined(Q_OS_NACL)
     if (!QElapsedTimer::isMonotonic()) {
@@ -75,8 +76,11 @@ QTimerInfoList::QTimerInfoList()
         msPerTick = 0;
     }
 #endif
+}
 
-    firstTimerInfo = 0;
+QTimerInfoList::~QTimerInfoList()
+{
+    qDeleteAll(heap);
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -143,9 +147,9 @@ bool QTimerInfoList::timeChanged(timespec *delta)
 */
 void QTimerInfoList::timerRepair(const timespec &diff)
 {
-    // repair all timers
-    for (int i = 0; i < size(); ++i) {
-        QTimerInfo *t = at(i);
+    // repair all timers; shifting them all by the same amount keeps the heap ordered
+    for (int i = 0; i < heap.size(); ++i) {
+        QTimerInfo *t = heap.at(i);
         t->timeout = t->timeout + diff;
     }
 }
@@ -167,18 +171,108 @@ void QTimerInfoList::repairTimersIfNeeded()
 
 #endif
 
+/*
+  Timers with equal timeouts fire in insertion order, as they did when the
+  timers were kept in a sorted list.
+*/
+static inline bool timerLessThan(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    if (t1->timeout < t2->timeout)
+        return true;
+    if (t2->timeout < t1->timeout)
+        return false;
+    return t1->sequence < t2->sequence;
+}
+
+void QTimerInfoList::siftUp(int index)
+{
+    QTimerInfo *t = heap.at(index);
+    while (index > 0) {
+        const int parent = (index - 1) / 2;
+        if (!timerLessThan(t, heap.at(parent)))
+            break;
+        heap[index] = heap.at(parent);
+        index = parent;
+    }
+    heap[index] = t;
+}
+
+void QTimerInfoList::siftDown(int index)
+{
+    const int count = heap.size();
+    QTimerInfo *t = heap.at(index);
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && timerLessThan(heap.at(child + 1), heap.at(child)))
+            ++child;
+        if (!timerLessThan(heap.at(child), t))
+            break;
+        heap[index] = heap.at(child);
+        index = child;
+    }
+    heap[index] = t;
+}
+
+QTimerInfo *QTimerInfoList::heapPop()
+{
+    QTimerInfo *t = heap.first();
+    QTimerInfo *last = heap.takeLast();
+    if (!heap.isEmpty()) {
+        heap[0] = last;
+        siftDown(0);
+    }
+    return t;
+}
+
 /*
   insert timer info into list
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
-            break;
+    ti->sequence = nextSequence++;
+    heap.append(ti);
+    siftUp(heap.size() - 1);
+}
+
+/*
+  Marks the timer dead; it stays in the heap until purgeDeadTimers() drops it.
+  The caller must remove it from timersByObject.
+*/
+void QTimerInfoList::removeTimer(QTimerInfo *t)
+{
+    timersById.remove(t->id);
+    if (t->activateRef)
+        *(t->activateRef) = 0;
+    t->activateRef = 0;
+    t->obj = 0;
+    ++deadCount;
+}
+
+void QTimerInfoList::purgeDeadTimers()
+{
+    // keep a live timer at the top, timerWait() and the activation loop rely on it
+    while (!heap.isEmpty() && !heap.first()->obj) {
+        delete heapPop();
+        --deadCount;
+    }
+
+    // don't let cancelled timers pile up, rebuild once they are the majority
+    if (deadCount > 64 && deadCount > heap.size() / 2) {
+        int live = 0;
+        for (int i = 0; i < heap.size(); ++i) {
+            QTimerInfo *t = heap.at(i);
+            if (t->obj)
+                heap[live++] = t;
+            else
+                delete t;
+        }
+        heap.resize(live);
+        deadCount = 0;
+        for (int i = live / 2 - 1; i >= 0; --i)
+            siftDown(i);
     }
-    insert(index+1, ti);
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -381,10 +475,14 @@ bool QTimerInfoList::timerWait(timespec &tm)
 
     // Find first waiting timer not already active
     QTimerInfo *t = 0;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
+    if (!heap.isEmpty() && !heap.first()->activateRef) {
+        t = heap.first();
+    } else {
+        // only timers whose activation is in a nested event loop are active, so this is rare
+        for (int i = 0; i < heap.size(); ++i) {
+            QTimerInfo *candidate = heap.at(i);
+            if (candidate->obj && !candidate->activateRef && (!t || timerLessThan(candidate, t)))
+                t = candidate;
         }
     }
 
@@ -414,16 +512,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timersById.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -486,6 +581,8 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     }
 
     timerInsert(t);
+    timersById.insert(timerId, t);
+    timersByObject.insert(object, t);
 
 #ifdef QTIMERINFO_DEBUG
     t->expected = expected;
@@ -499,57 +596,44 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
+    QTimerInfo *t = timersById.value(timerId);
+    if (!t) // id not found
+        return false;
+
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            return true;
-        }
-    }
-    // id not found
-    return false;
+    timersByObject.remove(t->obj, t);
+    removeTimer(t);
+    purgeDeadTimers();
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->obj == object) {
-            // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            // move back one so that we don't skip the new current item
-            --i;
-        }
+
+    QMultiHash<QObject *, QTimerInfo *>::iterator it = timersByObject.find(object);
+    if (it == timersByObject.end())
+        return true;
+    while (it != timersByObject.end() && it.key() == object) {
+        removeTimer(it.value());
+        it = timersByObject.erase(it);
     }
+    purgeDeadTimers();
     return true;
 }
 
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
     QList<QAbstractEventDispatcher::TimerInfo> list;
-    for (int i = 0; i < count(); ++i) {
-        const QTimerInfo * const t = at(i);
-        if (t->obj == object) {
-            list << QAbstractEventDispatcher::TimerInfo(t->id,
-                                                        (t->timerType == Qt::VeryCoarseTimer
-                                                         ? t->interval * 1000
-                                                         : t->interval),
-                                                        t->timerType);
-        }
+    QMultiHash<QObject *, QTimerInfo *>::const_iterator it = timersByObject.constFind(object);
+    for (; it != timersByObject.constEnd() && it.key() == object; ++it) {
+        const QTimerInfo * const t = it.value();
+        list << QAbstractEventDispatcher::TimerInfo(t->id,
+                                                    (t->timerType == Qt::VeryCoarseTimer
+                                                     ? t->interval * 1000
+                                                     : t->interval),
+                                                    t->timerType);
     }
     return list;
 }
@@ -562,42 +646,28 @@ int QTimerInfoList::activateTimers()
     if (qt_disable_lowpriority_timers || isEmpty())
         return 0; // nothing to do
 
-    int n_act = 0, maxCount = 0;
-    firstTimerInfo = 0;
+    int n_act = 0;
 
     timespec currentTime = updateCurrentTime();
     // qDebug() << "Thread" << QThread::currentThreadId() << "woken up at" << currentTime;
     repairTimersIfNeeded();
 
-
-    // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
-    }
+    // Timers inserted from now on, including the ones we reschedule below, get a
+    // higher sequence number. They sort after every timer that has already expired,
+    // so stopping at the first of them avoids sending the same timer multiple times.
+    const quint64 firstNewSequence = nextSequence;
 
     //fire the timers.
-    while (maxCount--) {
-        if (isEmpty())
-            break;
-
-        QTimerInfo *currentTimerInfo = first();
+    while (!heap.isEmpty()) {
+        QTimerInfo *currentTimerInfo = heap.first();
         if (currentTime < currentTimerInfo->timeout)
             break; // no timer has expired
+        if (currentTimerInfo->sequence >= firstNewSequence)
+            break; // already handled in this pass
 
-        if (!firstTimerInfo) {
-            firstTimerInfo = currentTimerInfo;
-        } else if (firstTimerInfo == currentTimerInfo) {
-            // avoid sending the same timer multiple times
-            break;
-        } else if (currentTimerInfo->interval <  firstTimerInfo->interval
-                   || currentTimerInfo->interval == firstTimerInfo->interval) {
-            firstTimerInfo = currentTimerInfo;
-        }
-
-        // remove from list
-        removeFirst();
+        // remove from list, the next live timer moves to the top
+        heapPop();
+        purgeDeadTimers();
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
@@ -639,7 +709,6 @@ int QTimerInfoList::activateTimers()
         }
     }
 
-    firstTimerInfo = 0;
     // qDebug() << "Thread" << QThread::currentThreadId() << "activated" << n_act << "timers";
     return n_act;
 }
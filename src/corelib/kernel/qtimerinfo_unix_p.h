@@ -48,6 +48,8 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
+#include "qvector.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -59,8 +61,9 @@ struct QTimerInfo {
     int interval;     // - timer interval in milliseconds
     Qt::TimerType timerType; // - timer type
     timespec timeout;  // - when to actually fire
-    QObject *obj;     // - object to receive event
+    QObject *obj;     // - object to receive event, 0 once unregistered
     QTimerInfo **activateRef; // - ref from activateTimers
+    quint64 sequence; // - insertion order, breaks ties between equal timeouts
 
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
@@ -69,8 +72,13 @@ struct QTimerInfo {
 #endif
 };
 
-class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
+// Timers are kept in a binary min-heap ordered by timeout, so registering a timer is
+// O(log n). Unregistering only marks the timer dead in O(1); dead timers are dropped
+// when they reach the top of the heap, or all at once when they outnumber the live ones.
+class Q_CORE_EXPORT QTimerInfoList
 {
+    Q_DISABLE_COPY(QTimerInfoList)
+
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
     timespec previousTime;
     clock_t previousTicks;
@@ -81,11 +89,21 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     void timerRepair(const timespec &);
 #endif
 
-    // state variables used by activateTimers()
-    QTimerInfo *firstTimerInfo;
+    QVector<QTimerInfo *> heap;  // live and dead timers
+    QHash<int, QTimerInfo *> timersById;
+    QMultiHash<QObject *, QTimerInfo *> timersByObject;
+    int deadCount;
+    quint64 nextSequence;
+
+    QTimerInfo *heapPop();
+    void siftUp(int index);
+    void siftDown(int index);
+    void removeTimer(QTimerInfo *);
+    void purgeDeadTimers();
 
 public:
     QTimerInfoList();
+    ~QTimerInfoList();
 
     timespec currentTime;
     timespec updateCurrentTime();
@@ -96,6 +114,9 @@ public:
     bool timerWait(timespec &);
     void timerInsert(QTimerInfo *);
 
+    // when the earliest timer fires; the top of the heap is always live, see purgeDeadTimers()
+    timespec firstTimeout() const { Q_ASSERT(!heap.isEmpty()); return heap.first()->timeout; }
+
     int timerRemainingTime(int timerId);
 
     void registerTimer(int timerId, int interval, Qt::TimerType timerType, QObject *object);
@@ -104,6 +125,9 @@ public:
     QList<QAbstractEventDispatcher::TimerInfo> registeredTimers(QObject *object) const;
 
     int activateTimers();
+
+    bool isEmpty() const { return timersById.isEmpty(); }
+    int size() const { return timersById.size(); }
 };
 
 QT_END_NAMESPACE
@@ -44,6 +44,8 @@
 #include "qmutex_p.h"
 #include "qtypetraits.h"
 
+#include <algorithm>
+
 #ifndef QT_LINUX_FUTEX
 #include "private/qfreelist_p.h"
 #endif
@@ -378,6 +380,139 @@ bool QBasicMutex::isRecursive()
 
 */
 
+Q_LOGGING_CATEGORY(lcMutexContention, "qt.core.mutex.contention")
+
+QBasicAtomicInt QMutexContentionStatistics::enabled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+namespace {
+enum { ContentionTableSize = 512, ReportedEntries = 20 };
+
+// Contended mutexes by address, with open addressing. The table can't be
+// protected by a QMutex, so it has a spin lock of its own.
+struct ContentionTable
+{
+    QBasicAtomicInt lock;
+    QMutexContentionStatistics::Entry entries[ContentionTableSize];
+
+    void acquire() Q_DECL_NOTHROW
+    {
+        while (!lock.testAndSetAcquire(0, 1))
+            QThread::yieldCurrentThread();
+    }
+    void release() Q_DECL_NOTHROW { lock.storeRelease(0); }
+};
+
+ContentionTable contentionTable;
+
+bool longerWait(const QMutexContentionStatistics::Entry &e1, const QMutexContentionStatistics::Entry &e2)
+{
+    return e1.waitTime > e2.waitTime;
+}
+
+// times the slow path of locking a mutex, if the statistics are enabled
+class ContentionTimer
+{
+public:
+    explicit ContentionTimer(const void *mutex) Q_DECL_NOTHROW
+        : mutex(QMutexContentionStatistics::isEnabled() ? mutex : 0)
+    {
+        if (this->mutex)
+            timer.start();
+    }
+    ~ContentionTimer()
+    {
+        if (mutex)
+            QMutexContentionStatistics::record(mutex, timer.nsecsElapsed());
+    }
+
+private:
+    const void *mutex;
+    QElapsedTimer timer;
+};
+}
+
+/*!
+    \internal
+    Enables recording contention statistics if \a enable is true, and
+    disables it otherwise. Statistics recorded so far are kept.
+ */
+void QMutexContentionStatistics::setEnabled(bool enable)
+{
+    enabled.store(enable);
+}
+
+/*!
+    \internal
+    Returns the mutexes that threads had to wait for, the ones waited
+    for the longest first.
+ */
+QVector<QMutexContentionStatistics::Entry> QMutexContentionStatistics::entries()
+{
+    QVector<Entry> result;
+    result.reserve(ContentionTableSize);
+    contentionTable.acquire();
+    for (int i = 0; i < ContentionTableSize; ++i) {
+        if (contentionTable.entries[i].mutex)
+            result.append(contentionTable.entries[i]);
+    }
+    contentionTable.release();
+    std::sort(result.begin(), result.end(), longerWait);
+    return result;
+}
+
+/*!
+    \internal
+    Forgets all statistics recorded so far.
+ */
+void QMutexContentionStatistics::clear()
+{
+    contentionTable.acquire();
+    memset(contentionTable.entries, 0, sizeof(contentionTable.entries));
+    contentionTable.release();
+}
+
+/*!
+    \internal
+    Logs the most contended mutexes to the qt.core.mutex.contention
+    logging category.
+ */
+void QMutexContentionStatistics::report()
+{
+    const QVector<Entry> contended = entries();
+    if (contended.isEmpty())
+        return;
+
+    qCDebug(lcMutexContention, "%d contended mutexes, by total wait time:", contended.size());
+    for (int i = 0; i < qMin<int>(contended.size(), ReportedEntries); ++i) {
+        const Entry &e = contended.at(i);
+        qCDebug(lcMutexContention, "  %p: %llu contentions, %lld us waited, %lld us at most",
+                e.mutex, e.contentions, e.waitTime / 1000, e.longestWait / 1000);
+    }
+}
+
+/*!
+    \internal
+    Records that a thread waited \a waitTime nanoseconds for \a mutex. If
+    too many different mutexes were contended, the record is dropped.
+ */
+void QMutexContentionStatistics::record(const void *mutex, qint64 waitTime) Q_DECL_NOTHROW
+{
+    const uint index = uint(quintptr(mutex) / sizeof(void *));
+    contentionTable.acquire();
+    for (uint i = 0; i < ContentionTableSize; ++i) {
+        Entry &e = contentionTable.entries[(index + i) % ContentionTableSize];
+        if (!e.mutex)
+            e.mutex = mutex;
+        if (e.mutex == mutex) {
+            ++e.contentions;
+            e.waitTime += waitTime;
+            e.longestWait = qMax(e.longestWait, waitTime);
+            break;
+        }
+    }
+    contentionTable.release();
+}
+
 #ifndef QT_LINUX_FUTEX //linux implementation is in qmutex_linux.cpp
 
 /*
@@ -414,6 +549,7 @@ void QBasicMutex::lockInternal() QT_MUTEX_LOCK_NOEXCEPT
 bool QBasicMutex::lockInternal(int timeout) QT_MUTEX_LOCK_NOEXCEPT
 {
     Q_ASSERT(!isRecursive());
+    ContentionTimer contentionTimer(this);
 
     while (!fastTryLock()) {
         QMutexData *copy = d_ptr.loadAcquire();
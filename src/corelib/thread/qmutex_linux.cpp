@@ -94,6 +94,17 @@ QT_BEGIN_NAMESPACE
  * If it fails, unlockInternal() is called. The only possibility is that the
  * mutex value was 0x3, which indicates some other thread is waiting or was
  * waiting in the past. We then set the mutex to 0x0 and perform a FUTEX_WAKE.
+ *
+ * SPINNING:
+ *
+ * Before setting the waiting bit, lockInternal spins for a while in case the
+ * owner unlocks the mutex soon: for short critical sections, that is much
+ * cheaper than sleeping in FUTEX_WAIT and being woken up again. Like glibc's
+ * adaptive mutexes, it learns how long to spin: the estimate moves towards
+ * the number of spins it took to get the mutex, and spinning stops at twice
+ * the estimate. The estimates are kept in a small table indexed by the
+ * mutex's address. There is no spinning on single-CPU machines, nor while
+ * other threads sleep on the mutex already.
  */
 
 static QBasicAtomicInt futexFlagSupport = Q_BASIC_ATOMIC_INITIALIZER(-1);
@@ -151,6 +162,59 @@ static inline QMutexData *dummyFutexValue()
     return reinterpret_cast<QMutexData *>(quintptr(3));
 }
 
+static inline QMutexData *dummyLockedValue()
+{
+    return reinterpret_cast<QMutexData *>(quintptr(1));
+}
+
+static inline void relaxCpu() Q_DECL_NOTHROW
+{
+#if defined(Q_PROCESSOR_X86) && defined(Q_CC_GNU)
+    asm volatile("pause" ::: "memory");
+#elif defined(Q_PROCESSOR_ARM_V7) && defined(Q_CC_GNU)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+static bool spinningIsUseful() Q_DECL_NOTHROW
+{
+    static QBasicAtomicInt cpuCount = Q_BASIC_ATOMIC_INITIALIZER(0);
+    int count = cpuCount.load();
+    if (!count) {
+        count = qMax(1, int(sysconf(_SC_NPROCESSORS_ONLN)));
+        cpuCount.store(count);
+    }
+    return count > 1;
+}
+
+enum { MaxSpinCount = 100, SpinEstimateCount = 64 };
+static QBasicAtomicInt spinEstimates[SpinEstimateCount];
+
+static bool lockBySpinning(QBasicAtomicPointer<QMutexData> &d_ptr) Q_DECL_NOTHROW
+{
+    if (!spinningIsUseful())
+        return false;
+
+    QBasicAtomicInt &estimate = spinEstimates[uint(quintptr(&d_ptr) / sizeof(void *)) % SpinEstimateCount];
+    const int spins = estimate.load();
+    const int maxSpins = qMin<int>(MaxSpinCount, 2 * spins + 10);
+    int count = 0;
+    bool locked = false;
+    while (count < maxSpins) {
+        QMutexData *d = d_ptr.load();
+        if (d == dummyFutexValue())
+            break; // queue up behind the sleeping threads
+        if (!d && d_ptr.testAndSetAcquire(0, dummyLockedValue())) {
+            locked = true;
+            break;
+        }
+        relaxCpu();
+        ++count;
+    }
+    estimate.store(spins + (count - spins) / 8);
+    return locked;
+}
+
 template <bool IsTimed> static inline
 bool lockInternal_helper(QBasicAtomicPointer<QMutexData> &d_ptr, int timeout = -1, QElapsedTimer *elapsedTimer = 0) Q_DECL_NOTHROW
 {
@@ -161,6 +225,9 @@ bool lockInternal_helper(QBasicAtomicPointer<QMutexData> &d_ptr, int timeout = -
     if (timeout == 0)
         return false;
 
+    if (lockBySpinning(d_ptr))
+        return true;
+
     struct timespec ts, *pts = 0;
     if (IsTimed && timeout > 0) {
         ts.tv_sec = timeout / 1000;
@@ -200,12 +267,14 @@ bool lockInternal_helper(QBasicAtomicPointer<QMutexData> &d_ptr, int timeout = -
 void QBasicMutex::lockInternal() Q_DECL_NOTHROW
 {
     Q_ASSERT(!isRecursive());
+    ContentionTimer contentionTimer(this);
     lockInternal_helper<false>(d_ptr);
 }
 
 bool QBasicMutex::lockInternal(int timeout) Q_DECL_NOTHROW
 {
     Q_ASSERT(!isRecursive());
+    ContentionTimer contentionTimer(this);
     QElapsedTimer elapsedTimer;
     elapsedTimer.start();
     return lockInternal_helper<true>(d_ptr, timeout, &elapsedTimer);
@@ -52,6 +52,8 @@
 #include <QtCore/qnamespace.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qatomic.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qloggingcategory.h>
 
 #if defined(Q_OS_MAC)
 # include <mach/semaphore.h>
@@ -130,6 +132,38 @@ public:
 };
 #endif //QT_LINUX_FUTEX
 
+#ifndef QT_NO_THREAD
+Q_DECLARE_LOGGING_CATEGORY(lcMutexContention)
+
+// Records how often and how long threads wait for locked mutexes. Enabled
+// by setEnabled() or by enabling debug output of the qt.core.mutex.contention
+// logging category, in which case report() runs when QCoreApplication is
+// destroyed.
+class Q_CORE_EXPORT QMutexContentionStatistics
+{
+public:
+    struct Entry
+    {
+        const void *mutex;
+        quint64 contentions;
+        qint64 waitTime;    // in nanoseconds
+        qint64 longestWait; // in nanoseconds
+    };
+
+    static bool isEnabled() { return enabled.load(); }
+    static void setEnabled(bool enable);
+
+    static QVector<Entry> entries();
+    static void clear();
+    static void report();
+
+    static void record(const void *mutex, qint64 waitTime) Q_DECL_NOTHROW;
+
+private:
+    static QBasicAtomicInt enabled;
+};
+Q_DECLARE_TYPEINFO(QMutexContentionStatistics::Entry, Q_PRIMITIVE_TYPE);
+#endif // QT_NO_THREAD
 
 #ifdef Q_OS_UNIX
 // helper functions for qmutex_unix.cpp and qwaitcondition_unix.cpp
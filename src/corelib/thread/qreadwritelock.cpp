@@ -38,11 +38,147 @@
 #include "qmutex.h"
 #include "qthread.h"
 #include "qwaitcondition.h"
+#include "qthreadstorage.h"
+#include "qvarlengtharray.h"
 
 #include "qreadwritelock_p.h"
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+// the read locks a thread holds on a recursive QReadWriteLock
+struct ReadLockCount
+{
+    QReadWriteLockPrivate *lock;
+    int count;
+};
+typedef QVarLengthArray<ReadLockCount, 4> ReadLockCounts;
+}
+
+Q_DECLARE_TYPEINFO(ReadLockCount, Q_PRIMITIVE_TYPE);
+Q_GLOBAL_STATIC(QThreadStorage<ReadLockCounts>, threadReadLockCounts)
+
+static inline ReadLockCounts *currentThreadReadLocks()
+{
+    QThreadStorage<ReadLockCounts> *storage = threadReadLockCounts();
+    return storage ? &storage->localData() : 0;
+}
+
+static inline int indexOfReadLock(const ReadLockCounts *counts, const QReadWriteLockPrivate *d)
+{
+    if (counts) {
+        for (int i = 0; i < counts->size(); ++i) {
+            if (counts->at(i).lock == d)
+                return i;
+        }
+    }
+    return -1;
+}
+
+/*
+    Takes a read lock if nobody holds the write lock and, unless
+    \a ignoreWaiters is \c true, nobody is waiting in the slow path.
+*/
+static inline bool tryLockForReadFast(QReadWriteLockPrivate *d, bool ignoreWaiters)
+{
+    int state = d->state.load();
+    for (;;) {
+        if (state & QReadWriteLockPrivate::Writer)
+            return false;
+        if (!ignoreWaiters && (state & QReadWriteLockPrivate::Waiting))
+            return false;
+        Q_ASSERT_X((state & QReadWriteLockPrivate::ReaderMask) != QReadWriteLockPrivate::ReaderMask,
+                   "QReadWriteLock::lockForRead()", "Overflow in lock counter");
+        if (d->state.testAndSetAcquire(state, state + 1, state))
+            return true;
+    }
+}
+
+static inline bool tryLockForWriteFast(QReadWriteLockPrivate *d)
+{
+    int state = d->state.load();
+    for (;;) {
+        if (state & (QReadWriteLockPrivate::ReaderMask | QReadWriteLockPrivate::Writer))
+            return false;
+        if (d->state.testAndSetAcquire(state, state | QReadWriteLockPrivate::Writer, state))
+            return true;
+    }
+}
+
+/*
+    Slow path of the locking functions, a negative \a timeout waits forever.
+    Waiting threads set the Waiting bit so that new lockers come here too
+    and unlock() knows to wake them up.
+*/
+static bool lockForReadSlow(QReadWriteLockPrivate *d, int timeout)
+{
+    QMutexLocker lock(&d->mutex);
+    ++d->waitingReaders;
+    d->state.fetchAndOrOrdered(QReadWriteLockPrivate::Waiting);
+
+    bool locked = false;
+    bool waited = true;
+    for (;;) {
+        int state = d->state.load();
+        if (!(state & QReadWriteLockPrivate::Writer) && !d->waitingWriters) {
+            Q_ASSERT_X((state & QReadWriteLockPrivate::ReaderMask) != QReadWriteLockPrivate::ReaderMask,
+                       "QReadWriteLock::lockForRead()", "Overflow in lock counter");
+            if (!d->state.testAndSetAcquire(state, state + 1))
+                continue;
+            locked = true;
+            break;
+        }
+        if (!waited)
+            break;
+        waited = d->readerWait.wait(&d->mutex, timeout < 0 ? ULONG_MAX : ulong(timeout));
+    }
+
+    if (--d->waitingReaders == 0 && !d->waitingWriters)
+        d->state.fetchAndAndOrdered(~QReadWriteLockPrivate::Waiting);
+    return locked;
+}
+
+static bool lockForWriteSlow(QReadWriteLockPrivate *d, int timeout)
+{
+    QMutexLocker lock(&d->mutex);
+    ++d->waitingWriters;
+    d->state.fetchAndOrOrdered(QReadWriteLockPrivate::Waiting);
+
+    bool locked = false;
+    bool waited = true;
+    for (;;) {
+        int state = d->state.load();
+        if (!(state & (QReadWriteLockPrivate::ReaderMask | QReadWriteLockPrivate::Writer))) {
+            if (!d->state.testAndSetAcquire(state, state | QReadWriteLockPrivate::Writer))
+                continue;
+            locked = true;
+            break;
+        }
+        if (!waited)
+            break;
+        waited = d->writerWait.wait(&d->mutex, timeout < 0 ? ULONG_MAX : ulong(timeout));
+    }
+
+    if (--d->waitingWriters == 0) {
+        if (!d->waitingReaders)
+            d->state.fetchAndAndOrdered(~QReadWriteLockPrivate::Waiting);
+        else if (!locked && !d->isLockedForWrite())
+            d->readerWait.wakeAll(); // they were only held back by us
+    } else if (!locked && !d->isLocked()) {
+        d->writerWait.wakeOne(); // in case we consumed the wake-up meant for another writer
+    }
+    return locked;
+}
+
+static void wakeWaiters(QReadWriteLockPrivate *d)
+{
+    QMutexLocker lock(&d->mutex);
+    if (d->waitingWriters)
+        d->writerWait.wakeOne();
+    else if (d->waitingReaders)
+        d->readerWait.wakeAll();
+}
+
 /*! \class QReadWriteLock
     \inmodule QtCore
     \brief The QReadWriteLock class provides read-write locking.
@@ -134,32 +270,24 @@ QReadWriteLock::~QReadWriteLock()
 */
 void QReadWriteLock::lockForRead()
 {
-    QMutexLocker lock(&d->mutex);
-
-    Qt::HANDLE self = 0;
+    ReadLockCounts *counts = 0;
     if (d->recursive) {
-        self = QThread::currentThreadId();
-
-        QHash<Qt::HANDLE, int>::iterator it = d->currentReaders.find(self);
-        if (it != d->currentReaders.end()) {
-            ++it.value();
-            ++d->accessCount;
-            Q_ASSERT_X(d->accessCount > 0, "QReadWriteLock::lockForRead()",
-                       "Overflow in lock counter");
+        counts = currentThreadReadLocks();
+        const int index = indexOfReadLock(counts, d);
+        if (index >= 0) {
+            // we already hold a read lock, so there can be no writer
+            d->state.fetchAndAddAcquire(1);
+            ++(*counts)[index].count;
             return;
         }
     }
 
-    while (d->accessCount < 0 || d->waitingWriters) {
-        ++d->waitingReaders;
-        d->readerWait.wait(&d->mutex);
-        --d->waitingReaders;
+    if (!tryLockForReadFast(d, false))
+        lockForReadSlow(d, -1);
+    if (counts) {
+        const ReadLockCount entry = { d, 1 };
+        counts->append(entry);
     }
-    if (d->recursive)
-        d->currentReaders.insert(self, 1);
-
-    ++d->accessCount;
-    Q_ASSERT_X(d->accessCount > 0, "QReadWriteLock::lockForRead()", "Overflow in lock counter");
 }
 
 /*!
@@ -180,30 +308,24 @@ void QReadWriteLock::lockForRead()
 */
 bool QReadWriteLock::tryLockForRead()
 {
-    QMutexLocker lock(&d->mutex);
-
-    Qt::HANDLE self = 0;
+    ReadLockCounts *counts = 0;
     if (d->recursive) {
-        self = QThread::currentThreadId();
-
-        QHash<Qt::HANDLE, int>::iterator it = d->currentReaders.find(self);
-        if (it != d->currentReaders.end()) {
-            ++it.value();
-            ++d->accessCount;
-            Q_ASSERT_X(d->accessCount > 0, "QReadWriteLock::tryLockForRead()",
-                       "Overflow in lock counter");
+        counts = currentThreadReadLocks();
+        const int index = indexOfReadLock(counts, d);
+        if (index >= 0) {
+            // we already hold a read lock, so there can be no writer
+            d->state.fetchAndAddAcquire(1);
+            ++(*counts)[index].count;
             return true;
         }
     }
 
-    if (d->accessCount < 0)
+    if (!tryLockForReadFast(d, true))
         return false;
-    if (d->recursive)
-        d->currentReaders.insert(self, 1);
-
-    ++d->accessCount;
-    Q_ASSERT_X(d->accessCount > 0, "QReadWriteLock::tryLockForRead()", "Overflow in lock counter");
-
+    if (counts) {
+        const ReadLockCount entry = { d, 1 };
+        counts->append(entry);
+    }
     return true;
 }
 
@@ -228,35 +350,24 @@ bool QReadWriteLock::tryLockForRead()
 */
 bool QReadWriteLock::tryLockForRead(int timeout)
 {
-    QMutexLocker lock(&d->mutex);
-
-    Qt::HANDLE self = 0;
+    ReadLockCounts *counts = 0;
     if (d->recursive) {
-        self = QThread::currentThreadId();
-
-        QHash<Qt::HANDLE, int>::iterator it = d->currentReaders.find(self);
-        if (it != d->currentReaders.end()) {
-            ++it.value();
-            ++d->accessCount;
-            Q_ASSERT_X(d->accessCount > 0, "QReadWriteLock::tryLockForRead()",
-                       "Overflow in lock counter");
+        counts = currentThreadReadLocks();
+        const int index = indexOfReadLock(counts, d);
+        if (index >= 0) {
+            // we already hold a read lock, so there can be no writer
+            d->state.fetchAndAddAcquire(1);
+            ++(*counts)[index].count;
             return true;
         }
     }
 
-    while (d->accessCount < 0 || d->waitingWriters) {
-        ++d->waitingReaders;
-        bool success = d->readerWait.wait(&d->mutex, timeout < 0 ? ULONG_MAX : ulong(timeout));
-        --d->waitingReaders;
-        if (!success)
-            return false;
+    if (!tryLockForReadFast(d, false) && !lockForReadSlow(d, timeout))
+        return false;
+    if (counts) {
+        const ReadLockCount entry = { d, 1 };
+        counts->append(entry);
     }
-    if (d->recursive)
-        d->currentReaders.insert(self, 1);
-
-    ++d->accessCount;
-    Q_ASSERT_X(d->accessCount > 0, "QReadWriteLock::tryLockForRead()", "Overflow in lock counter");
-
     return true;
 }
 
@@ -273,30 +384,20 @@ bool QReadWriteLock::tryLockForRead(int timeout)
 */
 void QReadWriteLock::lockForWrite()
 {
-    QMutexLocker lock(&d->mutex);
-
     Qt::HANDLE self = 0;
     if (d->recursive) {
         self = QThread::currentThreadId();
 
         if (d->currentWriter == self) {
-            --d->accessCount;
-            Q_ASSERT_X(d->accessCount < 0, "QReadWriteLock::lockForWrite()",
-                       "Overflow in lock counter");
+            ++d->writerRecursion;
             return;
         }
     }
 
-    while (d->accessCount != 0) {
-        ++d->waitingWriters;
-        d->writerWait.wait(&d->mutex);
-        --d->waitingWriters;
-    }
+    if (!tryLockForWriteFast(d))
+        lockForWriteSlow(d, -1);
     if (d->recursive)
         d->currentWriter = self;
-
-    --d->accessCount;
-    Q_ASSERT_X(d->accessCount < 0, "QReadWriteLock::lockForWrite()", "Overflow in lock counter");
 }
 
 /*!
@@ -316,29 +417,20 @@ void QReadWriteLock::lockForWrite()
 */
 bool QReadWriteLock::tryLockForWrite()
 {
-    QMutexLocker lock(&d->mutex);
-
     Qt::HANDLE self = 0;
     if (d->recursive) {
         self = QThread::currentThreadId();
 
         if (d->currentWriter == self) {
-            --d->accessCount;
-            Q_ASSERT_X(d->accessCount < 0, "QReadWriteLock::lockForWrite()",
-                       "Overflow in lock counter");
+            ++d->writerRecursion;
             return true;
         }
     }
 
-    if (d->accessCount != 0)
+    if (!tryLockForWriteFast(d))
         return false;
     if (d->recursive)
         d->currentWriter = self;
-
-    --d->accessCount;
-    Q_ASSERT_X(d->accessCount < 0, "QReadWriteLock::tryLockForWrite()",
-               "Overflow in lock counter");
-
     return true;
 }
 
@@ -363,35 +455,20 @@ bool QReadWriteLock::tryLockForWrite()
 */
 bool QReadWriteLock::tryLockForWrite(int timeout)
 {
-    QMutexLocker lock(&d->mutex);
-
     Qt::HANDLE self = 0;
     if (d->recursive) {
         self = QThread::currentThreadId();
 
         if (d->currentWriter == self) {
-            --d->accessCount;
-            Q_ASSERT_X(d->accessCount < 0, "QReadWriteLock::lockForWrite()",
-                       "Overflow in lock counter");
+            ++d->writerRecursion;
             return true;
         }
     }
 
-    while (d->accessCount != 0) {
-        ++d->waitingWriters;
-        bool success = d->writerWait.wait(&d->mutex, timeout < 0 ? ULONG_MAX : ulong(timeout));
-        --d->waitingWriters;
-
-        if (!success)
-            return false;
-    }
+    if (!tryLockForWriteFast(d) && !lockForWriteSlow(d, timeout))
+        return false;
     if (d->recursive)
         d->currentWriter = self;
-
-    --d->accessCount;
-    Q_ASSERT_X(d->accessCount < 0, "QReadWriteLock::tryLockForWrite()",
-               "Overflow in lock counter");
-
     return true;
 }
 
@@ -405,35 +482,33 @@ bool QReadWriteLock::tryLockForWrite(int timeout)
 */
 void QReadWriteLock::unlock()
 {
-    QMutexLocker lock(&d->mutex);
-
-    Q_ASSERT_X(d->accessCount != 0, "QReadWriteLock::unlock()", "Cannot unlock an unlocked lock");
-
-    bool unlocked = false;
-    if (d->accessCount > 0) {
+    int state = d->state.load();
+    Q_ASSERT_X(state & (QReadWriteLockPrivate::ReaderMask | QReadWriteLockPrivate::Writer),
+               "QReadWriteLock::unlock()", "Cannot unlock an unlocked lock");
+
+    if (state & QReadWriteLockPrivate::Writer) {
+        // releasing a write lock
+        if (d->writerRecursion > 0) {
+            --d->writerRecursion;
+            return;
+        }
+        d->currentWriter = 0;
+        state = d->state.fetchAndAndOrdered(~QReadWriteLockPrivate::Writer);
+        if (state & QReadWriteLockPrivate::Waiting)
+            wakeWaiters(d);
+    } else {
         // releasing a read lock
         if (d->recursive) {
-            Qt::HANDLE self = QThread::currentThreadId();
-            QHash<Qt::HANDLE, int>::iterator it = d->currentReaders.find(self);
-            if (it != d->currentReaders.end()) {
-                if (--it.value() <= 0)
-                    d->currentReaders.erase(it);
+            ReadLockCounts *counts = currentThreadReadLocks();
+            const int index = indexOfReadLock(counts, d);
+            if (index >= 0 && --(*counts)[index].count == 0) {
+                (*counts)[index] = counts->last();
+                counts->removeLast();
             }
         }
-
-        unlocked = --d->accessCount == 0;
-    } else if (d->accessCount < 0 && ++d->accessCount == 0) {
-        // released a write lock
-        unlocked = true;
-        d->currentWriter = 0;
-    }
-
-    if (unlocked) {
-        if (d->waitingWriters) {
-            d->writerWait.wakeOne();
-        } else if (d->waitingReaders) {
-            d->readerWait.wakeAll();
-        }
+        state = d->state.fetchAndAddOrdered(-1);
+        if ((state & QReadWriteLockPrivate::ReaderMask) == 1 && (state & QReadWriteLockPrivate::Waiting))
+            wakeWaiters(d);
     }
 }
 
@@ -46,7 +46,7 @@
 //
 
 #include <QtCore/qglobal.h>
-#include <QtCore/qhash.h>
+#include <QtCore/qatomic.h>
 
 #ifndef QT_NO_THREAD
 
@@ -54,22 +54,38 @@ QT_BEGIN_NAMESPACE
 
 struct QReadWriteLockPrivate
 {
+    // layout of state
+    enum {
+        ReaderMask = 0x0fffffff, // number of read locks held, recursive ones included
+        Writer = 0x10000000,     // locked for writing
+        Waiting = 0x20000000     // a thread waits in the slow path, unlock must wake it
+    };
+
     QReadWriteLockPrivate(QReadWriteLock::RecursionMode recursionMode)
-        : accessCount(0), waitingReaders(0), waitingWriters(0),
-          recursive(recursionMode == QReadWriteLock::Recursive), currentWriter(0)
+        : state(0), waitingReaders(0), waitingWriters(0),
+          recursive(recursionMode == QReadWriteLock::Recursive),
+          writerRecursion(0), currentWriter(0)
     { }
 
+    // read and modified with atomic operations; uncontended locking never takes the mutex
+    QAtomicInt state;
+
+    // the slow path, waitingReaders and waitingWriters are protected by mutex
     QMutex mutex;
     QWaitCondition readerWait;
     QWaitCondition writerWait;
 
-    int accessCount;
     int waitingReaders;
     int waitingWriters;
 
+    // recursive mode; only the thread holding the write lock touches these,
+    // read lock counts are kept per thread
     bool recursive;
+    int writerRecursion;
     Qt::HANDLE currentWriter;
-    QHash<Qt::HANDLE, int> currentReaders;
+
+    bool isLocked() const { return state.load() & (ReaderMask | Writer); }
+    bool isLockedForWrite() const { return state.load() & Writer; }
 };
 
 QT_END_NAMESPACE
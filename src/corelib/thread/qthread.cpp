@@ -51,11 +51,21 @@ QT_BEGIN_NAMESPACE
 
 QThreadData::QThreadData(int initialRefCount)
     : _ref(initialRefCount), loopLevel(0), thread(0), threadId(0),
-      eventDispatcher(0), quitNow(false), canWait(true), isAdopted(false)
+      eventDispatcher(0), quitNow(false), canWait(true), isAdopted(false),
+      metaCallEventCache(0)
 {
     // fprintf(stderr, "QThreadData %p created\n", this);
 }
 
+static void deleteBlocks(QRecycledBlock *block)
+{
+    while (block) {
+        QRecycledBlock *next = block->next;
+        ::operator delete(block);
+        block = next;
+    }
+}
+
 QThreadData::~QThreadData()
 {
     Q_ASSERT(_ref.load() == 0);
@@ -84,6 +94,9 @@ QThreadData::~QThreadData()
         }
     }
 
+    deleteBlocks(metaCallEventCache);
+    deleteBlocks(recycledMetaCallEvents.fetchAndStoreAcquire(0));
+
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
@@ -82,6 +82,12 @@ inline bool operator<(const QPostEvent &first, const QPostEvent &second)
     return first.priority > second.priority;
 }
 
+// A block of memory waiting to be reused
+struct QRecycledBlock
+{
+    QRecycledBlock *next;
+};
+
 // This class holds the list of posted events.
 //  The list has to be kept sorted by priority
 class QPostEventList : public QVector<QPostEvent>
@@ -281,6 +287,17 @@ public:
     bool quitNow;
     bool canWait;
     bool isAdopted;
+
+    // memory for queued calls, see QMetaCallEvent::operator new().
+    // recycledMetaCallEvents == events deleted in this thread, taken as
+    // a whole by threads posting to objects living here;
+    // recycledMetaCallEventCount == approximate length of that list,
+    // which is not allowed to grow beyond MaxRecycledMetaCallEvents;
+    // metaCallEventCache == blocks taken, only used by this thread
+    enum { MaxRecycledMetaCallEvents = 256 };
+    QAtomicPointer<QRecycledBlock> recycledMetaCallEvents;
+    QAtomicInt recycledMetaCallEventCount;
+    QRecycledBlock *metaCallEventCache;
 };
 
 class QScopedLoopLevelCounter
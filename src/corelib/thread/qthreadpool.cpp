@@ -43,6 +43,85 @@ QT_BEGIN_NAMESPACE
 
 Q_GLOBAL_STATIC(QThreadPool, theInstance)
 
+/*
+    Bounded queue of runnables owned by one pool thread. Only the owning
+    thread pushes; any thread may take from the front, so idle threads
+    can steal work without going through the pool mutex. Runnables are
+    taken in the order they were pushed, like the pool's own queue.
+*/
+class QThreadPoolWorkQueue
+{
+public:
+    enum { Capacity = 256 };
+
+    QThreadPoolWorkQueue() : head(0), tail(0) { }
+
+    bool push(QRunnable *runnable);
+    QRunnable *take();
+    bool remove(QRunnable *runnable);
+    bool mayHaveTasks();
+
+private:
+    QAtomicInteger<uint> head;
+    QAtomicInteger<uint> tail;
+    QAtomicPointer<QRunnable> entries[Capacity];
+};
+
+/*
+    Called by the owning thread only. Returns \c false if the queue is full.
+*/
+bool QThreadPoolWorkQueue::push(QRunnable *runnable)
+{
+    const uint t = tail.load();
+    if (t - head.loadAcquire() >= uint(Capacity))
+        return false;
+
+    // a slot is cleared by whoever takes it, which can lag behind head
+    QAtomicPointer<QRunnable> &slot = entries[t % Capacity];
+    if (slot.loadAcquire())
+        return false;
+
+    slot.storeRelease(runnable);
+    // full barrier, pairs with mayHaveTasks() in a thread about to sleep
+    tail.fetchAndAddOrdered(1);
+    return true;
+}
+
+QRunnable *QThreadPoolWorkQueue::take()
+{
+    for (;;) {
+        const uint h = head.loadAcquire();
+        if (int(tail.loadAcquire() - h) <= 0)
+            return 0;
+        if (!head.testAndSetOrdered(h, h + 1))
+            continue;
+        // the slot may have been emptied by remove()
+        if (QRunnable *runnable = entries[h % Capacity].fetchAndStoreAcquire(0))
+            return runnable;
+    }
+}
+
+/*
+    Removes \a runnable if it has not been taken yet. The slot is left
+    empty and skipped by take().
+*/
+bool QThreadPoolWorkQueue::remove(QRunnable *runnable)
+{
+    const uint h = head.loadAcquire();
+    const uint t = tail.loadAcquire();
+    for (uint i = h; int(t - i) > 0; ++i) {
+        if (entries[i % Capacity].testAndSetOrdered(runnable, 0))
+            return true;
+    }
+    return false;
+}
+
+bool QThreadPoolWorkQueue::mayHaveTasks()
+{
+    // read-modify-write instead of a plain load for the same full barrier as in push()
+    return int(tail.fetchAndAddOrdered(0) - head.loadAcquire()) > 0;
+}
+
 /*
     QThread wrapper, provides synchronization against a ThreadPool
 */
@@ -56,6 +135,10 @@ public:
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    QThreadPoolWorkQueue localQueue;
+    QAtomicPointer<void> threadId;
+    QThreadPoolThread *nextWorker; // never changes once the thread is in manager->workers
 };
 
 /*
@@ -67,7 +150,7 @@ public:
     \internal
 */
 QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
-    :manager(manager), runnable(0)
+    :manager(manager), runnable(0), nextWorker(0)
 { }
 
 /*
@@ -76,17 +159,18 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 void QThreadPoolThread::run()
 {
     QMutexLocker locker(&manager->mutex);
+    threadId.storeRelease(QThread::currentThreadId());
     for(;;) {
         QRunnable *r = runnable;
         runnable = 0;
+        locker.unlock();
 
-        do {
+        for (;;) {
             if (r) {
                 const bool autoDelete = r->autoDelete();
 
 
                 // run the task
-                locker.unlock();
 #ifndef QT_NO_EXCEPTIONS
                 try {
 #endif
@@ -100,20 +184,31 @@ void QThreadPoolThread::run()
                     throw;
                 }
 #endif
-                locker.relock();
 
-                if (autoDelete && !--r->ref)
+                if (autoDelete && !QThreadPoolPrivate::runnableRef(r).deref())
                     delete r;
             }
 
             // if too many threads are active, expire this thread
-            if (manager->tooManyThreadsActive())
-                break;
+            if (manager->spareThreadCount.load() < 0) {
+                locker.relock();
+                if (manager->tooManyThreadsActive())
+                    break;
+                locker.unlock();
+            }
 
-            r = !manager->queue.isEmpty() ? manager->queue.takeFirst().first : 0;
-        } while (r != 0);
+            r = manager->takeTask(this);
+            if (!r) {
+                locker.relock();
+                if (manager->queue.isEmpty())
+                    break;
+                r = manager->dequeueTask();
+                locker.unlock();
+            }
+        }
 
         if (manager->isExiting) {
+            manager->requeueLocalTasks(this);
             registerThreadInactive();
             break;
         }
@@ -123,18 +218,30 @@ void QThreadPoolThread::run()
         if (!expired) {
             manager->waitingThreads.enqueue(this);
             registerThreadInactive();
+            manager->updateSpareThreadCount();
+            if (manager->hasLocalTasks()) {
+                // another pool thread queued work before it could see us waiting
+                manager->waitingThreads.removeOne(this);
+                ++manager->activeThreads;
+                manager->updateSpareThreadCount();
+                continue;
+            }
             // wait for work, exiting after the expiry timeout is reached
             runnableReady.wait(locker.mutex(), manager->expiryTimeout);
             ++manager->activeThreads;
             if (manager->waitingThreads.removeOne(this))
                 expired = true;
+            manager->updateSpareThreadCount();
         }
         if (expired) {
+            manager->requeueLocalTasks(this);
             manager->expiredThreads.enqueue(this);
             registerThreadInactive();
+            manager->updateSpareThreadCount();
             break;
         }
     }
+    threadId.storeRelease(0);
 }
 
 void QThreadPoolThread::registerThreadInactive()
@@ -148,12 +255,15 @@ void QThreadPoolThread::registerThreadInactive()
     \internal
 */
 QThreadPoolPrivate:: QThreadPoolPrivate()
-    : isExiting(false),
+    : queueFrontPriority(INT_MIN),
+      isExiting(false),
       expiryTimeout(30000),
       maxThreadCount(qAbs(QThread::idealThreadCount())),
       reservedThreads(0),
       activeThreads(0)
-{ }
+{
+    spareThreadCount.store(maxThreadCount);
+}
 
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
 {
@@ -182,7 +292,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         ++activeThreads;
 
         if (task->autoDelete())
-            ++task->ref;
+            runnableRef(task).ref();
         thread->runnable = task;
         thread->start();
         return true;
@@ -201,7 +311,7 @@ inline bool operator<(const QPair<QRunnable *, int> &p, int priority)
 void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
 {
     if (runnable->autoDelete())
-        ++runnable->ref;
+        runnableRef(runnable).ref();
 
     // put it on the queue
     QList<QPair<QRunnable *, int> >::const_iterator begin = queue.constBegin();
@@ -209,6 +319,23 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     if (it != begin && priority > (*(it - 1)).second)
         it = std::upper_bound(begin, --it, priority);
     queue.insert(it - begin, qMakePair(runnable, priority));
+    updateQueueHint();
+}
+
+QRunnable *QThreadPoolPrivate::dequeueTask()
+{
+    QRunnable *runnable = queue.takeFirst().first;
+    updateQueueHint();
+    return runnable;
+}
+
+/*
+    Publishes the priority of the first queued runnable, or INT_MIN if the
+    queue is empty, so that pool threads can check the queue without locking.
+*/
+void QThreadPoolPrivate::updateQueueHint()
+{
+    queueFrontPriority.storeRelease(queue.isEmpty() ? INT_MIN : queue.first().second);
 }
 
 int QThreadPoolPrivate::activeThreadCount() const
@@ -219,11 +346,116 @@ int QThreadPoolPrivate::activeThreadCount() const
             + reservedThreads);
 }
 
+/*
+    Publishes how many more threads may become active. Must be called
+    whenever the result of activeThreadCount() or maxThreadCount changes.
+*/
+void QThreadPoolPrivate::updateSpareThreadCount()
+{
+    // read-modify-write for a full barrier, pairs with enqueueLocalTask()
+    spareThreadCount.fetchAndStoreOrdered(maxThreadCount - activeThreadCount());
+}
+
+/*
+    Called from QThreadPool::start() for runnables of the default priority.
+    If the calling thread is one of our pool threads, \a runnable is pushed
+    on that thread's local queue without taking the mutex; other threads
+    steal from it when they run out of work.
+*/
+bool QThreadPoolPrivate::enqueueLocalTask(QRunnable *runnable)
+{
+    const Qt::HANDLE self = QThread::currentThreadId();
+    // reset() doesn't delete the threads while a walk is counted; it clears
+    // workers first, so walks counted after that don't find them anymore
+    workerWalks.fetchAndAddOrdered(1);
+    QThreadPoolThread *thread = workers.loadAcquire();
+    while (thread && thread->threadId.load() != self)
+        thread = thread->nextWorker;
+    workerWalks.fetchAndAddRelease(-1);
+    // a thread found here is the calling one, which stays alive
+    if (!thread)
+        return false;
+
+    const bool autoDelete = runnable->autoDelete();
+    if (autoDelete)
+        runnableRef(runnable).ref();
+    if (!thread->localQueue.push(runnable)) {
+        if (autoDelete)
+            runnableRef(runnable).deref();
+        return false;
+    }
+
+    // make sure a thread is around to steal it if we are below the limit
+    if (spareThreadCount.fetchAndAddOrdered(0) > 0) {
+        QMutexLocker locker(&mutex);
+        tryToStartMoreThreads();
+    }
+    return true;
+}
+
+/*
+    Returns the next runnable for \a thread without taking the mutex, or 0
+    if none was found. Queued runnables with a priority of 0 or higher go
+    before the thread-local ones, then the thread's own queue is drained,
+    then other threads' queues are stolen from. The caller checks the
+    queue again with the mutex held before going idle.
+*/
+QRunnable *QThreadPoolPrivate::takeTask(QThreadPoolThread *thread)
+{
+    if (queueFrontPriority.loadAcquire() >= 0) {
+        QMutexLocker locker(&mutex);
+        if (!queue.isEmpty())
+            return dequeueTask();
+    }
+
+    if (QRunnable *runnable = thread->localQueue.take())
+        return runnable;
+
+    for (QThreadPoolThread *victim = workers.loadAcquire(); victim; victim = victim->nextWorker) {
+        if (victim == thread)
+            continue;
+        if (QRunnable *runnable = victim->localQueue.take())
+            return runnable;
+    }
+    return 0;
+}
+
+/*
+    Moves what is left in the local queue of an exiting \a thread to the
+    pool queue. Must be called with the mutex held.
+*/
+void QThreadPoolPrivate::requeueLocalTasks(QThreadPoolThread *thread)
+{
+    while (QRunnable *runnable = thread->localQueue.take()) {
+        enqueueTask(runnable);
+        if (runnable->autoDelete())
+            runnableRef(runnable).deref(); // enqueueTask() took its own reference
+    }
+}
+
+/*
+    Must be called with the mutex held.
+*/
+bool QThreadPoolPrivate::hasLocalTasks()
+{
+    for (QThreadPoolThread *thread = workers.loadAcquire(); thread; thread = thread->nextWorker) {
+        if (thread->localQueue.mayHaveTasks())
+            return true;
+    }
+    return false;
+}
+
 void QThreadPoolPrivate::tryToStartMoreThreads()
 {
     // try to push tasks on the queue to any available threads
     while (!queue.isEmpty() && tryStart(queue.first().first))
         queue.removeFirst();
+    updateQueueHint();
+
+    // and get another thread stealing from the local queues
+    if (activeThreadCount() < maxThreadCount && hasLocalTasks())
+        startThreadForLocalTask();
+    updateSpareThreadCount();
 }
 
 bool QThreadPoolPrivate::tooManyThreadsActive() const
@@ -242,12 +474,34 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
     allThreads.insert(thread.data());
     ++activeThreads;
 
-    if (runnable->autoDelete())
-        ++runnable->ref;
+    // publish it to the threads stealing from the local queues
+    thread->nextWorker = workers.load();
+    workers.storeRelease(thread.data());
+
+    if (runnable && runnable->autoDelete())
+        runnableRef(runnable).ref();
     thread->runnable = runnable;
     thread.take()->start();
 }
 
+/*!
+    \internal
+    Wakes up, restarts or starts a thread without a runnable of its own.
+*/
+void QThreadPoolPrivate::startThreadForLocalTask()
+{
+    if (!waitingThreads.isEmpty()) {
+        waitingThreads.takeFirst()->runnableReady.wakeOne();
+    } else if (!expiredThreads.isEmpty()) {
+        QThreadPoolThread *thread = expiredThreads.dequeue();
+        Q_ASSERT(thread->runnable == 0);
+        ++activeThreads;
+        thread->start();
+    } else {
+        startThread();
+    }
+}
+
 /*!
     \internal
     Makes all threads exit, waits for each thread to exit and deletes it.
@@ -261,21 +515,28 @@ void QThreadPoolPrivate::reset()
         // move the contents of the set out so that we can iterate without the lock
         QSet<QThreadPoolThread *> allThreadsCopy;
         allThreadsCopy.swap(allThreads);
+        // start() must not recycle the threads while they are deleted
+        waitingThreads.clear();
+        expiredThreads.clear();
+        updateSpareThreadCount();
+        // full barrier, pairs with enqueueLocalTask()
+        workers.fetchAndStoreOrdered(0);
         locker.unlock();
 
         foreach (QThreadPoolThread *thread, allThreadsCopy) {
             thread->runnableReady.wakeAll();
             thread->wait();
-            delete thread;
         }
+        // only delete them once none of them can be stealing from the
+        // others, and no start() from outside the pool is looking at them
+        while (workerWalks.loadAcquire() != 0)
+            QThread::yieldCurrentThread();
+        qDeleteAll(allThreadsCopy);
 
         locker.relock();
         // repeat until all newly arrived threads have also completed
     }
 
-    waitingThreads.clear();
-    expiredThreads.clear();
-
     isExiting = false;
 }
 
@@ -302,10 +563,18 @@ void QThreadPoolPrivate::clear()
     for (QList<QPair<QRunnable *, int> >::const_iterator it = queue.constBegin();
          it != queue.constEnd(); ++it) {
         QRunnable* r = it->first;
-        if (r->autoDelete() && !--r->ref)
+        if (r->autoDelete() && !runnableRef(r).deref())
             delete r;
     }
     queue.clear();
+    updateQueueHint();
+
+    for (QThreadPoolThread *thread = workers.loadAcquire(); thread; thread = thread->nextWorker) {
+        while (QRunnable *r = thread->localQueue.take()) {
+            if (r->autoDelete() && !runnableRef(r).deref())
+                delete r;
+        }
+    }
 }
 
 /*!
@@ -328,17 +597,21 @@ void QThreadPoolPrivate::stealRunnable(QRunnable *runnable)
             if (it->first == runnable) {
                 found = true;
                 queue.erase(it);
+                updateQueueHint();
                 break;
             }
             ++it;
         }
+
+        for (QThreadPoolThread *thread = workers.loadAcquire(); thread && !found; thread = thread->nextWorker)
+            found = thread->localQueue.remove(runnable);
     }
 
     if (!found)
         return;
 
     const bool autoDelete = runnable->autoDelete();
-    bool del = autoDelete && !--runnable->ref;
+    bool del = autoDelete && !runnableRef(runnable).deref();
 
     runnable->run();
 
@@ -430,6 +703,11 @@ QThreadPool *QThreadPool::globalInstance()
     \a runnable is added to a run queue instead. The \a priority argument can
     be used to control the run queue's order of execution.
 
+    When called from one of the pool's own threads with the default
+    \a priority, \a runnable is queued on that thread instead, and idle
+    threads take it from there. Such runnables are run after queued
+    runnables with a priority of 0 or higher.
+
     Note that the thread pool takes ownership of the \a runnable if
     \l{QRunnable::autoDelete()}{runnable->autoDelete()} returns \c true,
     and the \a runnable will be deleted automatically by the thread
@@ -445,6 +723,9 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (priority == 0 && d->enqueueLocalTask(runnable))
+        return;
+
     QMutexLocker locker(&d->mutex);
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
@@ -452,6 +733,7 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         if (!d->waitingThreads.isEmpty())
             d->waitingThreads.takeFirst()->runnableReady.wakeOne();
     }
+    d->updateSpareThreadCount();
 }
 
 /*!
@@ -482,7 +764,9 @@ bool QThreadPool::tryStart(QRunnable *runnable)
     if (d->allThreads.isEmpty() == false && d->activeThreadCount() >= d->maxThreadCount)
         return false;
 
-    return d->tryStart(runnable);
+    const bool started = d->tryStart(runnable);
+    d->updateSpareThreadCount();
+    return started;
 }
 
 /*! \property QThreadPool::expiryTimeout
@@ -576,6 +860,7 @@ void QThreadPool::reserveThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     ++d->reservedThreads;
+    d->updateSpareThreadCount();
 }
 
 /*!
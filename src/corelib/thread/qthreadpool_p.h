@@ -50,6 +50,7 @@
 #include "QtCore/qwaitcondition.h"
 #include "QtCore/qset.h"
 #include "QtCore/qqueue.h"
+#include "QtCore/qatomic.h"
 #include "private/qobject_p.h"
 
 #ifndef QT_NO_THREAD
@@ -67,17 +68,34 @@ public:
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
+    QRunnable *dequeueTask();
+    void updateQueueHint();
     int activeThreadCount() const;
+    void updateSpareThreadCount();
+
+    bool enqueueLocalTask(QRunnable *task);
+    QRunnable *takeTask(QThreadPoolThread *thread);
+    void requeueLocalTasks(QThreadPoolThread *thread);
+    bool hasLocalTasks();
 
     void tryToStartMoreThreads();
     bool tooManyThreadsActive() const;
 
     void startThread(QRunnable *runnable = 0);
+    void startThreadForLocalTask();
     void reset();
     bool waitForDone(int msecs);
     void clear();
     void stealRunnable(QRunnable *);
 
+    // QRunnable::ref is a plain int in the public API, but the pool threads
+    // count references without holding the mutex
+    static QBasicAtomicInt &runnableRef(QRunnable *runnable)
+    {
+        Q_STATIC_ASSERT(sizeof(QBasicAtomicInt) == sizeof(int));
+        return *reinterpret_cast<QBasicAtomicInt *>(&runnable->ref);
+    }
+
     mutable QMutex mutex;
     QSet<QThreadPoolThread *> allThreads;
     QQueue<QThreadPoolThread *> waitingThreads;
@@ -85,6 +103,12 @@ public:
     QList<QPair<QRunnable *, int> > queue;
     QWaitCondition noActiveThreads;
 
+    // read without holding the mutex by the pool threads
+    QAtomicPointer<QThreadPoolThread> workers;
+    QAtomicInt workerWalks; // start() calls that may still look at workers
+    QAtomicInt spareThreadCount;
+    QAtomicInt queueFrontPriority;
+
     bool isExiting;
     int expiryTimeout;
     int maxThreadCount;
@@ -185,20 +185,20 @@ bool QWaitCondition::wait(QMutex *mutex, unsigned long time)
 
 bool QWaitCondition::wait(QReadWriteLock *readWriteLock, unsigned long time)
 {
-    if (!readWriteLock || readWriteLock->d->accessCount == 0)
+    if (!readWriteLock || !readWriteLock->d->isLocked())
         return false;
-    if (readWriteLock->d->accessCount < -1) {
+    if (readWriteLock->d->writerRecursion > 0) {
         qWarning("QWaitCondition: cannot wait on QReadWriteLocks with recursive lockForWrite()");
         return false;
     }
 
     QWaitConditionEvent *wce = d->pre();
-    int previousAccessCount = readWriteLock->d->accessCount;
+    const bool wasLockedForWrite = readWriteLock->d->isLockedForWrite();
     readWriteLock->unlock();
 
     bool returnValue = d->wait(wce, time);
 
-    if (previousAccessCount < 0)
+    if (wasLockedForWrite)
         readWriteLock->lockForWrite();
     else
         readWriteLock->lockForRead();
@@ -0,0 +1,677 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qbytearrayview.h"
+#include "qhash.h"
+#include "qvarlengtharray.h"
+#include "private/qlocale_p.h"
+
+#include <stdlib.h>
+
+QT_BEGIN_NAMESPACE
+
+int qFindByteArray(
+    const char *haystack0, int haystackLen, int from,
+    const char *needle0, int needleLen);
+
+/*!
+    \class QByteArrayView
+    \inmodule QtCore
+    \since 5.5
+    \brief The QByteArrayView class provides a read-only view on a range of bytes.
+
+    \ingroup tools
+    \ingroup shared
+    \ingroup string-processing
+
+    \reentrant
+
+    QByteArrayView refers to a contiguous range of bytes owned by someone
+    else, typically a QByteArray or a buffer that a parser is working
+    on. It consists of nothing but a pointer and a size, so it is cheap
+    to create and to pass by value, and its functions that return a part
+    of the view, such as left(), mid() and trimmed(), never copy the
+    data.
+
+    This makes QByteArrayView suitable for splitting and inspecting
+    protocol data: a parser can cut a header line into its components,
+    compare them and convert numbers with toInt() and friends without
+    creating a QByteArray for every piece. Call toByteArray() for the
+    pieces that need to be kept.
+
+    \snippet code/src_corelib_tools_qbytearrayview.cpp 0
+
+    The view does not keep the data alive. It is the caller's
+    responsibility to ensure that the data outlives the view, and that a
+    QByteArray a view refers to is not modified while the view is used.
+
+    Unlike QByteArray, the data of a view is not guaranteed to be
+    '\\0'-terminated.
+
+    \sa QByteArray, QLatin1String, QStringRef
+*/
+
+/*!
+    \typedef QByteArrayView::const_iterator
+
+    This typedef provides an STL-style const iterator for QByteArrayView.
+*/
+
+/*!
+    \typedef QByteArrayView::iterator
+
+    Same as const_iterator; the view is read-only.
+*/
+
+/*!
+    \fn QByteArrayView::QByteArrayView()
+
+    Constructs a null view.
+
+    \sa isNull()
+*/
+
+/*!
+    \fn QByteArrayView::QByteArrayView(const char *data, int size)
+
+    Constructs a view on the \a size bytes starting at \a data.
+*/
+
+/*!
+    \fn QByteArrayView::QByteArrayView(const char *str)
+
+    Constructs a view on the '\\0'-terminated string \a str, not
+    including the terminator. If \a str is 0, the view is null.
+*/
+
+/*!
+    \fn QByteArrayView::QByteArrayView(const QByteArray &ba)
+
+    Constructs a view on the contents of \a ba. The view is null if \a
+    ba is null.
+*/
+
+/*!
+    \fn const char *QByteArrayView::data() const
+
+    Returns a pointer to the first byte of the view.
+
+    \sa constData(), size()
+*/
+
+/*!
+    \fn const char *QByteArrayView::constData() const
+
+    Same as data().
+*/
+
+/*!
+    \fn int QByteArrayView::size() const
+
+    Returns the number of bytes in the view.
+*/
+
+/*!
+    \fn int QByteArrayView::length() const
+
+    Same as size().
+*/
+
+/*!
+    \fn bool QByteArrayView::isNull() const
+
+    Returns \c true if the view does not refer to any data.
+*/
+
+/*!
+    \fn bool QByteArrayView::isEmpty() const
+
+    Returns \c true if the view has size 0.
+*/
+
+/*!
+    \fn char QByteArrayView::at(int i) const
+
+    Returns the byte at index position \a i, which must be a valid index
+    position in the view.
+*/
+
+/*!
+    \fn char QByteArrayView::operator[](int i) const
+
+    Same as at(\a i).
+*/
+
+/*!
+    \fn char QByteArrayView::front() const
+
+    Returns the first byte of the view, which must not be empty.
+*/
+
+/*!
+    \fn char QByteArrayView::back() const
+
+    Returns the last byte of the view, which must not be empty.
+*/
+
+/*!
+    \fn QByteArrayView::const_iterator QByteArrayView::begin() const
+
+    Returns an STL-style iterator pointing to the first byte of the view.
+*/
+
+/*!
+    \fn QByteArrayView::const_iterator QByteArrayView::cbegin() const
+
+    Same as begin().
+*/
+
+/*!
+    \fn QByteArrayView::const_iterator QByteArrayView::constBegin() const
+
+    Same as begin().
+*/
+
+/*!
+    \fn QByteArrayView::const_iterator QByteArrayView::end() const
+
+    Returns an STL-style iterator pointing just after the last byte of
+    the view.
+*/
+
+/*!
+    \fn QByteArrayView::const_iterator QByteArrayView::cend() const
+
+    Same as end().
+*/
+
+/*!
+    \fn QByteArrayView::const_iterator QByteArrayView::constEnd() const
+
+    Same as end().
+*/
+
+/*!
+    Returns a view on the first \a n bytes of this view.
+
+    The entire view is returned if \a n is greater than size(); an
+    empty view is returned if \a n is negative.
+
+    \sa right(), mid(), QByteArray::left()
+*/
+QByteArrayView QByteArrayView::left(int n) const
+{
+    if (n >= m_size)
+        return *this;
+    return QByteArrayView(m_data, qMax(n, 0));
+}
+
+/*!
+    Returns a view on the last \a n bytes of this view.
+
+    The entire view is returned if \a n is greater than size(); an
+    empty view is returned if \a n is negative.
+
+    \sa left(), mid(), QByteArray::right()
+*/
+QByteArrayView QByteArrayView::right(int n) const
+{
+    if (n >= m_size)
+        return *this;
+    if (n < 0)
+        n = 0;
+    return QByteArrayView(m_data + m_size - n, n);
+}
+
+/*!
+    Returns a view on \a len bytes of this view, starting at position
+    \a pos. The positions are interpreted as by QByteArray::mid(): if \a
+    len is -1 or goes past the end, all bytes from \a pos onwards are
+    returned, and a null view is returned if \a pos is past the end.
+
+    \sa left(), right()
+*/
+QByteArrayView QByteArrayView::mid(int pos, int len) const
+{
+    using namespace QtPrivate;
+    switch (QContainerImplHelper::mid(m_size, &pos, &len)) {
+    case QContainerImplHelper::Null:
+        return QByteArrayView();
+    case QContainerImplHelper::Empty:
+        return QByteArrayView(m_data + m_size, 0);
+    case QContainerImplHelper::Full:
+        return *this;
+    case QContainerImplHelper::Subset:
+        return QByteArrayView(m_data + pos, len);
+    }
+    Q_UNREACHABLE();
+    return QByteArrayView();
+}
+
+static inline bool isSpace(char c)
+{
+    // same set as QByteArray::trimmed()
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/*!
+    Returns a view with the whitespace at the start and the end of this
+    view removed. Whitespace means the same characters as for
+    QByteArray::trimmed().
+*/
+QByteArrayView QByteArrayView::trimmed() const
+{
+    const char *begin = m_data;
+    const char *end = m_data + m_size;
+    while (begin < end && isSpace(*begin))
+        ++begin;
+    while (begin < end && isSpace(end[-1]))
+        --end;
+    return QByteArrayView(begin, int(end - begin));
+}
+
+/*!
+    \fn void QByteArrayView::truncate(int pos)
+
+    Shortens the view to the first \a pos bytes. Nothing happens if \a
+    pos is not less than size().
+
+    \sa chop()
+*/
+
+/*!
+    \fn void QByteArrayView::chop(int n)
+
+    Removes \a n bytes from the end of the view.
+
+    \sa truncate()
+*/
+
+/*!
+    Returns the index position of the first occurrence of the byte \a c
+    in this view, searching forward from index position \a from, or -1
+    if \a c could not be found.
+*/
+int QByteArrayView::indexOf(char c, int from) const
+{
+    if (from < 0)
+        from = qMax(from + m_size, 0);
+    if (from >= m_size)
+        return -1;
+    const void *found = memchr(m_data + from, uchar(c), m_size - from);
+    return found ? int(static_cast<const char *>(found) - m_data) : -1;
+}
+
+/*!
+    \overload
+
+    Returns the index position of the first occurrence of \a a in this
+    view, searching forward from index position \a from, or -1 if \a a
+    could not be found.
+*/
+int QByteArrayView::indexOf(QByteArrayView a, int from) const
+{
+    if (a.m_size == 0)
+        return from;
+    if (a.m_size == 1)
+        return indexOf(*a.m_data, from);
+    if (from < 0)
+        from = qMax(from + m_size, 0);
+    if (from > m_size || a.m_size + from > m_size)
+        return -1;
+    return qFindByteArray(m_data, m_size, from, a.m_data, a.m_size);
+}
+
+/*!
+    Returns the index position of the last occurrence of the byte \a c
+    in this view, searching backward from index position \a from, or -1
+    if \a c could not be found. If \a from is -1, the search starts at
+    the last byte.
+*/
+int QByteArrayView::lastIndexOf(char c, int from) const
+{
+    if (from < 0)
+        from += m_size;
+    else if (from >= m_size)
+        from = m_size - 1;
+    for (int i = from; i >= 0; --i) {
+        if (m_data[i] == c)
+            return i;
+    }
+    return -1;
+}
+
+/*!
+    \overload
+
+    Returns the index position of the last occurrence of \a a in this
+    view, searching backward from index position \a from, or -1 if \a a
+    could not be found.
+*/
+int QByteArrayView::lastIndexOf(QByteArrayView a, int from) const
+{
+    if (a.m_size == 1)
+        return lastIndexOf(*a.m_data, from);
+    const int delta = m_size - a.m_size;
+    if (from < 0)
+        from = delta;
+    if (from < 0 || from > m_size)
+        return -1;
+    if (from > delta)
+        from = delta;
+    for (int i = from; i >= 0; --i) {
+        if (memcmp(m_data + i, a.m_data, a.m_size) == 0)
+            return i;
+    }
+    return -1;
+}
+
+/*!
+    \fn bool QByteArrayView::contains(char c) const
+
+    Returns \c true if the view contains the byte \a c.
+*/
+
+/*!
+    \fn bool QByteArrayView::contains(QByteArrayView a) const
+    \overload
+
+    Returns \c true if the view contains \a a.
+*/
+
+/*!
+    Returns the number of occurrences of the byte \a c in the view.
+*/
+int QByteArrayView::count(char c) const
+{
+    int n = 0;
+    for (const char *p = m_data, *e = m_data + m_size; p != e; ++p) {
+        if (*p == c)
+            ++n;
+    }
+    return n;
+}
+
+/*!
+    \fn bool QByteArrayView::startsWith(char c) const
+
+    Returns \c true if the view starts with the byte \a c.
+*/
+
+/*!
+    \fn bool QByteArrayView::startsWith(QByteArrayView a) const
+    \overload
+
+    Returns \c true if the view starts with \a a.
+*/
+
+/*!
+    \fn bool QByteArrayView::endsWith(char c) const
+
+    Returns \c true if the view ends with the byte \a c.
+*/
+
+/*!
+    \fn bool QByteArrayView::endsWith(QByteArrayView a) const
+    \overload
+
+    Returns \c true if the view ends with \a a.
+*/
+
+static inline uchar foldCase(uchar c)
+{
+    // Latin-1 lowercasing, as done by qstricmp()
+    if ((c >= 'A' && c <= 'Z') || (c >= 0xc0 && c <= 0xde && c != 0xd7))
+        return c + 0x20;
+    return c;
+}
+
+/*!
+    Compares this view with \a other and returns an integer less than,
+    equal to, or greater than zero if this view is less than, equal to,
+    or greater than \a other.
+
+    If \a cs is Qt::CaseInsensitive, the bytes are compared as Latin-1
+    characters ignoring their case, like qstricmp() does. Unlike
+    qstricmp(), the comparison does not stop at '\\0' bytes.
+*/
+int QByteArrayView::compare(QByteArrayView other, Qt::CaseSensitivity cs) const
+{
+    const int n = qMin(m_size, other.m_size);
+    if (cs == Qt::CaseSensitive) {
+        const int r = n ? memcmp(m_data, other.m_data, n) : 0;
+        if (r)
+            return r;
+    } else {
+        const uchar *s1 = reinterpret_cast<const uchar *>(m_data);
+        const uchar *s2 = reinterpret_cast<const uchar *>(other.m_data);
+        for (int i = 0; i < n; ++i) {
+            const int r = foldCase(s1[i]) - foldCase(s2[i]);
+            if (r)
+                return r;
+        }
+    }
+    return m_size - other.m_size;
+}
+
+static qlonglong toIntegral_helper(const char *data, bool *ok, int base, qlonglong)
+{
+    return QLocaleData::bytearrayToLongLong(data, base, ok);
+}
+
+static qulonglong toIntegral_helper(const char *data, bool *ok, int base, qulonglong)
+{
+    return QLocaleData::bytearrayToUnsLongLong(data, base, ok);
+}
+
+template <typename T> static inline
+T toIntegral_helper(const char *data, int size, bool *ok, int base)
+{
+    const bool isUnsigned = T(0) < T(-1);
+    typedef typename QtPrivate::QConditional<isUnsigned, qulonglong, qlonglong>::Type Int64;
+
+#if defined(QT_CHECK_RANGE)
+    if (base != 0 && (base < 2 || base > 36)) {
+        qWarning("QByteArrayView::toIntegral: Invalid base %d", base);
+        base = 10;
+    }
+#endif
+
+    // The conversion functions work on '\0'-terminated strings; numbers
+    // in protocol data are short enough to be copied to the stack.
+    QVarLengthArray<char, 64> buffer(size + 1);
+    memcpy(buffer.data(), data, size);
+    buffer[size] = '\0';
+
+    // we select the right overload by the last, unused parameter
+    Int64 val = toIntegral_helper(buffer.constData(), ok, base, Int64());
+    if (T(val) != val) {
+        if (ok)
+            *ok = false;
+        val = 0;
+    }
+    return T(val);
+}
+
+/*!
+    Returns the view converted to a \c short using base \a base. The
+    conversion follows the same rules as QByteArray::toShort(), and the
+    data does not need to be '\\0'-terminated.
+
+    If \a ok is not 0, failure is reported by setting *\a{ok} to
+    \c false, and success by setting *\a{ok} to \c true.
+*/
+short QByteArrayView::toShort(bool *ok, int base) const
+{
+    return toIntegral_helper<short>(m_data, m_size, ok, base);
+}
+
+/*!
+    Returns the view converted to an \c{unsigned short} using base \a
+    base, following the same rules as QByteArray::toUShort().
+
+    \sa toShort()
+*/
+ushort QByteArrayView::toUShort(bool *ok, int base) const
+{
+    return toIntegral_helper<ushort>(m_data, m_size, ok, base);
+}
+
+/*!
+    Returns the view converted to an \c int using base \a base,
+    following the same rules as QByteArray::toInt().
+
+    \sa toShort()
+*/
+int QByteArrayView::toInt(bool *ok, int base) const
+{
+    return toIntegral_helper<int>(m_data, m_size, ok, base);
+}
+
+/*!
+    Returns the view converted to an \c{unsigned int} using base \a
+    base, following the same rules as QByteArray::toUInt().
+
+    \sa toShort()
+*/
+uint QByteArrayView::toUInt(bool *ok, int base) const
+{
+    return toIntegral_helper<uint>(m_data, m_size, ok, base);
+}
+
+/*!
+    Returns the view converted to a \c long using base \a base,
+    following the same rules as QByteArray::toLong().
+
+    \sa toShort()
+*/
+long QByteArrayView::toLong(bool *ok, int base) const
+{
+    return toIntegral_helper<long>(m_data, m_size, ok, base);
+}
+
+/*!
+    Returns the view converted to an \c{unsigned long} using base \a
+    base, following the same rules as QByteArray::toULong().
+
+    \sa toShort()
+*/
+ulong QByteArrayView::toULong(bool *ok, int base) const
+{
+    return toIntegral_helper<ulong>(m_data, m_size, ok, base);
+}
+
+/*!
+    Returns the view converted to a \c{long long} using base \a base,
+    following the same rules as QByteArray::toLongLong().
+
+    \sa toShort()
+*/
+qlonglong QByteArrayView::toLongLong(bool *ok, int base) const
+{
+    return toIntegral_helper<qlonglong>(m_data, m_size, ok, base);
+}
+
+/*!
+    Returns the view converted to an \c{unsigned long long} using base
+    \a base, following the same rules as QByteArray::toULongLong().
+
+    \sa toShort()
+*/
+qulonglong QByteArrayView::toULongLong(bool *ok, int base) const
+{
+    return toIntegral_helper<qulonglong>(m_data, m_size, ok, base);
+}
+
+/*!
+    \fn QByteArray QByteArrayView::toByteArray() const
+
+    Returns a deep copy of the viewed data as a QByteArray.
+*/
+
+/*!
+    \relates QByteArrayView
+
+    Returns the hash value for the \a key, using \a seed to seed the
+    calculation. Equal to qHash() of a QByteArray with the same
+    contents.
+*/
+uint qHash(QByteArrayView key, uint seed) Q_DECL_NOTHROW
+{
+    return qHashBits(key.data(), size_t(key.size()), seed);
+}
+
+/*!
+    \fn bool operator==(QByteArrayView lhs, QByteArrayView rhs)
+    \relates QByteArrayView
+
+    Returns \c true if \a lhs and \a rhs contain the same bytes.
+*/
+
+/*!
+    \fn bool operator!=(QByteArrayView lhs, QByteArrayView rhs)
+    \relates QByteArrayView
+
+    Returns \c true if \a lhs and \a rhs differ.
+*/
+
+/*!
+    \fn bool operator<(QByteArrayView lhs, QByteArrayView rhs)
+    \relates QByteArrayView
+
+    Returns \c true if \a lhs is lexically less than \a rhs.
+*/
+
+/*!
+    \fn bool operator<=(QByteArrayView lhs, QByteArrayView rhs)
+    \relates QByteArrayView
+
+    Returns \c true if \a lhs is lexically less than or equal to \a rhs.
+*/
+
+/*!
+    \fn bool operator>(QByteArrayView lhs, QByteArrayView rhs)
+    \relates QByteArrayView
+
+    Returns \c true if \a lhs is lexically greater than \a rhs.
+*/
+
+/*!
+    \fn bool operator>=(QByteArrayView lhs, QByteArrayView rhs)
+    \relates QByteArrayView
+
+    Returns \c true if \a lhs is lexically greater than or equal to \a
+    rhs.
+*/
+
+QT_END_NAMESPACE
@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBYTEARRAYVIEW_H
+#define QBYTEARRAYVIEW_H
+
+#include <QtCore/qbytearray.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class Q_CORE_EXPORT QByteArrayView
+{
+public:
+    typedef const char *const_iterator;
+    typedef const_iterator iterator;
+
+    Q_DECL_CONSTEXPR inline QByteArrayView() : m_data(0), m_size(0) {}
+    Q_DECL_CONSTEXPR inline QByteArrayView(const char *data, int size) : m_data(data), m_size(size) {}
+    inline QByteArrayView(const char *str) : m_data(str), m_size(str ? int(strlen(str)) : 0) {}
+    inline QByteArrayView(const QByteArray &ba) : m_data(ba.isNull() ? 0 : ba.constData()), m_size(ba.size()) {}
+
+    inline const char *data() const { return m_data; }
+    inline const char *constData() const { return m_data; }
+    inline int size() const { return m_size; }
+    inline int length() const { return m_size; }
+    inline bool isNull() const { return !m_data; }
+    inline bool isEmpty() const { return !m_size; }
+
+    inline char at(int i) const
+    { Q_ASSERT(uint(i) < uint(m_size)); return m_data[i]; }
+    inline char operator[](int i) const { return at(i); }
+    inline char front() const { return at(0); }
+    inline char back() const { return at(m_size - 1); }
+
+    inline const_iterator begin() const { return m_data; }
+    inline const_iterator cbegin() const { return m_data; }
+    inline const_iterator constBegin() const { return m_data; }
+    inline const_iterator end() const { return m_data + m_size; }
+    inline const_iterator cend() const { return m_data + m_size; }
+    inline const_iterator constEnd() const { return m_data + m_size; }
+
+    QByteArrayView left(int n) const Q_REQUIRED_RESULT;
+    QByteArrayView right(int n) const Q_REQUIRED_RESULT;
+    QByteArrayView mid(int pos, int len = -1) const Q_REQUIRED_RESULT;
+    QByteArrayView trimmed() const Q_REQUIRED_RESULT;
+    inline void truncate(int pos) { if (pos < m_size) m_size = qMax(pos, 0); }
+    inline void chop(int n) { if (n > 0) m_size = qMax(m_size - n, 0); }
+
+    int indexOf(char c, int from = 0) const;
+    int indexOf(QByteArrayView a, int from = 0) const;
+    int lastIndexOf(char c, int from = -1) const;
+    int lastIndexOf(QByteArrayView a, int from = -1) const;
+    inline bool contains(char c) const { return indexOf(c) != -1; }
+    inline bool contains(QByteArrayView a) const { return indexOf(a) != -1; }
+    int count(char c) const;
+
+    inline bool startsWith(char c) const { return m_size && m_data[0] == c; }
+    inline bool startsWith(QByteArrayView a) const
+    { return a.m_size <= m_size && memcmp(m_data, a.m_data, a.m_size) == 0; }
+    inline bool endsWith(char c) const { return m_size && m_data[m_size - 1] == c; }
+    inline bool endsWith(QByteArrayView a) const
+    { return a.m_size <= m_size && memcmp(m_data + m_size - a.m_size, a.m_data, a.m_size) == 0; }
+
+    int compare(QByteArrayView other, Qt::CaseSensitivity cs = Qt::CaseSensitive) const;
+
+    short toShort(bool *ok = 0, int base = 10) const;
+    ushort toUShort(bool *ok = 0, int base = 10) const;
+    int toInt(bool *ok = 0, int base = 10) const;
+    uint toUInt(bool *ok = 0, int base = 10) const;
+    long toLong(bool *ok = 0, int base = 10) const;
+    ulong toULong(bool *ok = 0, int base = 10) const;
+    qlonglong toLongLong(bool *ok = 0, int base = 10) const;
+    qulonglong toULongLong(bool *ok = 0, int base = 10) const;
+
+    inline QByteArray toByteArray() const
+    { return m_data ? QByteArray(m_data, m_size) : QByteArray(); }
+
+private:
+    const char *m_data;
+    int m_size;
+};
+Q_DECLARE_TYPEINFO(QByteArrayView, Q_PRIMITIVE_TYPE);
+
+inline bool operator==(QByteArrayView lhs, QByteArrayView rhs)
+{ return lhs.size() == rhs.size() && memcmp(lhs.data(), rhs.data(), lhs.size()) == 0; }
+inline bool operator!=(QByteArrayView lhs, QByteArrayView rhs)
+{ return !(lhs == rhs); }
+inline bool operator<(QByteArrayView lhs, QByteArrayView rhs)
+{ return lhs.compare(rhs) < 0; }
+inline bool operator<=(QByteArrayView lhs, QByteArrayView rhs)
+{ return lhs.compare(rhs) <= 0; }
+inline bool operator>(QByteArrayView lhs, QByteArrayView rhs)
+{ return lhs.compare(rhs) > 0; }
+inline bool operator>=(QByteArrayView lhs, QByteArrayView rhs)
+{ return lhs.compare(rhs) >= 0; }
+
+Q_CORE_EXPORT uint qHash(QByteArrayView key, uint seed = 0) Q_DECL_NOTHROW;
+
+QT_END_NAMESPACE
+
+#endif // QBYTEARRAYVIEW_H
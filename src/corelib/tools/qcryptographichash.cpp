@@ -34,6 +34,11 @@
 
 #include <qcryptographichash.h>
 #include <qiodevice.h>
+#ifndef QT_BOOTSTRAPPED
+#include <qbuffer.h>
+#include <qfiledevice.h>
+#endif
+#include <private/qsimd_p.h>
 
 #include "../../3rdparty/sha1/sha1.cpp"
 
@@ -138,6 +143,430 @@ static inline int SHA384_512AddLength(SHA512Context *context, unsigned int lengt
 
 QT_BEGIN_NAMESPACE
 
+#if !defined(QT_BOOTSTRAPPED) && !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1)
+// the round constants of SHA-224 and SHA-256, for the vectorized code below
+static const quint32 sha256RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// Copies the bytes after the last full block of message to tail and pads
+// them the way SHA-1 and SHA-2 do. Returns the size of the tail, 64 or 128.
+static inline int shaPadTail(uchar *tail, const QByteArray &message)
+{
+    const int size = message.size();
+    const int rest = size % 64;
+    const int tailSize = rest < 56 ? 64 : 128;
+    memcpy(tail, message.constData() + size - rest, rest);
+    tail[rest] = 0x80;
+    memset(tail + rest + 1, 0, tailSize - rest - 1 - 8);
+    qToBigEndian(quint64(size) << 3, tail + tailSize - 8);
+    return tailSize;
+}
+
+static inline QByteArray shaHashFromState(const quint32 *state, int hashSize)
+{
+    QByteArray result(hashSize, Qt::Uninitialized);
+    uchar *out = reinterpret_cast<uchar *>(result.data());
+    for (int i = 0; i < hashSize / 4; ++i)
+        qToBigEndian(state[i], out + 4 * i);
+    return result;
+}
+#endif
+
+#if QT_COMPILER_SUPPORTS_HERE(SHA) && !defined(QT_BOOTSTRAPPED)
+/*
+    SHA-1 and SHA-256 using the SHA extensions, selected at runtime. They hash
+    whole 64-byte blocks straight from the caller's buffer; the partial blocks
+    at either end and the padding go through the portable code above.
+*/
+static inline bool hasShaNi()
+{
+    return qCpuHasFeature(SHA);
+}
+
+// four rounds of SHA-1, with the message schedule for the rounds that follow
+template <int Quad>
+QT_FUNCTION_TARGET(SHA)
+static inline void sha1Rounds_shani(__m128i &abcd, __m128i e[2], __m128i msg[4])
+{
+    const __m128i m = msg[Quad & 3];
+    if (Quad == 0)
+        e[0] = _mm_add_epi32(e[0], m);
+    else
+        e[Quad & 1] = _mm_sha1nexte_epu32(e[Quad & 1], m);
+    e[(Quad + 1) & 1] = abcd;
+    if (Quad >= 3 && Quad <= 18)
+        msg[(Quad + 1) & 3] = _mm_sha1msg2_epu32(msg[(Quad + 1) & 3], m);
+    abcd = _mm_sha1rnds4_epu32(abcd, e[Quad & 1], Quad / 5);
+    if (Quad >= 1 && Quad <= 16)
+        msg[(Quad + 3) & 3] = _mm_sha1msg1_epu32(msg[(Quad + 3) & 3], m);
+    if (Quad >= 2 && Quad <= 17)
+        msg[(Quad + 2) & 3] = _mm_xor_si128(msg[(Quad + 2) & 3], m);
+}
+
+QT_FUNCTION_TARGET(SHA)
+static void sha1Blocks_shani(quint32 *hash, const uchar *data, qint64 blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(Q_INT64_C(0x0001020304050607), Q_INT64_C(0x08090a0b0c0d0e0f));
+    __m128i abcd = _mm_set_epi32(hash[0], hash[1], hash[2], hash[3]);
+    __m128i e0 = _mm_set_epi32(hash[4], 0, 0, 0);
+
+    for ( ; blocks; --blocks, data += 64) {
+        const __m128i abcdSaved = abcd;
+        __m128i e[2] = { e0, _mm_setzero_si128() };
+        __m128i msg[4];
+        for (int i = 0; i < 4; ++i)
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data) + i), byteSwap);
+
+        sha1Rounds_shani<0>(abcd, e, msg);  sha1Rounds_shani<1>(abcd, e, msg);
+        sha1Rounds_shani<2>(abcd, e, msg);  sha1Rounds_shani<3>(abcd, e, msg);
+        sha1Rounds_shani<4>(abcd, e, msg);  sha1Rounds_shani<5>(abcd, e, msg);
+        sha1Rounds_shani<6>(abcd, e, msg);  sha1Rounds_shani<7>(abcd, e, msg);
+        sha1Rounds_shani<8>(abcd, e, msg);  sha1Rounds_shani<9>(abcd, e, msg);
+        sha1Rounds_shani<10>(abcd, e, msg); sha1Rounds_shani<11>(abcd, e, msg);
+        sha1Rounds_shani<12>(abcd, e, msg); sha1Rounds_shani<13>(abcd, e, msg);
+        sha1Rounds_shani<14>(abcd, e, msg); sha1Rounds_shani<15>(abcd, e, msg);
+        sha1Rounds_shani<16>(abcd, e, msg); sha1Rounds_shani<17>(abcd, e, msg);
+        sha1Rounds_shani<18>(abcd, e, msg); sha1Rounds_shani<19>(abcd, e, msg);
+
+        e0 = _mm_sha1nexte_epu32(e[0], e0);
+        abcd = _mm_add_epi32(abcd, abcdSaved);
+    }
+
+    hash[0] = _mm_extract_epi32(abcd, 3);
+    hash[1] = _mm_extract_epi32(abcd, 2);
+    hash[2] = _mm_extract_epi32(abcd, 1);
+    hash[3] = _mm_extract_epi32(abcd, 0);
+    hash[4] = _mm_extract_epi32(e0, 3);
+}
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+
+// four rounds of SHA-256, computing their part of the message schedule first
+template <int Quad>
+QT_FUNCTION_TARGET(SHA)
+static inline void sha256Rounds_shani(__m128i &state0, __m128i &state1, __m128i msg[4])
+{
+    if (Quad >= 4) {
+        // W[t..t+3] from W[t-16..t-13], W[t-12..t-9], W[t-8..t-5] and W[t-4..t-1]
+        const __m128i w = _mm_add_epi32(_mm_sha256msg1_epu32(msg[Quad & 3], msg[(Quad + 1) & 3]),
+                                        _mm_alignr_epi8(msg[(Quad + 3) & 3], msg[(Quad + 2) & 3], 4));
+        msg[Quad & 3] = _mm_sha256msg2_epu32(w, msg[(Quad + 3) & 3]);
+    }
+    const __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sha256RoundConstants) + Quad);
+    const __m128i wk = _mm_add_epi32(msg[Quad & 3], k);
+    state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0e));
+}
+
+QT_FUNCTION_TARGET(SHA)
+static void sha256Blocks_shani(quint32 *hash, const uchar *data, qint64 blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(Q_INT64_C(0x0c0d0e0f08090a0b), Q_INT64_C(0x0405060700010203));
+
+    // the instructions want the state as ABEF and CDGH
+    const __m128i cdab = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash)), 0xb1);
+    const __m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash + 4)), 0x1b);
+    __m128i state0 = _mm_alignr_epi8(cdab, efgh, 8);
+    __m128i state1 = _mm_blend_epi16(efgh, cdab, 0xf0);
+
+    for ( ; blocks; --blocks, data += 64) {
+        const __m128i state0Saved = state0;
+        const __m128i state1Saved = state1;
+        __m128i msg[4];
+        for (int i = 0; i < 4; ++i)
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data) + i), byteSwap);
+
+        sha256Rounds_shani<0>(state0, state1, msg);  sha256Rounds_shani<1>(state0, state1, msg);
+        sha256Rounds_shani<2>(state0, state1, msg);  sha256Rounds_shani<3>(state0, state1, msg);
+        sha256Rounds_shani<4>(state0, state1, msg);  sha256Rounds_shani<5>(state0, state1, msg);
+        sha256Rounds_shani<6>(state0, state1, msg);  sha256Rounds_shani<7>(state0, state1, msg);
+        sha256Rounds_shani<8>(state0, state1, msg);  sha256Rounds_shani<9>(state0, state1, msg);
+        sha256Rounds_shani<10>(state0, state1, msg); sha256Rounds_shani<11>(state0, state1, msg);
+        sha256Rounds_shani<12>(state0, state1, msg); sha256Rounds_shani<13>(state0, state1, msg);
+        sha256Rounds_shani<14>(state0, state1, msg); sha256Rounds_shani<15>(state0, state1, msg);
+
+        state0 = _mm_add_epi32(state0, state0Saved);
+        state1 = _mm_add_epi32(state1, state1Saved);
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(state0, 0x1b);
+    const __m128i dchg = _mm_shuffle_epi32(state1, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+#endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+#endif // QT_COMPILER_SUPPORTS_HERE(SHA)
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED) && !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1)
+/*
+    SHA-1 and SHA-256 of eight independent messages at once, one per 32-bit
+    lane of the AVX2 registers. Used by hash(QByteArrayList) when the CPU has
+    no SHA extensions: short messages are dominated by the serial dependency
+    chain of the rounds, which the lanes hide.
+*/
+static inline bool hasAvx2()
+{
+    return qCpuHasFeature(AVX2);
+}
+
+template <int Bits>
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i rol32_avx2(__m256i x)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(x, Bits), _mm256_srli_epi32(x, 32 - Bits));
+}
+
+// state[i][lane] is word i of the state of each lane, block[t][lane] is word t of its message block
+QT_FUNCTION_TARGET(AVX2)
+static void sha1Compress8_avx2(quint32 (*state)[8], const quint32 (*block)[8])
+{
+    __m256i w[16];
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[0]));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[1]));
+    __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[2]));
+    __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[3]));
+    __m256i e = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[4]));
+
+    for (int t = 0; t < 80; ++t) {
+        __m256i f, k;
+        if (t < 16) {
+            w[t] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block[t]));
+        } else {
+            w[t & 15] = rol32_avx2<1>(_mm256_xor_si256(_mm256_xor_si256(w[(t - 3) & 15], w[(t - 8) & 15]),
+                                                       _mm256_xor_si256(w[(t - 14) & 15], w[t & 15])));
+        }
+        if (t < 20) {
+            f = _mm256_xor_si256(_mm256_and_si256(b, c), _mm256_andnot_si256(b, d));
+            k = _mm256_set1_epi32(0x5a827999);
+        } else if (t < 40) {
+            f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+            k = _mm256_set1_epi32(0x6ed9eba1);
+        } else if (t < 60) {
+            f = _mm256_or_si256(_mm256_and_si256(b, c), _mm256_and_si256(_mm256_or_si256(b, c), d));
+            k = _mm256_set1_epi32(0x8f1bbcdc);
+        } else {
+            f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+            k = _mm256_set1_epi32(0xca62c1d6);
+        }
+        const __m256i temp = _mm256_add_epi32(_mm256_add_epi32(rol32_avx2<5>(a), f),
+                                              _mm256_add_epi32(_mm256_add_epi32(e, k), w[t & 15]));
+        e = d;
+        d = c;
+        c = rol32_avx2<30>(b);
+        b = a;
+        a = temp;
+    }
+
+    __m256i *s = reinterpret_cast<__m256i *>(state);
+    _mm256_storeu_si256(s + 0, _mm256_add_epi32(_mm256_loadu_si256(s + 0), a));
+    _mm256_storeu_si256(s + 1, _mm256_add_epi32(_mm256_loadu_si256(s + 1), b));
+    _mm256_storeu_si256(s + 2, _mm256_add_epi32(_mm256_loadu_si256(s + 2), c));
+    _mm256_storeu_si256(s + 3, _mm256_add_epi32(_mm256_loadu_si256(s + 3), d));
+    _mm256_storeu_si256(s + 4, _mm256_add_epi32(_mm256_loadu_si256(s + 4), e));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void sha256Compress8_avx2(quint32 (*state)[8], const quint32 (*block)[8])
+{
+    __m256i w[16];
+    __m256i v[8];
+    for (int i = 0; i < 8; ++i)
+        v[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[i]));
+    __m256i a = v[0], b = v[1], c = v[2], d = v[3], e = v[4], f = v[5], g = v[6], h = v[7];
+
+    for (int t = 0; t < 64; ++t) {
+        if (t < 16) {
+            w[t] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block[t]));
+        } else {
+            const __m256i w15 = w[(t - 15) & 15];
+            const __m256i w2 = w[(t - 2) & 15];
+            const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rol32_avx2<25>(w15), rol32_avx2<14>(w15)),
+                                                _mm256_srli_epi32(w15, 3));
+            const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rol32_avx2<15>(w2), rol32_avx2<13>(w2)),
+                                                _mm256_srli_epi32(w2, 10));
+            w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(w[t & 15], s0),
+                                         _mm256_add_epi32(w[(t - 7) & 15], s1));
+        }
+        const __m256i sigma1 = _mm256_xor_si256(_mm256_xor_si256(rol32_avx2<26>(e), rol32_avx2<21>(e)),
+                                                rol32_avx2<7>(e));
+        const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i temp1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, sigma1), ch),
+                                               _mm256_add_epi32(_mm256_set1_epi32(sha256RoundConstants[t]), w[t & 15]));
+        const __m256i sigma0 = _mm256_xor_si256(_mm256_xor_si256(rol32_avx2<30>(a), rol32_avx2<19>(a)),
+                                                rol32_avx2<10>(a));
+        const __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(_mm256_or_si256(a, b), c));
+        const __m256i temp2 = _mm256_add_epi32(sigma0, maj);
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, temp1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(temp1, temp2);
+    }
+
+    v[0] = _mm256_add_epi32(v[0], a);
+    v[1] = _mm256_add_epi32(v[1], b);
+    v[2] = _mm256_add_epi32(v[2], c);
+    v[3] = _mm256_add_epi32(v[3], d);
+    v[4] = _mm256_add_epi32(v[4], e);
+    v[5] = _mm256_add_epi32(v[5], f);
+    v[6] = _mm256_add_epi32(v[6], g);
+    v[7] = _mm256_add_epi32(v[7], h);
+    for (int i = 0; i < 8; ++i)
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(state[i]), v[i]);
+}
+
+/*
+    Hashes eight messages at a time with compress(), which runs one block of
+    each of them. Every lane takes the next message from the list as soon as it
+    is done with its current one; lanes without work hash a dummy block.
+*/
+typedef void (*MultiBufferCompressFunction)(quint32 (*state)[8], const quint32 (*block)[8]);
+
+struct MultiBufferLane
+{
+    const uchar *data;  // the next full block of the message
+    int fullBlocks;     // number of full blocks left at data
+    int tailSize;       // 64 or 128, the last bytes of the message and the padding
+    int tailOffset;     // next block in tail
+    int message;        // index of the message, -1 if the lane is idle
+    uchar tail[128];
+};
+
+static void hashMultiBuffer(const QByteArrayList &data, QByteArrayList &results,
+                            const quint32 *initialState, int stateSize, int hashSize,
+                            MultiBufferCompressFunction compress)
+{
+    const int Lanes = 8;
+    quint32 state[8][Lanes];
+    quint32 block[16][Lanes];
+    MultiBufferLane lanes[Lanes];
+    static const uchar idleBlock[64] = { 0 };
+
+    int next = 0;
+    for (int l = 0; l < Lanes; ++l)
+        lanes[l].message = -1;
+
+    for (;;) {
+        int active = 0;
+        for (int l = 0; l < Lanes; ++l) {
+            MultiBufferLane &lane = lanes[l];
+            if (lane.message < 0 && next < data.size()) {
+                const QByteArray &message = data.at(next);
+                lane.data = reinterpret_cast<const uchar *>(message.constData());
+                lane.fullBlocks = message.size() / 64;
+                lane.tailSize = shaPadTail(lane.tail, message);
+                lane.tailOffset = 0;
+                lane.message = next++;
+                for (int i = 0; i < stateSize; ++i)
+                    state[i][l] = initialState[i];
+            }
+
+            const uchar *p = idleBlock;
+            if (lane.message >= 0) {
+                ++active;
+                if (lane.fullBlocks) {
+                    p = lane.data;
+                    lane.data += 64;
+                    --lane.fullBlocks;
+                } else {
+                    p = lane.tail + lane.tailOffset;
+                    lane.tailOffset += 64;
+                }
+            }
+            for (int t = 0; t < 16; ++t)
+                block[t][l] = qFromBigEndian<quint32>(p + 4 * t);
+        }
+        if (!active)
+            break;
+
+        compress(state, block);
+
+        for (int l = 0; l < Lanes; ++l) {
+            MultiBufferLane &lane = lanes[l];
+            if (lane.message < 0 || lane.fullBlocks || lane.tailOffset < lane.tailSize)
+                continue;
+            quint32 laneState[8];
+            for (int i = 0; i < stateSize; ++i)
+                laneState[i] = state[i][l];
+            results[lane.message] = shaHashFromState(laneState, hashSize);
+            lane.message = -1;
+        }
+    }
+}
+#endif // QT_COMPILER_SUPPORTS_HERE(AVX2)
+
+static void sha1Input(Sha1State *state, const uchar *data, qint64 len)
+{
+#if QT_COMPILER_SUPPORTS_HERE(SHA) && !defined(QT_BOOTSTRAPPED)
+    if (len >= 64 && hasShaNi()) {
+        // complete the buffered block, then hash the whole blocks in place
+        quint32 hash[5] = { state->h0, state->h1, state->h2, state->h3, state->h4 };
+        const quint32 rest = quint32(state->messageSize & 63);
+        if (rest) {
+            const quint32 fill = 64 - rest;
+            memcpy(state->buffer + rest, data, fill);
+            sha1Blocks_shani(hash, state->buffer, 1);
+            state->messageSize += fill;
+            data += fill;
+            len -= fill;
+        }
+        const qint64 blocks = len / 64;
+        sha1Blocks_shani(hash, data, blocks);
+        state->h0 = hash[0];
+        state->h1 = hash[1];
+        state->h2 = hash[2];
+        state->h3 = hash[3];
+        state->h4 = hash[4];
+        state->messageSize += blocks * 64;
+        data += blocks * 64;
+        len -= blocks * 64;
+    }
+#endif
+    sha1Update(state, data, len);
+}
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+static void sha256Input(SHA256Context *context, const uchar *data, uint len)
+{
+#if QT_COMPILER_SUPPORTS_HERE(SHA) && !defined(QT_BOOTSTRAPPED)
+    if (len >= 64 && !context->Computed && !context->Corrupted && hasShaNi()) {
+        // complete the buffered block, then hash the whole blocks in place
+        uint fill = 0;
+        if (context->Message_Block_Index) {
+            fill = SHA256_Message_Block_Size - context->Message_Block_Index;
+            memcpy(context->Message_Block + context->Message_Block_Index, data, fill);
+            sha256Blocks_shani(context->Intermediate_Hash, context->Message_Block, 1);
+            context->Message_Block_Index = 0;
+        }
+        const uint blocks = (len - fill) / 64;
+        sha256Blocks_shani(context->Intermediate_Hash, data + fill, blocks);
+
+        const uint hashed = fill + blocks * 64;
+        const quint64 bits = ((quint64(context->Length_High) << 32) | context->Length_Low)
+                             + (quint64(hashed) << 3);
+        if (bits >> 32 < context->Length_High)
+            context->Corrupted = shaInputTooLong;
+        context->Length_High = quint32(bits >> 32);
+        context->Length_Low = quint32(bits);
+        data += hashed;
+        len -= hashed;
+    }
+#endif
+    SHA256Input(context, data, len);
+}
+#endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+
 class QCryptographicHashPrivate
 {
 public:
@@ -265,7 +694,7 @@ void QCryptographicHash::addData(const char *data, int length)
 {
     switch (d->method) {
     case Sha1:
-        sha1Update(&d->sha1Context, (const unsigned char *)data, length);
+        sha1Input(&d->sha1Context, (const unsigned char *)data, length);
         break;
 #ifdef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
     default:
@@ -280,10 +709,10 @@ void QCryptographicHash::addData(const char *data, int length)
         MD5Update(&d->md5Context, (const unsigned char *)data, length);
         break;
     case Sha224:
-        SHA224Input(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha256Input(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha256:
-        SHA256Input(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha256Input(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha384:
         SHA384Input(&d->sha384Context, reinterpret_cast<const unsigned char *>(data), length);
@@ -319,6 +748,10 @@ void QCryptographicHash::addData(const QByteArray &data)
 /*!
   Reads the data from the open QIODevice \a device until it ends
   and hashes it. Returns \c true if reading was successful.
+
+  Files and buffers that are not opened in text mode are hashed in place,
+  by mapping the file into memory or by using the buffer's data directly;
+  other devices are read in large chunks.
   \since 5.0
  */
 bool QCryptographicHash::addData(QIODevice* device)
@@ -329,11 +762,45 @@ bool QCryptographicHash::addData(QIODevice* device)
     if (!device->isOpen())
         return false;
 
-    char buffer[1024];
-    int length;
+#ifndef QT_BOOTSTRAPPED
+    if (!device->isTextModeEnabled()) {
+        if (QBuffer *buffer = qobject_cast<QBuffer *>(device)) {
+            const QByteArray &data = buffer->data();
+            const qint64 pos = buffer->pos();
+            if (pos < data.size()) {
+                addData(data.constData() + pos, data.size() - int(pos));
+                buffer->seek(data.size());
+            }
+        } else if (QFileDevice *file = qobject_cast<QFileDevice *>(device)) {
+            // map large files in windows, so that a 32-bit address space doesn't limit
+            // what can be hashed; whatever can't be mapped is read below
+            const qint64 MinimumMapSize = 256 * 1024;
+            const qint64 MapWindowSize = 64 * 1024 * 1024;
+            const qint64 size = file->isSequential() ? 0 : file->size();
+            qint64 pos = file->pos();
+            if (size - pos >= MinimumMapSize) {
+                while (pos < size) {
+                    const qint64 length = qMin(size - pos, MapWindowSize);
+                    uchar *mapped = file->map(pos, length);
+                    if (!mapped)
+                        break;
+                    addData(reinterpret_cast<const char *>(mapped), int(length));
+                    file->unmap(mapped);
+                    pos += length;
+                }
+                if (!file->seek(pos))
+                    return false;
+            }
+        }
+    }
+#endif
+
+    // same as QIODevice's own buffer, so that reading bypasses it
+    char buffer[16384];
+    qint64 length;
 
-    while ((length = device->read(buffer,sizeof(buffer))) > 0)
-        addData(buffer,length);
+    while ((length = device->read(buffer, sizeof(buffer))) > 0)
+        addData(buffer, int(length));
 
     return device->atEnd();
 }
@@ -438,4 +905,82 @@ QByteArray QCryptographicHash::hash(const QByteArray &data, Algorithm method)
     return hash.result();
 }
 
+/*!
+  \since 5.5
+  \overload
+
+  Returns the hashes of each of the messages in \a data using \a method,
+  in the same order.
+
+  This is faster than calling hash() for every message, especially for
+  many short messages: with SHA-1, SHA-224 and SHA-256 there is no setup
+  per message, and processors that support it hash several messages at
+  the same time.
+*/
+QByteArrayList QCryptographicHash::hash(const QByteArrayList &data, Algorithm method)
+{
+    QByteArrayList results;
+    results.reserve(data.size());
+#if (QT_COMPILER_SUPPORTS_HERE(SHA) || QT_COMPILER_SUPPORTS_HERE(AVX2)) \
+    && !defined(QT_BOOTSTRAPPED) && !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1)
+    static const quint32 sha1InitialState[5] = {
+        0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
+    };
+    const quint32 *initialState = 0;
+    int hashSize = 0;
+    if (method == Sha1) {
+        initialState = sha1InitialState;
+        hashSize = 20;
+    } else if (method == Sha224) {
+        initialState = SHA224_H0;
+        hashSize = SHA224HashSize;
+    } else if (method == Sha256) {
+        initialState = SHA256_H0;
+        hashSize = SHA256HashSize;
+    }
+    const int stateSize = method == Sha1 ? 5 : 8;
+
+#  if QT_COMPILER_SUPPORTS_HERE(SHA)
+    // with the SHA extensions, one message after the other is fastest; this
+    // skips the per-message setup and hashes the padding with them too
+    if (initialState && hasShaNi()) {
+        for (int i = 0; i < data.size(); ++i) {
+            const QByteArray &message = data.at(i);
+            quint32 state[8];
+            uchar tail[128];
+            memcpy(state, initialState, stateSize * sizeof(quint32));
+            const int tailSize = shaPadTail(tail, message);
+            const uchar *blocks = reinterpret_cast<const uchar *>(message.constData());
+            if (method == Sha1) {
+                sha1Blocks_shani(state, blocks, message.size() / 64);
+                sha1Blocks_shani(state, tail, tailSize / 64);
+            } else {
+                sha256Blocks_shani(state, blocks, message.size() / 64);
+                sha256Blocks_shani(state, tail, tailSize / 64);
+            }
+            results.append(shaHashFromState(state, hashSize));
+        }
+        return results;
+    }
+#  endif
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (initialState && data.size() > 1 && hasAvx2()) {
+        for (int i = 0; i < data.size(); ++i)
+            results.append(QByteArray());
+        hashMultiBuffer(data, results, initialState, stateSize, hashSize,
+                        method == Sha1 ? sha1Compress8_avx2 : sha256Compress8_avx2);
+        return results;
+    }
+#  endif
+#endif
+
+    QCryptographicHash hash(method);
+    for (int i = 0; i < data.size(); ++i) {
+        hash.reset();
+        hash.addData(data.at(i));
+        results.append(hash.result());
+    }
+    return results;
+}
+
 QT_END_NAMESPACE
@@ -0,0 +1,752 @@
+
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Copyright (C) 2012 Giuseppe D'Angelo <dangelog@gmail.com>.
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qflathash.h"
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+extern void qt_initialize_qhash_seed(); // qhash.cpp
+extern Q_CORE_EXPORT QBasicAtomicInt qt_qhash_seed; // qhash.cpp
+
+const QFlatHashData QFlatHashData::shared_null = {
+    Q_REFCOUNT_INITIALIZE_STATIC, 0, 0, 0, 0, 0, 0
+};
+
+/*!
+    \internal
+
+    Allocates a table with \a capacity slots of \a slotSize bytes each,
+    all of them empty. The control bytes and the slots are placed in the
+    same block of memory as the header.
+*/
+QFlatHashData *QFlatHashData::allocate(int capacity, int slotSize, int slotAlign)
+{
+    Q_ASSERT(capacity == 0 || (capacity >= GroupSize && (capacity & (capacity - 1)) == 0));
+    Q_ASSERT(slotAlign > 0 && (slotAlign & (slotAlign - 1)) == 0);
+
+    qt_initialize_qhash_seed();
+
+    const size_t ctrlOffset = (sizeof(QFlatHashData) + GroupSize - 1) & ~size_t(GroupSize - 1);
+    const size_t entriesOffset = (ctrlOffset + size_t(capacity) + slotAlign - 1) & ~size_t(slotAlign - 1);
+    const size_t alignment = qMax(size_t(GroupSize), size_t(slotAlign));
+    if (capacity && size_t(slotSize) > (size_t(INT_MAX) - entriesOffset) / size_t(capacity))
+        qBadAlloc();
+
+    char *block = static_cast<char *>(qMallocAligned(entriesOffset + size_t(capacity) * slotSize, alignment));
+    Q_CHECK_PTR(block);
+
+    QFlatHashData *d = reinterpret_cast<QFlatHashData *>(block);
+    d->ref.initializeOwned();
+    d->size = 0;
+    d->capacity = capacity;
+    d->growthLeft = maxSizeForCapacity(capacity);
+    d->seed = uint(qt_qhash_seed.load());
+    if (capacity) {
+        d->ctrl = reinterpret_cast<qint8 *>(block + ctrlOffset);
+        d->entries = block + entriesOffset;
+        memset(d->ctrl, Empty, capacity);
+    } else {
+        d->ctrl = 0;
+        d->entries = 0;
+    }
+    return d;
+}
+
+/*!
+    \internal
+
+    Frees the memory of \a d. The entries must have been destroyed already.
+*/
+void QFlatHashData::deallocate(QFlatHashData *d)
+{
+    qFreeAligned(d);
+}
+
+/*!
+    \internal
+
+    Returns the smallest capacity that holds \a size entries without
+    rehashing.
+*/
+int QFlatHashData::capacityForSize(int size)
+{
+    if (size <= 0)
+        return 0;
+    int capacity = GroupSize;
+    while (maxSizeForCapacity(capacity) < size) {
+        if (capacity >= (1 << 30))
+            qBadAlloc();
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+/*!
+    \class QFlatHash
+    \inmodule QtCore
+    \since 5.5
+    \brief The QFlatHash class is a template class that provides a
+    hash-table-based dictionary which stores its items in a single array.
+
+    \ingroup tools
+    \ingroup shared
+
+    \reentrant
+
+    QFlatHash\<Key, T\> provides the same functionality as QHash for
+    keys that are unique. It uses the same qHash() overloads and the
+    same seed as QHash, so any type that can be used as a QHash key can
+    be used with QFlatHash.
+
+    Unlike QHash, which allocates every item separately and chains the
+    items of a bucket, QFlatHash stores the items directly in a table
+    (open addressing). Next to the table, it keeps one control byte per
+    item holding 7 bits of the item's hash value, and compares the
+    control bytes of 16 items at once (using SSE2 where available) while
+    looking up a key. This makes lookups faster and saves one memory
+    allocation per insertion, which pays off for large tables of small
+    keys and values.
+
+    The price for this is that inserting an item can move all other
+    items, so that, different from QHash, any insertion invalidates all
+    iterators and references into the hash. Removing items with remove(),
+    take() or erase() never moves the remaining items.
+
+    QFlatHash has no equivalent of QHash::insertMulti(); every key is
+    stored at most once.
+
+    \sa QFlatSet, QHash
+*/
+
+/*! \fn QFlatHash::QFlatHash()
+
+    Constructs an empty hash.
+
+    \sa clear()
+*/
+
+/*! \fn QFlatHash::QFlatHash(std::initializer_list<std::pair<Key,T> > list)
+
+    Constructs a hash with a copy of each of the elements in the
+    initializer list \a list.
+
+    This function is only available if the program is being
+    compiled in C++11 mode.
+*/
+
+/*! \fn QFlatHash::QFlatHash(const QFlatHash &other)
+
+    Constructs a copy of \a other.
+
+    This operation occurs in \l{constant time}, because QFlatHash is
+    \l{implicitly shared}.
+*/
+
+/*! \fn QFlatHash::QFlatHash(QFlatHash &&other)
+
+    Move-constructs a QFlatHash instance, making it point at the same
+    object that \a other was pointing to.
+*/
+
+/*! \fn QFlatHash::~QFlatHash()
+
+    Destroys the hash. References to the values in the hash and all
+    iterators of this hash become invalid.
+*/
+
+/*! \fn QFlatHash &QFlatHash::operator=(const QFlatHash &other)
+
+    Assigns \a other to this hash and returns a reference to this hash.
+*/
+
+/*! \fn QFlatHash &QFlatHash::operator=(QFlatHash &&other)
+
+    Move-assigns \a other to this QFlatHash instance.
+*/
+
+/*! \fn void QFlatHash::swap(QFlatHash &other)
+
+    Swaps hash \a other with this hash. This operation is very
+    fast and never fails.
+*/
+
+/*! \fn bool QFlatHash::operator==(const QFlatHash &other) const
+
+    Returns \c true if \a other is equal to this hash; otherwise returns
+    false.
+
+    Two hashes are considered equal if they contain the same (key,
+    value) pairs. This function requires the value type to implement
+    \c operator==().
+*/
+
+/*! \fn bool QFlatHash::operator!=(const QFlatHash &other) const
+
+    Returns \c true if \a other is not equal to this hash; otherwise
+    returns \c false.
+*/
+
+/*! \fn int QFlatHash::size() const
+
+    Returns the number of items in the hash.
+
+    \sa isEmpty(), count()
+*/
+
+/*! \fn int QFlatHash::count() const
+
+    Same as size().
+*/
+
+/*! \fn bool QFlatHash::isEmpty() const
+
+    Returns \c true if the hash contains no items; otherwise returns
+    false.
+
+    \sa size()
+*/
+
+/*! \fn bool QFlatHash::empty() const
+
+    This function is provided for STL compatibility. It is equivalent
+    to isEmpty().
+*/
+
+/*! \fn int QFlatHash::capacity() const
+
+    Returns the number of slots in the hash's table. At most seven
+    eighths of them are used before the table grows.
+
+    \sa reserve(), squeeze()
+*/
+
+/*! \fn void QFlatHash::reserve(int size)
+
+    Ensures that the hash can hold \a size items without growing its
+    table.
+
+    \sa squeeze(), capacity()
+*/
+
+/*! \fn void QFlatHash::squeeze()
+
+    Shrinks the table to the smallest size that holds the current items,
+    and drops the slots of removed items.
+
+    \sa reserve(), capacity()
+*/
+
+/*! \fn void QFlatHash::detach()
+
+    \internal
+
+    Detaches this hash from any other hashes with which it may share
+    data.
+*/
+
+/*! \fn bool QFlatHash::isDetached() const
+
+    \internal
+
+    Returns \c true if the hash's internal data isn't shared with any
+    other hash object; otherwise returns \c false.
+*/
+
+/*! \fn bool QFlatHash::isSharedWith(const QFlatHash &other) const
+
+    \internal
+*/
+
+/*! \fn void QFlatHash::clear()
+
+    Removes all items from the hash.
+
+    \sa remove()
+*/
+
+/*! \fn int QFlatHash::remove(const Key &key)
+
+    Removes the item that has the \a key from the hash. Returns 1 if an
+    item was removed, 0 otherwise.
+
+    \sa clear(), take()
+*/
+
+/*! \fn T QFlatHash::take(const Key &key)
+
+    Removes the item with the \a key from the hash and returns
+    the value associated with it.
+
+    If the item does not exist in the hash, the function simply
+    returns a \l{default-constructed value}.
+
+    \sa remove()
+*/
+
+/*! \fn bool QFlatHash::contains(const Key &key) const
+
+    Returns \c true if the hash contains an item with the \a key;
+    otherwise returns \c false.
+
+    \sa count()
+*/
+
+/*! \fn int QFlatHash::count(const Key &key) const
+
+    Returns 1 if the hash contains an item with the \a key, 0 otherwise.
+
+    \sa contains()
+*/
+
+/*! \fn const Key QFlatHash::key(const T &value) const
+    \overload
+
+    Returns the first key mapped to \a value, or a
+    \l{default-constructed value} if the hash contains no item mapped
+    to \a value.
+
+    This function can be slow (\l{linear time}), because QFlatHash's
+    internal data structure is optimized for fast lookup by key, not
+    by value.
+*/
+
+/*! \fn const Key QFlatHash::key(const T &value, const Key &defaultKey) const
+
+    Returns the first key mapped to \a value, or \a defaultKey if the
+    hash contains no item mapped to \a value.
+
+    This function can be slow (\l{linear time}).
+*/
+
+/*! \fn const T QFlatHash::value(const Key &key) const
+
+    Returns the value associated with the \a key.
+
+    If the hash contains no item with the \a key, the function
+    returns a \l{default-constructed value}.
+
+    \sa key(), values(), contains(), operator[]()
+*/
+
+/*! \fn const T QFlatHash::value(const Key &key, const T &defaultValue) const
+    \overload
+
+    If the hash contains no item with the given \a key, the function returns
+    \a defaultValue.
+*/
+
+/*! \fn T &QFlatHash::operator[](const Key &key)
+
+    Returns the value associated with the \a key as a modifiable
+    reference.
+
+    If the hash contains no item with the \a key, the function inserts
+    a \l{default-constructed value} into the hash with the \a key, and
+    returns a reference to it. The reference stays valid until the next
+    insertion into the hash.
+
+    \sa insert(), value()
+*/
+
+/*! \fn const T QFlatHash::operator[](const Key &key) const
+
+    \overload
+
+    Same as value().
+*/
+
+/*! \fn QList<Key> QFlatHash::keys() const
+
+    Returns a list containing all the keys in the hash, in an
+    arbitrary order.
+
+    \sa values(), key()
+*/
+
+/*! \fn QList<Key> QFlatHash::keys(const T &value) const
+
+    \overload
+
+    Returns a list containing all the keys associated with value \a
+    value, in an arbitrary order.
+
+    This function can be slow (\l{linear time}).
+*/
+
+/*! \fn QList<T> QFlatHash::values() const
+
+    Returns a list containing all the values in the hash, in the same
+    order as keys().
+
+    \sa keys(), value()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::begin()
+
+    Returns an \l{STL-style iterators}{STL-style iterator} pointing to the first item in
+    the hash.
+
+    \sa constBegin(), end()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::begin() const
+
+    \overload
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::cbegin() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the first item
+    in the hash.
+
+    \sa begin(), cend()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::constBegin() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the first item
+    in the hash.
+
+    \sa begin(), constEnd()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::end()
+
+    Returns an \l{STL-style iterators}{STL-style iterator} pointing to the imaginary item
+    after the last item in the hash.
+
+    \sa begin(), constEnd()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::end() const
+
+    \overload
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::cend() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the
+    imaginary item after the last item in the hash.
+
+    \sa cbegin(), end()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::constEnd() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the
+    imaginary item after the last item in the hash.
+
+    \sa constBegin(), end()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::erase(iterator pos)
+
+    Removes the (key, value) pair associated with the iterator \a pos
+    from the hash, and returns an iterator to the next item in the
+    hash.
+
+    Unlike insert(), this function never moves the other items, so
+    it is safe to erase items while iterating over the hash.
+
+    \sa remove(), take(), find()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::find(const Key &key)
+
+    Returns an iterator pointing to the item with the \a key in the
+    hash, or end() if the hash contains no item with the key.
+
+    \sa value(), contains()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::find(const Key &key) const
+
+    \overload
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::constFind(const Key &key) const
+
+    Returns an iterator pointing to the item with the \a key in the
+    hash, or constEnd() if the hash contains no item with the key.
+
+    \sa find()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::insert(const Key &key, const T &value)
+
+    Inserts a new item with the \a key and a value of \a value.
+
+    If there is already an item with the \a key, that item's value
+    is replaced with \a value.
+
+    Inserting a new item may move all other items, invalidating all
+    iterators and references into the hash.
+
+    \sa operator[]()
+*/
+
+/*! \typedef QFlatHash::Iterator
+
+    Qt-style synonym for QFlatHash::iterator.
+*/
+
+/*! \typedef QFlatHash::ConstIterator
+
+    Qt-style synonym for QFlatHash::const_iterator.
+*/
+
+/*! \typedef QFlatHash::difference_type
+
+    Typedef for ptrdiff_t. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::key_type
+
+    Typedef for Key. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::mapped_type
+
+    Typedef for T. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::size_type
+
+    Typedef for int. Provided for STL compatibility.
+*/
+
+/*! \class QFlatHash::iterator
+    \inmodule QtCore
+    \brief The QFlatHash::iterator class provides an STL-style non-const iterator for QFlatHash.
+
+    Apart from being invalidated by any insertion into the hash, it
+    behaves like QHash::iterator.
+
+    \sa QFlatHash::const_iterator
+*/
+
+/*! \class QFlatHash::const_iterator
+    \inmodule QtCore
+    \brief The QFlatHash::const_iterator class provides an STL-style const iterator for QFlatHash.
+
+    Apart from being invalidated by any insertion into the hash, it
+    behaves like QHash::const_iterator.
+
+    \sa QFlatHash::iterator
+*/
+
+/*!
+    \class QFlatSet
+    \inmodule QtCore
+    \since 5.5
+    \brief The QFlatSet class is a template class that provides a
+    hash-table-based set which stores its values in a single array.
+
+    \ingroup tools
+    \ingroup shared
+
+    \reentrant
+
+    QFlatSet\<T\> is to QSet\<T\> what QFlatHash is to QHash: it is
+    implemented on top of QFlatHash, stores its values without
+    allocating memory for each of them, and finds them faster. Any
+    insertion invalidates all iterators into the set.
+
+    \sa QFlatHash, QSet
+*/
+
+/*! \fn QFlatSet::QFlatSet()
+
+    Constructs an empty set.
+*/
+
+/*! \fn QFlatSet::QFlatSet(std::initializer_list<T> list)
+
+    Constructs a set containing the elements in \a list.
+
+    This function is only available if the program is being
+    compiled in C++11 mode.
+*/
+
+/*! \fn void QFlatSet::swap(QFlatSet<T> &other)
+
+    Swaps set \a other with this set. This operation is very fast and
+    never fails.
+*/
+
+/*! \fn bool QFlatSet::operator==(const QFlatSet<T> &other) const
+
+    Returns \c true if the \a other set is equal to this set; otherwise
+    returns \c false.
+*/
+
+/*! \fn bool QFlatSet::operator!=(const QFlatSet<T> &other) const
+
+    Returns \c true if the \a other set is not equal to this set;
+    otherwise returns \c false.
+*/
+
+/*! \fn int QFlatSet::size() const
+
+    Returns the number of items in the set.
+*/
+
+/*! \fn int QFlatSet::count() const
+
+    Same as size().
+*/
+
+/*! \fn bool QFlatSet::isEmpty() const
+
+    Returns \c true if the set contains no elements; otherwise returns
+    false.
+*/
+
+/*! \fn bool QFlatSet::empty() const
+
+    Returns \c true if the set is empty. This function is provided
+    for STL compatibility. It is equivalent to isEmpty().
+*/
+
+/*! \fn int QFlatSet::capacity() const
+
+    Returns the number of slots in the set's table.
+
+    \sa QFlatHash::capacity()
+*/
+
+/*! \fn void QFlatSet::reserve(int size)
+
+    Ensures that the set can hold \a size items without growing its
+    table.
+*/
+
+/*! \fn void QFlatSet::squeeze()
+
+    Shrinks the table to the smallest size that holds the current items.
+*/
+
+/*! \fn void QFlatSet::detach()
+
+    \internal
+*/
+
+/*! \fn bool QFlatSet::isDetached() const
+
+    \internal
+*/
+
+/*! \fn void QFlatSet::clear()
+
+    Removes all elements from the set.
+*/
+
+/*! \fn bool QFlatSet::remove(const T &value)
+
+    Removes any occurrence of item \a value from the set. Returns
+    true if an item was actually removed; otherwise returns \c false.
+*/
+
+/*! \fn bool QFlatSet::contains(const T &value) const
+
+    Returns \c true if the set contains item \a value; otherwise returns
+    false.
+*/
+
+/*! \fn QFlatSet::const_iterator QFlatSet::begin() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} positioned at the first
+    item in the set.
+*/
+
+/*! \fn QFlatSet::const_iterator QFlatSet::cbegin() const
+
+    Same as begin().
+*/
+
+/*! \fn QFlatSet::const_iterator QFlatSet::constBegin() const
+
+    Same as begin().
+*/
+
+/*! \fn QFlatSet::const_iterator QFlatSet::end() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} positioned at the imaginary
+    item after the last item in the set.
+*/
+
+/*! \fn QFlatSet::const_iterator QFlatSet::cend() const
+
+    Same as end().
+*/
+
+/*! \fn QFlatSet::const_iterator QFlatSet::constEnd() const
+
+    Same as end().
+*/
+
+/*! \fn QFlatSet::const_iterator QFlatSet::erase(const_iterator pos)
+
+    Removes the item at the iterator position \a pos from the set, and
+    returns an iterator positioned at the next item in the set.
+*/
+
+/*! \fn QFlatSet::const_iterator QFlatSet::find(const T &value) const
+
+    Returns a const iterator positioned at the item \a value in the
+    set, or end() if the set contains no such item.
+*/
+
+/*! \fn QFlatSet::const_iterator QFlatSet::constFind(const T &value) const
+
+    Same as find().
+*/
+
+/*! \fn QFlatSet::const_iterator QFlatSet::insert(const T &value)
+
+    Inserts item \a value into the set, if \a value isn't already
+    in the set, and returns an iterator pointing at the inserted
+    item.
+*/
+
+/*! \fn QList<T> QFlatSet::values() const
+
+    Returns a new QList containing the elements in the set, in an
+    arbitrary order.
+*/
+
+QT_END_NAMESPACE
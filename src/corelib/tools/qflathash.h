@@ -0,0 +1,867 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qhash.h>
+
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+#include <initializer_list>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define QT_FLATHASH_SSE2
+#  include <emmintrin.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*
+    The table is an array of slots and a parallel array of control bytes,
+    one per slot. A control byte is Empty, Deleted, or holds the lower 7
+    bits of the hash of the key stored in the slot. Slots are looked at
+    in groups of GroupSize, and all control bytes of a group are compared
+    at once. The group size is the same with and without SSE2 so that
+    tables can be passed between code compiled with different flags.
+*/
+struct Q_CORE_EXPORT QFlatHashData
+{
+    enum {
+        GroupSize = 16,
+        Empty = -128,
+        Deleted = -2
+    };
+
+    QtPrivate::RefCount ref;
+    int size;
+    int capacity;       // 0, or a power of two not less than GroupSize
+    int growthLeft;     // number of Empty slots that may still be filled
+    uint seed;
+    qint8 *ctrl;
+    void *entries;
+
+    static QFlatHashData *allocate(int capacity, int slotSize, int slotAlign);
+    static void deallocate(QFlatHashData *d);
+    static int capacityForSize(int size);
+    static inline int maxSizeForCapacity(int capacity) { return capacity - capacity / 8; }
+
+    // scrambles the result of qHash() so that both the group (upper bits)
+    // and the control byte (lower 7 bits) depend on all of its bits
+    static inline uint mix(uint h)
+    {
+        h ^= h >> 16;
+        h *= 0x85ebca6bU;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35U;
+        h ^= h >> 16;
+        return h;
+    }
+
+    // the following return one bit per slot of the group starting at ctrl
+    static inline uint match(const qint8 *ctrl, qint8 h2)
+    {
+#ifdef QT_FLATHASH_SSE2
+        const __m128i group = _mm_load_si128(reinterpret_cast<const __m128i *>(ctrl));
+        return uint(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), group)));
+#else
+        uint mask = 0;
+        for (int i = 0; i < GroupSize; ++i)
+            mask |= uint(ctrl[i] == h2) << i;
+        return mask;
+#endif
+    }
+    static inline uint matchEmpty(const qint8 *ctrl)
+    {
+        return match(ctrl, qint8(Empty));
+    }
+    static inline uint matchEmptyOrDeleted(const qint8 *ctrl)
+    {
+#ifdef QT_FLATHASH_SSE2
+        // Empty and Deleted are the only values below -1
+        const __m128i group = _mm_load_si128(reinterpret_cast<const __m128i *>(ctrl));
+        return uint(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), group)));
+#else
+        uint mask = 0;
+        for (int i = 0; i < GroupSize; ++i)
+            mask |= uint(ctrl[i] < -1) << i;
+        return mask;
+#endif
+    }
+    static inline int firstSlot(uint mask)
+    {
+        Q_ASSERT(mask);
+#if defined(Q_CC_GNU)
+        return __builtin_ctz(mask);
+#else
+        int i = 0;
+        while (!(mask & 1)) {
+            mask >>= 1;
+            ++i;
+        }
+        return i;
+#endif
+    }
+
+    // returns the slot after i that holds an entry, or capacity
+    inline int nextFull(int i) const
+    {
+        while (++i < capacity) {
+            if (ctrl[i] >= 0)
+                return i;
+        }
+        return capacity;
+    }
+    inline int previousFull(int i) const
+    {
+        while (--i >= 0 && ctrl[i] < 0) { }
+        return i;
+    }
+
+    static const QFlatHashData shared_null;
+};
+
+template <class Key, class T>
+struct QFlatHashNode
+{
+    const Key key;
+    T value;
+
+    inline QFlatHashNode(const Key &key0, const T &value0) : key(key0), value(value0) {}
+    inline QFlatHashNode(const QFlatHashNode &other) : key(other.key), value(other.value) {}
+    static inline T &valueOf(QFlatHashNode *node) { return node->value; }
+
+private:
+    QFlatHashNode &operator=(const QFlatHashNode &);
+};
+
+// Specialize for QHashDummyValue in order to save some memory
+template <class Key>
+struct QFlatHashNode<Key, QHashDummyValue>
+{
+    const Key key;
+
+    inline QFlatHashNode(const Key &key0, const QHashDummyValue &) : key(key0) {}
+    inline QFlatHashNode(const QFlatHashNode &other) : key(other.key) {}
+    static inline QHashDummyValue &valueOf(QFlatHashNode *)
+    { static QHashDummyValue dummy; return dummy; }
+
+private:
+    QFlatHashNode &operator=(const QFlatHashNode &);
+};
+
+template <class Key, class T>
+class QFlatHash
+{
+    typedef QFlatHashNode<Key, T> Node;
+
+    QFlatHashData *d;
+
+    static inline Node *nodes(const QFlatHashData *data) { return static_cast<Node *>(data->entries); }
+    static inline T &valueAt(const QFlatHashData *data, int i) { return Node::valueOf(nodes(data) + i); }
+
+public:
+    inline QFlatHash() : d(const_cast<QFlatHashData *>(&QFlatHashData::shared_null)) { }
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatHash(std::initializer_list<std::pair<Key,T> > list)
+        : d(const_cast<QFlatHashData *>(&QFlatHashData::shared_null))
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<std::pair<Key,T> >::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+#endif
+    inline QFlatHash(const QFlatHash &other) : d(other.d)
+    {
+        if (!d->ref.ref())
+            detach_helper();
+    }
+    inline ~QFlatHash() { if (!d->ref.deref()) freeData(d); }
+
+    QFlatHash &operator=(const QFlatHash &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    inline QFlatHash(QFlatHash &&other) : d(other.d)
+    { other.d = const_cast<QFlatHashData *>(&QFlatHashData::shared_null); }
+    inline QFlatHash &operator=(QFlatHash &&other)
+    { QFlatHash moved(std::move(other)); swap(moved); return *this; }
+#endif
+    inline void swap(QFlatHash &other) { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash &other) const;
+    inline bool operator!=(const QFlatHash &other) const { return !(*this == other); }
+
+    inline int size() const { return d->size; }
+    inline int count() const { return d->size; }
+    inline bool isEmpty() const { return d->size == 0; }
+
+    inline int capacity() const { return d->capacity; }
+    void reserve(int size);
+    void squeeze();
+
+    inline void detach() { if (d->ref.isShared()) detach_helper(); }
+    inline bool isDetached() const { return !d->ref.isShared(); }
+    inline bool isSharedWith(const QFlatHash &other) const { return d == other.d; }
+
+    void clear();
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    bool contains(const Key &key) const { return findIndex(key) >= 0; }
+    int count(const Key &key) const { return findIndex(key) >= 0 ? 1 : 0; }
+    const Key key(const T &value) const;
+    const Key key(const T &value, const Key &defaultKey) const;
+    const T value(const Key &key) const;
+    const T value(const Key &key, const T &defaultValue) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const;
+
+    QList<Key> keys() const;
+    QList<Key> keys(const T &value) const;
+    QList<T> values() const;
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class const_iterator;
+        friend class QFlatHash<Key, T>;
+        QFlatHashData *d;
+        int i;
+
+        inline iterator(QFlatHashData *data, int index) : d(data), i(index) { }
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        inline iterator() : d(0), i(0) { }
+
+        inline const Key &key() const { return nodes(d)[i].key; }
+        inline T &value() const { return valueAt(d, i); }
+        inline T &operator*() const { return valueAt(d, i); }
+        inline T *operator->() const { return &valueAt(d, i); }
+        inline bool operator==(const iterator &o) const { return i == o.i && d == o.d; }
+        inline bool operator!=(const iterator &o) const { return !(*this == o); }
+
+        inline iterator &operator++() { i = d->nextFull(i); return *this; }
+        inline iterator operator++(int) { iterator r = *this; i = d->nextFull(i); return r; }
+        inline iterator &operator--() { i = d->previousFull(i); return *this; }
+        inline iterator operator--(int) { iterator r = *this; i = d->previousFull(i); return r; }
+
+#ifndef QT_STRICT_ITERATORS
+        inline bool operator==(const const_iterator &o) const { return i == o.i && d == o.d; }
+        inline bool operator!=(const const_iterator &o) const { return !(*this == o); }
+#endif
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class iterator;
+        friend class QFlatHash<Key, T>;
+        const QFlatHashData *d;
+        int i;
+
+        inline const_iterator(const QFlatHashData *data, int index) : d(data), i(index) { }
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() : d(0), i(0) { }
+#ifdef QT_STRICT_ITERATORS
+        explicit inline const_iterator(const iterator &o)
+#else
+        inline const_iterator(const iterator &o)
+#endif
+            : d(o.d), i(o.i) { }
+
+        inline const Key &key() const { return nodes(d)[i].key; }
+        inline const T &value() const { return valueAt(d, i); }
+        inline const T &operator*() const { return valueAt(d, i); }
+        inline const T *operator->() const { return &valueAt(d, i); }
+        inline bool operator==(const const_iterator &o) const { return i == o.i && d == o.d; }
+        inline bool operator!=(const const_iterator &o) const { return !(*this == o); }
+
+        inline const_iterator &operator++() { i = d->nextFull(i); return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; i = d->nextFull(i); return r; }
+        inline const_iterator &operator--() { i = d->previousFull(i); return *this; }
+        inline const_iterator operator--(int) { const_iterator r = *this; i = d->previousFull(i); return r; }
+    };
+    friend class const_iterator;
+
+    // STL style
+    inline iterator begin() { detach(); return iterator(d, d->nextFull(-1)); }
+    inline const_iterator begin() const { return const_iterator(d, d->nextFull(-1)); }
+    inline const_iterator cbegin() const { return const_iterator(d, d->nextFull(-1)); }
+    inline const_iterator constBegin() const { return const_iterator(d, d->nextFull(-1)); }
+    inline iterator end() { detach(); return iterator(d, d->capacity); }
+    inline const_iterator end() const { return const_iterator(d, d->capacity); }
+    inline const_iterator cend() const { return const_iterator(d, d->capacity); }
+    inline const_iterator constEnd() const { return const_iterator(d, d->capacity); }
+
+    iterator erase(iterator it);
+
+    // more Qt
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+    iterator find(const Key &key);
+    const_iterator find(const Key &key) const;
+    const_iterator constFind(const Key &key) const;
+    iterator insert(const Key &key, const T &value);
+
+    // STL compatibility
+    typedef T mapped_type;
+    typedef Key key_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const { return isEmpty(); }
+
+private:
+    void detach_helper();
+    // a table without slots would have to grow for the first entry anyway
+    inline void detachForInsert()
+    { if (d->capacity == 0) rehash(QFlatHashData::GroupSize); else detach(); }
+    void rehash(int newCapacity);
+    static void freeData(QFlatHashData *x);
+    static QFlatHashData *allocate(int capacity)
+    { return QFlatHashData::allocate(capacity, int(sizeof(Node)), int(Q_ALIGNOF(Node))); }
+    int findIndex(const Key &key) const;
+    int findIndex(const Key &key, uint h) const;
+    int insertNew(const Key &key, const T &value, uint h);
+    void eraseAt(int i);
+};
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::freeData(QFlatHashData *x)
+{
+    if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex) {
+        Node *n = nodes(x);
+        for (int i = 0; i < x->capacity; ++i) {
+            if (x->ctrl[i] >= 0)
+                n[i].~Node();
+        }
+    }
+    QFlatHashData::deallocate(x);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::detach_helper()
+{
+    QFlatHashData *x = allocate(d->capacity);
+    x->size = d->size;
+    x->growthLeft = d->growthLeft;
+    if (d->capacity) {
+        // keep the seed so that every entry stays in its slot
+        x->seed = d->seed;
+        Node *src = nodes(d);
+        Node *dst = nodes(x);
+        QT_TRY {
+            for (int i = 0; i < d->capacity; ++i) {
+                if (d->ctrl[i] >= 0) {
+                    new (dst + i) Node(src[i]);
+                    x->ctrl[i] = d->ctrl[i];
+                } else if (d->ctrl[i] == QFlatHashData::Deleted) {
+                    x->ctrl[i] = QFlatHashData::Deleted;
+                }
+            }
+        } QT_CATCH(...) {
+            freeData(x);
+            QT_RETHROW;
+        }
+    }
+    if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::rehash(int newCapacity)
+{
+    QFlatHashData *x = allocate(newCapacity);
+    Node *src = nodes(d);
+    Node *dst = nodes(x);
+    const int mask = (newCapacity / QFlatHashData::GroupSize) - 1;
+    QT_TRY {
+        for (int i = 0; i < d->capacity; ++i) {
+            if (d->ctrl[i] < 0)
+                continue;
+            const uint h = QFlatHashData::mix(qHash(src[i].key, x->seed));
+            int group = int(h >> 7) & mask;
+            for (int step = 1; ; ++step) {
+                const qint8 *ctrl = x->ctrl + group * QFlatHashData::GroupSize;
+                const uint empty = QFlatHashData::matchEmpty(ctrl);
+                if (empty) {
+                    const int j = group * QFlatHashData::GroupSize + QFlatHashData::firstSlot(empty);
+                    new (dst + j) Node(src[i]);
+                    x->ctrl[j] = qint8(h & 0x7f);
+                    ++x->size;
+                    --x->growthLeft;
+                    break;
+                }
+                group = (group + step) & mask;
+            }
+        }
+    } QT_CATCH(...) {
+        freeData(x);
+        QT_RETHROW;
+    }
+    if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE QFlatHash<Key, T> &QFlatHash<Key, T>::operator=(const QFlatHash &other)
+{
+    if (d != other.d) {
+        QFlatHashData *o = other.d;
+        o->ref.ref();
+        if (!d->ref.deref())
+            freeData(d);
+        d = o;
+        if (!d->ref.isSharable())
+            detach_helper();
+    }
+    return *this;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::clear()
+{
+    *this = QFlatHash();
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int asize)
+{
+    const int newCapacity = QFlatHashData::capacityForSize(asize);
+    if (newCapacity > d->capacity)
+        rehash(newCapacity);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::squeeze()
+{
+    if (d->size == 0) {
+        clear();
+        return;
+    }
+    const int newCapacity = QFlatHashData::capacityForSize(d->size);
+    if (newCapacity < d->capacity)
+        rehash(newCapacity);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findIndex(const Key &akey) const
+{
+    if (d->size == 0)
+        return -1;
+    return findIndex(akey, QFlatHashData::mix(qHash(akey, d->seed)));
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findIndex(const Key &akey, uint h) const
+{
+    const qint8 h2 = qint8(h & 0x7f);
+    const int mask = (d->capacity / QFlatHashData::GroupSize) - 1;
+    const Node *n = nodes(d);
+    int group = int(h >> 7) & mask;
+    for (int step = 1; ; ++step) {
+        const int first = group * QFlatHashData::GroupSize;
+        const qint8 *ctrl = d->ctrl + first;
+        for (uint m = QFlatHashData::match(ctrl, h2); m; m &= m - 1) {
+            const int i = first + QFlatHashData::firstSlot(m);
+            if (n[i].key == akey)
+                return i;
+        }
+        // an entry is never placed beyond a group that had an empty slot
+        if (QFlatHashData::matchEmpty(ctrl))
+            return -1;
+        group = (group + step) & mask;
+    }
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::insertNew(const Key &akey, const T &avalue, uint h)
+{
+    for (;;) {
+        const int mask = (d->capacity / QFlatHashData::GroupSize) - 1;
+        int group = int(h >> 7) & mask;
+        int i = -1;
+        for (int step = 1; d->capacity; ++step) {
+            const int first = group * QFlatHashData::GroupSize;
+            const uint m = QFlatHashData::matchEmptyOrDeleted(d->ctrl + first);
+            if (m) {
+                i = first + QFlatHashData::firstSlot(m);
+                break;
+            }
+            group = (group + step) & mask;
+        }
+
+        if (i < 0 || (d->growthLeft == 0 && d->ctrl[i] == QFlatHashData::Empty)) {
+            // grow, unless most of the table is taken by deleted entries
+            int newCapacity = d->capacity ? d->capacity : int(QFlatHashData::GroupSize);
+            if (d->size * 2 >= QFlatHashData::maxSizeForCapacity(d->capacity))
+                newCapacity = QFlatHashData::capacityForSize(d->size + 1);
+            rehash(newCapacity);
+            continue;
+        }
+
+        new (nodes(d) + i) Node(akey, avalue);
+        if (d->ctrl[i] == QFlatHashData::Empty)
+            --d->growthLeft;
+        d->ctrl[i] = qint8(h & 0x7f);
+        ++d->size;
+        return i;
+    }
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::eraseAt(int i)
+{
+    nodes(d)[i].~Node();
+    // a slot may become empty again only if lookups would stop at
+    // this group anyway, otherwise entries beyond it would get lost
+    const qint8 *group = d->ctrl + (i & ~(QFlatHashData::GroupSize - 1));
+    if (QFlatHashData::matchEmpty(group)) {
+        d->ctrl[i] = QFlatHashData::Empty;
+        ++d->growthLeft;
+    } else {
+        d->ctrl[i] = QFlatHashData::Deleted;
+    }
+    --d->size;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::remove(const Key &akey)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return 0;
+    const int i = findIndex(akey);
+    if (i < 0)
+        return 0;
+    detach();
+    eraseAt(i);
+    return 1;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &akey)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return T();
+    const int i = findIndex(akey);
+    if (i < 0)
+        return T();
+    detach();
+    T t = valueAt(d, i);
+    eraseAt(i);
+    return t;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(iterator it)
+{
+    Q_ASSERT_X(it.d == d || d->ref.isShared(), "QFlatHash::erase", "The specified iterator argument 'it' is invalid");
+    Q_ASSERT(it.i >= 0 && it.i < d->capacity && d->ctrl[it.i] >= 0);
+    // a detached copy keeps every entry in the same slot
+    detach();
+    eraseAt(it.i);
+    return iterator(d, d->nextFull(it.i));
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey) const
+{
+    const int i = findIndex(akey);
+    return i < 0 ? T() : valueAt(d, i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey, const T &adefaultValue) const
+{
+    const int i = findIndex(akey);
+    return i < 0 ? adefaultValue : valueAt(d, i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &akey)
+{
+    detachForInsert();
+    const uint h = QFlatHashData::mix(qHash(akey, d->seed));
+    int i = d->size ? findIndex(akey, h) : -1;
+    if (i < 0)
+        i = insertNew(akey, T(), h);
+    return valueAt(d, i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::operator[](const Key &akey) const
+{
+    return value(akey);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &akey, const T &avalue)
+{
+    detachForInsert();
+    const uint h = QFlatHashData::mix(qHash(akey, d->seed));
+    int i = d->size ? findIndex(akey, h) : -1;
+    if (i < 0)
+        i = insertNew(akey, avalue, h);
+    else
+        valueAt(d, i) = avalue;
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &akey)
+{
+    detach();
+    const int i = findIndex(akey);
+    return iterator(d, i < 0 ? d->capacity : i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::find(const Key &akey) const
+{
+    const int i = findIndex(akey);
+    return const_iterator(d, i < 0 ? d->capacity : i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constFind(const Key &akey) const
+{
+    return find(akey);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue) const
+{
+    return key(avalue, Key());
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue, const Key &defaultValue) const
+{
+    for (const_iterator i = begin(); i != end(); ++i) {
+        if (i.value() == avalue)
+            return i.key();
+    }
+    return defaultValue;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator i = begin(); i != end(); ++i)
+        res.append(i.key());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys(const T &avalue) const
+{
+    QList<Key> res;
+    for (const_iterator i = begin(); i != end(); ++i) {
+        if (i.value() == avalue)
+            res.append(i.key());
+    }
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator i = begin(); i != end(); ++i)
+        res.append(i.value());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (d == other.d)
+        return true;
+    for (const_iterator it = begin(); it != end(); ++it) {
+        const int i = other.findIndex(it.key());
+        if (i < 0 || !(valueAt(other.d, i) == it.value()))
+            return false;
+    }
+    return true;
+}
+
+template <class Key, class T>
+inline void qSwap(QFlatHash<Key, T> &value1, QFlatHash<Key, T> &value2)
+{
+    value1.swap(value2);
+}
+
+
+template <class T>
+class QFlatSet
+{
+    typedef QFlatHash<T, QHashDummyValue> Hash;
+
+public:
+    inline QFlatSet() {}
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatSet(std::initializer_list<T> list)
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<T>::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(*it);
+    }
+#endif
+    // compiler-generated copy/move ctor/assignment operators are fine!
+    // compiler-generated destructor is fine!
+
+    inline void swap(QFlatSet<T> &other) { q_hash.swap(other.q_hash); }
+
+    inline bool operator==(const QFlatSet<T> &other) const
+        { return q_hash == other.q_hash; }
+    inline bool operator!=(const QFlatSet<T> &other) const
+        { return q_hash != other.q_hash; }
+
+    inline int size() const { return q_hash.size(); }
+    inline int count() const { return q_hash.count(); }
+    inline bool isEmpty() const { return q_hash.isEmpty(); }
+
+    inline int capacity() const { return q_hash.capacity(); }
+    inline void reserve(int size) { q_hash.reserve(size); }
+    inline void squeeze() { q_hash.squeeze(); }
+
+    inline void detach() { q_hash.detach(); }
+    inline bool isDetached() const { return q_hash.isDetached(); }
+
+    inline void clear() { q_hash.clear(); }
+
+    inline bool remove(const T &value) { return q_hash.remove(value) != 0; }
+    inline bool contains(const T &value) const { return q_hash.contains(value); }
+
+    class const_iterator
+    {
+        typename Hash::const_iterator i;
+        friend class QFlatSet<T>;
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() {}
+        inline const_iterator(typename Hash::const_iterator o) : i(o) {}
+        inline const T &operator*() const { return i.key(); }
+        inline const T *operator->() const { return &i.key(); }
+        inline bool operator==(const const_iterator &o) const { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const { return i != o.i; }
+        inline const_iterator &operator++() { ++i; return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; ++i; return r; }
+        inline const_iterator &operator--() { --i; return *this; }
+        inline const_iterator operator--(int) { const_iterator r = *this; --i; return r; }
+    };
+    typedef const_iterator iterator;
+
+    // STL style
+    inline const_iterator begin() const { return q_hash.begin(); }
+    inline const_iterator cbegin() const { return q_hash.begin(); }
+    inline const_iterator constBegin() const { return q_hash.constBegin(); }
+    inline const_iterator end() const { return q_hash.end(); }
+    inline const_iterator cend() const { return q_hash.end(); }
+    inline const_iterator constEnd() const { return q_hash.constEnd(); }
+
+    const_iterator erase(const_iterator i)
+    {
+        Q_ASSERT_X(isValidIterator(i), "QFlatSet::erase", "The specified const_iterator argument 'i' is invalid");
+        // the underlying hash keeps its entries in place when detaching
+        typename Hash::iterator it = q_hash.find(*i);
+        return typename Hash::const_iterator(q_hash.erase(it));
+    }
+
+    // more Qt
+    typedef const_iterator ConstIterator;
+    inline const_iterator find(const T &value) const { return q_hash.find(value); }
+    inline const_iterator constFind(const T &value) const { return find(value); }
+    inline const_iterator insert(const T &value)
+        { return static_cast<typename Hash::const_iterator>(q_hash.insert(value, QHashDummyValue())); }
+
+    QList<T> values() const { return q_hash.keys(); }
+
+    // STL compatibility
+    typedef T key_type;
+    typedef T value_type;
+    typedef value_type *pointer;
+    typedef const value_type *const_pointer;
+    typedef value_type &reference;
+    typedef const value_type &const_reference;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const { return isEmpty(); }
+
+private:
+    Hash q_hash;
+    bool isValidIterator(const const_iterator &i) const
+    {
+        return i != end() && contains(*i);
+    }
+};
+
+template <class T>
+inline void qSwap(QFlatSet<T> &value1, QFlatSet<T> &value2)
+{
+    value1.swap(value2);
+}
+
+QT_END_NAMESPACE
+
+#undef QT_FLATHASH_SSE2
+
+#endif // QFLATHASH_H
@@ -281,8 +281,10 @@ Q_CORE_EXPORT QBasicAtomicInt qt_qhash_seed = Q_BASIC_ATOMIC_INITIALIZER(-1);
     We don't actually care about the fact that different calls to
     qt_create_qhash_seed() might return different values,
     as long as in the end everyone uses the very same value.
+
+    Also used by QFlatHashData.
 */
-static void qt_initialize_qhash_seed()
+void qt_initialize_qhash_seed()
 {
     if (qt_qhash_seed.load() == -1) {
         int x(qt_create_qhash_seed() & INT_MAX);
@@ -2720,6 +2720,7 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
                                     const QChar exponential, const QChar group, const QChar decimal,
                                     double d, int precision, DoubleForm form, int width, unsigned flags)
 {
+    const bool shortest = precision == QLocale::FloatingPointShortest;
     if (precision == -1)
         precision = 6;
     if (width == -1)
@@ -2746,6 +2747,8 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
 
 #ifdef QT_QLOCALE_USES_FCVT
         // NOT thread safe!
+        if (shortest)
+            precision = QFastDtoaMaxDigits;
         if (form == DFDecimal) {
             digits = QLatin1String(fcvt(d, precision, &decpt, &sign));
         } else {
@@ -2783,20 +2786,39 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
         int pr = precision;
         if (form == DFExponent)
             ++pr;
-
-        char *rve = 0;
-        char *buff = 0;
-        QT_TRY {
-            digits = QLatin1String(qdtoa(d, mode, pr, &decpt, &sign, &rve, &buff));
-        } QT_CATCH(...) {
+        if (shortest)
+            mode = 0;
+
+        char fast[QFastDtoaMaxDigits + 1];
+        int length;
+        if (qt_fastDtoa(d, mode, pr, fast, &length, &decpt)) {
+            digits = QString::fromLatin1(fast, length);
+            sign = d < 0;
+        } else {
+            char *rve = 0;
+            char *buff = 0;
+            QT_TRY {
+                digits = QLatin1String(qdtoa(d, mode, pr, &decpt, &sign, &rve, &buff));
+            } QT_CATCH(...) {
+                if (buff != 0)
+                    free(buff);
+                QT_RETHROW;
+            }
             if (buff != 0)
                 free(buff);
-            QT_RETHROW;
         }
-        if (buff != 0)
-            free(buff);
 #endif // QT_QLOCALE_USES_FCVT
 
+        if (shortest) {
+            // show exactly the digits needed
+            if (form == DFExponent)
+                precision = digits.length() - 1;
+            else if (form == DFDecimal)
+                precision = qMax(digits.length() - decpt, 0);
+            else
+                precision = digits.length();
+        }
+
         if (_zero.unicode() != '0') {
             ushort z = _zero.unicode() - '0';
             for (int i = 0; i < digits.length(); ++i)
@@ -2821,7 +2843,10 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
                 PrecisionMode mode = (flags & Alternate) ?
                             PMSignificantDigits : PMChopTrailingZeros;
 
-                if (decpt != digits.length() && (decpt <= -4 || decpt > precision))
+                // as many digits as needed to tell doubles apart before
+                // switching to exponent form in shortest mode
+                const int cutoff = shortest ? QFastDtoaMaxDigits : precision;
+                if (decpt != digits.length() && (decpt <= -4 || decpt > cutoff))
                     num_str = exponentForm(_zero, decimal, exponential, group, plus, minus,
                                            digits, decpt, precision, mode,
                                            always_show_decpt);
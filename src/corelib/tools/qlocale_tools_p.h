@@ -98,6 +98,11 @@ inline bool isZero(double d)
 
 Q_CORE_EXPORT char *qdtoa(double d, int mode, int ndigits, int *decpt,
                           int *sign, char **rve, char **digits_str);
+// enough significant digits to tell all doubles apart
+enum { QFastDtoaMaxDigits = 17 };
+#ifndef QT_QLOCALE_USES_FCVT
+Q_CORE_EXPORT bool qt_fastDtoa(double d, int mode, int ndigits, char *buf, int *length, int *decpt);
+#endif
 Q_CORE_EXPORT double qstrtod(const char *s00, char const **se, bool *ok);
 qlonglong qstrtoll(const char *nptr, const char **endptr, int base, bool *ok);
 qulonglong qstrtoull(const char *nptr, const char **endptr, int base, bool *ok);
@@ -304,6 +304,8 @@ static inline uint detectProcessorFeatures()
         features |= HLE; // Hardware Lock Ellision
     if (cpuid0700EBX & (1u << 11))
         features |= RTM; // Restricted Transactional Memory
+    if ((features & SSE4_1) && (cpuid0700EBX & (1u << 29)))
+        features |= SHA; // SHA-1 and SHA-256 extensions
 
     return features;
 }
@@ -467,6 +469,7 @@ static inline uint detectProcessorFeatures()
  rtm
  dsp
  dspr2
+ sha
   */
 
 // begin generated
@@ -484,11 +487,12 @@ static const char features_string[] =
     " rtm\0"
     " dsp\0"
     " dspr2\0"
+    " sha\0"
     "\0";
 
 static const int features_indices[] = {
     0,    1,    7,   13,   19,   26,   34,   42,
-   47,   53,   58,   63,   68,   -1
+   47,   53,   58,   63,   68,   75,   -1
 };
 // end generated
 
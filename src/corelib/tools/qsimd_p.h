@@ -73,6 +73,7 @@
  *  SSE4_2   | x86  | I & C | I & C    | I only |
  *  AVX      | x86  | I & C | I & C    | I & C  |
  *  AVX2     | x86  | I & C | I & C    | I only |
+ *  SHA      | x86  | I & C | I & C    | I only |
  * I = intrinsics; C = code generation
  *
  * Code can use the following constructs to determine compiler support & status:
@@ -217,6 +218,19 @@
 #  endif
 #endif
 
+// SHA intrinsics
+// the SHA instructions are useless without the byte shuffles from SSSE3 and the
+// blends from SSE4.1, so we require those too
+#define QT_FUNCTION_TARGET_STRING_SHA       "sha,sse4.1"
+#if defined(__SHA__) || (defined(QT_COMPILER_SUPPORTS_SSE4_1) \
+    && (defined(Q_CC_INTEL) || (defined(Q_CC_MSVC) && _MSC_VER >= 1900) \
+        || (defined(Q_CC_GNU) && !defined(Q_CC_CLANG) && (__GNUC__-0) * 100 + (__GNUC_MINOR__-0) >= 409)))
+#  define QT_COMPILER_SUPPORTS_SHA 1
+#endif
+#if defined(__SHA__) || (defined(QT_COMPILER_SUPPORTS_SHA) && defined(QT_COMPILER_SUPPORTS_SIMD_ALWAYS))
+#include <immintrin.h>
+#endif
+
 // other x86 intrinsics
 #if defined(Q_PROCESSOR_X86) && ((defined(Q_CC_GNU) && (Q_CC_GNU >= 404)) \
     || (defined(Q_CC_CLANG) && (Q_CC_CLANG >= 208)) \
@@ -256,12 +270,16 @@ enum CPUFeatures {
     RTM         = 0x400,
     DSP         = 0x800,
     DSPR2       = 0x1000,
+    SHA         = 0x2000,
 
     // used only to indicate that the CPU detection was initialised
     QSimdInitialized = 0x80000000
 };
 
 static const uint qCompilerCpuFeatures = 0
+#if defined __SHA__
+        | SHA
+#endif
 #if defined __RTM__
         | RTM
 #endif
@@ -0,0 +1,237 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSMALLBYTEARRAY_P_H
+#define QSMALLBYTEARRAY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbytearray.h>
+
+#include <new>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+// A byte array for short, short-lived payloads such as header field names,
+// cookie attributes and URL components. Up to InlineCapacity bytes are kept
+// inside the object itself, so building, trimming and appending to them
+// does not touch the heap. Longer contents are held in a QByteArray that
+// is shared with the one they were created from, if any.
+//
+// The object is as large as three pointers on 64-bit platforms. The last
+// byte of the storage holds the size of the inline data, or HeapTag when
+// the storage holds a QByteArray instead.
+class QSmallByteArray
+{
+public:
+    enum { InlineCapacity = 22 };
+
+    inline QSmallByteArray() { setInline(0); }
+    inline QSmallByteArray(const char *data, int size)
+    {
+        if (size <= InlineCapacity) {
+            memcpy(u.inlineData, data, size);
+            setInline(size);
+        } else {
+            new (u.heapData) QByteArray(data, size);
+            u.inlineData[TagIndex] = char(HeapTag);
+        }
+    }
+    explicit inline QSmallByteArray(const QByteArray &ba)
+    {
+        if (ba.size() <= InlineCapacity) {
+            memcpy(u.inlineData, ba.constData(), ba.size());
+            setInline(ba.size());
+        } else {
+            new (u.heapData) QByteArray(ba);
+            u.inlineData[TagIndex] = char(HeapTag);
+        }
+    }
+    inline QSmallByteArray(const QSmallByteArray &other)
+    {
+        if (other.isInline())
+            u = other.u;
+        else
+            copyHeap(other);
+    }
+    inline ~QSmallByteArray()
+    {
+        if (!isInline())
+            heap()->~QByteArray();
+    }
+
+    inline QSmallByteArray &operator=(const QSmallByteArray &other)
+    {
+        if (this != &other) {
+            if (!isInline())
+                heap()->~QByteArray();
+            if (other.isInline())
+                u = other.u;
+            else
+                copyHeap(other);
+        }
+        return *this;
+    }
+
+    inline bool isInline() const { return uchar(u.inlineData[TagIndex]) != HeapTag; }
+    inline int size() const { return isInline() ? int(uchar(u.inlineData[TagIndex])) : heap()->size(); }
+    inline bool isEmpty() const { return size() == 0; }
+    inline const char *constData() const { return isInline() ? u.inlineData : heap()->constData(); }
+    inline char at(int i) const { Q_ASSERT(uint(i) < uint(size())); return constData()[i]; }
+
+    inline void clear()
+    {
+        if (!isInline())
+            heap()->~QByteArray();
+        setInline(0);
+    }
+
+    inline QSmallByteArray &append(const char *data, int len)
+    {
+        if (isInline()) {
+            const int oldSize = size();
+            if (oldSize + len <= InlineCapacity) {
+                memcpy(u.inlineData + oldSize, data, len);
+                setInline(oldSize + len);
+                return *this;
+            }
+            moveToHeap(oldSize + len);
+        }
+        heap()->append(data, len);
+        return *this;
+    }
+    inline QSmallByteArray &append(char c) { return append(&c, 1); }
+    inline QSmallByteArray &append(const QByteArray &ba)
+    {
+        if (isEmpty() && ba.size() > InlineCapacity) {
+            *this = QSmallByteArray(ba);
+            return *this;
+        }
+        return append(ba.constData(), ba.size());
+    }
+
+    inline bool startsWith(char c) const { return size() && constData()[0] == c; }
+
+    // Same as QByteArray::toLower(): the contents are taken as Latin-1.
+    inline QSmallByteArray toLower() const
+    {
+        if (!isInline())
+            return QSmallByteArray(heap()->toLower());
+        QSmallByteArray result(*this);
+        const int n = size();
+        for (int i = 0; i < n; ++i) {
+            const uchar c = uchar(u.inlineData[i]);
+            if ((c >= 'A' && c <= 'Z') || (c >= 0xc0 && c <= 0xde && c != 0xd7))
+                result.u.inlineData[i] = char(c + 0x20);
+        }
+        return result;
+    }
+
+    // Same as QByteArray(data, size).trimmed(), without the temporaries.
+    static inline QSmallByteArray trimmed(const char *data, int size)
+    {
+        while (size && isSpace(data[0])) {
+            ++data;
+            --size;
+        }
+        while (size && isSpace(data[size - 1]))
+            --size;
+        return QSmallByteArray(data, size);
+    }
+
+    // Inline contents need one allocation here; heap contents are shared.
+    inline QByteArray toByteArray() const
+    { return isInline() ? QByteArray(u.inlineData, size()) : *heap(); }
+
+    friend inline bool operator==(const QSmallByteArray &a1, const QSmallByteArray &a2)
+    { return a1.size() == a2.size() && memcmp(a1.constData(), a2.constData(), a1.size()) == 0; }
+    friend inline bool operator!=(const QSmallByteArray &a1, const QSmallByteArray &a2)
+    { return !(a1 == a2); }
+    friend inline bool operator==(const QSmallByteArray &a1, const QByteArray &a2)
+    { return a1.size() == a2.size() && memcmp(a1.constData(), a2.constData(), a1.size()) == 0; }
+    friend inline bool operator!=(const QSmallByteArray &a1, const QByteArray &a2)
+    { return !(a1 == a2); }
+    friend inline bool operator==(const QSmallByteArray &a1, const char *a2)
+    { return int(qstrlen(a2)) == a1.size() && memcmp(a1.constData(), a2, a1.size()) == 0; }
+    friend inline bool operator!=(const QSmallByteArray &a1, const char *a2)
+    { return !(a1 == a2); }
+
+private:
+    enum { TagIndex = InlineCapacity + 1, HeapTag = 0xff };
+
+    static inline bool isSpace(char c)
+    { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+    inline void setInline(int size)
+    {
+        u.inlineData[size] = '\0';
+        u.inlineData[TagIndex] = char(size);
+    }
+    inline QByteArray *heap() { return reinterpret_cast<QByteArray *>(u.heapData); }
+    inline const QByteArray *heap() const { return reinterpret_cast<const QByteArray *>(u.heapData); }
+    inline void copyHeap(const QSmallByteArray &other)
+    {
+        new (u.heapData) QByteArray(*other.heap());
+        u.inlineData[TagIndex] = char(HeapTag);
+    }
+    inline void moveToHeap(int capacity)
+    {
+        QByteArray ba;
+        ba.reserve(capacity);
+        ba.append(u.inlineData, size());
+        new (u.heapData) QByteArray(ba);
+        u.inlineData[TagIndex] = char(HeapTag);
+    }
+
+    union {
+        char inlineData[InlineCapacity + 2];
+        char heapData[sizeof(QByteArray)];
+        void *alignment;
+    } u;
+};
+
+Q_DECLARE_TYPEINFO(QSmallByteArray, Q_MOVABLE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QSMALLBYTEARRAY_P_H
@@ -203,9 +203,130 @@ inline RetType UnrollTailLoop<0>::exec(int, RetType returnIfExited, Functor1, Fu
 }
 #endif
 
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+/*
+    AVX2 versions of the loops below, selected at runtime so that builds for
+    plain x86-64 still use the wide vectors where the CPU has them. They
+    process whole 32-byte blocks and return how far they got; the caller
+    finishes the rest, including finding the exact position of a mismatch.
+*/
+static inline bool hasAvx2()
+{
+    return qCpuHasFeature(AVX2);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static qptrdiff qt_from_latin1_avx2(ushort *dst, const char *str, qptrdiff size)
+{
+    qptrdiff offset = 0;
+    // we're going to read str[offset..offset+31] (32 bytes)
+    for ( ; offset + 31 < size; offset += 32) {
+        const __m256i chunk = _mm256_loadu_si256((const __m256i *)(str + offset));
+        // zero extend each half to 16 characters
+        const __m256i first = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(chunk));
+        const __m256i second = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(chunk, 1));
+        _mm256_storeu_si256((__m256i *)(dst + offset), first);
+        _mm256_storeu_si256((__m256i *)(dst + offset + 16), second);
+    }
+    return offset;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static qptrdiff qt_to_latin1_avx2(uchar *dst, const ushort *src, qptrdiff length)
+{
+    const __m256i questionMark = _mm256_set1_epi16('?');
+    const __m256i latin1Max = _mm256_set1_epi16(0xff);
+    qptrdiff offset = 0;
+    // we're going to write dst[offset..offset+31] (32 bytes)
+    for ( ; offset + 31 < length; offset += 32) {
+        __m256i chunk1 = _mm256_loadu_si256((const __m256i *)(src + offset));
+        __m256i chunk2 = _mm256_loadu_si256((const __m256i *)(src + offset + 16));
+
+        // replace the non-Latin 1 characters with question marks
+        const __m256i inRange1 = _mm256_cmpeq_epi16(_mm256_min_epu16(chunk1, latin1Max), chunk1);
+        const __m256i inRange2 = _mm256_cmpeq_epi16(_mm256_min_epu16(chunk2, latin1Max), chunk2);
+        chunk1 = _mm256_blendv_epi8(questionMark, chunk1, inRange1);
+        chunk2 = _mm256_blendv_epi8(questionMark, chunk2, inRange2);
+
+        // packing works on each 128-bit lane, so put the quadwords back in order
+        const __m256i packed = _mm256_packus_epi16(chunk1, chunk2);
+        _mm256_storeu_si256((__m256i *)(dst + offset), _mm256_permute4x64_epi64(packed, 0xd8));
+    }
+    return offset;
+}
+
+// returns the length of the common prefix, rounded down to 16 characters
+QT_FUNCTION_TARGET(AVX2)
+static qptrdiff ucstrncmp_avx2(const ushort *a, const ushort *b, qptrdiff l)
+{
+    qptrdiff offset = 0;
+    for ( ; offset + 15 < l; offset += 16) {
+        const __m256i a_data = _mm256_loadu_si256((const __m256i *)(a + offset));
+        const __m256i b_data = _mm256_loadu_si256((const __m256i *)(b + offset));
+        if (uint(_mm256_movemask_epi8(_mm256_cmpeq_epi16(a_data, b_data))) != 0xffffffffU)
+            break;
+    }
+    return offset;
+}
+
+// same, comparing to Latin 1 and rounded down to 32 characters
+QT_FUNCTION_TARGET(AVX2)
+static qptrdiff ucstrncmp_avx2(const ushort *uc, const uchar *c, qptrdiff l)
+{
+    qptrdiff offset = 0;
+    for ( ; offset + 31 < l; offset += 32) {
+        const __m256i chunk = _mm256_loadu_si256((const __m256i *)(c + offset));
+        const __m256i first = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(chunk));
+        const __m256i second = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(chunk, 1));
+        const __m256i result1 = _mm256_cmpeq_epi16(first, _mm256_loadu_si256((const __m256i *)(uc + offset)));
+        const __m256i result2 = _mm256_cmpeq_epi16(second, _mm256_loadu_si256((const __m256i *)(uc + offset + 16)));
+        if (uint(_mm256_movemask_epi8(_mm256_and_si256(result1, result2))) != 0xffffffffU)
+            break;
+    }
+    return offset;
+}
+
+// returns the number of characters before the first block of 16 containing c
+QT_FUNCTION_TARGET(AVX2)
+static qptrdiff findChar_avx2(const ushort *n, qptrdiff l, ushort c)
+{
+    const __m256i mch = _mm256_set1_epi16(short(c));
+    qptrdiff offset = 0;
+    for ( ; offset + 15 < l; offset += 16) {
+        const __m256i data = _mm256_loadu_si256((const __m256i *)(n + offset));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(data, mch)))
+            break;
+    }
+    return offset;
+}
+#else
+static inline bool hasAvx2()
+{
+    return false;
+}
+
+static inline qptrdiff qt_from_latin1_avx2(ushort *, const char *, qptrdiff)
+{ return 0; }
+static inline qptrdiff qt_to_latin1_avx2(uchar *, const ushort *, qptrdiff)
+{ return 0; }
+static inline qptrdiff ucstrncmp_avx2(const ushort *, const ushort *, qptrdiff)
+{ return 0; }
+static inline qptrdiff ucstrncmp_avx2(const ushort *, const uchar *, qptrdiff)
+{ return 0; }
+static inline qptrdiff findChar_avx2(const ushort *, qptrdiff, ushort)
+{ return 0; }
+#endif
+
 // conversion between Latin 1 and UTF-16
 void qt_from_latin1(ushort *dst, const char *str, size_t size)
 {
+    if (size >= 32 && hasAvx2()) {
+        const qptrdiff done = qt_from_latin1_avx2(dst, str, size);
+        dst += done;
+        str += done;
+        size -= done;
+    }
+
     /* SIMD:
      * Unpacking with SSE has been shown to improve performance on recent CPUs
      * The same method gives no improvement with NEON.
@@ -311,6 +432,13 @@ static inline __m128i mergeQuestionMarks(__m128i chunk)
 
 static void qt_to_latin1(uchar *dst, const ushort *src, int length)
 {
+    if (length >= 32 && hasAvx2()) {
+        const int done = int(qt_to_latin1_avx2(dst, src, length));
+        dst += done;
+        src += done;
+        length -= done;
+    }
+
 #if defined(__SSE2__)
     uchar *e = dst + length;
     qptrdiff offset = 0;
@@ -450,6 +578,13 @@ static int ucstrncmp(const QChar *a, const QChar *b, int l)
                                          l);
     }
 #endif // __mips_dsp
+    if (l >= 16 && hasAvx2()) {
+        const int same = int(ucstrncmp_avx2(reinterpret_cast<const ushort *>(a),
+                                            reinterpret_cast<const ushort *>(b), l));
+        a += same;
+        b += same;
+        l -= same;
+    }
 #ifdef __SSE2__
     const char *ptr = reinterpret_cast<const char*>(a);
     qptrdiff distance = reinterpret_cast<const char*>(b) - ptr;
@@ -533,6 +668,12 @@ static int ucstrncmp(const QChar *a, const uchar *c, int l)
     const ushort *uc = reinterpret_cast<const ushort *>(a);
     const ushort *e = uc + l;
 
+    if (l >= 32 && hasAvx2()) {
+        const qptrdiff same = ucstrncmp_avx2(uc, c, l);
+        uc += same;
+        c += same;
+    }
+
 #ifdef __SSE2__
     __m128i nullmask = _mm_setzero_si128();
     qptrdiff offset = 0;
@@ -668,6 +809,8 @@ static int findChar(const QChar *str, int len, QChar ch, int from,
         const ushort *n = s + from;
         const ushort *e = s + len;
         if (cs == Qt::CaseSensitive) {
+            if (e - n >= 16 && hasAvx2())
+                n += findChar_avx2(n, e - n, c);
 #ifdef __SSE2__
             __m128i mch = _mm_set1_epi32(c | (c << 16));
 
@@ -1094,6 +1237,10 @@ const QString::Null QString::null = { };
     formats, the \e precision represents the maximum number of
     significant digits (trailing zeroes are omitted).
 
+    A \e precision of QLocale::FloatingPointShortest selects as many digits
+    as are needed to convert the string back to the exact same number, and
+    no more.
+
     \section1 More Efficient String Construction
 
     Many strings are known at compile time. But the trivial
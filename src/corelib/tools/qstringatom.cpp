@@ -0,0 +1,476 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qstringatom.h"
+#include "qstringatom_p.h"
+
+#include "qhash.h"
+#include "qreadwritelock.h"
+#include "qvarlengtharray.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+void qt_from_latin1(ushort *dst, const char *str, size_t size);
+extern void qt_initialize_qhash_seed(); // qhash.cpp
+extern Q_CORE_EXPORT QBasicAtomicInt qt_qhash_seed; // qhash.cpp
+
+QBasicAtomicInt qt_stringAtomClients = Q_BASIC_ATOMIC_INITIALIZER(0);
+QBasicAtomicInt qt_stringAtomTableFull = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+namespace {
+
+// Every atom is one block that is never freed: the QString referring to the
+// data, the precomputed hash and the immortal QStringData with the
+// characters. The blocks are carved out of larger arena blocks, so that an
+// atom costs no more than its header and characters.
+struct AtomEntry
+{
+    QString string;
+    uint hash;
+};
+
+enum {
+    ShardCount = 32,
+    ArenaBlockSize = 16 * 1024,
+    MinimumTableSize = 64,
+    // the parsers stop interning when the table holds this many strings,
+    // see qt_isInterning()
+    AutomaticInterningLimit = 64 * 1024
+};
+
+static inline size_t alignedSize(size_t size)
+{
+    return (size + 7) & ~size_t(7);
+}
+
+// One shard of the atom table: an open addressing hash table with linear
+// probing, kept at most half full. Lookups take the read lock, insertions
+// the write lock.
+class AtomShard
+{
+public:
+    AtomShard() : size(0), table(0), capacity(0), arena(0), arenaLeft(0) {}
+
+    const AtomEntry *find(const QChar *unicode, int length, uint hash) const;
+    const AtomEntry *insert(const QChar *unicode, int length, uint hash);
+
+    QReadWriteLock lock;
+    int size;
+
+private:
+    void rehash(int newCapacity);
+    char *allocate(size_t size);
+
+    const AtomEntry **table;
+    int capacity;
+    char *arena;
+    size_t arenaLeft;
+};
+
+const AtomEntry *AtomShard::find(const QChar *unicode, int length, uint hash) const
+{
+    if (!capacity)
+        return 0;
+    const uint mask = capacity - 1;
+    for (uint i = hash & mask; ; i = (i + 1) & mask) {
+        const AtomEntry *e = table[i];
+        if (!e)
+            return 0;
+        if (e->hash == hash && e->string.size() == length
+            && memcmp(e->string.constData(), unicode, length * sizeof(QChar)) == 0)
+            return e;
+    }
+}
+
+const AtomEntry *AtomShard::insert(const QChar *unicode, int length, uint hash)
+{
+    if ((size + 1) * 2 > capacity)
+        rehash(capacity ? capacity * 2 : int(MinimumTableSize));
+
+    const size_t headerSize = alignedSize(sizeof(AtomEntry));
+    char *block = allocate(headerSize + sizeof(QStringData) + (length + 1) * sizeof(QChar));
+
+    // a ref count of -1 makes the data static: copies of the string never
+    // touch the ref count and modifying one detaches it
+    QStringData *data = reinterpret_cast<QStringData *>(block + headerSize);
+    data->ref.atomic.store(-1);
+    data->size = length;
+    data->alloc = 0;
+    data->capacityReserved = false;
+    data->offset = sizeof(QStringData);
+    memcpy(data->data(), unicode, length * sizeof(QChar));
+    data->data()[length] = 0;
+
+    AtomEntry *e = reinterpret_cast<AtomEntry *>(block);
+    QStringDataPtr dataPtr = { data };
+    new (&e->string) QString(dataPtr);
+    e->hash = hash;
+
+    const uint mask = capacity - 1;
+    uint i = hash & mask;
+    while (table[i])
+        i = (i + 1) & mask;
+    table[i] = e;
+    ++size;
+    return e;
+}
+
+void AtomShard::rehash(int newCapacity)
+{
+    const AtomEntry **newTable = static_cast<const AtomEntry **>(calloc(newCapacity, sizeof(AtomEntry *)));
+    Q_CHECK_PTR(newTable);
+    const uint mask = newCapacity - 1;
+    for (int n = 0; n < capacity; ++n) {
+        if (const AtomEntry *e = table[n]) {
+            uint i = e->hash & mask;
+            while (newTable[i])
+                i = (i + 1) & mask;
+            newTable[i] = e;
+        }
+    }
+    free(table);
+    table = newTable;
+    capacity = newCapacity;
+}
+
+char *AtomShard::allocate(size_t size)
+{
+    size = alignedSize(size);
+    if (size > ArenaBlockSize / 4) {
+        char *block = static_cast<char *>(malloc(size));
+        Q_CHECK_PTR(block);
+        return block;
+    }
+    if (size > arenaLeft) {
+        // the rest of the old block is wasted; it is less than a quarter
+        // of a block in the worst case
+        arena = static_cast<char *>(malloc(ArenaBlockSize));
+        Q_CHECK_PTR(arena);
+        arenaLeft = ArenaBlockSize;
+    }
+    char *block = arena;
+    arena += size;
+    arenaLeft -= size;
+    return block;
+}
+
+struct AtomTable
+{
+    AtomTable() : count(0)
+    {
+        // the seed must not change while the table exists, so it is taken
+        // once; qt_initialize_qhash_seed() makes all threads agree on it
+        qt_initialize_qhash_seed();
+        seed = uint(qt_qhash_seed.load());
+    }
+
+    AtomShard shards[ShardCount];
+    uint seed;
+    QAtomicInt count;
+};
+
+// The table is intentionally never destroyed: interned strings may be
+// referenced from other global objects that outlive any static destructor.
+static QBasicAtomicPointer<AtomTable> atomTable = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+static AtomTable *atoms()
+{
+    AtomTable *table = atomTable.loadAcquire();
+    if (!table) {
+        AtomTable *created = new AtomTable;
+        if (atomTable.testAndSetOrdered(0, created, table)) {
+            table = created;
+        } else {
+            delete created;
+        }
+    }
+    return table;
+}
+
+} // unnamed namespace
+
+const QString *qt_internString(const QChar *unicode, int size)
+{
+    AtomTable *table = atoms();
+    // the hash is seeded, so that the strings colliding in the probe
+    // sequences of a shard cannot be predicted by the input
+    const uint hash = qHashBits(unicode, size * sizeof(QChar), table->seed);
+    // the shard is selected with the high bits, the slot with the low ones
+    AtomShard &shard = table->shards[hash >> 27];
+
+    {
+        QReadLocker locker(&shard.lock);
+        if (const AtomEntry *e = shard.find(unicode, size, hash))
+            return &e->string;
+    }
+
+    QWriteLocker locker(&shard.lock);
+    const AtomEntry *e = shard.find(unicode, size, hash);
+    if (!e) {
+        e = shard.insert(unicode, size, hash);
+        if (table->count.fetchAndAddRelaxed(1) + 1 >= AutomaticInterningLimit)
+            qt_stringAtomTableFull.store(1);
+    }
+    return &e->string;
+}
+
+/*!
+    \class QStringAtom
+    \inmodule QtCore
+    \since 5.5
+    \brief The QStringAtom class represents an interned string.
+
+    \ingroup tools
+    \ingroup string-processing
+
+    \threadsafe
+
+    Data sets such as JSON documents, XML files and configuration files
+    usually repeat a small set of keys and names many times. Every
+    QString created while parsing them owns a separate copy of its
+    characters. QStringAtom keeps a single copy of each distinct string
+    in a process-wide table, so that all strings interned from equal
+    input share the same data.
+
+    Interned strings are never freed. Their data is static, which means
+    that copying an interned QString does not touch a reference count,
+    and modifying a copy detaches it like modifying any other shared
+    string. Since the table only grows, interning is meant for strings
+    drawn from a bounded vocabulary, not for arbitrary values.
+    QStringAtom itself does not limit the size of the table.
+
+    A QStringAtom is a single pointer. Two atoms compare equal if and only
+    if their strings are equal, and hash() returns a hash value that was
+    computed when the string was interned, which makes QStringAtom a cheap
+    key for QHash and QSet.
+
+    \snippet code/src_corelib_tools_qstringatom.cpp 0
+
+    The static intern() functions return the interned QString directly.
+    Passing a string that is already in the table does not allocate
+    memory.
+
+    \section1 Automatic Interning
+
+    Some parsers in Qt Core can intern the keys and names they produce.
+    This is off by default and can be enabled for the whole process with
+    setAutomaticInterning():
+
+    \list
+    \li QStringAtom::JsonObjectKeys: the keys returned by QJsonObject,
+        for instance by keys(), toVariantMap() and the iterators.
+    \li QStringAtom::XmlStreamNames: element and attribute names reported
+        by QXmlStreamReader.
+    \li QStringAtom::SettingsKeys: the keys read from INI files by QSettings.
+    \endlist
+
+    Since the parsed data may come from untrusted sources, the parsers
+    stop interning once the table holds 65536 strings, whoever added
+    them. From then on they create ordinary strings, as if automatic
+    interning was disabled.
+*/
+
+/*!
+    \enum QStringAtom::Client
+
+    This enum describes the parsers that can intern the strings they
+    produce.
+
+    \value JsonObjectKeys Keys of QJsonObject.
+    \value XmlStreamNames Element and attribute names reported by QXmlStreamReader.
+    \value SettingsKeys Keys read from INI files by QSettings.
+
+    \sa setAutomaticInterning()
+*/
+
+/*!
+    \fn QStringAtom::QStringAtom()
+
+    Constructs a null atom.
+
+    \sa isNull()
+*/
+
+/*!
+    Constructs the atom for \a str, adding it to the table if necessary.
+    If \a str is null, the atom is null.
+*/
+QStringAtom::QStringAtom(const QString &str)
+    : d(str.isNull() ? 0 : qt_internString(str.constData(), str.size()))
+{
+}
+
+/*!
+    Constructs the atom for the Latin-1 string \a str, adding it to the
+    table if necessary. If \a str is null, the atom is null.
+*/
+QStringAtom::QStringAtom(QLatin1String str)
+    : d(0)
+{
+    if (!str.data())
+        return;
+    QVarLengthArray<ushort, 256> buffer(str.size());
+    qt_from_latin1(buffer.data(), str.data(), str.size());
+    d = qt_internString(reinterpret_cast<const QChar *>(buffer.constData()), str.size());
+}
+
+/*!
+    Constructs the atom for the first \a size characters of \a unicode,
+    adding it to the table if necessary. If \a unicode is 0, the atom is
+    null.
+*/
+QStringAtom::QStringAtom(const QChar *unicode, int size)
+    : d(unicode ? qt_internString(unicode, size) : 0)
+{
+}
+
+/*!
+    \fn bool QStringAtom::isNull() const
+
+    Returns \c true if this atom was default constructed or created from
+    a null string; otherwise returns \c false.
+*/
+
+/*!
+    \fn QString QStringAtom::toString() const
+
+    Returns the interned string. The returned string shares the static
+    data held by the table.
+*/
+
+/*!
+    \fn int QStringAtom::size() const
+
+    Returns the number of characters in the interned string.
+*/
+
+/*!
+    Returns the hash value of the string computed when it was interned,
+    or 0 for a null atom. Like the hash values used by QHash, it is seeded
+    per process, so it usually differs between runs of the application.
+
+    \sa qHash()
+*/
+uint QStringAtom::hash() const
+{
+    return d ? reinterpret_cast<const AtomEntry *>(d)->hash : 0;
+}
+
+/*!
+    Returns the interned copy of \a str. If \a str is null, a null string
+    is returned.
+*/
+QString QStringAtom::intern(const QString &str)
+{
+    return QStringAtom(str).toString();
+}
+
+/*!
+    \overload
+
+    Returns the interned copy of the Latin-1 string \a str.
+*/
+QString QStringAtom::intern(QLatin1String str)
+{
+    return QStringAtom(str).toString();
+}
+
+/*!
+    \overload
+
+    Returns the interned copy of the first \a size characters of \a unicode.
+*/
+QString QStringAtom::intern(const QChar *unicode, int size)
+{
+    return QStringAtom(unicode, size).toString();
+}
+
+/*!
+    Returns the number of distinct strings interned so far.
+*/
+int QStringAtom::count()
+{
+    AtomTable *table = atomTable.loadAcquire();
+    return table ? table->count.load() : 0;
+}
+
+/*!
+    Enables automatic interning for the parsers in \a clients and disables
+    it for all others. Objects that were already parsed are not affected.
+
+    \sa automaticInterning()
+*/
+void QStringAtom::setAutomaticInterning(Clients clients)
+{
+    qt_stringAtomClients.store(int(clients));
+}
+
+/*!
+    Returns the parsers for which automatic interning is enabled. The
+    default is none.
+
+    \sa setAutomaticInterning()
+*/
+QStringAtom::Clients QStringAtom::automaticInterning()
+{
+    return Clients(qt_stringAtomClients.load());
+}
+
+/*!
+    \fn bool operator==(QStringAtom a1, QStringAtom a2)
+    \relates QStringAtom
+
+    Returns \c true if \a a1 and \a a2 refer to the same string; otherwise
+    returns \c false.
+*/
+
+/*!
+    \fn bool operator!=(QStringAtom a1, QStringAtom a2)
+    \relates QStringAtom
+
+    Returns \c true if \a a1 and \a a2 refer to different strings;
+    otherwise returns \c false.
+*/
+
+/*!
+    \fn uint qHash(QStringAtom key, uint seed = 0)
+    \relates QStringAtom
+
+    Returns the hash value for \a key, using \a seed to seed the
+    calculation. This does not look at the characters of the string.
+*/
+
+QT_END_NAMESPACE
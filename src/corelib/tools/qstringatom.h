@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSTRINGATOM_H
+#define QSTRINGATOM_H
+
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class Q_CORE_EXPORT QStringAtom
+{
+public:
+    enum Client {
+        JsonObjectKeys = 0x1,
+        XmlStreamNames = 0x2,
+        SettingsKeys = 0x4
+    };
+    Q_DECLARE_FLAGS(Clients, Client)
+
+    Q_DECL_CONSTEXPR inline QStringAtom() : d(0) {}
+    explicit QStringAtom(const QString &str);
+    explicit QStringAtom(QLatin1String str);
+    QStringAtom(const QChar *unicode, int size);
+
+    inline bool isNull() const { return !d; }
+    inline QString toString() const { return d ? *d : QString(); }
+    inline int size() const { return d ? d->size() : 0; }
+    uint hash() const;
+
+    static QString intern(const QString &str);
+    static QString intern(QLatin1String str);
+    static QString intern(const QChar *unicode, int size);
+    static int count();
+
+    static void setAutomaticInterning(Clients clients);
+    static Clients automaticInterning();
+
+    friend inline bool operator==(QStringAtom a1, QStringAtom a2) { return a1.d == a2.d; }
+    friend inline bool operator!=(QStringAtom a1, QStringAtom a2) { return a1.d != a2.d; }
+
+private:
+    const QString *d;
+};
+
+Q_DECLARE_TYPEINFO(QStringAtom, Q_PRIMITIVE_TYPE);
+Q_DECLARE_OPERATORS_FOR_FLAGS(QStringAtom::Clients)
+
+inline uint qHash(QStringAtom key, uint seed = 0) Q_DECL_NOTHROW
+{ return key.hash() ^ seed; }
+
+QT_END_NAMESPACE
+
+#endif // QSTRINGATOM_H
@@ -0,0 +1,70 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSTRINGATOM_P_H
+#define QSTRINGATOM_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qstringatom.h"
+#include <QtCore/qatomic.h>
+
+QT_BEGIN_NAMESPACE
+
+// the clients passed to QStringAtom::setAutomaticInterning(), kept here so
+// that the parsers can test them without a function call per key
+extern Q_CORE_EXPORT QBasicAtomicInt qt_stringAtomClients;
+// set once the table has reached its limit for automatic interning
+extern Q_CORE_EXPORT QBasicAtomicInt qt_stringAtomTableFull;
+
+static inline bool qt_isInterning(QStringAtom::Client client)
+{
+    return (qt_stringAtomClients.load() & client) && !qt_stringAtomTableFull.load();
+}
+
+// returns the interned copy of the string; the QString object itself lives
+// as long as the atom table, so QStringRefs may point at it
+Q_CORE_EXPORT const QString *qt_internString(const QChar *unicode, int size);
+
+QT_END_NAMESPACE
+
+#endif // QSTRINGATOM_P_H
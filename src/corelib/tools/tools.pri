@@ -11,6 +11,7 @@ HEADERS +=  \
         tools/qbytearray.h \
         tools/qbytearraylist.h \
         tools/qbytearraymatcher.h \
+        tools/qbytearrayview.h \
         tools/qbytedata_p.h \
         tools/qcache.h \
         tools/qchar.h \
@@ -25,6 +26,7 @@ HEADERS +=  \
         tools/qdatetimeparser_p.h \
         tools/qeasingcurve.h \
         tools/qfreelist_p.h \
+        tools/qflathash.h \
         tools/qhash.h \
         tools/qiterator.h \
         tools/qline.h \
@@ -54,10 +56,13 @@ HEADERS +=  \
         tools/qsharedpointer_impl.h \
         tools/qset.h \
         tools/qsimd_p.h \
+        tools/qsmallbytearray_p.h \
         tools/qsize.h \
         tools/qstack.h \
         tools/qstring.h \
         tools/qstringalgorithms_p.h \
+        tools/qstringatom.h \
+        tools/qstringatom_p.h \
         tools/qstringbuilder.h \
         tools/qstringiterator_p.h \
         tools/qstringlist.h \
@@ -81,6 +86,7 @@ SOURCES += \
         tools/qbytearray.cpp \
         tools/qbytearraylist.cpp \
         tools/qbytearraymatcher.cpp \
+        tools/qbytearrayview.cpp \
         tools/qcollator.cpp \
         tools/qcommandlineoption.cpp \
         tools/qcommandlineparser.cpp \
@@ -89,6 +95,7 @@ SOURCES += \
         tools/qdatetimeparser.cpp \
         tools/qeasingcurve.cpp \
         tools/qelapsedtimer.cpp \
+        tools/qflathash.cpp \
         tools/qfreelist.cpp \
         tools/qhash.cpp \
         tools/qline.cpp \
@@ -109,6 +116,7 @@ SOURCES += \
         tools/qsimd.cpp \
         tools/qsize.cpp \
         tools/qstring.cpp \
+        tools/qstringatom.cpp \
         tools/qstringbuilder.cpp \
         tools/qstringlist.cpp \
         tools/qtextboundaryfinder.cpp \
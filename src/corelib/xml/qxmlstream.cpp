@@ -44,6 +44,7 @@
 #include <qbuffer.h>
 #ifndef QT_BOOTSTRAPPED
 #include <qcoreapplication.h>
+#include <private/qstringatom_p.h>
 #else
 // This specialization of Q_DECLARE_TR_FUNCTIONS is not in qcoreapplication.h,
 // because that header depends on QObject being available, which is not the
@@ -1610,8 +1611,16 @@ void QXmlStreamReaderPrivate::resolveTag()
         QStringRef qualifiedName(symName(attrib.key));
         QStringRef value(symString(attrib.value));
 
-        attribute.m_name = QXmlStreamStringRef(name);
-        attribute.m_qualifiedName = QXmlStreamStringRef(qualifiedName);
+#ifndef QT_BOOTSTRAPPED
+        if (qt_isInterning(QStringAtom::XmlStreamNames)) {
+            attribute.m_name = QXmlStreamStringRef(QStringRef(qt_internString(name.unicode(), name.size())));
+            attribute.m_qualifiedName = QXmlStreamStringRef(QStringRef(qt_internString(qualifiedName.unicode(), qualifiedName.size())));
+        } else
+#endif
+        {
+            attribute.m_name = QXmlStreamStringRef(name);
+            attribute.m_qualifiedName = QXmlStreamStringRef(qualifiedName);
+        }
         attribute.m_value = QXmlStreamStringRef(value);
 
         if (!prefix.isEmpty()) {
@@ -710,6 +710,13 @@ public:
         tagStackStringStorageSize += sz;
         return QStringRef(&tagStackStringStorage, pos, sz);
     }
+    inline QStringRef addNameToStringStorage(const QStringRef &s) {
+#ifndef QT_BOOTSTRAPPED
+        if (!s.isEmpty() && qt_isInterning(QStringAtom::XmlStreamNames))
+            return QStringRef(qt_internString(s.unicode(), s.size()));
+#endif
+        return addToStringStorage(s);
+    }
 
     QXmlStreamSimpleStack<Tag> tagStack;
 
@@ -1746,8 +1753,8 @@ bool QXmlStreamReaderPrivate::parse()
             normalizeLiterals = true;
             Tag &tag = tagStack_push();
             prefix = tag.namespaceDeclaration.prefix  = addToStringStorage(symPrefix(2));
-            name = tag.name = addToStringStorage(symString(2));
-            qualifiedName = tag.qualifiedName = addToStringStorage(symName(2));
+            name = tag.name = addNameToStringStorage(symString(2));
+            qualifiedName = tag.qualifiedName = addNameToStringStorage(symName(2));
             if ((!prefix.isEmpty() && !QXmlUtils::isNCName(prefix)) || !QXmlUtils::isNCName(name))
                 raiseWellFormedError(QXmlStream::tr("Invalid XML name."));
         } break;
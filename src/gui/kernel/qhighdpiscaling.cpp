@@ -44,6 +44,8 @@
 #include "qguiapplication.h"
 #include "qscreen.h"
 #include "private/qscreen_p.h"
+#include "qwindowsysteminterface.h"
+#include <qpa/qplatformwindow.h>
 
 #include <QtCore/qdebug.h>
 
@@ -119,28 +121,37 @@ void QHighDpiScaling::setFactor(qreal factor)
          screen->d_func()->updateHighDpi();
 }
 
-static const char *scaleFactorProperty = "_q_scaleFactor";
-
+/*
+    Sets an additional scale factor for \a window, on top of the
+    process-global one. If the window has already been created, its
+    geometry is updated and it is exposed again at the new scale.
+*/
 void QHighDpiScaling::setWindowFactor(QWindow *window, qreal factor)
 {
     m_perWindowActive = true;
-    window->setProperty(scaleFactorProperty, QVariant(factor));
+    m_active = true;
+
+    QWindowPrivate *d = QWindowPrivate::get(window);
+    if (qFuzzyCompare(factor, d->scaleFactor))
+        return;
+    d->scaleFactor = factor;
+
+    if (QPlatformWindow *platformWindow = window->handle()) {
+        const QRect geometry = platformWindow->geometry();
+        QWindowSystemInterface::handleGeometryChange(window, geometry);
+        if (window->isExposed())
+            QWindowSystemInterface::handleExposeEvent(window, QRect(QPoint(), geometry.size()));
+    }
 }
 
-qreal QHighDpiScaling::factor(const QWindow *window)
+// Slow path of factor(), for per-window scaling and for scaling by
+// the device pixel ratio of the window.
+qreal QHighDpiScaling::windowFactor(const QWindow *window)
 {
-    if (window == 0)
-        return m_factor;
-
-    if (!m_perWindowActive) {
-        if (m_isFactor)
-            return m_factor;
-        else
-            return m_factor / (window->handle()? window->handle()->devicePixelRatio() : qreal(1.0));
-    }
+    if (!m_perWindowActive)
+        return m_factor / (window->handle() ? window->handle()->devicePixelRatio() : qreal(1.0));
 
-    QVariant windowFactor = window->property(scaleFactorProperty);
-    return m_factor * (windowFactor.isValid() ? windowFactor.toReal() : 1);
+    return m_factor * QWindowPrivate::get(window)->scaleFactor;
 }
 
 bool QHighDpiScaling::scaleDpi()
@@ -48,6 +48,7 @@
 #include <QtCore/qvector.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtGui/qregion.h>
+#include <QtGui/qpolygon.h>
 
 // This file implmements utility functions for high-dpi scaling on operating
 // systems that do not provide native scaling support.
@@ -79,11 +80,18 @@ Q_DECLARE_LOGGING_CATEGORY(lcScaling);
 class Q_GUI_EXPORT QHighDpiScaling {
 public:
     static bool isActive() { return m_active; }
-    static qreal factor(const QWindow *window = 0);
+    static qreal factor(const QWindow *window = 0)
+    {
+        if (!window || (!m_perWindowActive && m_isFactor))
+            return m_factor;
+        return windowFactor(window);
+    }
     static bool scaleDpi();
     static void setFactor(qreal factor);
     static void setWindowFactor(QWindow *window, qreal factor);
 private:
+    static qreal windowFactor(const QWindow *window);
+
     static qreal m_factor;
     static bool m_scaleDpi;
     static bool m_isFactor;
@@ -175,15 +183,92 @@ inline QMargins qHighDpiToDevicePixels(const QMargins &pointMargins, const QWind
                     pointMargins.right() * scaleFactor, pointMargins.bottom() * scaleFactor);
 }
 
+// Batch conversion helpers: convert \a count values in place, with the
+// scale factor hoisted out of the loop. Scaling up by a whole number
+// uses integer arithmetic, which is exact and needs no rounding.
+template <typename T>
+inline void qHighDpiScaleDown(T *values, int count, qreal scaleFactor)
+{
+    for (T *end = values + count; values != end; ++values)
+        *values = *values / scaleFactor;
+}
+
+template <typename T>
+inline void qHighDpiScaleUp(T *values, int count, qreal scaleFactor)
+{
+    const int intFactor = int(scaleFactor);
+    if (qreal(intFactor) == scaleFactor) {
+        for (T *end = values + count; values != end; ++values)
+            *values = *values * intFactor;
+    } else {
+        for (T *end = values + count; values != end; ++values)
+            *values = *values * scaleFactor;
+    }
+}
+
+inline void qHighDpiScaleDown(QRect *rects, int count, qreal scaleFactor)
+{
+    for (QRect *end = rects + count; rects != end; ++rects)
+        *rects = QRect(rects->topLeft() / scaleFactor, rects->size() / scaleFactor);
+}
+
+inline void qHighDpiScaleUp(QRect *rects, int count, qreal scaleFactor)
+{
+    const int intFactor = int(scaleFactor);
+    if (qreal(intFactor) == scaleFactor) {
+        for (QRect *end = rects + count; rects != end; ++rects)
+            *rects = QRect(rects->topLeft() * intFactor, rects->size() * intFactor);
+    } else {
+        for (QRect *end = rects + count; rects != end; ++rects)
+            *rects = QRect(rects->topLeft() * scaleFactor, rects->size() * scaleFactor);
+    }
+}
+
+// Returns true if all of \a rects are aligned to multiples of \a factor,
+// so that dividing them by it is exact.
+inline bool qHighDpiIsAligned(const QRect *rects, int count, int factor)
+{
+    for (const QRect *end = rects + count; rects != end; ++rects) {
+        if (rects->x() % factor || rects->y() % factor
+            || rects->width() % factor || rects->height() % factor)
+            return false;
+    }
+    return true;
+}
+
+// Exact conversions keep the y-x sorted, banded and non-overlapping
+// rects of a region valid, so the result can be set directly instead of
+// being rebuilt by uniting the rects one by one.
+inline QRegion qHighDpiRegionFromRects(const QVector<QRect> &rects, bool exact)
+{
+    QRegion region;
+    if (exact) {
+        region.setRects(rects.constData(), rects.size());
+    } else {
+        for (int i = 0; i < rects.size(); ++i)
+            region += rects.at(i);
+    }
+    return region;
+}
+
 inline QRegion qHighDpiToDeviceIndependentPixels(const QRegion &pixelRegion, const QWindow *window = 0)
 {
     if (!QHighDpiScaling::isActive())
         return pixelRegion;
 
-    QRegion pointRegion;
-    foreach (const QRect &rect, pixelRegion.rects())
-        pointRegion += qHighDpiToDeviceIndependentPixels(rect, window);
-    return pointRegion;
+    const qreal scaleFactor = QHighDpiScaling::factor(window);
+    if (pixelRegion.rectCount() <= 1) {
+        QRect rect = pixelRegion.boundingRect();
+        qHighDpiScaleDown(&rect, 1, scaleFactor);
+        return QRegion(rect);
+    }
+
+    QVector<QRect> rects = pixelRegion.rects();
+    const int intFactor = int(scaleFactor);
+    const bool exact = qreal(intFactor) == scaleFactor
+            && qHighDpiIsAligned(rects.constData(), rects.size(), intFactor);
+    qHighDpiScaleDown(rects.data(), rects.size(), scaleFactor);
+    return qHighDpiRegionFromRects(rects, exact);
 }
 
 inline QRegion qHighDpiToDevicePixels(const QRegion &pointRegion, const QWindow *window = 0)
@@ -191,10 +276,57 @@ inline QRegion qHighDpiToDevicePixels(const QRegion &pointRegion, const QWindow
     if (!QHighDpiScaling::isActive())
         return pointRegion;
 
-    QRegion pixelRegon;
-    foreach (const QRect &rect, pointRegion.rects())
-        pixelRegon += qHighDpiToDevicePixels(rect, window);
-    return pixelRegon;
+    const qreal scaleFactor = QHighDpiScaling::factor(window);
+    if (pointRegion.rectCount() <= 1) {
+        QRect rect = pointRegion.boundingRect();
+        qHighDpiScaleUp(&rect, 1, scaleFactor);
+        return QRegion(rect);
+    }
+
+    QVector<QRect> rects = pointRegion.rects();
+    const bool exact = qreal(int(scaleFactor)) == scaleFactor;
+    qHighDpiScaleUp(rects.data(), rects.size(), scaleFactor);
+    return qHighDpiRegionFromRects(rects, exact);
+}
+
+inline QPolygon qHighDpiToDeviceIndependentPixels(const QPolygon &pixelPolygon, const QWindow *window = 0)
+{
+    if (!QHighDpiScaling::isActive())
+        return pixelPolygon;
+
+    QPolygon pointPolygon(pixelPolygon);
+    qHighDpiScaleDown(pointPolygon.data(), pointPolygon.size(), QHighDpiScaling::factor(window));
+    return pointPolygon;
+}
+
+inline QPolygon qHighDpiToDevicePixels(const QPolygon &pointPolygon, const QWindow *window = 0)
+{
+    if (!QHighDpiScaling::isActive())
+        return pointPolygon;
+
+    QPolygon pixelPolygon(pointPolygon);
+    qHighDpiScaleUp(pixelPolygon.data(), pixelPolygon.size(), QHighDpiScaling::factor(window));
+    return pixelPolygon;
+}
+
+inline QPolygonF qHighDpiToDeviceIndependentPixels(const QPolygonF &pixelPolygon, const QWindow *window = 0)
+{
+    if (!QHighDpiScaling::isActive())
+        return pixelPolygon;
+
+    QPolygonF pointPolygon(pixelPolygon);
+    qHighDpiScaleDown(pointPolygon.data(), pointPolygon.size(), QHighDpiScaling::factor(window));
+    return pointPolygon;
+}
+
+inline QPolygonF qHighDpiToDevicePixels(const QPolygonF &pointPolygon, const QWindow *window = 0)
+{
+    if (!QHighDpiScaling::isActive())
+        return pointPolygon;
+
+    QPolygonF pixelPolygon(pointPolygon);
+    qHighDpiScaleUp(pixelPolygon.data(), pixelPolygon.size(), QHighDpiScaling::factor(window));
+    return pixelPolygon;
 }
 
 // Any T that has operator/()
@@ -225,9 +357,8 @@ QVector<T> qHighDpiToDeviceIndependentPixels(const QVector<T> &pixelValues, cons
     if (!QHighDpiScaling::isActive())
         return pixelValues;
 
-    QVector<T> pointValues;
-    foreach (const T& pixelValue, pixelValues)
-        pointValues.append(pixelValue / QHighDpiScaling::factor(window));
+    QVector<T> pointValues(pixelValues);
+    qHighDpiScaleDown(pointValues.data(), pointValues.size(), QHighDpiScaling::factor(window));
     return pointValues;
 }
 
@@ -238,13 +369,11 @@ QVector<T> qHighDpiToDevicePixels(const QVector<T> &pointValues, const QWindow *
     if (!QHighDpiScaling::isActive())
         return pointValues;
 
-    QVector<T> pixelValues;
-    foreach (const T& pointValue, pointValues)
-        pixelValues.append(pointValue * QHighDpiScaling::factor(window));
+    QVector<T> pixelValues(pointValues);
+    qHighDpiScaleUp(pixelValues.data(), pixelValues.size(), QHighDpiScaling::factor(window));
     return pixelValues;
 }
 
-
 // Any QPair<T, U> where T and U has operator/()
 template <typename T, typename U>
 QPair<T, U> qHighDpiToDeviceIndependentPixels(const QPair<T, U> &pixelPair, const QWindow *window = 0)
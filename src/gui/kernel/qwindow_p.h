@@ -95,6 +95,7 @@ public:
         , hasCursor(false)
 #endif
         , compositing(false)
+        , scaleFactor(qreal(1.0))
     {
         isWindow = true;
     }
@@ -141,6 +142,7 @@ public:
     bool isPopup() const { return (windowFlags & Qt::WindowType_Mask) == Qt::Popup; }
 
     static QWindowPrivate *get(QWindow *window) { return window->d_func(); }
+    static const QWindowPrivate *get(const QWindow *window) { return window->d_func(); }
 
     QWindow::SurfaceType surfaceType;
     Qt::WindowFlags windowFlags;
@@ -183,6 +185,9 @@ public:
 #endif
 
     bool compositing;
+
+    // per-window high-dpi scale factor, see QHighDpiScaling::setWindowFactor()
+    qreal scaleFactor;
 };
 
 
@@ -444,6 +444,7 @@ void QWindowSystemInterface::handleTouchEvent(QWindow *w, QTouchDevice *device,
 QList<QTouchEvent::TouchPoint> QWindowSystemInterfacePrivate::convertTouchPoints(const QList<QWindowSystemInterface::TouchPoint> &points, QEvent::Type *type)
 {
     QList<QTouchEvent::TouchPoint> touchPoints;
+    touchPoints.reserve(points.size());
     Qt::TouchPointStates states;
     QTouchEvent::TouchPoint p;
 
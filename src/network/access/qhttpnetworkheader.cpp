@@ -47,6 +47,23 @@ QHttpNetworkHeaderPrivate::QHttpNetworkHeaderPrivate(const QHttpNetworkHeaderPri
 {
     url = other.url;
     fields = other.fields;
+    rawHeader = other.rawHeader;
+    rawFields = other.rawFields;
+}
+
+QList<QPair<QByteArray, QByteArray> > QHttpNetworkHeaderPrivate::headerFields() const
+{
+    if (rawFields.isEmpty())
+        return fields;
+
+    QList<QPair<QByteArray, QByteArray> > result;
+    result.reserve(rawFields.size() + fields.size());
+    for (int i = 0; i < rawFields.size(); ++i) {
+        const RawField &field = rawFields.at(i);
+        result.append(qMakePair(rawName(field).toByteArray(), rawValue(field).toByteArray()));
+    }
+    result += fields;
+    return result;
 }
 
 qint64 QHttpNetworkHeaderPrivate::contentLength() const
@@ -54,13 +71,20 @@ qint64 QHttpNetworkHeaderPrivate::contentLength() const
     bool ok = false;
     // We are not using the headerField() method here because servers might send us multiple content-length
     // headers which is crap (see QTBUG-15311). Therefore just take the first content-length header field.
-    QByteArray value;
+    QByteArrayView value;
+    bool found = false;
+    for (int i = 0; i < rawFields.size() && !found; ++i) {
+        if (rawName(rawFields.at(i)).compare("content-length", Qt::CaseInsensitive) == 0) {
+            value = rawValue(rawFields.at(i));
+            found = true;
+        }
+    }
     QList<QPair<QByteArray, QByteArray> >::ConstIterator it = fields.constBegin(),
                                                         end = fields.constEnd();
-    for ( ; it != end; ++it)
+    for ( ; it != end && !found; ++it)
         if (qstricmp("content-length", it->first) == 0) {
             value = it->second;
-            break;
+            found = true;
         }
 
     qint64 length = value.toULongLong(&ok);
@@ -76,24 +100,46 @@ void QHttpNetworkHeaderPrivate::setContentLength(qint64 length)
 
 QByteArray QHttpNetworkHeaderPrivate::headerField(const QByteArray &name, const QByteArray &defaultValue) const
 {
-    QList<QByteArray> allValues = headerFieldValues(name);
-    if (allValues.isEmpty())
-        return defaultValue;
-
+    // most fields appear once: share their value instead of building a list
     QByteArray result;
-    bool first = true;
-    foreach (const QByteArray &value, allValues) {
-        if (!first)
-            result += ", ";
-        first = false;
-        result += value;
+    bool found = false;
+    for (int i = 0; i < rawFields.size(); ++i) {
+        const RawField &field = rawFields.at(i);
+        if (rawName(field).compare(name, Qt::CaseInsensitive) == 0) {
+            const QByteArrayView value = rawValue(field);
+            if (found) {
+                result += ", ";
+                result.append(value.data(), value.size());
+            } else {
+                result = value.toByteArray();
+                found = true;
+            }
+        }
     }
-    return result;
+    QList<QPair<QByteArray, QByteArray> >::ConstIterator it = fields.constBegin(),
+                                                        end = fields.constEnd();
+    for ( ; it != end; ++it) {
+        if (qstricmp(name.constData(), it->first) == 0) {
+            if (found) {
+                result += ", ";
+                result += it->second;
+            } else {
+                result = it->second;
+                found = true;
+            }
+        }
+    }
+    return found ? result : defaultValue;
 }
 
 QList<QByteArray> QHttpNetworkHeaderPrivate::headerFieldValues(const QByteArray &name) const
 {
     QList<QByteArray> result;
+    for (int i = 0; i < rawFields.size(); ++i) {
+        const RawField &field = rawFields.at(i);
+        if (rawName(field).compare(name, Qt::CaseInsensitive) == 0)
+            result += rawValue(field).toByteArray();
+    }
     QList<QPair<QByteArray, QByteArray> >::ConstIterator it = fields.constBegin(),
                                                         end = fields.constEnd();
     for ( ; it != end; ++it)
@@ -105,6 +151,10 @@ QList<QByteArray> QHttpNetworkHeaderPrivate::headerFieldValues(const QByteArray
 
 void QHttpNetworkHeaderPrivate::setHeaderField(const QByteArray &name, const QByteArray &data)
 {
+    for (int i = rawFields.size() - 1; i >= 0; --i) {
+        if (rawName(rawFields.at(i)).compare(name, Qt::CaseInsensitive) == 0)
+            rawFields.remove(i);
+    }
     QList<QPair<QByteArray, QByteArray> >::Iterator it = fields.begin();
     while (it != fields.end()) {
         if (qstricmp(name.constData(), it->first) == 0)
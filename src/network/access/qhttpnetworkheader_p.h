@@ -48,6 +48,8 @@
 
 #include <qshareddata.h>
 #include <qurl.h>
+#include <qvector.h>
+#include <qbytearrayview.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -72,8 +74,27 @@ public:
 class QHttpNetworkHeaderPrivate : public QSharedData
 {
 public:
+    // A field of a received header, as offsets into rawHeader. It only
+    // becomes a QByteArray when it is looked up or the header is listed.
+    struct RawField
+    {
+        int nameOffset;
+        int nameSize;
+        int valueOffset;
+        int valueSize;
+    };
+
     QUrl url;
     QList<QPair<QByteArray, QByteArray> > fields;
+    // come before fields
+    QByteArray rawHeader;
+    QVector<RawField> rawFields;
+
+    inline QByteArrayView rawName(const RawField &field) const
+    { return QByteArrayView(rawHeader.constData() + field.nameOffset, field.nameSize); }
+    inline QByteArrayView rawValue(const RawField &field) const
+    { return QByteArrayView(rawHeader.constData() + field.valueOffset, field.valueSize); }
+    QList<QPair<QByteArray, QByteArray> > headerFields() const;
 
     QHttpNetworkHeaderPrivate(const QUrl &newUrl = QUrl());
     QHttpNetworkHeaderPrivate(const QHttpNetworkHeaderPrivate &other);
@@ -86,6 +107,7 @@ public:
     bool operator==(const QHttpNetworkHeaderPrivate &other) const;
 
 };
+Q_DECLARE_TYPEINFO(QHttpNetworkHeaderPrivate::RawField, Q_PRIMITIVE_TYPE);
 
 
 QT_END_NAMESPACE
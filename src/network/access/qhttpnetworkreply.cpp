@@ -34,7 +34,8 @@
 #include "qhttpnetworkreply_p.h"
 #include "qhttpnetworkconnection_p.h"
 
-#include <qbytearraymatcher.h>
+#include <QtCore/qbytearrayview.h>
+#include <private/qsmallbytearray_p.h>
 
 #ifndef QT_NO_HTTP
 
@@ -91,7 +92,7 @@ void QHttpNetworkReply::setContentLength(qint64 length)
 
 QList<QPair<QByteArray, QByteArray> > QHttpNetworkReply::header() const
 {
-    return d_func()->fields;
+    return d_func()->headerFields();
 }
 
 QByteArray QHttpNetworkReply::headerField(const QByteArray &name, const QByteArray &defaultValue) const
@@ -329,6 +330,8 @@ void QHttpNetworkReplyPrivate::clearHttpLayerInformation()
         inflateEnd(inflateStrm);
 #endif
     fields.clear();
+    rawFields.clear();
+    rawHeader.clear();
 }
 
 // TODO: Isn't everything HTTP layer related? We don't need to set connection and connectionChannel to 0 at all
@@ -340,6 +343,18 @@ void QHttpNetworkReplyPrivate::clear()
     clearHttpLayerInformation();
 }
 
+// Same as value.toLower().contains(token) for a lowercase token, without
+// allocating
+static bool headerFieldContains(const QByteArray &value, const char *token)
+{
+    const int tokenLength = qstrlen(token);
+    for (int i = 0; i + tokenLength <= value.size(); ++i) {
+        if (qstrnicmp(value.constData() + i, token, tokenLength) == 0)
+            return true;
+    }
+    return false;
+}
+
 // QHttpNetworkReplyPrivate
 qint64 QHttpNetworkReplyPrivate::bytesAvailable() const
 {
@@ -348,7 +363,7 @@ qint64 QHttpNetworkReplyPrivate::bytesAvailable() const
 
 bool QHttpNetworkReplyPrivate::isCompressed()
 {
-    QByteArray encoding = headerField("content-encoding");
+    QByteArray encoding = headerField(QByteArrayLiteral("content-encoding"));
     return qstricmp(encoding.constData(), "gzip") == 0 || qstricmp(encoding.constData(), "deflate") == 0;
 }
 
@@ -357,6 +372,12 @@ void QHttpNetworkReplyPrivate::removeAutoDecompressHeader()
     // The header "Content-Encoding  = gzip" is retained.
     // Content-Length is removed since the actual one sent by the server is for compressed data
     QByteArray name("content-length");
+    for (int i = 0; i < rawFields.size(); ++i) {
+        if (rawName(rawFields.at(i)).compare(name, Qt::CaseInsensitive) == 0) {
+            rawFields.remove(i);
+            return;
+        }
+    }
     QList<QPair<QByteArray, QByteArray> >::Iterator it = fields.begin(),
                                                    end = fields.end();
     while (it != end) {
@@ -484,7 +505,7 @@ bool QHttpNetworkReplyPrivate::parseStatus(const QByteArray &status)
 
     int i = spacePos;
     int j = status.indexOf(' ', i + 1); // j == -1 || at(j) == ' ' so j+1 == 0 && j+1 <= length()
-    const QByteArray code = status.mid(i + 1, j - i - 1);
+    const QByteArrayView code = QByteArrayView(status).mid(i + 1, j - i - 1);
 
     bool ok;
     statusCode = code.toInt(&ok);
@@ -543,15 +564,16 @@ qint64 QHttpNetworkReplyPrivate::readHeader(QAbstractSocket *socket)
         bodyLength = contentLength(); // cache the length
 
         // cache isChunked() since it is called often
-        chunkedTransferEncoding = headerField("transfer-encoding").toLower().contains("chunked");
+        chunkedTransferEncoding = headerFieldContains(headerField(QByteArrayLiteral("transfer-encoding")), "chunked");
 
         // cache isConnectionCloseEnabled since it is called often
-        QByteArray connectionHeaderField = headerField("connection");
+        QByteArray connectionHeaderField = headerField(QByteArrayLiteral("connection"));
+        QByteArray proxyConnectionHeaderField = headerField(QByteArrayLiteral("proxy-connection"));
         // check for explicit indication of close or the implicit connection close of HTTP/1.0
-        connectionCloseEnabled = (connectionHeaderField.toLower().contains("close") ||
-            headerField("proxy-connection").toLower().contains("close")) ||
+        connectionCloseEnabled = (headerFieldContains(connectionHeaderField, "close") ||
+            headerFieldContains(proxyConnectionHeaderField, "close")) ||
             (majorVersion == 1 && minorVersion == 0 &&
-            (connectionHeaderField.isEmpty() && !headerField("proxy-connection").toLower().contains("keep-alive")));
+            (connectionHeaderField.isEmpty() && !headerFieldContains(proxyConnectionHeaderField, "keep-alive")));
 
 #ifndef QT_NO_COMPRESS
         if (autoDecompress && isCompressed()) {
@@ -572,33 +594,72 @@ void QHttpNetworkReplyPrivate::parseHeader(const QByteArray &header)
 {
     // see rfc2616, sec 4 for information about HTTP/1.1 headers.
     // allows relaxed parsing here, accepts both CRLF & LF line endings
-    const QByteArrayMatcher lf("\n");
-    const QByteArrayMatcher colon(":");
+    // Field names and values are cut out of the header block as views, and
+    // stored as offsets into it. Only the first block of a reply can be
+    // kept like that, fields parsed after others are stored as copies.
+    const bool keepBlock = rawFields.isEmpty() && fields.isEmpty();
+    if (keepBlock)
+        rawHeader = header;
+    const char *data = header.constData();
+    const int size = header.size();
     int i = 0;
-    while (i < header.count()) {
-        int j = colon.indexIn(header, i); // field-name
-        if (j == -1)
+    while (i < size) {
+        const char *colon = static_cast<const char *>(memchr(data + i, ':', size - i));
+        if (!colon) // field-name
             break;
-        const QByteArray field = header.mid(i, j - i).trimmed();
+        int j = colon - data;
+        const QByteArrayView field = QByteArrayView(data + i, j - i).trimmed();
         j++;
         // any number of LWS is allowed before and after the value
-        QByteArray value;
+        QByteArrayView value;
+        // only values continued on further lines need to be assembled
+        QSmallByteArray continued;
+        bool isContinued = false;
         do {
-            i = lf.indexIn(header, j);
-            if (i == -1)
+            const char *lf = static_cast<const char *>(memchr(data + j, '\n', size - j));
+            if (!lf) {
+                i = -1;
                 break;
-            if (!value.isEmpty())
-                value += ' ';
+            }
+            i = lf - data;
             // check if we have CRLF or only LF
-            bool hasCR = (i && header[i-1] == '\r');
+            bool hasCR = (i && data[i-1] == '\r');
             int length = i -(hasCR ? 1: 0) - j;
-            value += header.mid(j, length).trimmed();
+            const QByteArrayView part = QByteArrayView(data + j, length).trimmed();
+            if (!isContinued && value.isNull()) {
+                value = part;
+            } else {
+                if (!isContinued) {
+                    continued.append(value.data(), value.size());
+                    isContinued = true;
+                }
+                if (!continued.isEmpty())
+                    continued.append(' ');
+                continued.append(part.data(), part.size());
+            }
             j = ++i;
-        } while (i < header.count() && (header.at(i) == ' ' || header.at(i) == '\t'));
+        } while (i < size && (data[i] == ' ' || data[i] == '\t'));
         if (i == -1)
             break; // something is wrong
 
-        fields.append(qMakePair(field, value));
+        if (!keepBlock) {
+            fields.append(qMakePair(field.toByteArray(),
+                                    isContinued ? continued.toByteArray() : value.toByteArray()));
+            continue;
+        }
+
+        RawField rawField;
+        rawField.nameOffset = field.data() - data;
+        rawField.nameSize = field.size();
+        if (isContinued) {
+            // assembled values go after the block
+            rawField.valueOffset = rawHeader.size();
+            rawHeader.append(continued.constData(), continued.size());
+        } else {
+            rawField.valueOffset = value.data() - data;
+        }
+        rawField.valueSize = isContinued ? continued.size() : value.size();
+        rawFields.append(rawField);
     }
 }
 
@@ -876,6 +937,11 @@ qint64 QHttpNetworkReplyPrivate::getChunkSize(QAbstractSocket *socket, qint64 *c
     char crlf[2];
     *chunkSize = -1;
 
+    // the chunk-size line is collected in fragment, which keeps its
+    // buffer from one chunk to the next
+    if (!fragment.capacity())
+        fragment.reserve(32);
+
     int bytesAvailable = socket->bytesAvailable();
     // FIXME rewrite to permanent loop without bytesAvailable
     while (bytesAvailable > bytes) {
@@ -891,9 +957,9 @@ qint64 QHttpNetworkReplyPrivate::getChunkSize(QAbstractSocket *socket, qint64 *c
                 bytes += socket->read(crlf, 1); // read the \n
             bool ok = false;
             // ignore the chunk-extension
-            fragment = fragment.mid(0, fragment.indexOf(';')).trimmed();
-            *chunkSize = fragment.toLong(&ok, 16);
-            fragment.clear();
+            const QByteArrayView line(fragment);
+            *chunkSize = line.mid(0, line.indexOf(';')).trimmed().toLong(&ok, 16);
+            fragment.resize(0);
             break; // size done
         } else {
             // read the fragment to the buffer
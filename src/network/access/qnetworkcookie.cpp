@@ -45,6 +45,7 @@
 #include "QtCore/qurl.h"
 #include "QtNetwork/qhostaddress.h"
 #include "private/qobject_p.h"
+#include "private/qsmallbytearray_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -375,7 +376,9 @@ void QNetworkCookie::setValue(const QByteArray &value)
 }
 
 // ### move this to qnetworkcookie_p.h and share with qnetworkaccesshttpbackend
-static QPair<QByteArray, QByteArray> nextField(const QByteArray &text, int &position, bool isNameValue)
+// Attribute names and most values are short, so the fields are returned as
+// QSmallByteArrays: they only allocate if they have to be stored.
+static QPair<QSmallByteArray, QSmallByteArray> nextField(const QByteArray &text, int &position, bool isNameValue)
 {
     // format is one of:
     //    (1)  token
@@ -391,15 +394,15 @@ static QPair<QByteArray, QByteArray> nextField(const QByteArray &text, int &posi
     int equalsPosition = text.indexOf('=', position);
     if (equalsPosition < 0 || equalsPosition > semiColonPosition) {
         if (isNameValue)
-            return qMakePair(QByteArray(), QByteArray()); //'=' is required for name-value-pair (RFC6265 section 5.2, rule 2)
+            return qMakePair(QSmallByteArray(), QSmallByteArray()); //'=' is required for name-value-pair (RFC6265 section 5.2, rule 2)
         equalsPosition = semiColonPosition; //no '=' means there is an attribute-name but no attribute-value
     }
 
-    QByteArray first = text.mid(position, equalsPosition - position).trimmed();
-    QByteArray second;
+    QSmallByteArray first = QSmallByteArray::trimmed(text.constData() + position, equalsPosition - position);
+    QSmallByteArray second;
     int secondLength = semiColonPosition - equalsPosition - 1;
     if (secondLength > 0)
-        second = text.mid(equalsPosition + 1, secondLength).trimmed();
+        second = QSmallByteArray::trimmed(text.constData() + equalsPosition + 1, secondLength);
 
     position = semiColonPosition;
     return qMakePair(first, second);
@@ -909,12 +912,12 @@ QList<QNetworkCookie> QNetworkCookiePrivate::parseSetCookieHeaderLine(const QByt
         QNetworkCookie cookie;
 
         // The first part is always the "NAME=VALUE" part
-        QPair<QByteArray,QByteArray> field = nextField(cookieString, position, true);
+        QPair<QSmallByteArray, QSmallByteArray> field = nextField(cookieString, position, true);
         if (field.first.isEmpty())
             // parsing error
             break;
-        cookie.setName(field.first);
-        cookie.setValue(field.second);
+        cookie.setName(field.first.toByteArray());
+        cookie.setValue(field.second.toByteArray());
 
         position = nextNonWhitespace(cookieString, position);
         while (position < length) {
@@ -925,7 +928,7 @@ QList<QNetworkCookie> QNetworkCookiePrivate::parseSetCookieHeaderLine(const QByt
                 field.first = field.first.toLower(); // everything but the NAME=VALUE is case-insensitive
 
                 if (field.first == "expires") {
-                    position -= field.second.length();
+                    position -= field.second.size();
                     int end;
                     for (end = position; end < length; ++end)
                         if (isValueSeparator(cookieString.at(end)))
@@ -938,7 +941,7 @@ QList<QNetworkCookie> QNetworkCookiePrivate::parseSetCookieHeaderLine(const QByt
                         cookie.setExpirationDate(dt);
                     //if unparsed, ignore the attribute but not the whole cookie (RFC6265 section 5.2.1)
                 } else if (field.first == "domain") {
-                    QByteArray rawDomain = field.second;
+                    QByteArray rawDomain = field.second.toByteArray();
                     //empty domain should be ignored (RFC6265 section 5.2.3)
                     if (!rawDomain.isEmpty()) {
                         QString maybeLeadingDot;
@@ -960,7 +963,7 @@ QList<QNetworkCookie> QNetworkCookiePrivate::parseSetCookieHeaderLine(const QByt
                     }
                 } else if (field.first == "max-age") {
                     bool ok = false;
-                    int secs = field.second.toInt(&ok);
+                    int secs = field.second.toByteArray().toInt(&ok);
                     if (ok) {
                         if (secs <= 0) {
                             //earliest representable time (RFC6265 section 5.2.2)
@@ -974,7 +977,7 @@ QList<QNetworkCookie> QNetworkCookiePrivate::parseSetCookieHeaderLine(const QByt
                     if (field.second.startsWith('/')) {
                         // ### we should treat cookie paths as an octet sequence internally
                         // However RFC6265 says we should assume UTF-8 for presentation as a string
-                        cookie.setPath(QString::fromUtf8(field.second));
+                        cookie.setPath(QString::fromUtf8(field.second.constData(), field.second.size()));
                     } else {
                         // if the path doesn't start with '/' then set the default path (RFC6265 section 5.2.4)
                         // and also IETF test case path0030 which has valid and empty path in the same cookie
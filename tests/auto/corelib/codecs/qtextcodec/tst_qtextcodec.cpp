@@ -55,6 +55,9 @@ private slots:
     void fromUnicode();
     void toUnicode_codecForHtml();
     void toUnicode_incremental();
+    void toUnicode_buffer_data();
+    void toUnicode_buffer();
+    void appendToUnicode();
     void codecForLocale();
 
     void asciiToIscii() const;
@@ -310,6 +313,129 @@ void tst_QTextCodec::toUnicode_incremental()
     delete utf8Decoder;
 }
 
+void tst_QTextCodec::toUnicode_buffer_data()
+{
+    QTest::addColumn<int>("mib");
+    QTest::addColumn<QByteArray>("encoded");
+
+    // ASCII, two-, three- and four-byte sequences, plus an invalid byte
+    QByteArray utf8;
+    for (int i = 0; i < 40; ++i)
+        utf8 += "text, \xc3\xa9t\xc3\xa9, \xe2\x82\xac\xf0\x90\x80\x80\xff ";
+    QTest::newRow("utf8") << 106 << utf8;
+    QTest::newRow("utf8-bom") << 106 << QByteArray("\xef\xbb\xbf" + utf8);
+
+    QByteArray latin1;
+    for (int i = 0; i < 1000; ++i)
+        latin1 += char(i);
+    QTest::newRow("latin1") << 4 << latin1;
+    QTest::newRow("utf16") << 1015 << QTextCodec::codecForMib(1015)->fromUnicode(QString::fromUtf8(utf8));
+    QTest::newRow("utf32") << 1017 << QTextCodec::codecForMib(1017)->fromUnicode(QString::fromUtf8(utf8));
+
+    // TSCII turns some bytes, like 0x8c, into three characters
+    QByteArray tscii;
+    for (int i = 0; i < 256; ++i)
+        tscii += char(i);
+    tscii += QByteArray(100, '\x8c');
+    QTest::newRow("tscii") << 2107 << tscii;
+}
+
+void tst_QTextCodec::toUnicode_buffer()
+{
+    QFETCH(int, mib);
+    QFETCH(QByteArray, encoded);
+
+    QTextCodec *codec = QTextCodec::codecForMib(mib);
+    QVERIFY(codec);
+    const QString expected = codec->toUnicode(encoded);
+
+    // feed the data in uneven chunks into small buffers
+    const int bufferSizes[] = { 1, 2, 3, 5, 17, 64, 4096 };
+    const int chunkSizes[] = { 1, 2, 3, 7, 100, 100000 };
+    for (size_t b = 0; b < sizeof(bufferSizes) / sizeof(bufferSizes[0]); ++b) {
+        for (size_t c = 0; c < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++c) {
+            QTextDecoder decoder(codec);
+            QVarLengthArray<QChar, 4096> buffer(bufferSizes[b]);
+            QString actual;
+            int pos = 0;
+            int stalled = 0;
+            while (pos < encoded.size()) {
+                const int len = qMin(chunkSizes[c], encoded.size() - pos);
+                int bytesRead = -1;
+                const int written = decoder.toUnicode(buffer.data(), buffer.size(),
+                                                      encoded.constData() + pos, len, &bytesRead);
+                QVERIFY(written >= 0 && written <= buffer.size());
+                QVERIFY(bytesRead >= 0 && bytesRead <= len);
+                actual.append(buffer.constData(), written);
+                pos += bytesRead;
+                if (!bytesRead) {
+                    // the buffer is too small for this codec
+                    QVERIFY(++stalled < 2);
+                    break;
+                }
+            }
+            if (stalled)
+                continue;
+            QCOMPARE(actual, expected);
+            QVERIFY(!decoder.hasFailure() || expected.contains(QChar::ReplacementCharacter));
+        }
+    }
+
+    // a buffer of len + 1 characters always takes all of UTF-8 and Latin-1
+    if (mib == 106 || mib == 4) {
+        QTextDecoder decoder(codec);
+        QString buffer(encoded.size() + 1, Qt::Uninitialized);
+        int bytesRead;
+        const int written = decoder.toUnicode(buffer.data(), buffer.size(), encoded.constData(),
+                                              encoded.size(), &bytesRead);
+        QCOMPARE(bytesRead, encoded.size());
+        buffer.resize(written);
+        QCOMPARE(buffer, expected);
+    }
+}
+
+void tst_QTextCodec::appendToUnicode()
+{
+    QTextDecoder decoder(QTextCodec::codecForMib(106));
+    const QByteArray chunk("h\xc3\xa9llo, w\xc3\xb6rld! ");
+    QString expected;
+
+    // prefilled target strings keep their contents
+    QString target = QStringLiteral("prefix: ");
+    expected = target;
+    for (int i = 0; i < 100; ++i) {
+        decoder.appendToUnicode(&target, chunk.constData(), chunk.size());
+        expected += QString::fromUtf8(chunk);
+    }
+    QCOMPARE(target, expected);
+
+    // once big enough, appending doesn't reallocate
+    target.resize(0);
+    const QChar *data = target.constData();
+    for (int i = 0; i < 100; ++i)
+        decoder.appendToUnicode(&target, chunk.constData(), chunk.size());
+    QCOMPARE(target.constData(), data);
+    QCOMPARE(target, expected.mid(8));
+
+    // sequences split across calls
+    target.clear();
+    for (int i = 0; i < chunk.size(); ++i)
+        decoder.appendToUnicode(&target, chunk.constData() + i, 1);
+    QCOMPARE(target, QString::fromUtf8(chunk));
+
+    // Latin-1 and other codecs
+    QTextDecoder latin1(QTextCodec::codecForMib(4));
+    target = QStringLiteral("a");
+    latin1.appendToUnicode(&target, "\xe9t\xe9", 3);
+    QCOMPARE(target, QString::fromLatin1("a\xe9t\xe9"));
+
+    QTextDecoder utf16(QTextCodec::codecForMib(1014));
+    target = QStringLiteral("a");
+    utf16.appendToUnicode(&target, "b", 1);
+    utf16.appendToUnicode(&target, "\0c\0", 3);
+    QCOMPARE(target, QStringLiteral("abc"));
+}
+
 void tst_QTextCodec::codecForLocale()
 {
     QTextCodec *codec = QTextCodec::codecForLocale();
@@ -22,6 +22,7 @@ SUBDIRS=\
     qprocess \
     qprocess-noapplication \
     qprocessenvironment \
+    qprocesspool \
     qresourceengine \
     qsettings \
     qsavefile \
@@ -63,4 +64,5 @@ winrt: SUBDIRS -= \
     qprocess \
     qprocess-noapplication \
     qprocessenvironment \
+    qprocesspool \
     qwinoverlappedionotifier
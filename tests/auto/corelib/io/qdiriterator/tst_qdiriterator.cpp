@@ -97,6 +97,11 @@ private slots:
     void cleanupTestCase();
     void iterateRelativeDirectory_data();
     void iterateRelativeDirectory();
+    void parallelTraversal_data();
+    void parallelTraversal();
+    void parallelTraversalTree_data();
+    void parallelTraversalTree();
+    void parallelTraversalStopEarly();
     void iterateResource_data();
     void iterateResource();
     void stopLinkLoop();
@@ -632,6 +637,124 @@ void tst_QDirIterator::hiddenDirs_hiddenFiles()
 }
 #endif // Q_OS_WIN
 
+void tst_QDirIterator::parallelTraversal_data()
+{
+    iterateRelativeDirectory_data();
+}
+
+void tst_QDirIterator::parallelTraversal()
+{
+    QFETCH(QString, dirName);
+    QFETCH(QDirIterator::IteratorFlags, flags);
+    QFETCH(QDir::Filters, filters);
+    QFETCH(QStringList, nameFilters);
+    QFETCH(QStringList, entries);
+
+    QDirIterator it(dirName, nameFilters, filters, flags | QDirIterator::ParallelTraversal);
+    QStringList list;
+    while (it.hasNext()) {
+        QString next = it.next();
+        QCOMPARE(it.path(), dirName);
+        QCOMPARE(next, it.filePath());
+        QCOMPARE(it.fileInfo(), QFileInfo(next));
+        list << it.fileInfo().canonicalFilePath();
+    }
+    list.sort();
+
+    QStringList sortedEntries;
+    foreach (const QString &item, entries)
+        sortedEntries.append(QFileInfo(item).canonicalFilePath());
+    sortedEntries.sort();
+
+    QCOMPARE(list, sortedEntries);
+}
+
+static QStringList sortedEntries(const QString &path, QDir::Filters filters,
+                                 QDirIterator::IteratorFlags flags)
+{
+    // When following links, which path a directory is listed under
+    // depends on which one is found first.
+    const bool canonical = flags & QDirIterator::FollowSymlinks;
+    QStringList list;
+    QDirIterator it(path, filters, flags);
+    while (it.hasNext()) {
+        it.next();
+        list << (canonical ? it.fileInfo().canonicalFilePath() : it.filePath());
+    }
+    if (canonical)
+        list = list.toSet().toList();
+    list.sort();
+    return list;
+}
+
+void tst_QDirIterator::parallelTraversalTree_data()
+{
+    QTest::addColumn<QDir::Filters>("filters");
+    QTest::addColumn<QDirIterator::IteratorFlags>("flags");
+
+    const QDirIterator::IteratorFlags recursive = QDirIterator::Subdirectories;
+    QTest::newRow("all") << QDir::Filters(QDir::NoFilter) << recursive;
+    QTest::newRow("files") << QDir::Filters(QDir::Files) << recursive;
+    QTest::newRow("dirs-hidden") << QDir::Filters(QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot) << recursive;
+    QTest::newRow("alldirs") << QDir::Filters(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot) << recursive;
+    QTest::newRow("nosymlinks") << QDir::Filters(QDir::AllEntries | QDir::NoSymLinks | QDir::System) << recursive;
+#ifndef Q_NO_SYMLINKS
+    QTest::newRow("follow") << QDir::Filters(QDir::AllEntries | QDir::NoDotAndDotDot)
+                            << (recursive | QDirIterator::FollowSymlinks);
+#endif
+    QTest::newRow("flat") << QDir::Filters(QDir::AllEntries) << QDirIterator::IteratorFlags();
+}
+
+// Compares the parallel traversal of a tree larger than one batch of
+// entries with the sequential one.
+void tst_QDirIterator::parallelTraversalTree()
+{
+    QFETCH(QDir::Filters, filters);
+    QFETCH(QDirIterator::IteratorFlags, flags);
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString root = tempDir.path();
+    QDir dir(root);
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            const QString path = QString::fromLatin1("d%1/e%2").arg(i).arg(j);
+            QVERIFY(dir.mkpath(path));
+            for (int k = 0; k < 40; ++k) {
+                QFile file(root + QString::fromLatin1("/%1/f%2").arg(path).arg(k));
+                QVERIFY(file.open(QIODevice::WriteOnly));
+            }
+        }
+        QVERIFY(dir.mkpath(QString::fromLatin1("d%1/.hidden/inside").arg(i)));
+        QFile hidden(root + QString::fromLatin1("/d%1/.hiddenFile").arg(i));
+        QVERIFY(hidden.open(QIODevice::WriteOnly));
+    }
+#ifndef Q_NO_SYMLINKS
+    QVERIFY(QFile::link(root + "/d1", root + "/d0/e0/linkToD1"));
+    QVERIFY(QFile::link(root, root + "/d2/linkToRoot"));
+    QVERIFY(QFile::link(root + "/nothing", root + "/d3/brokenLink"));
+#endif
+
+    const QStringList expected = sortedEntries(root, filters, flags);
+    QVERIFY(expected.size() > 1);
+    QCOMPARE(sortedEntries(root, filters, flags | QDirIterator::ParallelTraversal), expected);
+}
+
+void tst_QDirIterator::parallelTraversalStopEarly()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QDir dir(tempDir.path());
+    for (int i = 0; i < 64; ++i)
+        QVERIFY(dir.mkpath(QString::fromLatin1("a%1/b/c/d").arg(i)));
+
+    for (int stopAfter = 0; stopAfter < 10; stopAfter += 3) {
+        QDirIterator it(tempDir.path(), QDirIterator::Subdirectories | QDirIterator::ParallelTraversal);
+        for (int i = 0; i < stopAfter && it.hasNext(); ++i)
+            it.next();
+    }
+}
+
 QTEST_MAIN(tst_QDirIterator)
 
 #include "tst_qdiriterator.moc"
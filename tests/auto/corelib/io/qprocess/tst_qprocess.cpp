@@ -42,6 +42,9 @@
 #include <QtCore/QMetaType>
 #include <QtNetwork/QHostInfo>
 #include <stdlib.h>
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
 
 #ifndef QT_NO_PROCESS
 # if defined(Q_OS_WIN)
@@ -155,6 +158,8 @@ private slots:
     void failToStart();
     void failToStartWithWait();
     void failToStartWithEventLoop();
+    void failToStartSpawned();
+    void childProcessSetupDisabled();
 
 protected slots:
     void readFromProcess();
@@ -1648,6 +1653,75 @@ void tst_QProcess::failToStartWithEventLoop()
     }
 }
 
+//-----------------------------------------------------------------------------
+void tst_QProcess::failToStartSpawned()
+{
+#if !defined(Q_OS_UNIX) || defined(Q_OS_QNX)
+    QSKIP("posix_spawn() is only used on Unix");
+#else
+    qRegisterMetaType<QProcess::ProcessError>("QProcess::ProcessError");
+
+    QProcess forked;
+    forked.start("/blurp");
+    QVERIFY(!forked.waitForStarted());
+    QCOMPARE(forked.error(), QProcess::FailedToStart);
+
+    // a failure of posix_spawn() is reported later, like one of exec()
+    // in a forked child, and with the same message
+    QProcess process;
+    process.setChildProcessSetupEnabled(false);
+    QSignalSpy errorSpy(&process, static_cast<void (QProcess::*)(QProcess::ProcessError)>(&QProcess::error));
+    QVERIFY(errorSpy.isValid());
+
+    process.start("/blurp");
+    QCOMPARE(process.state(), QProcess::Starting);
+    QCOMPARE(errorSpy.count(), 0);
+    QTRY_COMPARE(errorSpy.count(), 1);
+    QCOMPARE(process.error(), QProcess::FailedToStart);
+    QCOMPARE(process.state(), QProcess::NotRunning);
+    QCOMPARE(process.errorString(), forked.errorString());
+
+    process.start("/blurp");
+    QVERIFY(!process.waitForStarted());
+    QCOMPARE(errorSpy.count(), 2);
+    QCOMPARE(process.errorString(), forked.errorString());
+#endif
+}
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_QNX)
+class ChdirProcess : public QProcess
+{
+protected:
+    void setupChildProcess() Q_DECL_OVERRIDE
+    {
+        if (::chdir("test") == -1)
+            ::_exit(1);
+    }
+};
+#endif
+
+//-----------------------------------------------------------------------------
+void tst_QProcess::childProcessSetupDisabled()
+{
+#if !defined(Q_OS_UNIX) || defined(Q_OS_QNX)
+    QSKIP("setupChildProcess() is only called on Unix");
+#else
+    // the child changes its directory, so the program must not be relative to it
+    const QString program = QDir::currentPath() + QLatin1String("/testSetWorkingDirectory/testSetWorkingDirectory");
+    ChdirProcess process;
+    QVERIFY(process.isChildProcessSetupEnabled());
+    process.start(program);
+    QVERIFY(process.waitForFinished());
+    QCOMPARE(QDir(process.readAllStandardOutput().constData()).canonicalPath(), QDir("test").canonicalPath());
+
+    process.setChildProcessSetupEnabled(false);
+    QVERIFY(!process.isChildProcessSetupEnabled());
+    process.start(program);
+    QVERIFY(process.waitForFinished());
+    QCOMPARE(QDir(process.readAllStandardOutput().constData()).canonicalPath(), QDir::current().canonicalPath());
+#endif
+}
+
 //-----------------------------------------------------------------------------
 #ifndef Q_OS_WINCE
 // Reading and writing to a process is not supported on Qt/CE
@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+
+SUBDIRS = \
+          testProcessPoolHelper \
+          test
+
+test.depends += testProcessPoolHelper
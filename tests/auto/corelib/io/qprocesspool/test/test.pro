@@ -0,0 +1,9 @@
+CONFIG += testcase
+CONFIG += parallel_test
+CONFIG -= app_bundle debug_and_release_target
+QT = core testlib
+SOURCES = ../tst_qprocesspool.cpp
+
+TARGET = ../tst_qprocesspool
+
+TEST_HELPER_INSTALLS += ../testProcessPoolHelper/testProcessPoolHelper
@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// testProcessPoolHelper exit <code> <standard output> <standard error>
+// testProcessPoolHelper size <bytes>
+// testProcessPoolHelper env <name>
+// testProcessPoolHelper sleep <milliseconds>
+// testProcessPoolHelper crash
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+        return 2;
+
+    if (!strcmp(argv[1], "exit") && argc == 5) {
+        fputs(argv[3], stdout);
+        fflush(stdout);
+        fputs(argv[4], stderr);
+        return atoi(argv[2]);
+    }
+    if (!strcmp(argv[1], "size") && argc == 3) {
+        char line[64];
+        memset(line, 'a', sizeof line - 1);
+        line[sizeof line - 1] = '\n';
+        for (int size = atoi(argv[2]); size > 0; size -= int(sizeof line))
+            fwrite(line, 1, size < int(sizeof line) ? size : sizeof line, stdout);
+        return 0;
+    }
+    if (!strcmp(argv[1], "env") && argc == 3) {
+        const char *value = getenv(argv[2]);
+        fputs(value ? value : "(unset)", stdout);
+        return 0;
+    }
+    if (!strcmp(argv[1], "sleep") && argc == 3) {
+#ifdef _WIN32
+        Sleep(atoi(argv[2]));
+#else
+        usleep(atoi(argv[2]) * 1000);
+#endif
+        return 0;
+    }
+    if (!strcmp(argv[1], "crash")) {
+        // don't let the C library print anything
+        fclose(stderr);
+        abort();
+    }
+    return 2;
+}
@@ -0,0 +1,335 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QProcessPool>
+
+static const char helper[] = "testProcessPoolHelper/testProcessPoolHelper";
+
+struct Result
+{
+    int exitCode;
+    QProcess::ExitStatus exitStatus;
+    QByteArray standardOutput;
+    QByteArray standardError;
+};
+
+class Receiver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Receiver(QProcessPool *pool)
+        : allFinished(0)
+    {
+        connect(pool, SIGNAL(finished(int,int,QProcess::ExitStatus,QByteArray,QByteArray)),
+                this, SLOT(finished(int,int,QProcess::ExitStatus,QByteArray,QByteArray)));
+        connect(pool, SIGNAL(error(int,QProcess::ProcessError)),
+                this, SLOT(error(int,QProcess::ProcessError)));
+        connect(pool, SIGNAL(allFinished()), this, SLOT(finishedAll()));
+    }
+
+    QMap<int, Result> results;
+    QList<int> failed;
+    int allFinished;
+
+public slots:
+    void finished(int id, int exitCode, QProcess::ExitStatus exitStatus,
+                  const QByteArray &standardOutput, const QByteArray &standardError)
+    {
+        QVERIFY(!results.contains(id));
+        Result result = { exitCode, exitStatus, standardOutput, standardError };
+        results.insert(id, result);
+    }
+    void error(int id, QProcess::ProcessError error)
+    {
+        QCOMPARE(error, QProcess::FailedToStart);
+        failed.append(id);
+    }
+    void finishedAll() { ++allFinished; }
+};
+
+class tst_QProcessPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void defaults();
+    void run_data();
+    void run();
+    void waitForFinished();
+    void channelModes_data();
+    void channelModes();
+    void largeOutput();
+    void descriptors();
+    void environment();
+    void crash();
+    void failToStart();
+    void clear();
+    void destroyWhileRunning();
+};
+
+void tst_QProcessPool::initTestCase()
+{
+    QVERIFY2(QFile::exists(helper)
+             || QFile::exists(QLatin1String(helper) + QLatin1String(".exe")),
+             "The helper program was not found");
+}
+
+void tst_QProcessPool::defaults()
+{
+    QProcessPool pool;
+    QCOMPARE(pool.maximumConcurrency(), qMax(1, QThread::idealThreadCount()));
+    QCOMPARE(pool.processChannelMode(), QProcess::SeparateChannels);
+    QCOMPARE(pool.processEnvironment(), QProcessEnvironment());
+    QCOMPARE(pool.outputBufferSize(), 4096);
+    QCOMPARE(pool.pendingCount(), 0);
+    QCOMPARE(pool.runningCount(), 0);
+    QVERIFY(pool.waitForFinished());
+
+    QTest::ignoreMessage(QtWarningMsg, "QProcessPool::setMaximumConcurrency: Concurrency must be at least 1");
+    pool.setMaximumConcurrency(0);
+    QCOMPARE(pool.maximumConcurrency(), qMax(1, QThread::idealThreadCount()));
+}
+
+void tst_QProcessPool::run_data()
+{
+    QTest::addColumn<int>("concurrency");
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1") << 1 << 10;
+    QTest::newRow("2") << 2 << 20;
+    QTest::newRow("8") << 8 << 50;
+}
+
+void tst_QProcessPool::run()
+{
+    QFETCH(int, concurrency);
+    QFETCH(int, count);
+
+    QProcessPool pool;
+    pool.setMaximumConcurrency(concurrency);
+    Receiver receiver(&pool);
+
+    for (int i = 0; i < count; ++i) {
+        const QStringList arguments = QStringList() << "exit" << QString::number(i % 7)
+                                                    << QString::number(i) << QString("error %1").arg(i);
+        QCOMPARE(pool.start(helper, arguments), i);
+        QVERIFY(pool.runningCount() <= concurrency);
+    }
+    QCOMPARE(pool.pendingCount(), count);
+
+    QTRY_COMPARE_WITH_TIMEOUT(receiver.allFinished, 1, 30000);
+    QCOMPARE(pool.pendingCount(), 0);
+    QCOMPARE(receiver.results.size(), count);
+    QVERIFY(receiver.failed.isEmpty());
+    for (int i = 0; i < count; ++i) {
+        const Result result = receiver.results.value(i);
+        QCOMPARE(result.exitStatus, QProcess::NormalExit);
+        QCOMPARE(result.exitCode, i % 7);
+        QCOMPARE(result.standardOutput, QByteArray::number(i));
+        QCOMPARE(result.standardError, "error " + QByteArray::number(i));
+    }
+}
+
+void tst_QProcessPool::waitForFinished()
+{
+    QProcessPool pool;
+    pool.setMaximumConcurrency(3);
+    Receiver receiver(&pool);
+
+    for (int i = 0; i < 10; ++i)
+        pool.start(helper, QStringList() << "exit" << "0" << QString::number(i) << QString());
+    QVERIFY(pool.waitForFinished(30000));
+
+    QCOMPARE(pool.pendingCount(), 0);
+    QCOMPARE(receiver.allFinished, 1);
+    QCOMPARE(receiver.results.size(), 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(receiver.results.value(i).standardOutput, QByteArray::number(i));
+
+    pool.start(helper, QStringList() << "sleep" << "5000");
+    QVERIFY(!pool.waitForFinished(100));
+    QCOMPARE(pool.runningCount(), 1);
+}
+
+void tst_QProcessPool::channelModes_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<QByteArray>("standardOutput");
+    QTest::addColumn<QByteArray>("standardError");
+
+    QTest::newRow("separate") << int(QProcess::SeparateChannels) << QByteArray("out") << QByteArray("err");
+    QTest::newRow("merged") << int(QProcess::MergedChannels) << QByteArray("outerr") << QByteArray();
+    QTest::newRow("forwarded-error") << int(QProcess::ForwardedErrorChannel) << QByteArray("out") << QByteArray();
+}
+
+void tst_QProcessPool::channelModes()
+{
+    QFETCH(int, mode);
+    QFETCH(QByteArray, standardOutput);
+    QFETCH(QByteArray, standardError);
+
+    QProcessPool pool;
+    pool.setProcessChannelMode(QProcess::ProcessChannelMode(mode));
+    Receiver receiver(&pool);
+
+    const int id = pool.start(helper, QStringList() << "exit" << "0" << "out" << "err");
+    QVERIFY(pool.waitForFinished(30000));
+    QCOMPARE(receiver.results.value(id).standardOutput, standardOutput);
+    QCOMPARE(receiver.results.value(id).standardError, standardError);
+}
+
+void tst_QProcessPool::largeOutput()
+{
+    QProcessPool pool;
+    pool.setOutputBufferSize(100);
+    Receiver receiver(&pool);
+
+    const int size = 1 << 20;
+    const int id = pool.start(helper, QStringList() << "size" << QString::number(size));
+    QTRY_COMPARE_WITH_TIMEOUT(receiver.allFinished, 1, 30000);
+
+    const QByteArray output = receiver.results.value(id).standardOutput;
+    QCOMPARE(output.size(), size);
+    QCOMPARE(output.count('a'), size - size / 64);
+    QCOMPARE(output.count('\n'), size / 64);
+}
+
+void tst_QProcessPool::descriptors()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("This test needs /proc/self/fd");
+#else
+    QDir fds("/proc/self/fd");
+    const int before = fds.entryList(QDir::Files | QDir::System).size();
+    {
+        QProcessPool pool;
+        pool.setMaximumConcurrency(2);
+        Receiver receiver(&pool);
+
+        for (int i = 0; i < 4; ++i)
+            pool.start(helper, QStringList() << "exit" << "0" << QString::number(i) << QString());
+        QVERIFY(pool.waitForFinished(30000));
+        fds.refresh();
+        const int idle = fds.entryList(QDir::Files | QDir::System).size();
+
+        // the runners keep their descriptors, but don't collect more
+        for (int i = 4; i < 20; ++i)
+            pool.start(helper, QStringList() << "exit" << "0" << QString::number(i) << QString());
+        QVERIFY(pool.waitForFinished(30000));
+        fds.refresh();
+        QCOMPARE(fds.entryList(QDir::Files | QDir::System).size(), idle);
+        QCOMPARE(receiver.results.size(), 20);
+        for (int i = 0; i < 20; ++i)
+            QCOMPARE(receiver.results.value(i).standardOutput, QByteArray::number(i));
+    }
+    fds.refresh();
+    QCOMPARE(fds.entryList(QDir::Files | QDir::System).size(), before);
+#endif
+}
+
+void tst_QProcessPool::environment()
+{
+    QProcessPool pool;
+    Receiver receiver(&pool);
+
+    QProcessEnvironment environment;
+    environment.insert("QPROCESSPOOL_TEST", "value");
+    pool.setProcessEnvironment(environment);
+    QCOMPARE(pool.processEnvironment(), environment);
+    const int first = pool.start(helper, QStringList() << "env" << "QPROCESSPOOL_TEST");
+
+    pool.setProcessEnvironment(QProcessEnvironment());
+    const int second = pool.start(helper, QStringList() << "env" << "QPROCESSPOOL_TEST");
+    QVERIFY(pool.waitForFinished(30000));
+
+    QCOMPARE(receiver.results.value(first).standardOutput, QByteArray("value"));
+    QCOMPARE(receiver.results.value(second).standardOutput, QByteArray("(unset)"));
+}
+
+void tst_QProcessPool::crash()
+{
+    QProcessPool pool;
+    Receiver receiver(&pool);
+
+    const int id = pool.start(helper, QStringList() << "crash");
+    QVERIFY(pool.waitForFinished(30000));
+    QCOMPARE(receiver.results.value(id).exitStatus, QProcess::CrashExit);
+}
+
+void tst_QProcessPool::failToStart()
+{
+    QProcessPool pool;
+    Receiver receiver(&pool);
+
+    const int id = pool.start("this-program-does-not-exist");
+    QTRY_COMPARE_WITH_TIMEOUT(receiver.allFinished, 1, 30000);
+    QVERIFY(receiver.results.isEmpty());
+    QCOMPARE(receiver.failed, QList<int>() << id);
+    QCOMPARE(pool.pendingCount(), 0);
+}
+
+void tst_QProcessPool::clear()
+{
+    QProcessPool pool;
+    pool.setMaximumConcurrency(1);
+    Receiver receiver(&pool);
+
+    const int id = pool.start(helper, QStringList() << "exit" << "0" << "first" << QString());
+    for (int i = 0; i < 4; ++i)
+        pool.start(helper, QStringList() << "exit" << "0" << "queued" << QString());
+    QCOMPARE(pool.pendingCount(), 5);
+    QCOMPARE(pool.runningCount(), 1);
+
+    pool.clear();
+    QCOMPARE(pool.pendingCount(), 1);
+    QVERIFY(pool.waitForFinished(30000));
+    QCOMPARE(receiver.results.keys(), QList<int>() << id);
+}
+
+void tst_QProcessPool::destroyWhileRunning()
+{
+    QElapsedTimer timer;
+    timer.start();
+    {
+        QProcessPool pool;
+        for (int i = 0; i < 4; ++i)
+            pool.start(helper, QStringList() << "sleep" << "30000");
+        QCOMPARE(pool.pendingCount(), 4);
+    }
+    QVERIFY(timer.elapsed() < 20000);
+}
+
+QTEST_MAIN(tst_QProcessPool)
+#include "tst_qprocesspool.moc"
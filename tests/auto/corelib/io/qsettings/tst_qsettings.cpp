@@ -162,6 +162,10 @@ private slots:
     void testByteArray();
     void iniCodec();
     void bom();
+    void binaryFormatJournal();
+    void binaryFormatCompaction();
+    void binaryFormatTornJournal();
+    void binaryFormatCorruptFile();
 
 private:
     const bool m_canWriteNativeSystemSettings;
@@ -277,6 +281,7 @@ static void populateWithFormats()
 
     QTest::newRow("native") << QSettings::NativeFormat;
     QTest::newRow("ini") << QSettings::IniFormat;
+    QTest::newRow("binary") << QSettings::BinaryFormat;
     QTest::newRow("custom1") << QSettings::CustomFormat1;
     QTest::newRow("custom2") << QSettings::CustomFormat2;
 }
@@ -740,6 +745,129 @@ void tst_QSettings::bom()
     QVERIFY(allkeys.contains("section2/foo2"));
 }
 
+// makes the next QSettings object read the file again, where possible
+static void clearConfFileCache()
+{
+#ifdef QT_BUILD_INTERNAL
+    QConfFile::clearCache();
+#endif
+}
+
+void tst_QSettings::binaryFormatJournal()
+{
+    const QString fileName = settingsPath("journal.qsettings");
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        for (int i = 0; i < 1000; ++i)
+            settings.setValue(QString("group%1/key%2").arg(i % 10).arg(i), i);
+        settings.setValue("point", QPoint(1, 2));
+    }
+    clearConfFileCache();
+    const qint64 snapshotSize = QFileInfo(fileName).size();
+    QVERIFY(snapshotSize > 0);
+
+    QSettings reader(fileName, QSettings::BinaryFormat);
+    QCOMPARE(reader.status(), QSettings::NoError);
+    QCOMPARE(reader.value("group3/key993"), QVariant(993));
+    QCOMPARE(reader.value("point"), QVariant(QPoint(1, 2)));
+    QVERIFY(!reader.contains("group3/key994"));
+    QCOMPARE(reader.childGroups().size(), 10);
+
+#ifdef Q_OS_UNIX
+    // a second path to the file is a QConfFile of its own, like another process
+    const QString linkName = settingsPath("link.qsettings");
+    QVERIFY(QFile::link(fileName, linkName));
+    {
+        QSettings writer(linkName, QSettings::BinaryFormat);
+        writer.setValue("group3/key3", "three");
+        writer.remove("group4");
+        writer.setValue("new/key", 42);
+    }
+
+    // the changes were appended instead of rewriting the file
+    const qint64 journalSize = QFileInfo(fileName).size() - snapshotSize;
+    QVERIFY(journalSize > 0);
+    QVERIFY(journalSize < 4096);
+
+    reader.sync();
+    QCOMPARE(reader.value("group3/key3"), QVariant(QString("three")));
+    QVERIFY(!reader.contains("group4/key4"));
+    QCOMPARE(reader.value("new/key"), QVariant(42));
+    QCOMPARE(reader.allKeys().size(), 1000 - 100 + 2);
+#endif
+}
+
+void tst_QSettings::binaryFormatCompaction()
+{
+    const QString fileName = settingsPath("compaction.qsettings");
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        for (int i = 0; i < 2000; ++i) {
+            settings.setValue("counter", i);
+            settings.sync();
+        }
+        QCOMPARE(settings.status(), QSettings::NoError);
+    }
+
+    // the file is rewritten before the journal grows without bounds
+    QVERIFY(QFileInfo(fileName).size() < 32 * 1024);
+
+    clearConfFileCache();
+    QSettings settings(fileName, QSettings::BinaryFormat);
+    QCOMPARE(settings.allKeys(), QStringList() << "counter");
+    QCOMPARE(settings.value("counter"), QVariant(1999));
+}
+
+void tst_QSettings::binaryFormatTornJournal()
+{
+    const QString fileName = settingsPath("torn.qsettings");
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        settings.setValue("a", 1);
+        settings.setValue("b", 2);
+        settings.sync();
+        settings.setValue("b", 3);
+    }
+    clearConfFileCache();
+
+    // cut the last record short, as a writer that crashed would leave it
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.resize(file.size() - 3));
+    }
+
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.value("a"), QVariant(1));
+        QCOMPARE(settings.value("b"), QVariant(2));
+        settings.setValue("c", 4);
+    }
+    clearConfFileCache();
+
+    QSettings settings(fileName, QSettings::BinaryFormat);
+    QCOMPARE(settings.status(), QSettings::NoError);
+    QCOMPARE(settings.allKeys(), QStringList() << "a" << "b" << "c");
+    QCOMPARE(settings.value("b"), QVariant(2));
+    QCOMPARE(settings.value("c"), QVariant(4));
+}
+
+void tst_QSettings::binaryFormatCorruptFile()
+{
+    const QString fileName = settingsPath("corrupt.qsettings");
+    QDir().mkpath(settingsPath());
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("[General]\nkey=value\n");
+    }
+
+    QSettings settings(fileName, QSettings::BinaryFormat);
+    QCOMPARE(settings.status(), QSettings::FormatError);
+    QVERIFY(settings.allKeys().isEmpty());
+}
+
 void tst_QSettings::testErrorHandling_data()
 {
     QTest::addColumn<int>("filePerms"); // -1 means file should not exist
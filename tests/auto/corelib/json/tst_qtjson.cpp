@@ -37,6 +37,7 @@
 #include "qjsonobject.h"
 #include "qjsonvalue.h"
 #include "qjsondocument.h"
+#include "qjsonstream.h"
 #include <limits>
 
 #define INVALID_UNICODE "\xCE\xBA\xE1"
@@ -103,8 +104,12 @@ private Q_SLOTS:
     void fromBinary();
     void toAndFromBinary_data();
     void toAndFromBinary();
+    void fromMappedFile();
+    void lazyValidation();
+    void rawDataNotModified();
     void parseNumbers();
     void parseStrings();
+    void parseStringBoundaries();
     void parseDuplicateKeys();
     void testParser();
 
@@ -145,6 +150,20 @@ private Q_SLOTS:
 
     void unicodeKeys();
     void garbageAtEnd();
+
+    void streamReaderTokens();
+    void streamReaderReadValue();
+    void streamReaderErrors_data();
+    void streamReaderErrors();
+    void streamReaderIncremental();
+    void streamReaderDevice();
+    void streamReaderMultipleDocuments();
+    void streamReaderSkip();
+    void streamWriter_data();
+    void streamWriter();
+    void streamWriterTokens();
+    void streamWriterCopy();
+    void streamWriterMisuse();
 private:
     QString testDataDir;
 };
@@ -1404,19 +1423,16 @@ void tst_QtJson::toJsonLargeNumericValues()
             "    \"Array\": [\n"
             "        1.234567,\n"
             "        1.7976931348623157e+308,\n"
-            //     ((4.9406564584124654e-324 == 5e-324) == true)
-            // I can only think JavaScript has a special formatter to
-            //  emit this value for this IEEE754 bit pattern.
-            "        4.9406564584124654e-324,\n"
+            "        5e-324,\n"
             "        2.2250738585072014e-308,\n"
             "        1.7976931348623157e+308,\n"
-            "        2.2204460492503131e-16,\n"
-            "        4.9406564584124654e-324,\n"
+            "        2.220446049250313e-16,\n"
+            "        5e-324,\n"
             "        0,\n"
             "        -2.2250738585072014e-308,\n"
             "        -1.7976931348623157e+308,\n"
-            "        -2.2204460492503131e-16,\n"
-            "        -4.9406564584124654e-324,\n"
+            "        -2.220446049250313e-16,\n"
+            "        -5e-324,\n"
             "        0,\n"
             "        9007199254740992,\n"
             "        -9007199254740992\n"
@@ -1769,6 +1785,124 @@ void tst_QtJson::toAndFromBinary()
     QVERIFY(doc == outdoc);
 }
 
+void tst_QtJson::fromMappedFile()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QVERIFY(!doc.isNull());
+
+    QJsonDocument mapped = QJsonDocument::fromMappedFile(testDataDir + "/test.bjson");
+    QVERIFY(!mapped.isNull());
+    QVERIFY(doc == mapped);
+    QCOMPARE(mapped.toJson(), doc.toJson());
+    QCOMPARE(mapped.toBinaryData(), doc.toBinaryData());
+
+    mapped = QJsonDocument::fromMappedFile(testDataDir + "/test.bjson", QJsonDocument::Validate);
+    QVERIFY(doc == mapped);
+
+    QVERIFY(QJsonDocument::fromMappedFile(testDataDir + "/doesnotexist.bjson").isNull());
+    // text JSON is not binary JSON
+    QVERIFY(QJsonDocument::fromMappedFile(testDataDir + "/test.json").isNull());
+
+    QTemporaryFile truncated;
+    QVERIFY(truncated.open());
+    truncated.write(doc.toBinaryData().left(100));
+    truncated.close();
+    QVERIFY(QJsonDocument::fromMappedFile(truncated.fileName()).isNull());
+}
+
+void tst_QtJson::lazyValidation()
+{
+    QJsonArray numbers;
+    for (int i = 0; i < 77; ++i)
+        numbers.append(i);
+    QJsonObject nested;
+    nested.insert("x", 1);
+    QJsonObject object;
+    object.insert("nested", nested);
+    object.insert("numbers", numbers);
+    object.insert("string", QLatin1String("text"));
+    QByteArray binary = QJsonDocument(object).toBinaryData();
+
+    // locate the header of the numbers array by its length of 77
+    int pos = binary.indexOf(QByteArray("\x9a\x00\x00\x00", 4));
+    QVERIFY(pos > 0);
+    // and point its table far outside the array
+    binary[pos + 6] = char(0xff);
+
+    QVERIFY(QJsonDocument::fromBinaryData(binary).isNull());
+
+    QTemporaryFile mappedFile;
+    QVERIFY(mappedFile.open());
+    mappedFile.write(binary);
+    mappedFile.close();
+
+    QJsonDocument docs[] = {
+        QJsonDocument::fromBinaryData(binary, QJsonDocument::ValidateLazily),
+        QJsonDocument::fromRawData(binary.constData(), binary.size(), QJsonDocument::ValidateLazily),
+        QJsonDocument::fromMappedFile(mappedFile.fileName())
+    };
+    for (int i = 0; i < 3; ++i) {
+        QJsonDocument doc = docs[i];
+        QVERIFY(!doc.isNull());
+        QVERIFY(doc.isObject());
+        QJsonObject o = doc.object();
+        QCOMPARE(o.size(), 3);
+        QCOMPARE(o.value("string").toString(), QString("text"));
+        QCOMPARE(o.value("nested").toObject().value("x").toInt(), 1);
+        // only the corrupted subtree is unusable
+        QVERIFY(o.value("numbers").isUndefined());
+        QVERIFY(doc.toJson().isEmpty());
+
+        // copying the invalid data around must not spread it
+        QTest::ignoreMessage(QtWarningMsg, "QJson: Dropping invalid binary JSON data");
+        o.insert("more", true);
+        QCOMPARE(o.size(), 1);
+        QCOMPARE(o.value("more"), QJsonValue(true));
+    }
+    QVERIFY(QJsonDocument::fromMappedFile(mappedFile.fileName(), QJsonDocument::Validate).isNull());
+
+    // untouched parts of an intact document are not validated, but still work
+    QJsonDocument lazy = QJsonDocument::fromBinaryData(QJsonDocument(object).toBinaryData(),
+                                                       QJsonDocument::ValidateLazily);
+    QVERIFY(lazy == QJsonDocument(object));
+    QJsonObject copy;
+    copy.insert("inner", lazy.object());
+    QCOMPARE(copy.value("inner").toObject(), object);
+}
+
+void tst_QtJson::rawDataNotModified()
+{
+    QJsonObject object;
+    object.insert("key", QLatin1String("value"));
+    object.insert("number", 42);
+    const QByteArray binary = QJsonDocument(object).toBinaryData();
+
+    // the document is the only reference to the data, which must not make
+    // it writable
+    QByteArray buffer = binary;
+    buffer.detach();
+    QJsonObject raw = QJsonDocument::fromRawData(buffer.constData(), buffer.size()).object();
+    raw.insert("number", 43);
+    raw.remove("key");
+    QCOMPARE(buffer, binary);
+    QCOMPARE(raw.value("number").toInt(), 43);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(binary);
+    file.close();
+
+    QJsonObject mapped = QJsonDocument::fromMappedFile(file.fileName()).object();
+    QCOMPARE(mapped, object);
+    mapped.insert("number", 43);
+    mapped["key"] = QLatin1String("changed");
+    QCOMPARE(mapped.value("key").toString(), QString("changed"));
+    QVERIFY(file.open());
+    QCOMPARE(file.readAll(), binary);
+}
+
 void tst_QtJson::parseNumbers()
 {
     {
@@ -1918,6 +2052,31 @@ void tst_QtJson::parseStrings()
 
 }
 
+void tst_QtJson::parseStringBoundaries()
+{
+    // the parser looks at blocks of 16 or 32 bytes, put escapes, non-ASCII
+    // characters and whitespace at every position relative to them
+    const char *const specials[] = { "\\n", "\\\"", "\\u00fc", "\xc3\xbc", "\xe2\x82\xac", "\xf0\x9f\x98\x80" };
+    const QString decoded[] = { QStringLiteral("\n"), QStringLiteral("\""), QString(QChar(0xfc)),
+                                QString(QChar(0xfc)), QString(QChar(0x20ac)), QString::fromUtf8("\xf0\x9f\x98\x80") };
+    for (int special = 0; special < 6; ++special) {
+        for (int length = 0; length < 70; ++length) {
+            for (int position = 0; position <= length; position += qMax(1, length / 7)) {
+                QByteArray json = "[" + QByteArray(length % 37, ' ') + "\"";
+                json += QByteArray(position, 'a') + specials[special] + QByteArray(length - position, 'b');
+                json += "\"" + QByteArray(length % 19, '\n') + "]";
+                const QString expected = QString(position, QLatin1Char('a')) + decoded[special]
+                        + QString(length - position, QLatin1Char('b'));
+
+                QJsonParseError error;
+                QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+                QVERIFY2(error.error == QJsonParseError::NoError, json.constData());
+                QCOMPARE(doc.array().at(0).toString(), expected);
+            }
+        }
+    }
+}
+
 void tst_QtJson::parseDuplicateKeys()
 {
     const char *json = "{ \"B\": true, \"A\": null, \"B\": false }";
@@ -2056,10 +2215,15 @@ void tst_QtJson::validation()
     for (int i = 0; i < binary.size(); ++i) {
         QByteArray corrupted = binary;
         corrupted[i] = char(0xff);
+        // walks everything that lazy validation lets through
+        QJsonDocument lazy = QJsonDocument::fromBinaryData(corrupted, QJsonDocument::ValidateLazily);
+        QVariant variant = lazy.toVariant();
+        QByteArray json = lazy.toJson();
+
         QJsonDocument doc = QJsonDocument::fromBinaryData(corrupted);
         if (doc.isNull())
             continue;
-        QByteArray json = doc.toJson();
+        json = doc.toJson();
 
         corrupted = binary;
         corrupted[i] = 0x00;
@@ -2774,5 +2938,327 @@ void tst_QtJson::garbageAtEnd()
     QVERIFY(!doc.isEmpty());
 }
 
+void tst_QtJson::streamReaderTokens()
+{
+    QJsonStreamReader reader(QByteArray("{ \"a\": [1, \"two\", true, false, null], \"b\": {}, \"c\": -1.5e3 }"));
+    QStringList tokens;
+    while (!reader.atEnd()) {
+        reader.readNext();
+        QString token = reader.tokenString();
+        if (!reader.name().isEmpty())
+            token += QLatin1Char(':') + reader.name();
+        if (reader.isString())
+            token += QLatin1Char('=') + reader.text();
+        else if (reader.isDouble())
+            token += QLatin1Char('=') + QString::number(reader.doubleValue());
+        else if (reader.isBool())
+            token += QLatin1String(reader.boolValue() ? "=true" : "=false");
+        tokens << token;
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(tokens.join(QLatin1Char(' ')),
+             QStringLiteral("StartDocument StartObject StartArray:a Double=1 String=two Bool=true "
+                            "Bool=false Null EndArray StartObject:b EndObject Double:c=-1500 "
+                            "EndObject EndDocument NoToken"));
+    QCOMPARE(reader.depth(), 0);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+}
+
+void tst_QtJson::streamReaderReadValue()
+{
+    const QString fileNames[] = { "/test.json", "/test2.json", "/test3.json" };
+    for (int i = 0; i < 3; ++i) {
+        QFile file(testDataDir + fileNames[i]);
+        QVERIFY(file.open(QFile::ReadOnly));
+        const QByteArray json = file.readAll();
+        const QJsonDocument doc = QJsonDocument::fromJson(json);
+        QVERIFY(!doc.isNull());
+
+        QJsonStreamReader reader(json);
+        QCOMPARE(reader.readNext(), QJsonStreamReader::StartDocument);
+        const QJsonValue value = reader.readValue();
+        QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+        if (doc.isObject())
+            QCOMPARE(value, QJsonValue(doc.object()));
+        else
+            QCOMPARE(value, QJsonValue(doc.array()));
+        QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+        QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+        QVERIFY(reader.atEnd());
+    }
+}
+
+void tst_QtJson::streamReaderErrors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<int>("error");
+    QTest::addColumn<int>("parseError");
+    QTest::addColumn<int>("offset");
+
+    const int NotWellFormed = QJsonStreamReader::NotWellFormedError;
+    const int Premature = QJsonStreamReader::PrematureEndOfDocumentError;
+    QTest::newRow("unterminated object") << QByteArray("{\n    \n\n")
+        << Premature << int(QJsonParseError::UnterminatedObject) << 0;
+    QTest::newRow("missing name separator") << QByteArray("{\n    \"key\" 10\n")
+        << NotWellFormed << int(QJsonParseError::MissingNameSeparator) << 12;
+    QTest::newRow("unterminated array") << QByteArray("[\n   1, true\n\n")
+        << Premature << int(QJsonParseError::UnterminatedArray) << 0;
+    QTest::newRow("missing value separator") << QByteArray("[\n  1 true\n\n")
+        << NotWellFormed << int(QJsonParseError::MissingValueSeparator) << 6;
+    QTest::newRow("nul") << QByteArray("[\n    nul")
+        << NotWellFormed << int(QJsonParseError::IllegalValue) << 6;
+    QTest::newRow("nulzz") << QByteArray("[\n    nulzz")
+        << NotWellFormed << int(QJsonParseError::IllegalValue) << 6;
+    QTest::newRow("trud") << QByteArray("[\n    trud]")
+        << NotWellFormed << int(QJsonParseError::IllegalValue) << 6;
+    QTest::newRow("termination by number") << QByteArray("[\n    11111")
+        << NotWellFormed << int(QJsonParseError::TerminationByNumber) << 11;
+    QTest::newRow("illegal number") << QByteArray("[\n    -1E10000]")
+        << NotWellFormed << int(QJsonParseError::IllegalNumber) << 6;
+    QTest::newRow("illegal escape") << QByteArray("[\n    \"\\u12\"]")
+        << NotWellFormed << int(QJsonParseError::IllegalEscapeSequence) << 9;
+    QTest::newRow("illegal utf8") << QByteArray("[\n    \"foo" INVALID_UNICODE "bar\"]")
+        << NotWellFormed << int(QJsonParseError::IllegalUTF8String) << 12;
+    QTest::newRow("unterminated string") << QByteArray("[\n    \"")
+        << NotWellFormed << int(QJsonParseError::UnterminatedString) << 7;
+    QTest::newRow("missing object") << QByteArray("{ \"a\": 1, }")
+        << NotWellFormed << int(QJsonParseError::MissingObject) << 10;
+    QTest::newRow("deep nesting") << QByteArray(1025, '[')
+        << NotWellFormed << int(QJsonParseError::DeepNesting) << 1024;
+}
+
+void tst_QtJson::streamReaderErrors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(int, error);
+    QFETCH(int, parseError);
+    QFETCH(int, offset);
+
+    QJsonParseError expected;
+    QJsonDocument::fromJson(json, &expected);
+    QCOMPARE(int(expected.error), parseError);
+
+    QJsonStreamReader reader(json);
+    while (!reader.atEnd())
+        reader.readNext();
+    QCOMPARE(int(reader.error()), error);
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.errorString(), expected.errorString());
+    if (error == QJsonStreamReader::NotWellFormedError) {
+        QCOMPARE(int(reader.characterOffset()), offset);
+        // the reader does not continue after errors
+        QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    }
+}
+
+static QStringList readTokens(QJsonStreamReader &reader)
+{
+    QStringList tokens;
+    while (reader.readNext() != QJsonStreamReader::NoToken && !reader.hasError())
+        tokens << reader.tokenString() + reader.name() + reader.value().toVariant().toString();
+    return tokens;
+}
+
+void tst_QtJson::streamReaderIncremental()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray json = file.readAll() + " 42 ";
+
+    QJsonStreamReader complete(json);
+    const QStringList expected = readTokens(complete);
+    QVERIFY(!complete.hasError());
+
+    // feed the data byte by byte
+    QJsonStreamReader reader;
+    QStringList tokens;
+    for (int i = 0; i < json.size(); ++i) {
+        reader.addData(json.mid(i, 1));
+        for (;;) {
+            const QJsonStreamReader::TokenType type = reader.readNext();
+            if (type == QJsonStreamReader::NoToken)
+                break;
+            if (type == QJsonStreamReader::Invalid) {
+                QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+                break;
+            }
+            tokens << reader.tokenString() + reader.name() + reader.value().toVariant().toString();
+        }
+    }
+    QCOMPARE(tokens, expected);
+}
+
+void tst_QtJson::streamReaderDevice()
+{
+    // larger than the chunks the reader reads at once
+    QByteArray json = "[";
+    for (int i = 0; i < 20000; ++i)
+        json += "{\"key\": \"value " + QByteArray::number(i) + "\", \"number\": " + QByteArray::number(i) + "},\n";
+    json += "{}]";
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.device(), static_cast<QIODevice *>(&buffer));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartDocument);
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonDocument::fromJson(json).array()));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QCOMPARE(reader.characterOffset(), qint64(json.size()));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+}
+
+void tst_QtJson::streamReaderMultipleDocuments()
+{
+    QJsonStreamReader reader(QByteArray("\xef\xbb\xbf{\"line\": 1}\n{\"line\": 2}\n[3]\n\"four\" 5"));
+    QList<QJsonValue> values;
+    while (reader.readNext() == QJsonStreamReader::StartDocument) {
+        values << reader.readValue();
+        QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(values.size(), 5);
+    QCOMPARE(values.at(0).toObject().value("line"), QJsonValue(1));
+    QCOMPARE(values.at(1).toObject().value("line"), QJsonValue(2));
+    QCOMPARE(values.at(2), QJsonValue(QJsonArray() << 3));
+    QCOMPARE(values.at(3), QJsonValue("four"));
+    QCOMPARE(values.at(4), QJsonValue(5));
+}
+
+void tst_QtJson::streamReaderSkip()
+{
+    QJsonStreamReader reader(QByteArray("{\"skipped\": {\"a\": [1, {}, []]}, \"read\": \"yes\"}"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartDocument);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.name(), QStringLiteral("skipped"));
+    reader.skipCurrentValue();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.name(), QStringLiteral("read"));
+    QCOMPARE(reader.text(), QStringLiteral("yes"));
+
+    reader.raiseError(QStringLiteral("custom"));
+    QCOMPARE(reader.error(), QJsonStreamReader::CustomError);
+    QCOMPARE(reader.errorString(), QStringLiteral("custom"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QVERIFY(reader.atEnd());
+}
+
+void tst_QtJson::streamWriter_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<int>("format");
+
+    QTest::newRow("test.json indented") << "/test.json" << int(QJsonDocument::Indented);
+    QTest::newRow("test.json compact") << "/test.json" << int(QJsonDocument::Compact);
+    QTest::newRow("test2.json indented") << "/test2.json" << int(QJsonDocument::Indented);
+    QTest::newRow("test2.json compact") << "/test2.json" << int(QJsonDocument::Compact);
+    QTest::newRow("test3.json indented") << "/test3.json" << int(QJsonDocument::Indented);
+    QTest::newRow("test3.json compact") << "/test3.json" << int(QJsonDocument::Compact);
+}
+
+void tst_QtJson::streamWriter()
+{
+    QFETCH(QString, fileName);
+    QFETCH(int, format);
+
+    QFile file(testDataDir + fileName);
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QVERIFY(!doc.isNull());
+
+    QByteArray json;
+    QJsonStreamWriter writer(&json);
+    QCOMPARE(writer.format(), QJsonDocument::Indented);
+    writer.setFormat(QJsonDocument::JsonFormat(format));
+    if (doc.isObject())
+        writer.writeValue(doc.object());
+    else
+        writer.writeValue(doc.array());
+    QCOMPARE(json, doc.toJson(QJsonDocument::JsonFormat(format)));
+}
+
+void tst_QtJson::streamWriterTokens()
+{
+    QJsonObject object;
+    object.insert("name", QStringLiteral("Qt"));
+    object.insert("empty", QJsonObject());
+    object.insert("versions", QJsonArray() << 5.4 << 5.5 << QJsonArray());
+    object.insert("valid", true);
+    object.insert("nothing", QJsonValue());
+    QJsonDocument doc(object);
+
+    for (int compact = 0; compact < 2; ++compact) {
+        const QJsonDocument::JsonFormat format = compact ? QJsonDocument::Compact : QJsonDocument::Indented;
+        QByteArray json;
+        QJsonStreamWriter writer(&json);
+        writer.setFormat(format);
+        writer.writeStartObject();
+        writer.writeStartObject("empty");
+        writer.writeEndObject();
+        writer.writeValue("name", QStringLiteral("Qt"));
+        writer.writeValue("nothing", QJsonValue());
+        writer.writeValue("valid", true);
+        writer.writeStartArray("versions");
+        writer.writeValue(5.4);
+        writer.writeValue(5.5);
+        writer.writeStartArray();
+        writer.writeEndDocument();
+        QCOMPARE(json, doc.toJson(format));
+    }
+}
+
+void tst_QtJson::streamWriterCopy()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QVERIFY(!doc.isNull());
+
+    // copy two documents from one device to another, changing the format
+    QByteArray input = doc.toJson(QJsonDocument::Indented) + doc.toJson(QJsonDocument::Indented);
+    QBuffer in(&input);
+    QVERIFY(in.open(QIODevice::ReadOnly));
+    QBuffer out;
+    QVERIFY(out.open(QIODevice::WriteOnly));
+    {
+        QJsonStreamReader reader(&in);
+        QJsonStreamWriter writer(&out);
+        QCOMPARE(writer.device(), static_cast<QIODevice *>(&out));
+        writer.setFormat(QJsonDocument::Compact);
+        while (!reader.atEnd()) {
+            reader.readNext();
+            writer.writeCurrentToken(reader);
+        }
+        QVERIFY(!reader.hasError());
+        QVERIFY(!writer.hasError());
+    }
+    QCOMPARE(out.data(), doc.toJson(QJsonDocument::Compact) + '\n' + doc.toJson(QJsonDocument::Compact));
+}
+
+void tst_QtJson::streamWriterMisuse()
+{
+    QByteArray json;
+    QJsonStreamWriter writer(&json);
+    writer.setFormat(QJsonDocument::Compact);
+
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter: only members of an object can have a name");
+    writer.writeValue("name", 1);
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeEndArray: there is no array to end");
+    writer.writeEndArray();
+    QVERIFY(json.isEmpty());
+
+    writer.writeStartObject();
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter: the members of an object need a name");
+    writer.writeValue(1);
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeEndArray: there is no array to end");
+    writer.writeEndArray();
+    writer.writeEndObject();
+    QCOMPARE(json, QByteArray("{}"));
+}
+
 QTEST_MAIN(tst_QtJson)
 #include "tst_qtjson.moc"
@@ -51,6 +51,7 @@
 #include "qobject.h"
 #ifdef QT_BUILD_INTERNAL
 #include <private/qobject_p.h>
+#include <private/qthread_p.h>
 #endif
 
 #include <math.h>
@@ -79,6 +80,7 @@ private slots:
     void metamethod();
     void namespaces();
     void threadSignalEmissionCrash();
+    void connectDisconnectWhileEmitting();
     void thread();
     void thread0();
     void moveToThread();
@@ -96,6 +98,7 @@ private slots:
 #endif
     void signalBlocking();
     void blockingQueuedConnection();
+    void recycledQueuedCallsAreBounded();
     void childEvents();
     void installEventFilter();
     void deleteSelfInSlot();
@@ -1581,6 +1584,63 @@ void tst_QObject::threadSignalEmissionCrash()
     }
 }
 
+class EmitUntilStoppedThread : public QThread
+{
+public:
+    explicit EmitUntilStoppedThread(SenderObject *sender)
+        : sender(sender), emitted(0), received(0)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        ReceiverObject receiver;
+        receiver.reset();
+        QObject::connect(sender, SIGNAL(signal1()), &receiver, SLOT(slot1()));
+        started.release();
+        while (!stop.load()) {
+            sender->emitSignal1();
+            ++emitted;
+        }
+        received = receiver.count_slot1;
+    }
+
+    SenderObject *sender;
+    QSemaphore started;
+    QAtomicInt stop;
+    int emitted;
+    int received;
+};
+
+void tst_QObject::connectDisconnectWhileEmitting()
+{
+    // Signals are emitted without locking the sender: connecting and disconnecting
+    // in another thread, which grows the connection lists and removes disconnected
+    // entries from them, must not disturb the emission.
+    for (int round = 0; round < 20; ++round) {
+        SenderObject sender;
+        ReceiverObject receiver;
+        EmitUntilStoppedThread thread(&sender);
+        thread.start();
+        thread.started.acquire();
+
+        for (int i = 0; i < 100; ++i) {
+            QMetaObject::Connection connection =
+                connect(&sender, &SenderObject::signal1, &receiver, &ReceiverObject::slot2);
+            connect(&sender, SIGNAL(signal1()), &receiver, SLOT(slot3()));
+            connect(&sender, SIGNAL(signal4()), &receiver, SLOT(slot4()));
+            QThread::yieldCurrentThread();
+            QVERIFY(QObject::disconnect(connection));
+            QVERIFY(QObject::disconnect(&sender, SIGNAL(signal1()), &receiver, SLOT(slot3())));
+            QVERIFY(QObject::disconnect(&sender, SIGNAL(signal4()), &receiver, SLOT(slot4())));
+        }
+
+        thread.stop.store(1);
+        QVERIFY(thread.wait(30000));
+        QVERIFY(thread.emitted > 0);
+        QCOMPARE(thread.received, thread.emitted);
+    }
+}
+
 class TestThread : public QThread
 {
     Q_OBJECT
@@ -3044,6 +3104,33 @@ void tst_QObject::blockingQueuedConnection()
     }
 }
 
+void tst_QObject::recycledQueuedCallsAreBounded()
+{
+#ifdef QT_BUILD_INTERNAL
+    SenderObject sender;
+    ReceiverObject receiver;
+    receiver.reset();
+    connect(&sender, SIGNAL(signal1()), &receiver, SLOT(slot1()), Qt::QueuedConnection);
+
+    // a burst of queued calls must not keep all of their memory around
+    const int calls = 4 * QThreadData::MaxRecycledMetaCallEvents;
+    for (int i = 0; i < calls; ++i)
+        sender.emitSignal1();
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.count_slot1, calls);
+
+    // the events were deleted in this thread, the receiver's
+    QThreadData *data = QObjectPrivate::get(&receiver)->threadData;
+    int blocks = 0;
+    for (QRecycledBlock *block = data->recycledMetaCallEvents.load(); block; block = block->next)
+        ++blocks;
+    QVERIFY(blocks <= QThreadData::MaxRecycledMetaCallEvents);
+    QCOMPARE(data->recycledMetaCallEventCount.load(), blocks);
+#else
+    QSKIP("Needs QT_BUILD_INTERNAL");
+#endif
+}
+
 class EventSpy : public QObject
 {
     Q_OBJECT
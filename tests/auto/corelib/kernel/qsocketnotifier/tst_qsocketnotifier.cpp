@@ -48,7 +48,14 @@
 #define NATIVESOCKETENGINE QNativeSocketEngine
 #ifdef Q_OS_UNIX
 #include <private/qnet_unix_p.h>
+#include <sys/resource.h>
 #include <sys/select.h>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtTest/QSignalSpy>
 #endif
 #include <limits>
 
@@ -65,6 +72,12 @@ private slots:
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
     void posixSockets();
+    void dispatcherBackends_data();
+    void dispatcherBackends();
+    void closedDescriptor_data();
+    void closedDescriptor();
+    void reusedDescriptor_data();
+    void reusedDescriptor();
 #endif
 };
 
@@ -297,6 +310,254 @@ void tst_QSocketNotifier::posixSockets()
     }
     qt_safe_close(posixSocket);
 }
+
+class DispatcherBackendThread : public QThread
+{
+public:
+    explicit DispatcherBackendThread(int minimumFd)
+        : minimumFd(minimumFd), fd(-1), readCount(0), writeCount(0), data(0)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        int sv[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == -1)
+            return;
+        fd = ::fcntl(sv[0], F_DUPFD, minimumFd);
+        qt_safe_close(sv[0]);
+        if (fd == -1) {
+            qt_safe_close(sv[1]);
+            return;
+        }
+
+        QEventLoop loop;
+        QSocketNotifier rn(fd, QSocketNotifier::Read);
+        QSignalSpy readSpy(&rn, &QSocketNotifier::activated);
+        QSocketNotifier wn(fd, QSocketNotifier::Write);
+        QSignalSpy writeSpy(&wn, &QSocketNotifier::activated);
+
+        // the socket is writable right away
+        QElapsedTimer timer;
+        timer.start();
+        while (writeSpy.isEmpty() && timer.elapsed() < 5000)
+            loop.processEvents(QEventLoop::WaitForMoreEvents);
+        wn.setEnabled(false);
+        writeCount = writeSpy.count();
+
+        // nothing to read yet
+        loop.processEvents();
+        const int spuriousReads = readSpy.count();
+
+        qt_safe_write(sv[1], "x", 1);
+        timer.restart();
+        while (readSpy.count() == spuriousReads && timer.elapsed() < 5000)
+            loop.processEvents(QEventLoop::WaitForMoreEvents);
+        readCount = readSpy.count() - spuriousReads;
+        if (spuriousReads)
+            readCount = -1;
+        if (qt_safe_read(fd, &data, 1) != 1)
+            data = 0;
+
+        rn.setEnabled(false);
+        qt_safe_close(sv[1]);
+        qt_safe_close(fd);
+    }
+
+    const int minimumFd;
+    int fd;
+    int readCount;
+    int writeCount;
+    char data;
+};
+
+void tst_QSocketNotifier::dispatcherBackends_data()
+{
+    QTest::addColumn<QByteArray>("backend");
+    QTest::addColumn<int>("minimumFd");
+
+    QTest::newRow("select") << QByteArray("select") << 0;
+    QTest::newRow("poll") << QByteArray("poll") << 0;
+    QTest::newRow("epoll") << QByteArray("epoll") << 0;
+    QTest::newRow("poll, above FD_SETSIZE") << QByteArray("poll") << int(FD_SETSIZE) + 16;
+    QTest::newRow("epoll, above FD_SETSIZE") << QByteArray("epoll") << int(FD_SETSIZE) + 16;
+}
+
+void tst_QSocketNotifier::dispatcherBackends()
+{
+    QFETCH(QByteArray, backend);
+    QFETCH(int, minimumFd);
+
+    if (minimumFd > 0) {
+        rlimit limit;
+        if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur <= rlim_t(minimumFd)) {
+            limit.rlim_cur = qMin(rlim_t(minimumFd) + 16, limit.rlim_max);
+            ::setrlimit(RLIMIT_NOFILE, &limit);
+        }
+        if (::getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur <= rlim_t(minimumFd))
+            QSKIP("Cannot raise the file descriptor limit above FD_SETSIZE");
+    }
+
+    // the new thread's event dispatcher reads the backend when it is created
+    qputenv("QT_EVENTDISPATCHER_UNIX_BACKEND", backend);
+    DispatcherBackendThread thread(minimumFd);
+    thread.start();
+    QVERIFY(thread.wait(30000));
+    qunsetenv("QT_EVENTDISPATCHER_UNIX_BACKEND");
+
+    QVERIFY(thread.fd >= minimumFd);
+    QVERIFY(thread.writeCount > 0);
+    QCOMPARE(thread.readCount, 1);
+    QCOMPARE(thread.data, 'x');
+}
+
+class ClosedDescriptorThread : public QThread
+{
+public:
+    ClosedDescriptorThread()
+        : readEnabled(true), writeEnabled(true), exceptionEnabled(true)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        int sv[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == -1)
+            return;
+
+        QEventLoop loop;
+        QSocketNotifier rn(sv[0], QSocketNotifier::Read);
+        loop.processEvents();
+
+        // the descriptor goes away while its notifier is still enabled,
+        // and another notifier is created for it
+        qt_safe_close(sv[0]);
+        QSocketNotifier wn(sv[0], QSocketNotifier::Write);
+        loop.processEvents();
+        readEnabled = rn.isEnabled();
+        writeEnabled = wn.isEnabled();
+
+        // a notifier that is removed after its descriptor was closed
+        {
+            QSocketNotifier en(sv[1], QSocketNotifier::Exception);
+            loop.processEvents();
+            qt_safe_close(sv[1]);
+            en.setEnabled(false);
+            exceptionEnabled = en.isEnabled();
+        }
+        loop.processEvents();
+    }
+
+    bool readEnabled;
+    bool writeEnabled;
+    bool exceptionEnabled;
+};
+
+void tst_QSocketNotifier::closedDescriptor_data()
+{
+    QTest::addColumn<QByteArray>("backend");
+
+    QTest::newRow("select") << QByteArray("select");
+    QTest::newRow("poll") << QByteArray("poll");
+    QTest::newRow("epoll") << QByteArray("epoll");
+}
+
+void tst_QSocketNotifier::closedDescriptor()
+{
+    QFETCH(QByteArray, backend);
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("^QSocketNotifier: Invalid socket \\d+ and type 'Read', disabling...$"));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("^QSocketNotifier: Invalid socket \\d+ and type 'Write', disabling...$"));
+    // only epoll notices when the exception notifier is removed; select() and
+    // poll() are not called again while the descriptor is closed
+    if (backend == "epoll")
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("^QSocketNotifier: Invalid socket \\d+ and type 'Exception', disabling...$"));
+
+    qputenv("QT_EVENTDISPATCHER_UNIX_BACKEND", backend);
+    ClosedDescriptorThread thread;
+    thread.start();
+    QVERIFY(thread.wait(30000));
+    qunsetenv("QT_EVENTDISPATCHER_UNIX_BACKEND");
+
+    QVERIFY(!thread.readEnabled);
+    QVERIFY(!thread.writeEnabled);
+    QVERIFY(!thread.exceptionEnabled);
+}
+
+class ReusedDescriptorThread : public QThread
+{
+public:
+    ReusedDescriptorThread()
+        : fd(-1), readEnabled(false), readCount(0)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        int sv[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == -1)
+            return;
+        fd = sv[0];
+
+        QEventLoop loop;
+        {
+            // the descriptor is found closed when the second notifier is added,
+            // and both notifiers go away before the dispatcher runs again
+            QSocketNotifier rn(fd, QSocketNotifier::Read);
+            loop.processEvents();
+            qt_safe_close(fd);
+            QSocketNotifier wn(fd, QSocketNotifier::Write);
+        }
+
+        // a new descriptor with the same number, which it usually gets anyway
+        int other[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, other) == -1)
+            return;
+        if (other[0] != fd) {
+            if (qt_safe_dup2(other[0], fd) == -1) {
+                fd = -1;
+                return;
+            }
+            qt_safe_close(other[0]);
+        }
+
+        {
+            QSocketNotifier rn(fd, QSocketNotifier::Read);
+            QSignalSpy spy(&rn, SIGNAL(activated(int)));
+            QObject::connect(&rn, SIGNAL(activated(int)), &loop, SLOT(quit()));
+            QTimer::singleShot(5000, &loop, SLOT(quit()));
+            qt_safe_write(other[1], "x", 1);
+            loop.exec();
+
+            readEnabled = rn.isEnabled();
+            readCount = spy.count();
+        }
+        qt_safe_close(fd);
+        qt_safe_close(other[1]);
+        qt_safe_close(sv[1]);
+    }
+
+    int fd;
+    bool readEnabled;
+    int readCount;
+};
+
+void tst_QSocketNotifier::reusedDescriptor_data()
+{
+    closedDescriptor_data();
+}
+
+void tst_QSocketNotifier::reusedDescriptor()
+{
+    QFETCH(QByteArray, backend);
+
+    qputenv("QT_EVENTDISPATCHER_UNIX_BACKEND", backend);
+    ReusedDescriptorThread thread;
+    thread.start();
+    QVERIFY(thread.wait(30000));
+    qunsetenv("QT_EVENTDISPATCHER_UNIX_BACKEND");
+
+    QVERIFY(thread.fd != -1);
+    QVERIFY(thread.readEnabled);
+    QVERIFY(thread.readCount > 0);
+}
 #endif
 
 QTEST_MAIN(tst_QSocketNotifier)
@@ -1,6 +1,6 @@
 CONFIG += testcase
 CONFIG += parallel_test
 TARGET = tst_qmutex
-QT = core testlib
+QT = core-private testlib
 SOURCES = tst_qmutex.cpp
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -39,6 +39,7 @@
 #include <qmutex.h>
 #include <qthread.h>
 #include <qwaitcondition.h>
+#include <private/qmutex_p.h>
 
 class tst_QMutex : public QObject
 {
@@ -52,6 +53,7 @@ private slots:
     void tryLockNegative_data();
     void tryLockNegative();
     void moreStress();
+    void contentionStatistics();
 };
 
 static const int iterations = 100;
@@ -684,6 +686,50 @@ void tst_QMutex::moreStress()
     QCOMPARE(MoreStressTestThread::errorCount.load(), 0);
 }
 
+void tst_QMutex::contentionStatistics()
+{
+    class Thread : public QThread
+    {
+    public:
+        QMutex *mutex;
+        QSemaphore started;
+
+        void run()
+        {
+            started.release();
+            mutex->lock();
+            mutex->unlock();
+        }
+    };
+
+    QMutexContentionStatistics::clear();
+    QMutexContentionStatistics::setEnabled(true);
+
+    QMutex mutex;
+    Thread thread;
+    thread.mutex = &mutex;
+    mutex.lock();
+    thread.start();
+    thread.started.acquire();
+    QThread::msleep(waitTime);
+    mutex.unlock();
+    QVERIFY(thread.wait());
+
+    QMutexContentionStatistics::setEnabled(false);
+
+    const QVector<QMutexContentionStatistics::Entry> entries = QMutexContentionStatistics::entries();
+    int i = 0;
+    while (i < entries.size() && entries.at(i).mutex != &mutex)
+        ++i;
+    QVERIFY(i < entries.size());
+    const QMutexContentionStatistics::Entry &entry = entries.at(i);
+    QCOMPARE(entry.contentions, Q_UINT64_C(1));
+    QVERIFY(entry.waitTime > 0);
+    QCOMPARE(entry.longestWait, entry.waitTime);
+
+    QMutexContentionStatistics::clear();
+    QVERIFY(QMutexContentionStatistics::entries().isEmpty());
+}
 
 QTEST_MAIN(tst_QMutex)
 #include "tst_qmutex.moc"
@@ -85,12 +85,15 @@ private slots:
     void releaseThread();
     void reserveAndStart();
     void start();
+    void startFromPoolThread_data();
+    void startFromPoolThread();
     void tryStart();
     void tryStartPeakThreadCount();
     void tryStartCount();
     void priorityStart_data();
     void priorityStart();
     void waitForDone();
+    void startDuringWaitForDone();
     void clear();
     void waitForDoneTimeout();
     void destroyingWaitsForTasksToFinish();
@@ -726,6 +729,63 @@ void tst_QThreadPool::start()
     QCOMPARE(count.load(), runs);
 }
 
+void tst_QThreadPool::startFromPoolThread_data()
+{
+    QTest::addColumn<int>("maxThreadCount");
+    QTest::newRow("1") << 1;
+    QTest::newRow("4") << 4;
+}
+
+void tst_QThreadPool::startFromPoolThread()
+{
+    class Child : public QRunnable
+    {
+    public:
+        QMutex &mutex;
+        QSet<QThread *> &threads;
+        Child(QMutex &mutex, QSet<QThread *> &threads) : mutex(mutex), threads(threads) {}
+        void run()
+        {
+            QTest::qSleep(2);
+            QMutexLocker locker(&mutex);
+            threads.insert(QThread::currentThread());
+            count.ref();
+        }
+    };
+    class Parent : public QRunnable
+    {
+    public:
+        QThreadPool &pool;
+        QMutex &mutex;
+        QSet<QThread *> &threads;
+        int runs;
+        Parent(QThreadPool &pool, QMutex &mutex, QSet<QThread *> &threads, int runs)
+            : pool(pool), mutex(mutex), threads(threads), runs(runs) {}
+        void run()
+        {
+            // these go to this thread's local queue, the others steal from it
+            for (int i = 0; i < runs; ++i)
+                pool.start(new Child(mutex, threads));
+        }
+    };
+
+    QFETCH(int, maxThreadCount);
+    const int runs = 100;
+    QMutex mutex;
+    QSet<QThread *> threads;
+    count.store(0);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(maxThreadCount);
+    threadPool.start(new Parent(threadPool, mutex, threads, runs));
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(count.load(), runs);
+    if (maxThreadCount > 1)
+        QVERIFY(threads.count() > 1);
+    else
+        QCOMPARE(threads.count(), 1);
+}
+
 void tst_QThreadPool::tryStart()
 {
     class WaitingTask : public QRunnable
@@ -904,6 +964,43 @@ void tst_QThreadPool::waitForDone()
     }
 }
 
+void tst_QThreadPool::startDuringWaitForDone()
+{
+    // waitForDone() deletes the threads that a start() from outside the
+    // pool may be looking at
+    class Starter : public QThread
+    {
+    public:
+        QThreadPool &pool;
+        QAtomicInt stop;
+        int runs;
+        explicit Starter(QThreadPool &pool) : pool(pool), runs(0) {}
+        void run()
+        {
+            while (!stop.load()) {
+                pool.start(new CountingRunnable());
+                ++runs;
+            }
+        }
+    };
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(4);
+    count.store(0);
+    Starter starter(threadPool);
+    starter.start();
+
+    QTime total;
+    total.start();
+    while (total.elapsed() < 2000)
+        threadPool.waitForDone();
+
+    starter.stop.store(1);
+    QVERIFY(starter.wait());
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(count.load(), starter.runs);
+}
+
 void tst_QThreadPool::waitForDoneTimeout()
 {
     QMutex mutex;
@@ -0,0 +1,4 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qbytearrayview
+QT = core testlib
+SOURCES = tst_qbytearrayview.cpp
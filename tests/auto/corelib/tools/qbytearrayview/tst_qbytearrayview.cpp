@@ -0,0 +1,351 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qbytearrayview.h>
+
+class tst_QByteArrayView : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void construct();
+    void cut_data();
+    void cut();
+    void trimmed_data();
+    void trimmed();
+    void indexOf_data();
+    void indexOf();
+    void lastIndexOf_data();
+    void lastIndexOf();
+    void startsEndsWith();
+    void compare_data();
+    void compare();
+    void toNumber_data();
+    void toNumber();
+    void toNumberNotTerminated();
+    void hash();
+};
+
+void tst_QByteArrayView::construct()
+{
+    QByteArrayView null;
+    QVERIFY(null.isNull());
+    QVERIFY(null.isEmpty());
+    QCOMPARE(null.size(), 0);
+    QVERIFY(QByteArrayView(QByteArray()).isNull());
+    QVERIFY(QByteArrayView(static_cast<const char *>(0)).isNull());
+
+    QByteArrayView empty("");
+    QVERIFY(!empty.isNull());
+    QVERIFY(empty.isEmpty());
+    QVERIFY(!QByteArrayView(QByteArray("")).isNull());
+
+    const QByteArray ba("hello");
+    QByteArrayView view(ba);
+    QCOMPARE(view.data(), ba.constData());
+    QCOMPARE(view.size(), 5);
+    QCOMPARE(view.at(1), 'e');
+    QCOMPARE(view[4], 'o');
+    QCOMPARE(view.front(), 'h');
+    QCOMPARE(view.back(), 'o');
+    QCOMPARE(int(view.end() - view.begin()), 5);
+    QCOMPARE(view.toByteArray(), ba);
+    QVERIFY(QByteArrayView().toByteArray().isNull());
+
+    QByteArrayView part("hello world", 5);
+    QCOMPARE(part.size(), 5);
+    QVERIFY(part == view);
+}
+
+void tst_QByteArrayView::cut_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<int>("pos");
+    QTest::addColumn<int>("len");
+
+    const QByteArray data("abcdefgh");
+    QTest::newRow("start") << data << 0 << 3;
+    QTest::newRow("middle") << data << 2 << 4;
+    QTest::newRow("end") << data << 5 << 3;
+    QTest::newRow("past-end") << data << 6 << 10;
+    QTest::newRow("to-end") << data << 3 << -1;
+    QTest::newRow("everything") << data << 0 << -1;
+    QTest::newRow("negative-pos") << data << -2 << 5;
+    QTest::newRow("at-end") << data << 8 << 2;
+    QTest::newRow("beyond-end") << data << 9 << 2;
+    QTest::newRow("zero") << data << 4 << 0;
+    QTest::newRow("empty") << QByteArray("") << 0 << 1;
+}
+
+void tst_QByteArrayView::cut()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, pos);
+    QFETCH(int, len);
+
+    const QByteArrayView view(data);
+    QCOMPARE(view.mid(pos, len).toByteArray(), data.mid(pos, len));
+    QCOMPARE(view.mid(pos, len).isNull(), data.mid(pos, len).isNull());
+    QCOMPARE(view.left(len).toByteArray(), data.left(len));
+    QCOMPARE(view.right(len).toByteArray(), data.right(len));
+
+    // the results point into the original data
+    const QByteArrayView mid = view.mid(pos, len);
+    if (!mid.isEmpty())
+        QCOMPARE(mid.data(), data.constData() + qMax(pos, 0));
+
+    QByteArrayView truncated(view);
+    truncated.truncate(len);
+    QByteArray expected(data);
+    expected.truncate(len);
+    QCOMPARE(truncated.toByteArray(), expected);
+
+    QByteArrayView chopped(view);
+    chopped.chop(len);
+    expected = data;
+    expected.chop(len);
+    QCOMPARE(chopped.toByteArray(), expected);
+}
+
+void tst_QByteArrayView::trimmed_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("empty") << QByteArray("");
+    QTest::newRow("none") << QByteArray("text");
+    QTest::newRow("spaces") << QByteArray("  text  ");
+    QTest::newRow("all-whitespace") << QByteArray(" \t\r\n\v\f");
+    QTest::newRow("inner") << QByteArray("\ta b\r\n");
+}
+
+void tst_QByteArrayView::trimmed()
+{
+    QFETCH(QByteArray, data);
+    QCOMPARE(QByteArrayView(data).trimmed().toByteArray(), data.trimmed());
+}
+
+void tst_QByteArrayView::indexOf_data()
+{
+    QTest::addColumn<QByteArray>("haystack");
+    QTest::addColumn<QByteArray>("needle");
+    QTest::addColumn<int>("from");
+
+    const QByteArray haystack("abcabcabcd");
+    QTest::newRow("char") << haystack << QByteArray("c") << 0;
+    QTest::newRow("char-from") << haystack << QByteArray("c") << 3;
+    QTest::newRow("char-negative-from") << haystack << QByteArray("a") << -4;
+    QTest::newRow("char-missing") << haystack << QByteArray("x") << 0;
+    QTest::newRow("string") << haystack << QByteArray("bca") << 0;
+    QTest::newRow("string-from") << haystack << QByteArray("bca") << 2;
+    QTest::newRow("string-end") << haystack << QByteArray("bcd") << 0;
+    QTest::newRow("string-missing") << haystack << QByteArray("bcb") << 0;
+    QTest::newRow("string-too-long") << QByteArray("ab") << QByteArray("abc") << 0;
+    QTest::newRow("empty-needle") << haystack << QByteArray("") << 3;
+}
+
+void tst_QByteArrayView::indexOf()
+{
+    QFETCH(QByteArray, haystack);
+    QFETCH(QByteArray, needle);
+    QFETCH(int, from);
+
+    const QByteArrayView view(haystack);
+    QCOMPARE(view.indexOf(QByteArrayView(needle), from), haystack.indexOf(needle, from));
+    if (needle.size() == 1) {
+        QCOMPARE(view.indexOf(needle.at(0), from), haystack.indexOf(needle.at(0), from));
+        QCOMPARE(view.contains(needle.at(0)), haystack.contains(needle.at(0)));
+        QCOMPARE(view.count(needle.at(0)), haystack.count(needle.at(0)));
+    }
+    QCOMPARE(view.contains(QByteArrayView(needle)), haystack.contains(needle));
+}
+
+void tst_QByteArrayView::lastIndexOf_data()
+{
+    QTest::addColumn<QByteArray>("haystack");
+    QTest::addColumn<QByteArray>("needle");
+    QTest::addColumn<int>("from");
+
+    const QByteArray haystack("abcabcabcd");
+    QTest::newRow("char") << haystack << QByteArray("c") << -1;
+    QTest::newRow("char-from") << haystack << QByteArray("c") << 7;
+    QTest::newRow("char-missing") << haystack << QByteArray("x") << -1;
+    QTest::newRow("char-beyond") << haystack << QByteArray("d") << 20;
+    QTest::newRow("string") << haystack << QByteArray("abc") << -1;
+    QTest::newRow("string-from") << haystack << QByteArray("abc") << 5;
+    QTest::newRow("string-missing") << haystack << QByteArray("cc") << -1;
+    QTest::newRow("string-too-long") << QByteArray("ab") << QByteArray("abc") << -1;
+}
+
+void tst_QByteArrayView::lastIndexOf()
+{
+    QFETCH(QByteArray, haystack);
+    QFETCH(QByteArray, needle);
+    QFETCH(int, from);
+
+    const QByteArrayView view(haystack);
+    QCOMPARE(view.lastIndexOf(QByteArrayView(needle), from), haystack.lastIndexOf(needle, from));
+    if (needle.size() == 1)
+        QCOMPARE(view.lastIndexOf(needle.at(0), from), haystack.lastIndexOf(needle.at(0), from));
+}
+
+void tst_QByteArrayView::startsEndsWith()
+{
+    const QByteArrayView view("Content-Length");
+    QVERIFY(view.startsWith('C'));
+    QVERIFY(!view.startsWith('c'));
+    QVERIFY(view.startsWith("Content"));
+    QVERIFY(view.startsWith(""));
+    QVERIFY(!view.startsWith("Content-Length-"));
+    QVERIFY(view.endsWith('h'));
+    QVERIFY(view.endsWith("Length"));
+    QVERIFY(!view.endsWith("length"));
+    QVERIFY(!QByteArrayView().startsWith('a'));
+    QVERIFY(!QByteArrayView().endsWith('a'));
+}
+
+void tst_QByteArrayView::compare_data()
+{
+    QTest::addColumn<QByteArray>("lhs");
+    QTest::addColumn<QByteArray>("rhs");
+    QTest::addColumn<int>("sensitive");
+    QTest::addColumn<int>("insensitive");
+
+    QTest::newRow("equal") << QByteArray("abc") << QByteArray("abc") << 0 << 0;
+    QTest::newRow("case") << QByteArray("abc") << QByteArray("ABC") << 1 << 0;
+    QTest::newRow("less") << QByteArray("abc") << QByteArray("abd") << -1 << -1;
+    QTest::newRow("prefix") << QByteArray("ab") << QByteArray("abc") << -1 << -1;
+    QTest::newRow("longer") << QByteArray("Abc") << QByteArray("ab") << -1 << 1;
+    QTest::newRow("empty") << QByteArray("") << QByteArray("") << 0 << 0;
+    QTest::newRow("latin1") << QByteArray("\xe9t\xe9") << QByteArray("\xc9T\xc9") << 1 << 0;
+    QTest::newRow("embedded-nul") << QByteArray("a\0b", 3) << QByteArray("a\0c", 3) << -1 << -1;
+}
+
+static inline int sign(int x)
+{
+    return x < 0 ? -1 : (x > 0 ? 1 : 0);
+}
+
+void tst_QByteArrayView::compare()
+{
+    QFETCH(QByteArray, lhs);
+    QFETCH(QByteArray, rhs);
+    QFETCH(int, sensitive);
+    QFETCH(int, insensitive);
+
+    const QByteArrayView l(lhs), r(rhs);
+    QCOMPARE(sign(l.compare(r)), sensitive);
+    QCOMPARE(sign(r.compare(l)), -sensitive);
+    QCOMPARE(sign(l.compare(r, Qt::CaseInsensitive)), insensitive);
+    QCOMPARE(sign(r.compare(l, Qt::CaseInsensitive)), -insensitive);
+    QCOMPARE(l == r, sensitive == 0);
+    QCOMPARE(l != r, sensitive != 0);
+    QCOMPARE(l < r, sensitive < 0);
+    QCOMPARE(l <= r, sensitive <= 0);
+    QCOMPARE(l > r, sensitive > 0);
+    QCOMPARE(l >= r, sensitive >= 0);
+}
+
+void tst_QByteArrayView::toNumber_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<int>("base");
+
+    QTest::newRow("decimal") << QByteArray("1234") << 10;
+    QTest::newRow("negative") << QByteArray("-1234") << 10;
+    QTest::newRow("spaces") << QByteArray("  42 ") << 10;
+    QTest::newRow("hex") << QByteArray("1aF") << 16;
+    QTest::newRow("auto-hex") << QByteArray("0x1f") << 0;
+    QTest::newRow("octal") << QByteArray("0777") << 0;
+    QTest::newRow("garbage") << QByteArray("12a") << 10;
+    QTest::newRow("empty") << QByteArray("") << 10;
+    QTest::newRow("short-overflow") << QByteArray("40000") << 10;
+    QTest::newRow("int-overflow") << QByteArray("4294967296") << 10;
+    QTest::newRow("longlong") << QByteArray("9223372036854775807") << 10;
+    QTest::newRow("ulonglong") << QByteArray("18446744073709551615") << 10;
+    QTest::newRow("too-large") << QByteArray("18446744073709551616") << 10;
+}
+
+void tst_QByteArrayView::toNumber()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, base);
+
+    const QByteArrayView view(data);
+    bool ok, expectedOk;
+#define CHECK(function) \
+    QCOMPARE(view.function(&ok, base), data.function(&expectedOk, base)); \
+    QCOMPARE(ok, expectedOk);
+    CHECK(toShort)
+    CHECK(toUShort)
+    CHECK(toInt)
+    CHECK(toUInt)
+    CHECK(toLong)
+    CHECK(toULong)
+    CHECK(toLongLong)
+    CHECK(toULongLong)
+#undef CHECK
+}
+
+void tst_QByteArrayView::toNumberNotTerminated()
+{
+    const char data[] = "123456: 0x10;";
+    bool ok;
+    QCOMPARE(QByteArrayView(data, 3).toInt(&ok), 123);
+    QVERIFY(ok);
+    QCOMPARE(QByteArrayView(data).left(6).toLongLong(&ok), Q_INT64_C(123456));
+    QVERIFY(ok);
+    QCOMPARE(QByteArrayView(data).mid(8, 4).toInt(&ok, 16), 16);
+    QVERIFY(ok);
+    QCOMPARE(QByteArrayView(data).mid(8, 4).toInt(&ok, 0), 16);
+    QVERIFY(ok);
+    QCOMPARE(QByteArrayView(data).mid(6).toInt(&ok), 0);
+    QVERIFY(!ok);
+
+    // longer than the stack buffer used for the conversion
+    const QByteArray padded = QByteArray(150, '0') + "77" + "junk";
+    QCOMPARE(QByteArrayView(padded).left(152).toInt(&ok), 77);
+    QVERIFY(ok);
+}
+
+void tst_QByteArrayView::hash()
+{
+    const QByteArray data("Content-Type: text/html");
+    QCOMPARE(qHash(QByteArrayView(data)), qHash(data));
+    QCOMPARE(qHash(QByteArrayView(data), 42), qHash(data, 42));
+    QCOMPARE(qHash(QByteArrayView(data).left(12)), qHash(data.left(12)));
+}
+
+QTEST_APPLESS_MAIN(tst_QByteArrayView)
+
+#include "tst_qbytearrayview.moc"
@@ -47,6 +47,12 @@ private slots:
     void sha3();
     void files_data();
     void files();
+    void chunked_data();
+    void chunked();
+    void hashList_data();
+    void hashList();
+    void devices_data();
+    void devices();
 };
 
 void tst_QCryptographicHash::repeated_result_data()
@@ -258,6 +264,128 @@ void tst_QCryptographicHash::files()
     }
 }
 
+void tst_QCryptographicHash::chunked_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::addColumn<int>("chunkSize");
+    QTest::addColumn<QByteArray>("hash");
+
+    // a million repetitions of "a", fed in chunks that don't line up with the blocks
+    static const int chunkSizes[] = { 1, 63, 64, 65, 1000, 1000000 };
+    for (uint i = 0; i < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++i) {
+        const QByteArray size = QByteArray::number(chunkSizes[i]);
+        QTest::newRow("sha1-" + size) << QCryptographicHash::Sha1 << chunkSizes[i]
+            << QByteArray::fromHex("34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+        QTest::newRow("sha224-" + size) << QCryptographicHash::Sha224 << chunkSizes[i]
+            << QByteArray::fromHex("20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67");
+        QTest::newRow("sha256-" + size) << QCryptographicHash::Sha256 << chunkSizes[i]
+            << QByteArray::fromHex("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+    }
+}
+
+void tst_QCryptographicHash::chunked()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QFETCH(int, chunkSize);
+    QFETCH(QByteArray, hash);
+
+    const QByteArray as(1000000, 'a');
+    QCryptographicHash hasher(algorithm);
+    for (int i = 0; i < as.size(); i += chunkSize)
+        hasher.addData(as.constData() + i, qMin(chunkSize, as.size() - i));
+    QCOMPARE(hasher.result().toHex(), hash.toHex());
+}
+
+void tst_QCryptographicHash::hashList_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::newRow("md5") << QCryptographicHash::Md5;
+    QTest::newRow("sha1") << QCryptographicHash::Sha1;
+    QTest::newRow("sha224") << QCryptographicHash::Sha224;
+    QTest::newRow("sha256") << QCryptographicHash::Sha256;
+    QTest::newRow("sha512") << QCryptographicHash::Sha512;
+    QTest::newRow("sha3_256") << QCryptographicHash::Sha3_256;
+}
+
+void tst_QCryptographicHash::hashList()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+
+    QVERIFY(QCryptographicHash::hash(QByteArrayList(), algorithm).isEmpty());
+
+    // every length around the block and padding boundaries, in an order
+    // that makes the messages finish at different times
+    QByteArrayList messages;
+    for (int i = 0; i < 300; ++i) {
+        const int size = (i * 37) % 300;
+        QByteArray message(size, Qt::Uninitialized);
+        for (int j = 0; j < size; ++j)
+            message[j] = char(i + j * 13);
+        messages << message;
+    }
+    messages << QByteArray(100000, 'x') << QByteArray("abc");
+
+    const QByteArrayList hashes = QCryptographicHash::hash(messages, algorithm);
+    QCOMPARE(hashes.size(), messages.size());
+    for (int i = 0; i < messages.size(); ++i)
+        QCOMPARE(hashes.at(i).toHex(), QCryptographicHash::hash(messages.at(i), algorithm).toHex());
+
+    const QByteArrayList single = QCryptographicHash::hash(QByteArrayList() << messages.last(), algorithm);
+    QCOMPARE(single.size(), 1);
+    QCOMPARE(single.first(), hashes.last());
+}
+
+void tst_QCryptographicHash::devices_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("skip");
+    QTest::addColumn<bool>("textMode");
+
+    QTest::newRow("empty") << 0 << 0 << false;
+    QTest::newRow("small") << 1000 << 0 << false;
+    QTest::newRow("small-skip") << 1000 << 10 << false;
+    QTest::newRow("large") << 3 * 1024 * 1024 + 17 << 0 << false;
+    QTest::newRow("large-skip") << 3 * 1024 * 1024 + 17 << 12345 << false;
+    QTest::newRow("large-text") << 3 * 1024 * 1024 + 17 << 0 << true;
+}
+
+void tst_QCryptographicHash::devices()
+{
+    QFETCH(int, size);
+    QFETCH(int, skip);
+    QFETCH(bool, textMode);
+
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i)
+        data[i] = (i % 97 == 0) ? '\r' : char(i * 7);
+    QByteArray expected = data.mid(skip);
+    if (textMode)
+        expected.replace('\r', QByteArray());
+    expected = QCryptographicHash::hash(expected, QCryptographicHash::Sha256);
+    const QIODevice::OpenMode mode = textMode ? QIODevice::ReadOnly | QIODevice::Text
+                                              : QIODevice::ReadOnly;
+
+    QTemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    QCOMPARE(tempFile.write(data), qint64(size));
+    tempFile.close();
+
+    QFile file(tempFile.fileName());
+    QVERIFY(file.open(mode));
+    QCOMPARE(file.read(skip).size(), skip);
+    QCryptographicHash fileHash(QCryptographicHash::Sha256);
+    QVERIFY(fileHash.addData(&file));
+    QVERIFY(file.atEnd());
+    QCOMPARE(fileHash.result().toHex(), expected.toHex());
+
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(mode));
+    QCOMPARE(buffer.read(skip).size(), skip);
+    QCryptographicHash bufferHash(QCryptographicHash::Sha256);
+    QVERIFY(bufferHash.addData(&buffer));
+    QVERIFY(buffer.atEnd());
+    QCOMPARE(bufferHash.result().toHex(), expected.toHex());
+}
 
 QTEST_MAIN(tst_QCryptographicHash)
 #include "tst_qcryptographichash.moc"
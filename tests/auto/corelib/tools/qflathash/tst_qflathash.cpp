@@ -0,0 +1,535 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qflathash.h>
+#include <qhash.h>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insert();
+    void insertString();
+    void operatorBracket();
+    void value();
+    void remove();
+    void take();
+    void erase();
+    void eraseWhileIterating();
+    void removedSlotsAreReused();
+    void iterators();
+    void implicitSharing();
+    void reserveAndSqueeze();
+    void clear();
+    void swap();
+    void operator_eq();
+    void keysAndValues();
+    void collisions();
+    void seed();
+    void complexType();
+    void initializerList();
+    void flatSet();
+};
+
+void tst_QFlatHash::insert()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+    QVERIFY(!hash.contains(0));
+
+    const int count = 100000;
+    for (int i = 0; i < count; ++i) {
+        QFlatHash<int, int>::iterator it = hash.insert(i, i * 2);
+        QCOMPARE(it.key(), i);
+        QCOMPARE(it.value(), i * 2);
+        QCOMPARE(hash.size(), i + 1);
+    }
+    QVERIFY(hash.capacity() >= count);
+    QVERIFY(hash.capacity() <= count * 4);
+
+    for (int i = 0; i < count; ++i) {
+        QVERIFY(hash.contains(i));
+        QCOMPARE(hash.value(i), i * 2);
+        QCOMPARE(hash.count(i), 1);
+    }
+    QVERIFY(!hash.contains(-1));
+    QVERIFY(!hash.contains(count));
+
+    // replacing a value keeps the size
+    hash.insert(42, -42);
+    QCOMPARE(hash.size(), count);
+    QCOMPARE(hash.value(42), -42);
+}
+
+void tst_QFlatHash::insertString()
+{
+    QFlatHash<QString, QString> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(QString::number(i), QString::number(i * 3));
+    QCOMPARE(hash.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(QString::number(i)), QString::number(i * 3));
+    QVERIFY(!hash.contains(QString()));
+    QVERIFY(!hash.contains(QStringLiteral("1000")));
+}
+
+void tst_QFlatHash::operatorBracket()
+{
+    QFlatHash<QString, int> hash;
+    hash[QStringLiteral("a")] = 1;
+    hash[QStringLiteral("b")] += 2;
+    ++hash[QStringLiteral("a")];
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash[QStringLiteral("a")], 2);
+    QCOMPARE(hash[QStringLiteral("b")], 2);
+
+    const QFlatHash<QString, int> &constHash = hash;
+    QCOMPARE(constHash[QStringLiteral("c")], 0);
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash[QStringLiteral("c")], 0);
+    QCOMPARE(hash.size(), 3);
+}
+
+void tst_QFlatHash::value()
+{
+    QFlatHash<int, QString> hash;
+    QCOMPARE(hash.value(1), QString());
+    QCOMPARE(hash.value(1, QStringLiteral("default")), QStringLiteral("default"));
+    hash.insert(1, QStringLiteral("one"));
+    QCOMPARE(hash.value(1), QStringLiteral("one"));
+    QCOMPARE(hash.value(1, QStringLiteral("default")), QStringLiteral("one"));
+    QCOMPARE(hash.key(QStringLiteral("one")), 1);
+    QCOMPARE(hash.key(QStringLiteral("two"), -1), -1);
+}
+
+void tst_QFlatHash::remove()
+{
+    QFlatHash<int, int> hash;
+    QCOMPARE(hash.remove(1), 0);
+
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    for (int i = 0; i < 1000; i += 2)
+        QCOMPARE(hash.remove(i), 1);
+    QCOMPARE(hash.size(), 500);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.contains(i), bool(i & 1));
+    QCOMPARE(hash.remove(0), 0);
+
+    // removed keys can be inserted again
+    for (int i = 0; i < 1000; i += 2)
+        hash.insert(i, -i);
+    QCOMPARE(hash.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(i), (i & 1) ? i : -i);
+}
+
+void tst_QFlatHash::take()
+{
+    QFlatHash<int, QString> hash;
+    QCOMPARE(hash.take(1), QString());
+    hash.insert(1, QStringLiteral("one"));
+    hash.insert(2, QStringLiteral("two"));
+    QCOMPARE(hash.take(1), QStringLiteral("one"));
+    QCOMPARE(hash.take(1), QString());
+    QCOMPARE(hash.size(), 1);
+    QVERIFY(hash.contains(2));
+}
+
+void tst_QFlatHash::erase()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 10; ++i)
+        hash.insert(i, i);
+
+    QFlatHash<int, int>::iterator it = hash.find(5);
+    QVERIFY(it != hash.end());
+    it = hash.erase(it);
+    QCOMPARE(hash.size(), 9);
+    QVERIFY(!hash.contains(5));
+    QVERIFY(hash.find(5) == hash.end());
+    QVERIFY(hash.constFind(5) == hash.constEnd());
+}
+
+void tst_QFlatHash::eraseWhileIterating()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+
+    int visited = 0;
+    QFlatHash<int, int>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        ++visited;
+        if (it.key() % 3 == 0)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(visited, 1000);
+    QCOMPARE(hash.size(), 666);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.contains(i), i % 3 != 0);
+}
+
+void tst_QFlatHash::removedSlotsAreReused()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+    const int capacity = hash.capacity();
+
+    // a sliding window of keys must not make the table grow forever
+    for (int i = 100; i < 100000; ++i) {
+        hash.insert(i, i);
+        QCOMPARE(hash.remove(i - 100), 1);
+    }
+    QCOMPARE(hash.size(), 100);
+    QVERIFY(hash.capacity() <= capacity * 2);
+    for (int i = 100000 - 100; i < 100000; ++i)
+        QCOMPARE(hash.value(i), i);
+}
+
+void tst_QFlatHash::iterators()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.begin() == hash.end());
+    QVERIFY(hash.constBegin() == hash.constEnd());
+
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i + 1);
+
+    QSet<int> seen;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        QCOMPARE(it.value(), it.key() + 1);
+        QCOMPARE(*it, it.key() + 1);
+        seen.insert(it.key());
+    }
+    QCOMPARE(seen.size(), 1000);
+
+    // backwards
+    int count = 0;
+    QFlatHash<int, int>::iterator it = hash.end();
+    while (it != hash.begin()) {
+        --it;
+        ++count;
+        QVERIFY(seen.contains(it.key()));
+    }
+    QCOMPARE(count, 1000);
+
+    // modifying through a non-const iterator
+    for (QFlatHash<int, int>::iterator it = hash.begin(); it != hash.end(); ++it)
+        *it = -it.key();
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(i), -i);
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, QString> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, QString::number(i));
+
+    QFlatHash<int, QString> copy = hash;
+    QVERIFY(copy.isSharedWith(hash));
+    QVERIFY(!hash.isDetached());
+
+    copy.insert(100, QStringLiteral("100"));
+    QVERIFY(!copy.isSharedWith(hash));
+    QCOMPARE(hash.size(), 100);
+    QCOMPARE(copy.size(), 101);
+    QVERIFY(!hash.contains(100));
+
+    QFlatHash<int, QString> copy2 = hash;
+    copy2.remove(5);
+    QVERIFY(hash.contains(5));
+    QVERIFY(!copy2.contains(5));
+
+    // erasing through an iterator of a shared hash detaches
+    QFlatHash<int, QString> copy3 = hash;
+    QFlatHash<int, QString>::iterator it = copy3.find(7);
+    QFlatHash<int, QString> copy4 = copy3;
+    it = copy3.erase(it);
+    QVERIFY(!copy3.contains(7));
+    QVERIFY(copy4.contains(7));
+    QVERIFY(hash.contains(7));
+
+    // a copy of a hash with removed entries finds everything
+    QFlatHash<int, QString> copy5 = copy2;
+    copy5.insert(1000, QString());
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(copy5.value(i), i == 5 ? QString() : QString::number(i));
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    const int capacity = hash.capacity();
+    QVERIFY(capacity >= 1000);
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QCOMPARE(hash.size(), 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i), i);
+
+    hash.clear();
+    hash.squeeze();
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::clear()
+{
+    QFlatHash<QString, int> hash;
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    hash.insert(QStringLiteral("key"), 1);
+    QFlatHash<QString, int> copy = hash;
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+    QCOMPARE(copy.size(), 1);
+}
+
+void tst_QFlatHash::swap()
+{
+    QFlatHash<int, QString> h1, h2;
+    QString s1, s2;
+    h1[0] = QStringLiteral("h1[0]");
+    s1 = h1[0];
+    h2[1] = QStringLiteral("h2[1]");
+    s2 = h2[1];
+    h1.swap(h2);
+    QCOMPARE(h1.value(1), s2);
+    QCOMPARE(h2.value(0), s1);
+}
+
+void tst_QFlatHash::operator_eq()
+{
+    QFlatHash<int, int> a, b;
+    QVERIFY(a == b);
+    a.insert(1, 1);
+    QVERIFY(a != b);
+    b.insert(1, 2);
+    QVERIFY(a != b);
+    b.insert(1, 1);
+    QVERIFY(a == b);
+
+    // equality does not depend on the table layout
+    for (int i = 0; i < 100; ++i)
+        a.insert(i, i);
+    for (int i = 99; i >= 0; --i)
+        b.insert(i, i);
+    b.reserve(10000);
+    QVERIFY(a == b);
+}
+
+void tst_QFlatHash::keysAndValues()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i % 10);
+
+    QList<int> keys = hash.keys();
+    QList<int> values = hash.values();
+    QCOMPARE(keys.size(), 100);
+    QCOMPARE(values.size(), 100);
+    for (int i = 0; i < keys.size(); ++i)
+        QCOMPARE(values.at(i), keys.at(i) % 10);
+
+    QList<int> threes = hash.keys(3);
+    std::sort(threes.begin(), threes.end());
+    QCOMPARE(threes, QList<int>() << 3 << 13 << 23 << 33 << 43 << 53 << 63 << 73 << 83 << 93);
+}
+
+struct BadHash
+{
+    int i;
+    BadHash(int i = 0) : i(i) {}
+    bool operator==(const BadHash &other) const { return i == other.i; }
+};
+
+uint qHash(const BadHash &key, uint seed)
+{
+    return uint(key.i % 3) ^ seed;
+}
+
+void tst_QFlatHash::collisions()
+{
+    // all keys share three hash values, so they fill many groups
+    QFlatHash<BadHash, int> hash;
+    for (int i = 0; i < 200; ++i)
+        hash.insert(BadHash(i), i);
+    QCOMPARE(hash.size(), 200);
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.value(BadHash(i)), i);
+    for (int i = 0; i < 200; i += 2)
+        QCOMPARE(hash.remove(BadHash(i)), 1);
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.contains(BadHash(i)), bool(i & 1));
+    for (int i = 200; i < 300; ++i)
+        hash.insert(BadHash(i), i);
+    QCOMPARE(hash.size(), 200);
+    for (int i = 0; i < 300; ++i)
+        QCOMPARE(hash.contains(BadHash(i)), i >= 200 || (i & 1));
+}
+
+struct SeedRecorder
+{
+    int i;
+    SeedRecorder(int i = 0) : i(i) {}
+    bool operator==(const SeedRecorder &other) const { return i == other.i; }
+    static uint lastSeed;
+};
+
+uint SeedRecorder::lastSeed = 0;
+
+uint qHash(const SeedRecorder &key, uint seed)
+{
+    SeedRecorder::lastSeed = seed;
+    return qHash(key.i, seed);
+}
+
+void tst_QFlatHash::seed()
+{
+    // QFlatHash uses the same seed as QHash
+    QHash<SeedRecorder, int> hash;
+    hash.insert(SeedRecorder(1), 1);
+    const uint hashSeed = SeedRecorder::lastSeed;
+
+    SeedRecorder::lastSeed = 0;
+    QFlatHash<SeedRecorder, int> flatHash;
+    flatHash.insert(SeedRecorder(1), 1);
+    QCOMPARE(SeedRecorder::lastSeed, hashSeed);
+}
+
+struct Counted
+{
+    static int instances;
+    int value;
+    Counted(int v = 0) : value(v) { ++instances; }
+    Counted(const Counted &other) : value(other.value) { ++instances; }
+    ~Counted() { --instances; }
+    Counted &operator=(const Counted &other) { value = other.value; return *this; }
+    bool operator==(const Counted &other) const { return value == other.value; }
+};
+
+int Counted::instances = 0;
+
+uint qHash(const Counted &key, uint seed)
+{
+    return qHash(key.value, seed);
+}
+
+void tst_QFlatHash::complexType()
+{
+    {
+        QFlatHash<Counted, Counted> hash;
+        for (int i = 0; i < 1000; ++i)
+            hash.insert(Counted(i), Counted(-i));
+        QCOMPARE(Counted::instances, 2000);
+        for (int i = 0; i < 1000; i += 4)
+            hash.remove(Counted(i));
+        QCOMPARE(Counted::instances, 1500);
+        QFlatHash<Counted, Counted> copy = hash;
+        copy.insert(Counted(-1), Counted(1));
+        QCOMPARE(Counted::instances, 3002);
+        copy.squeeze();
+        QCOMPARE(Counted::instances, 3002);
+        QCOMPARE(copy.value(Counted(1)).value, -1);
+    }
+    QCOMPARE(Counted::instances, 0);
+}
+
+void tst_QFlatHash::initializerList()
+{
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    QFlatHash<int, QString> hash = { { 1, QStringLiteral("bar") }, { 2, QStringLiteral("baz") } };
+    QCOMPARE(hash.count(), 2);
+    QCOMPARE(hash[1], QStringLiteral("bar"));
+    QCOMPARE(hash[2], QStringLiteral("baz"));
+
+    QFlatSet<int> set = { 1, 2, 3, 2 };
+    QCOMPARE(set.size(), 3);
+#else
+    QSKIP("Compiler doesn't support initializer lists");
+#endif
+}
+
+void tst_QFlatHash::flatSet()
+{
+    QFlatSet<QString> set;
+    QVERIFY(set.isEmpty());
+    for (int i = 0; i < 100; ++i)
+        set.insert(QString::number(i));
+    set.insert(QStringLiteral("0"));
+    QCOMPARE(set.size(), 100);
+    QVERIFY(set.contains(QStringLiteral("42")));
+    QVERIFY(!set.contains(QStringLiteral("100")));
+    QVERIFY(set.remove(QStringLiteral("42")));
+    QVERIFY(!set.remove(QStringLiteral("42")));
+    QCOMPARE(set.size(), 99);
+
+    int count = 0;
+    for (QFlatSet<QString>::const_iterator it = set.constBegin(); it != set.constEnd(); ++it) {
+        QVERIFY(set.contains(*it));
+        ++count;
+    }
+    QCOMPARE(count, 99);
+
+    QFlatSet<QString>::const_iterator it = set.find(QStringLiteral("7"));
+    QVERIFY(it != set.end());
+    QFlatSet<QString> copy = set;
+    set.erase(it);
+    QVERIFY(!set.contains(QStringLiteral("7")));
+    QVERIFY(copy.contains(QStringLiteral("7")));
+    QVERIFY(set != copy);
+    copy.remove(QStringLiteral("7"));
+    QVERIFY(set == copy);
+    QCOMPARE(set.values().size(), 98);
+
+    // the set only stores its keys
+    QVERIFY(sizeof(QFlatHashNode<int, QHashDummyValue>) == sizeof(int));
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
@@ -42,9 +42,13 @@
 #include <qdatetime.h>
 #include <qprocess.h>
 #include <float.h>
+#include <locale.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <qlocale.h>
 #include <private/qlocale_p.h>
+#include <private/qlocale_tools_p.h>
 #include <qnumeric.h>
 
 #if defined(Q_OS_LINUX) && !defined(__UCLIBC__)
@@ -148,6 +152,11 @@ private slots:
     void testInfAndNan();
     void fpExceptions();
     void negativeZero();
+    void shortestDoubles_data();
+    void shortestDoubles();
+    void doubleRoundTrip();
+    void fastDtoaMatchesQdtoa();
+    void toDoubleMatchesStrtod();
     void dayOfWeek();
     void dayOfWeek_data();
     void formatDate();
@@ -981,6 +990,198 @@ void tst_QLocale::negativeZero()
     QCOMPARE(s, QString("0"));
 }
 
+// xorshift64*, to get all bit patterns of a double
+static quint64 randomBits(quint64 &state)
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * Q_UINT64_C(2685821657736338717);
+}
+
+static double randomDouble(quint64 &state)
+{
+    double d;
+    do {
+        const quint64 bits = randomBits(state);
+        memcpy(&d, &bits, sizeof(d));
+    } while (!qIsFinite(d));
+    return d;
+}
+
+static bool sameDouble(double a, double b)
+{
+    return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+void tst_QLocale::shortestDoubles_data()
+{
+    QTest::addColumn<double>("num");
+    QTest::addColumn<char>("format");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("0.1 g") << 0.1 << 'g' << QString("0.1");
+    QTest::newRow("0.1 f") << 0.1 << 'f' << QString("0.1");
+    QTest::newRow("0.1 e") << 0.1 << 'e' << QString("1e-01");
+    QTest::newRow("1/3 g") << 1.0 / 3 << 'g' << QString("0.3333333333333333");
+    QTest::newRow("2/3 e") << 2.0 / 3 << 'e' << QString("6.666666666666666e-01");
+    QTest::newRow("0.1 + 0.2") << 0.1 + 0.2 << 'g' << QString("0.30000000000000004");
+    QTest::newRow("100 g") << 100.0 << 'g' << QString("100");
+    QTest::newRow("100 f") << 100.0 << 'f' << QString("100");
+    QTest::newRow("1e16 g") << 1e16 << 'g' << QString("10000000000000000");
+    QTest::newRow("1e17 g") << 1e17 << 'g' << QString("1e+17");
+    QTest::newRow("1e17 f") << 1e17 << 'f' << QString("100000000000000000");
+    QTest::newRow("123.456 g") << 123.456 << 'g' << QString("123.456");
+    QTest::newRow("-1.5 g") << -1.5 << 'g' << QString("-1.5");
+    QTest::newRow("0.0001 g") << 0.0001 << 'g' << QString("0.0001");
+    QTest::newRow("0.00001 g") << 0.00001 << 'g' << QString("1e-05");
+    QTest::newRow("0 g") << 0.0 << 'g' << QString("0");
+    QTest::newRow("max g") << DBL_MAX << 'g' << QString("1.7976931348623157e+308");
+    QTest::newRow("min g") << DBL_MIN << 'g' << QString("2.2250738585072014e-308");
+    QTest::newRow("denorm_min g") << 4.9406564584124654e-324 << 'g' << QString("5e-324");
+    QTest::newRow("2^53 + 2") << 9007199254740994.0 << 'g' << QString("9007199254740994");
+}
+
+void tst_QLocale::shortestDoubles()
+{
+    QFETCH(double, num);
+    QFETCH(char, format);
+    QFETCH(QString, expected);
+
+    QLocale c = QLocale::c();
+    c.setNumberOptions(QLocale::OmitGroupSeparator);
+    QCOMPARE(QString::number(num, format, QLocale::FloatingPointShortest), expected);
+    QCOMPARE(c.toString(num, format, QLocale::FloatingPointShortest), expected);
+    QCOMPARE(QByteArray::number(num, format, QLocale::FloatingPointShortest), expected.toLatin1());
+}
+
+void tst_QLocale::doubleRoundTrip()
+{
+    const QLocale c = QLocale::c();
+    QLocale german(QLocale::German);
+    german.setNumberOptions(QLocale::OmitGroupSeparator);
+
+    quint64 state = Q_UINT64_C(0x9e3779b97f4a7c15);
+    for (int i = 0; i < 200000; ++i) {
+        const double d = randomDouble(state);
+        bool ok;
+
+        const QString shortest = QString::number(d, 'g', QLocale::FloatingPointShortest);
+        const double fromShortest = c.toDouble(shortest, &ok);
+        QVERIFY2(ok && sameDouble(d, fromShortest), qPrintable(shortest));
+
+        const QString full = QString::number(d, 'e', 16);
+        QVERIFY2(sameDouble(c.toDouble(full, &ok), d) && ok, qPrintable(full));
+
+        const QString localized = german.toString(d, 'g', QLocale::FloatingPointShortest);
+        QVERIFY2(sameDouble(german.toDouble(localized, &ok), d) && ok, qPrintable(localized));
+    }
+
+    // powers of ten and two, and their neighbours
+    for (int e = -323; e <= 308; ++e) {
+        const double d = QString("1e%1").arg(e).toDouble();
+        QVERIFY(sameDouble(QString::number(d, 'g', QLocale::FloatingPointShortest).toDouble(), d));
+    }
+    for (int e = -1074; e <= 1023; ++e) {
+        const double d = ldexp(1.0, e);
+        QVERIFY(sameDouble(QString::number(d, 'g', QLocale::FloatingPointShortest).toDouble(), d));
+        const double below = d - ldexp(1.0, e - 53);
+        if (below > 0)
+            QVERIFY(sameDouble(QString::number(below, 'g', QLocale::FloatingPointShortest).toDouble(), below));
+    }
+}
+
+void tst_QLocale::fastDtoaMatchesQdtoa()
+{
+    quint64 state = Q_UINT64_C(0x2545f4914f6cdd1d);
+    int fast = 0;
+    int total = 0;
+    for (int i = 0; i < 100000; ++i) {
+        // mostly numbers of a reasonable size, for mode 3
+        double d = randomDouble(state);
+        if (i & 1)
+            d = ldexp(d, -ilogb(d) + int(randomBits(state) % 120) - 60);
+        for (int mode = 0; mode <= 3; ++mode) {
+            if (mode == 1)
+                continue;
+            const int ndigits = mode == 0 ? 0 : int(randomBits(state) % 18);
+            char buf[QFastDtoaMaxDigits + 1];
+            int length, decpt;
+            const bool handled = qt_fastDtoa(d, mode, ndigits, buf, &length, &decpt);
+            if (mode != 3 && (i & 1)) {
+                ++total;
+                fast += handled;
+            }
+            if (!handled)
+                continue;
+
+            int qdecpt, sign;
+            char *rve = 0;
+            char *buff = 0;
+            const QByteArray expected(qdtoa(d, mode, ndigits, &qdecpt, &sign, &rve, &buff));
+            free(buff);
+            const QByteArray actual(buf, length);
+            QVERIFY2(actual == expected && decpt == qdecpt,
+                     qPrintable(QString("%1 mode %2 ndigits %3: %4e%5, expected %6e%7")
+                                .arg(d, 0, 'e', 16).arg(mode).arg(ndigits)
+                                .arg(QString(actual)).arg(decpt)
+                                .arg(QString(expected)).arg(qdecpt)));
+        }
+    }
+    // the fast algorithms must handle the vast majority of ordinary numbers
+    QVERIFY2(fast > total * 0.9, qPrintable(QString("%1 of %2").arg(fast).arg(total)));
+}
+
+void tst_QLocale::toDoubleMatchesStrtod()
+{
+    const QByteArray oldLocale = setlocale(LC_NUMERIC, 0);
+    setlocale(LC_NUMERIC, "C");
+
+    const char *const hardCases[] = {
+        "2.2250738585072011e-308", "2.2250738585072012e-308", "4.9406564584124654e-324",
+        "1.7976931348623157e308", "1.7976931348623158e308", "9007199254740993",
+        "9007199254740992.5", "9007199254740993.0000000000000001", "0.1", "0.3",
+        "3.0517578125e-05", "7.3177701707893310e+15", "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124", "123456789012345678901234567890",
+        "1e23", "8.98846567431158e307", "5e-324", "2.4703282292062327e-324", "4.5035996273704955e15",
+        "1448997445238699", "-0", "0.000", "0e10", "+1.5", "1.", ".5", "3.4e38", "9.999999999999999e22"
+    };
+    for (size_t i = 0; i < sizeof(hardCases) / sizeof(hardCases[0]); ++i) {
+        bool ok;
+        const double d = QLocale::c().toDouble(QString(hardCases[i]), &ok);
+        const double expected = strtod(hardCases[i], 0);
+        QVERIFY2(ok, hardCases[i]);
+        QVERIFY2(sameDouble(d, expected), hardCases[i]);
+    }
+
+    quint64 state = Q_UINT64_C(0x853c49e6748fea9b);
+    for (int i = 0; i < 200000; ++i) {
+        const quint64 bits = randomBits(state);
+        QByteArray number;
+        if (bits & 1)
+            number += '-';
+        const int digits = 1 + int((bits >> 1) % 22);
+        const int point = int((bits >> 8) % (digits + 1));
+        for (int j = 0; j < digits; ++j) {
+            if (j == point)
+                number += '.';
+            number += char('0' + randomBits(state) % 10);
+        }
+        if (bits & 2)
+            number += 'e' + QByteArray::number(int((bits >> 16) % 700) - 350);
+
+        bool ok;
+        const double d = QLocale::c().toDouble(QString::fromLatin1(number), &ok);
+        const double expected = strtod(number.constData(), 0);
+        if (qIsFinite(expected) && (ok || qAbs(expected) >= DBL_MIN)) {
+            QVERIFY2(ok, number.constData());
+            QVERIFY2(sameDouble(d, expected), number.constData());
+        }
+    }
+
+    setlocale(LC_NUMERIC, oldLocale.constData());
+}
+
 void tst_QLocale::dayOfWeek_data()
 {
     QTest::addColumn<QDate>("date");
@@ -0,0 +1,4 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qsmallbytearray
+QT = core-private testlib
+SOURCES = tst_qsmallbytearray.cpp
@@ -0,0 +1,199 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <private/qsmallbytearray_p.h>
+
+class tst_QSmallByteArray : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void size();
+    void construct_data();
+    void construct();
+    void copy();
+    void append_data();
+    void append();
+    void trimmed_data();
+    void trimmed();
+    void toLower();
+    void compare();
+};
+
+void tst_QSmallByteArray::size()
+{
+    QCOMPARE(sizeof(QSmallByteArray), size_t(24));
+    QCOMPARE(int(QSmallByteArray::InlineCapacity), 22);
+}
+
+void tst_QSmallByteArray::construct_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<bool>("isInline");
+
+    QTest::newRow("empty") << QByteArray("") << true;
+    QTest::newRow("short") << QByteArray("Content-Type") << true;
+    QTest::newRow("22") << QByteArray(22, 'x') << true;
+    QTest::newRow("23") << QByteArray(23, 'x') << false;
+    QTest::newRow("long") << QByteArray("text/html; charset=utf-8; something=else") << false;
+    QTest::newRow("embedded-nul") << QByteArray("a\0b", 3) << true;
+}
+
+void tst_QSmallByteArray::construct()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(bool, isInline);
+
+    QSmallByteArray fromData(data.constData(), data.size());
+    QCOMPARE(fromData.isInline(), isInline);
+    QCOMPARE(fromData.size(), data.size());
+    QCOMPARE(fromData.isEmpty(), data.isEmpty());
+    QCOMPARE(fromData.toByteArray(), data);
+    QCOMPARE(fromData.constData()[data.size()], '\0');
+
+    QSmallByteArray fromByteArray(data);
+    QCOMPARE(fromByteArray.isInline(), isInline);
+    QCOMPARE(fromByteArray.toByteArray(), data);
+    QVERIFY(fromByteArray == data);
+    QVERIFY(fromByteArray == fromData);
+
+    // long contents share the QByteArray they were made from
+    if (!isInline) {
+        QCOMPARE(fromByteArray.constData(), data.constData());
+        QCOMPARE(fromByteArray.toByteArray().constData(), data.constData());
+    }
+
+    fromData.clear();
+    QVERIFY(fromData.isEmpty());
+    QVERIFY(fromData.isInline());
+}
+
+void tst_QSmallByteArray::copy()
+{
+    QSmallByteArray small("short", 5);
+    QSmallByteArray large(QByteArray(100, 'y'));
+
+    QSmallByteArray copy(small);
+    QVERIFY(copy == small);
+    copy = large;
+    QVERIFY(!copy.isInline());
+    QCOMPARE(copy.constData(), large.constData());
+    copy = small;
+    QVERIFY(copy.isInline());
+    QCOMPARE(copy.toByteArray(), QByteArray("short"));
+    copy = copy;
+    QCOMPARE(copy.toByteArray(), QByteArray("short"));
+
+    QVector<QSmallByteArray> vector;
+    for (int i = 0; i < 100; ++i)
+        vector.append(i % 2 ? small : large);
+    for (int i = 0; i < 100; ++i)
+        QVERIFY(vector.at(i) == (i % 2 ? small : large));
+}
+
+void tst_QSmallByteArray::append_data()
+{
+    QTest::addColumn<QByteArray>("initial");
+    QTest::addColumn<QByteArray>("appended");
+
+    QTest::newRow("inline+inline") << QByteArray("text/html;") << QByteArray(" charset=utf-8");
+    QTest::newRow("inline-to-heap") << QByteArray("text/html;") << QByteArray(" charset=utf-8; more");
+    QTest::newRow("heap+inline") << QByteArray(30, 'a') << QByteArray("b");
+    QTest::newRow("empty+heap") << QByteArray() << QByteArray(40, 'c');
+    QTest::newRow("empty+empty") << QByteArray() << QByteArray();
+}
+
+void tst_QSmallByteArray::append()
+{
+    QFETCH(QByteArray, initial);
+    QFETCH(QByteArray, appended);
+
+    QSmallByteArray small(initial);
+    small.append(appended.constData(), appended.size());
+    QCOMPARE(small.toByteArray(), initial + appended);
+    QCOMPARE(small.isInline(), initial.size() + appended.size() <= QSmallByteArray::InlineCapacity);
+
+    QSmallByteArray other(initial);
+    other.append(appended);
+    QCOMPARE(other.toByteArray(), initial + appended);
+    other.append('!');
+    QCOMPARE(other.toByteArray(), initial + appended + '!');
+}
+
+void tst_QSmallByteArray::trimmed_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("spaces") << QByteArray(" \t\r\n ");
+    QTest::newRow("none") << QByteArray("gzip");
+    QTest::newRow("both") << QByteArray(" \tgzip \r");
+    QTest::newRow("inner") << QByteArray("  text/html; charset=utf-8");
+    QTest::newRow("long") << QByteArray("   a value longer than the inline capacity   ");
+}
+
+void tst_QSmallByteArray::trimmed()
+{
+    QFETCH(QByteArray, data);
+
+    QSmallByteArray small = QSmallByteArray::trimmed(data.constData(), data.size());
+    QCOMPARE(small.toByteArray(), data.trimmed());
+}
+
+void tst_QSmallByteArray::toLower()
+{
+    const QByteArray mixed("Max-Age HttpOnly \xc0\xd7\xde\xdf");
+    QCOMPARE(QSmallByteArray(mixed).toLower().toByteArray(), mixed.toLower());
+
+    const QByteArray longMixed("Content-Security-Policy-Report-Only");
+    QCOMPARE(QSmallByteArray(longMixed).toLower().toByteArray(), longMixed.toLower());
+}
+
+void tst_QSmallByteArray::compare()
+{
+    QSmallByteArray expires("expires", 7);
+    QVERIFY(expires == "expires");
+    QVERIFY(expires != "expire");
+    QVERIFY(expires != "expiress");
+    QVERIFY(expires == QByteArray("expires"));
+    QVERIFY(expires != QByteArray("Expires"));
+    QVERIFY(QSmallByteArray() == "");
+    QVERIFY(expires.startsWith('e'));
+    QVERIFY(!expires.startsWith('x'));
+    QVERIFY(!QSmallByteArray().startsWith('e'));
+}
+
+QTEST_APPLESS_MAIN(tst_QSmallByteArray)
+
+#include "tst_qsmallbytearray.moc"
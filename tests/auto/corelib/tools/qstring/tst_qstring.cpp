@@ -259,6 +259,7 @@ private slots:
     void toHtmlEscaped();
     void operatorGreaterWithQLatin1String();
     void compareQLatin1Strings();
+    void vectorizedKernels();
     void fromQLatin1StringWithLength();
     void assignQLatin1String();
     void isRightToLeft_data();
@@ -6074,6 +6075,63 @@ void tst_QString::operatorGreaterWithQLatin1String()
     QVERIFY(!(stringfoo < latin1foo));
 }
 
+// the vectorized loops run over 8, 16 or 32 characters at a time; check that
+// all lengths and positions of the interesting character come out right
+void tst_QString::vectorizedKernels()
+{
+    for (int length = 0; length <= 80; ++length) {
+        QByteArray latin1(length, Qt::Uninitialized);
+        for (int i = 0; i < length; ++i)
+            latin1[i] = char(0x20 + (i * 37) % 0xdf);
+
+        const QString s = QString::fromLatin1(latin1);
+        QCOMPARE(s.size(), length);
+        for (int i = 0; i < length; ++i)
+            QCOMPARE(s.at(i).unicode(), ushort(uchar(latin1.at(i))));
+        QCOMPARE(s.toLatin1(), latin1);
+        QCOMPARE(s.compare(QString(s)), 0);
+        QVERIFY(s == QLatin1String(latin1));
+
+        // ASCII only, for the UTF-8 fast paths
+        QByteArray ascii = latin1;
+        for (int i = 0; i < length; ++i)
+            ascii[i] = char(ascii.at(i) & 0x7f);
+        QCOMPARE(QString::fromUtf8(ascii), QString::fromLatin1(ascii));
+        QCOMPARE(QString::fromLatin1(ascii).toUtf8(), ascii);
+
+        for (int pos = 0; pos < length; ++pos) {
+            QString other = s;
+            other[pos] = QChar(0x2022);
+            QVERIFY(s.compare(other) < 0);
+            QVERIFY(other.compare(s) > 0);
+            QVERIFY(other != QLatin1String(latin1));
+            QVERIFY(other > QLatin1String(latin1));
+            QCOMPARE(other.indexOf(QChar(0x2022)), pos);
+            QCOMPARE(other.toLatin1(), QByteArray(latin1).replace(pos, 1, "?"));
+
+            QString lower = s;
+            lower[pos] = QChar(0x1f);
+            QVERIFY(lower < QLatin1String(latin1));
+            QVERIFY(lower.compare(s) < 0);
+
+            QByteArray utf8 = ascii;
+            utf8.insert(pos, "\xe2\x80\xa2");
+            QString expected = QString::fromLatin1(ascii);
+            expected.insert(pos, QChar(0x2022));
+            QCOMPARE(QString::fromUtf8(utf8), expected);
+            QCOMPARE(expected.toUtf8(), utf8);
+        }
+
+        // unaligned data
+        if (length > 1) {
+            const QString tail = s.mid(1);
+            QCOMPARE(tail.toLatin1(), latin1.mid(1));
+            QCOMPARE(QString::fromLatin1(latin1.constData() + 1, length - 1), tail);
+            QCOMPARE(QStringRef(&s, 1, length - 1).compare(tail), 0);
+        }
+    }
+}
+
 void tst_QString::compareQLatin1Strings()
 {
     QLatin1String abc("abc");
@@ -0,0 +1,4 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qstringatom
+QT = core testlib
+SOURCES = tst_qstringatom.cpp
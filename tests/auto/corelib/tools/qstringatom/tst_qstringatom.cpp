@@ -0,0 +1,323 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <qstringatom.h>
+#include <qjsondocument.h>
+#include <qjsonarray.h>
+#include <qjsonobject.h>
+#include <qxmlstream.h>
+#include <qsettings.h>
+#include <qtemporarydir.h>
+#include <qthread.h>
+
+class tst_QStringAtom : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+
+    void nullAndEmpty();
+    void intern();
+    void overloads();
+    void atoms();
+    void staticData();
+    void threads();
+    void jsonObjectKeys();
+    void xmlStreamNames();
+    void settingsKeys();
+    void automaticInterningLimit(); // must be last
+};
+
+void tst_QStringAtom::cleanup()
+{
+    QStringAtom::setAutomaticInterning(0);
+}
+
+void tst_QStringAtom::nullAndEmpty()
+{
+    QStringAtom null;
+    QVERIFY(null.isNull());
+    QVERIFY(null.toString().isNull());
+    QCOMPARE(null.hash(), 0u);
+    QVERIFY(QStringAtom(QString()) == null);
+    QVERIFY(QStringAtom(QLatin1String(0)) == null);
+    QVERIFY(QStringAtom::intern(QString()).isNull());
+
+    QStringAtom empty((QString("")));
+    QVERIFY(!empty.isNull());
+    QVERIFY(empty != null);
+    QVERIFY(empty.toString().isEmpty());
+    QVERIFY(!empty.toString().isNull());
+    QCOMPARE(empty.size(), 0);
+    QVERIFY(QStringAtom(QLatin1String("")) == empty);
+}
+
+void tst_QStringAtom::intern()
+{
+    const QString key = QStringLiteral("tst_QStringAtom::intern");
+    const int count = QStringAtom::count();
+
+    QString s1 = QStringAtom::intern(key);
+    QCOMPARE(QStringAtom::count(), count + 1);
+    QString s2 = QStringAtom::intern(QString(key));
+    QCOMPARE(QStringAtom::count(), count + 1);
+
+    QCOMPARE(s1, key);
+    QCOMPARE(s2, key);
+    QVERIFY(s1.constData() != key.constData());
+    QCOMPARE(s1.constData(), s2.constData());
+
+    QString other = QStringAtom::intern(key + QLatin1Char('!'));
+    QCOMPARE(QStringAtom::count(), count + 2);
+    QVERIFY(other.constData() != s1.constData());
+}
+
+void tst_QStringAtom::overloads()
+{
+    QString s = QStringAtom::intern(QStringLiteral("tst_QStringAtom::overloads"));
+    QCOMPARE(QStringAtom::intern(QLatin1String("tst_QStringAtom::overloads")).constData(), s.constData());
+
+    const QString raw = QStringLiteral("xtst_QStringAtom::overloadsx");
+    QCOMPARE(QStringAtom::intern(raw.constData() + 1, raw.size() - 2).constData(), s.constData());
+
+    // non-Latin-1 characters
+    const QString unicode = QString::fromUtf8("\xe2\x82\xac\xc3\xa9t\xc3\xa9");
+    QString u = QStringAtom::intern(unicode);
+    QCOMPARE(u, unicode);
+    QCOMPARE(QStringAtom::intern(QString::fromUtf8("\xe2\x82\xac\xc3\xa9t\xc3\xa9")).constData(), u.constData());
+    QCOMPARE(QStringAtom::intern(QLatin1String("\xe9t\xe9")), QString::fromUtf8("\xc3\xa9t\xc3\xa9"));
+
+    // long strings don't fit the arena blocks
+    const QString large(20000, QLatin1Char('z'));
+    QString l = QStringAtom::intern(large);
+    QCOMPARE(l, large);
+    QCOMPARE(QStringAtom::intern(QString(20000, QLatin1Char('z'))).constData(), l.constData());
+}
+
+void tst_QStringAtom::atoms()
+{
+    QStringAtom a1(QStringLiteral("alpha"));
+    QStringAtom a2(QLatin1String("alpha"));
+    QStringAtom b(QStringLiteral("beta"));
+
+    QVERIFY(a1 == a2);
+    QVERIFY(a1 != b);
+    QCOMPARE(a1.hash(), a2.hash());
+    QCOMPARE(qHash(a1, 42), qHash(a2, 42));
+    QCOMPARE(a1.toString(), QStringLiteral("alpha"));
+    QCOMPARE(a1.size(), 5);
+
+    QHash<QStringAtom, int> hash;
+    hash.insert(a1, 1);
+    hash.insert(b, 2);
+    QCOMPARE(hash.value(a2), 1);
+    QCOMPARE(hash.value(QStringAtom(QLatin1String("beta"))), 2);
+    QVERIFY(!hash.contains(QStringAtom(QLatin1String("gamma"))));
+
+    // many distinct strings, to make the tables grow
+    QVector<QStringAtom> atoms;
+    for (int i = 0; i < 10000; ++i)
+        atoms.append(QStringAtom(QString::fromLatin1("tst_QStringAtom::atoms %1").arg(i)));
+    for (int i = 0; i < 10000; ++i) {
+        QStringAtom atom(QString::fromLatin1("tst_QStringAtom::atoms %1").arg(i));
+        QVERIFY(atom == atoms.at(i));
+        QCOMPARE(atom.toString(), QString::fromLatin1("tst_QStringAtom::atoms %1").arg(i));
+    }
+}
+
+void tst_QStringAtom::staticData()
+{
+    QString s = QStringAtom::intern(QStringLiteral("tst_QStringAtom::staticData"));
+    const QChar *data = s.constData();
+
+    {
+        QString copy = s;
+        QCOMPARE(copy.constData(), data);
+        copy.append(QLatin1Char('!'));
+        QVERIFY(copy.constData() != data);
+        QCOMPARE(copy, QStringLiteral("tst_QStringAtom::staticData!"));
+
+        QString copy2 = s;
+        copy2[0] = QLatin1Char('T');
+        QVERIFY(copy2.constData() != data);
+    }
+
+    QCOMPARE(s, QStringLiteral("tst_QStringAtom::staticData"));
+    QCOMPARE(QStringAtom::intern(QStringLiteral("tst_QStringAtom::staticData")).constData(), data);
+    QCOMPARE(data[s.size()], QChar());
+}
+
+class InternThread : public QThread
+{
+public:
+    QVector<const QChar *> results;
+
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int round = 0; round < 4; ++round) {
+            results.clear();
+            for (int i = 0; i < 2000; ++i)
+                results.append(QStringAtom::intern(QString::fromLatin1("threaded key %1").arg(i)).constData());
+        }
+    }
+};
+
+void tst_QStringAtom::threads()
+{
+    InternThread threads[4];
+    for (int i = 0; i < 4; ++i)
+        threads[i].start();
+    for (int i = 0; i < 4; ++i)
+        QVERIFY(threads[i].wait(60000));
+
+    for (int i = 0; i < 2000; ++i) {
+        const QChar *expected = QStringAtom::intern(QString::fromLatin1("threaded key %1").arg(i)).constData();
+        for (int t = 0; t < 4; ++t)
+            QCOMPARE(threads[t].results.at(i), expected);
+    }
+}
+
+void tst_QStringAtom::jsonObjectKeys()
+{
+    const QByteArray json = "[{\"name\": 1, \"\\u00e9t\\u00e9\": 2}, {\"name\": 3, \"\\u00e9t\\u00e9\": 4, \"\\u20ac\": 5}]";
+
+    QJsonDocument doc = QJsonDocument::fromJson(json);
+    QJsonObject o1 = doc.array().at(0).toObject();
+    QJsonObject o2 = doc.array().at(1).toObject();
+    QVERIFY(o1.keys().first().constData() != o2.keys().first().constData());
+
+    QStringAtom::setAutomaticInterning(QStringAtom::JsonObjectKeys);
+    QCOMPARE(QStringAtom::automaticInterning(), QStringAtom::Clients(QStringAtom::JsonObjectKeys));
+
+    QStringList keys1 = o1.keys();
+    QStringList keys2 = o2.keys();
+    QCOMPARE(keys1, QStringList() << QStringLiteral("name") << QString::fromUtf8("\xc3\xa9t\xc3\xa9"));
+    QCOMPARE(keys2.size(), 3);
+    QCOMPARE(keys2.at(2), QString::fromUtf8("\xe2\x82\xac"));
+    QCOMPARE(keys1.at(0).constData(), keys2.at(0).constData());
+    QCOMPARE(keys1.at(1).constData(), keys2.at(1).constData());
+    QCOMPARE(o1.begin().key().constData(), keys1.at(0).constData());
+    QCOMPARE(o2.toVariantMap().firstKey().constData(), keys1.at(0).constData());
+    QCOMPARE(keys1.at(0).constData(), QStringAtom::intern(QStringLiteral("name")).constData());
+
+    // lookups are not affected
+    QCOMPARE(o2.value(QStringLiteral("name")).toInt(), 3);
+    QCOMPARE(o2.value(QString::fromUtf8("\xe2\x82\xac")).toInt(), 5);
+}
+
+void tst_QStringAtom::xmlStreamNames()
+{
+    const QString xml = QStringLiteral("<root><item id=\"1\" x:kind=\"a\" xmlns:x=\"urn:x\"/><item id=\"2\" x:kind=\"b\" xmlns:x=\"urn:x\"/></root>");
+
+    QStringAtom::setAutomaticInterning(QStringAtom::XmlStreamNames);
+
+    QXmlStreamReader reader(xml);
+    QStringList names;
+    QVector<QXmlStreamAttributes> attributes;
+    while (!reader.atEnd()) {
+        if (reader.readNext() == QXmlStreamReader::StartElement) {
+            names.append(reader.name().toString());
+            attributes.append(reader.attributes());
+        }
+    }
+    QVERIFY(!reader.hasError());
+
+    QCOMPARE(names, QStringList() << "root" << "item" << "item");
+    QCOMPARE(names.at(1).constData(), names.at(2).constData());
+    QCOMPARE(names.at(1).constData(), QStringAtom::intern(QStringLiteral("item")).constData());
+
+    QCOMPARE(attributes.size(), 3);
+    const QXmlStreamAttributes &a1 = attributes.at(1);
+    const QXmlStreamAttributes &a2 = attributes.at(2);
+    QCOMPARE(a1.size(), 2);
+    QCOMPARE(a2.size(), 2);
+    QCOMPARE(a1.value(QStringLiteral("id")).toString(), QStringLiteral("1"));
+    QCOMPARE(a2.value(QStringLiteral("urn:x"), QStringLiteral("kind")).toString(), QStringLiteral("b"));
+    for (int i = 0; i < 2; ++i) {
+        QCOMPARE(a1.at(i).name().toString().constData(), a2.at(i).name().toString().constData());
+        QCOMPARE(a1.at(i).qualifiedName().toString().constData(), a2.at(i).qualifiedName().toString().constData());
+    }
+    QCOMPARE(a1.at(1).qualifiedName().toString(), QStringLiteral("x:kind"));
+    QCOMPARE(a1.at(1).namespaceUri().toString(), QStringLiteral("urn:x"));
+}
+
+void tst_QStringAtom::settingsKeys()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.path() + QStringLiteral("/settings.ini");
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("[group]\nsomekey=1\nother=2\n");
+    }
+
+    QStringAtom::setAutomaticInterning(QStringAtom::SettingsKeys);
+
+    QSettings settings(fileName, QSettings::IniFormat);
+    QStringList keys = settings.allKeys();
+    keys.sort();
+    QCOMPARE(keys, QStringList() << "group/other" << "group/somekey");
+    QCOMPARE(settings.value(QStringLiteral("group/somekey")).toInt(), 1);
+    QCOMPARE(keys.at(1).constData(), QStringAtom::intern(QStringLiteral("group/somekey")).constData());
+}
+
+void tst_QStringAtom::automaticInterningLimit()
+{
+    const QByteArray json = "[{\"tst_QStringAtom::automaticInterningLimit\": 1},"
+                            " {\"tst_QStringAtom::automaticInterningLimit\": 2}]";
+    QJsonDocument doc = QJsonDocument::fromJson(json);
+    QJsonObject o1 = doc.array().at(0).toObject();
+    QJsonObject o2 = doc.array().at(1).toObject();
+
+    // once the table is full, the parsers no longer add strings to it
+    for (int n = 0; QStringAtom::count() < 64 * 1024; ++n)
+        QStringAtom(QStringLiteral("tst_QStringAtom::automaticInterningLimit ") + QString::number(n));
+
+    QStringAtom::setAutomaticInterning(QStringAtom::JsonObjectKeys);
+    const int count = QStringAtom::count();
+    QCOMPARE(o1.keys(), o2.keys());
+    QVERIFY(o1.keys().first().constData() != o2.keys().first().constData());
+    QCOMPARE(QStringAtom::count(), count);
+
+    // explicit interning is not limited
+    QStringAtom atom(QStringLiteral("tst_QStringAtom::automaticInterningLimit"));
+    QCOMPARE(QStringAtom::count(), count + 1);
+    QCOMPARE(QStringAtom(o1.keys().first()), atom);
+}
+
+QTEST_MAIN(tst_QStringAtom)
+
+#include "tst_qstringatom.moc"
@@ -8,6 +8,7 @@ SUBDIRS=\
     qbytearray \
     qbytearraylist \
     qbytearraymatcher \
+    qbytearrayview \
     qbytedatabuffer \
     qcache \
     qchar \
@@ -20,6 +21,7 @@ SUBDIRS=\
     qeasingcurve \
     qelapsedtimer \
     qexplicitlyshareddatapointer \
+    qflathash \
     qfreelist \
     qhash \
     qhash_strictiterators \
@@ -46,9 +48,11 @@ SUBDIRS=\
     qsharedpointer \
     qsize \
     qsizef \
+    qsmallbytearray \
     qstl \
     qstring \
     qstring_no_cast_from_bytearray \
+    qstringatom \
     qstringbuilder \
     qstringiterator \
     qstringlist \
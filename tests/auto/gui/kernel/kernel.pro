@@ -10,6 +10,7 @@ SUBDIRS=\
    qguimetatype \
    qguitimer \
    qguivariant \
+   qhighdpiscaling \
    qinputmethod \
    qkeysequence \
    qmouseevent \
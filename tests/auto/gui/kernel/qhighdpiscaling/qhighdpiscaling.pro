@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = tst_qhighdpiscaling
+
+QT += gui-private testlib
+
+SOURCES += tst_qhighdpiscaling.cpp
@@ -0,0 +1,286 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtGui/QWindow>
+#include <QtGui/qpa/qplatformwindow.h>
+#include <QtGui/qpa/qwindowsysteminterface.h>
+#include <QtGui/private/qhighdpiscaling_p.h>
+
+#include <QtTest/QtTest>
+
+class ResizeCountingWindow : public QWindow
+{
+public:
+    ResizeCountingWindow() : resizes(0) { }
+
+    int resizes;
+    QSize lastSize;
+
+protected:
+    void resizeEvent(QResizeEvent *event) Q_DECL_OVERRIDE
+    {
+        ++resizes;
+        lastSize = event->size();
+    }
+};
+
+class tst_QHighDpiScaling : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void windowFactor();
+    void windowFactorBeforeCreate();
+    void windowFactorChanged();
+    void windowFactorUnchanged();
+    void convertPoints_data();
+    void convertPoints();
+    void convertPolygons_data();
+    void convertPolygons();
+    void convertRegions_data();
+    void convertRegions();
+
+private:
+    void scaleFactors();
+};
+
+void tst_QHighDpiScaling::windowFactor()
+{
+    QWindow scaled;
+    QWindow unscaled;
+    QHighDpiScaling::setWindowFactor(&scaled, 2);
+
+    QVERIFY(QHighDpiScaling::isActive());
+    QCOMPARE(QHighDpiScaling::factor(&scaled), qreal(2));
+    QCOMPARE(QHighDpiScaling::factor(&unscaled), qreal(1));
+    QCOMPARE(QHighDpiScaling::factor(), qreal(1));
+
+    QCOMPARE(qHighDpiToDevicePixels(QRect(10, 20, 30, 40), &scaled), QRect(20, 40, 60, 80));
+    QCOMPARE(qHighDpiToDevicePixels(QRect(10, 20, 30, 40), &unscaled), QRect(10, 20, 30, 40));
+    QCOMPARE(qHighDpiToDeviceIndependentPixels(QPointF(20, 40), &scaled), QPointF(10, 20));
+}
+
+void tst_QHighDpiScaling::windowFactorBeforeCreate()
+{
+    QWindow window;
+    QHighDpiScaling::setWindowFactor(&window, 2);
+    window.create();
+    QVERIFY(window.handle());
+    window.setGeometry(10, 20, 100, 50);
+
+    QCOMPARE(window.handle()->geometry(), QRect(20, 40, 200, 100));
+    QCOMPARE(window.geometry(), QRect(10, 20, 100, 50));
+}
+
+// Changing the factor of a created window has to re-deliver its
+// geometry, scaled by the new factor.
+void tst_QHighDpiScaling::windowFactorChanged()
+{
+    ResizeCountingWindow window;
+    window.setGeometry(0, 0, 400, 200);
+    window.create();
+    QVERIFY(window.handle());
+    QCoreApplication::processEvents();
+    const QRect nativeGeometry = window.handle()->geometry();
+
+    QHighDpiScaling::setWindowFactor(&window, 2);
+    QWindowSystemInterface::flushWindowSystemEvents();
+    QCOMPARE(QHighDpiScaling::factor(&window), qreal(2));
+    QCOMPARE(window.handle()->geometry(), nativeGeometry);
+    QCOMPARE(window.geometry().size(), QSize(200, 100));
+    QCOMPARE(window.lastSize, QSize(200, 100));
+
+    const int resizes = window.resizes;
+    QHighDpiScaling::setWindowFactor(&window, 4);
+    QWindowSystemInterface::flushWindowSystemEvents();
+    QCOMPARE(QHighDpiScaling::factor(&window), qreal(4));
+    QCOMPARE(window.geometry().size(), QSize(100, 50));
+    QCOMPARE(window.resizes, resizes + 1);
+    QCOMPARE(window.lastSize, QSize(100, 50));
+
+    QHighDpiScaling::setWindowFactor(&window, 1);
+    QWindowSystemInterface::flushWindowSystemEvents();
+    QCOMPARE(QHighDpiScaling::factor(&window), qreal(1));
+    QCOMPARE(window.geometry().size(), QSize(400, 200));
+    QCOMPARE(window.lastSize, QSize(400, 200));
+}
+
+void tst_QHighDpiScaling::windowFactorUnchanged()
+{
+    ResizeCountingWindow window;
+    window.setGeometry(0, 0, 400, 200);
+    window.create();
+    QHighDpiScaling::setWindowFactor(&window, 2);
+    QWindowSystemInterface::flushWindowSystemEvents();
+
+    const int resizes = window.resizes;
+    QHighDpiScaling::setWindowFactor(&window, 2);
+    QWindowSystemInterface::flushWindowSystemEvents();
+    QCOMPARE(window.resizes, resizes);
+    QCOMPARE(window.geometry().size(), QSize(200, 100));
+}
+
+// The batch conversions of vectors, polygons and regions have to give
+// the same results as converting the elements one by one, including the
+// rounding of odd coordinates and sizes.
+
+void tst_QHighDpiScaling::scaleFactors()
+{
+    QTest::addColumn<qreal>("factor");
+
+    QTest::newRow("1.5") << qreal(1.5);
+    QTest::newRow("2") << qreal(2);
+    QTest::newRow("3") << qreal(3);
+}
+
+void tst_QHighDpiScaling::convertPoints_data()
+{
+    scaleFactors();
+}
+
+void tst_QHighDpiScaling::convertPoints()
+{
+    QFETCH(qreal, factor);
+    QWindow window;
+    QHighDpiScaling::setWindowFactor(&window, factor);
+
+    QVector<QPoint> points;
+    QVector<QPointF> pointsF;
+    for (int i = -7; i < 25; ++i) {
+        points.append(QPoint(i, 3 * i + 1));
+        pointsF.append(QPointF(i + 0.25, 3 * i + 0.5));
+    }
+
+    const QVector<QPoint> pixelPoints = qHighDpiToDevicePixels(points, &window);
+    const QVector<QPoint> pointPoints = qHighDpiToDeviceIndependentPixels(points, &window);
+    const QVector<QPointF> pixelPointsF = qHighDpiToDevicePixels(pointsF, &window);
+    const QVector<QPointF> pointPointsF = qHighDpiToDeviceIndependentPixels(pointsF, &window);
+    QCOMPARE(pixelPoints.size(), points.size());
+    QCOMPARE(pointPoints.size(), points.size());
+    QCOMPARE(pixelPointsF.size(), pointsF.size());
+    QCOMPARE(pointPointsF.size(), pointsF.size());
+
+    for (int i = 0; i < points.size(); ++i) {
+        QCOMPARE(pixelPoints.at(i), qHighDpiToDevicePixels(points.at(i), &window));
+        QCOMPARE(pointPoints.at(i), qHighDpiToDeviceIndependentPixels(points.at(i), &window));
+        QCOMPARE(pixelPointsF.at(i), qHighDpiToDevicePixels(pointsF.at(i), &window));
+        QCOMPARE(pointPointsF.at(i), qHighDpiToDeviceIndependentPixels(pointsF.at(i), &window));
+    }
+}
+
+void tst_QHighDpiScaling::convertPolygons_data()
+{
+    scaleFactors();
+}
+
+void tst_QHighDpiScaling::convertPolygons()
+{
+    QFETCH(qreal, factor);
+    QWindow window;
+    QHighDpiScaling::setWindowFactor(&window, factor);
+
+    QPolygon polygon;
+    polygon << QPoint(1, 1) << QPoint(101, 3) << QPoint(55, 77) << QPoint(-9, 41);
+    QPolygonF polygonF(polygon);
+    polygonF << QPointF(0.5, 0.75);
+
+    const QPolygon pixelPolygon = qHighDpiToDevicePixels(polygon, &window);
+    const QPolygon pointPolygon = qHighDpiToDeviceIndependentPixels(polygon, &window);
+    const QPolygonF pixelPolygonF = qHighDpiToDevicePixels(polygonF, &window);
+    const QPolygonF pointPolygonF = qHighDpiToDeviceIndependentPixels(polygonF, &window);
+    QCOMPARE(pixelPolygon.size(), polygon.size());
+    QCOMPARE(pointPolygon.size(), polygon.size());
+    QCOMPARE(pixelPolygonF.size(), polygonF.size());
+    QCOMPARE(pointPolygonF.size(), polygonF.size());
+
+    for (int i = 0; i < polygon.size(); ++i) {
+        QCOMPARE(pixelPolygon.at(i), qHighDpiToDevicePixels(polygon.at(i), &window));
+        QCOMPARE(pointPolygon.at(i), qHighDpiToDeviceIndependentPixels(polygon.at(i), &window));
+    }
+    for (int i = 0; i < polygonF.size(); ++i) {
+        QCOMPARE(pixelPolygonF.at(i), qHighDpiToDevicePixels(polygonF.at(i), &window));
+        QCOMPARE(pointPolygonF.at(i), qHighDpiToDeviceIndependentPixels(polygonF.at(i), &window));
+    }
+}
+
+void tst_QHighDpiScaling::convertRegions_data()
+{
+    QTest::addColumn<qreal>("factor");
+    QTest::addColumn<QRegion>("region");
+
+    // rects aligned to multiples of 6 divide exactly by all factors
+    QRegion aligned;
+    QRegion odd;
+    for (int i = 0; i < 8; ++i) {
+        aligned += QRect(i * 36, (i % 3) * 48, 24, 12);
+        odd += QRect(i * 37 + 1, (i % 3) * 45 + 3, 23, 11 + i);
+    }
+    QVERIFY(aligned.rectCount() > 1);
+    QVERIFY(odd.rectCount() > 1);
+
+    const qreal factors[] = { 1.5, 2, 3 };
+    for (size_t i = 0; i < sizeof(factors) / sizeof(factors[0]); ++i) {
+        const QByteArray factor = QByteArray::number(factors[i]);
+        QTest::newRow(factor + " empty") << factors[i] << QRegion();
+        QTest::newRow(factor + " one rect") << factors[i] << QRegion(3, 5, 7, 9);
+        QTest::newRow(factor + " aligned") << factors[i] << aligned;
+        QTest::newRow(factor + " odd") << factors[i] << odd;
+    }
+}
+
+void tst_QHighDpiScaling::convertRegions()
+{
+    QFETCH(qreal, factor);
+    QFETCH(QRegion, region);
+    QWindow window;
+    QHighDpiScaling::setWindowFactor(&window, factor);
+
+    QRegion expectedPixelRegion;
+    QRegion expectedPointRegion;
+    foreach (const QRect &rect, region.rects()) {
+        expectedPixelRegion += qHighDpiToDevicePixels(rect, &window);
+        expectedPointRegion += qHighDpiToDeviceIndependentPixels(rect, &window);
+    }
+
+    const QRegion pixelRegion = qHighDpiToDevicePixels(region, &window);
+    const QRegion pointRegion = qHighDpiToDeviceIndependentPixels(region, &window);
+    QCOMPARE(pixelRegion, expectedPixelRegion);
+    QCOMPARE(pixelRegion.boundingRect(), expectedPixelRegion.boundingRect());
+    QCOMPARE(pixelRegion.rects(), expectedPixelRegion.rects());
+    QCOMPARE(pointRegion, expectedPointRegion);
+    QCOMPARE(pointRegion.boundingRect(), expectedPointRegion.boundingRect());
+    QCOMPARE(pointRegion.rects(), expectedPointRegion.rects());
+}
+
+QTEST_MAIN(tst_QHighDpiScaling)
+#include "tst_qhighdpiscaling.moc"
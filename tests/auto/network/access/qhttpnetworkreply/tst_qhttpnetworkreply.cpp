@@ -46,6 +46,7 @@ private Q_SLOTS:
 
     void parseHeader_data();
     void parseHeader();
+    void headerFields();
 };
 
 
@@ -122,5 +123,25 @@ void tst_QHttpNetworkReply::parseHeader()
     }
 }
 
+void tst_QHttpNetworkReply::headerFields()
+{
+    typedef QPair<QByteArray, QByteArray> Field;
+    QHttpNetworkReply reply;
+    reply.parseHeader("Content-Type: text/html\r\n"
+                      "Content-Length: 1024\r\n"
+                      "Vary: Cookie,\r\n User-Agent\r\n");
+    QCOMPARE(reply.contentLength(), qint64(1024));
+    reply.setHeaderField("content-length", "10");
+    reply.parseHeader("Content-Encoding: gzip\r\n");
+
+    const QList<Field> fields = reply.header();
+    QCOMPARE(fields.size(), 4);
+    QCOMPARE(fields.at(0), Field("Content-Type", "text/html"));
+    QCOMPARE(fields.at(1), Field("Vary", "Cookie, User-Agent"));
+    QCOMPARE(fields.at(2), Field("content-length", "10"));
+    QCOMPARE(fields.at(3), Field("Content-Encoding", "gzip"));
+    QCOMPARE(reply.contentLength(), qint64(10));
+}
+
 QTEST_MAIN(tst_QHttpNetworkReply)
 #include "tst_qhttpnetworkreply.moc"
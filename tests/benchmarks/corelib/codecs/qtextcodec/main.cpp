@@ -32,6 +32,7 @@
 ****************************************************************************/
 #include <QTextCodec>
 #include <QFile>
+#include <QVarLengthArray>
 #include <qtest.h>
 
 Q_DECLARE_METATYPE(QTextCodec *)
@@ -47,6 +48,8 @@ private slots:
     void fromUnicode() const;
     void toUnicode_data() const;
     void toUnicode() const;
+    void decodeStream_data() const;
+    void decodeStream() const;
 };
 
 void tst_QTextCodec::codecForName() const
@@ -167,7 +170,63 @@ void tst_QTextCodec::toUnicode() const
 }
 
 
+enum DecodeMethod { ReturnString, AppendToString, FixedBuffer };
+Q_DECLARE_METATYPE(DecodeMethod)
 
+void tst_QTextCodec::decodeStream_data() const
+{
+    QTest::addColumn<DecodeMethod>("method");
+
+    QTest::newRow("toUnicode()") << ReturnString;
+    QTest::newRow("appendToUnicode()") << AppendToString;
+    QTest::newRow("toUnicode(buffer)") << FixedBuffer;
+}
+
+// decodes 64 MB of mostly ASCII text in 16 kB chunks, like a log reader would
+void tst_QTextCodec::decodeStream() const
+{
+    QFETCH(DecodeMethod, method);
+
+    QString testFile = QFINDTESTDATA("utf-8.txt");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file utf-8.txt!");
+    QFile file(testFile);
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray sample = file.readAll();
+
+    QByteArray line = "2015-06-01 12:00:00 INFO [worker] request handled in 12 ms, path=/index.html\n";
+    QByteArray data;
+    data.reserve(64 << 20);
+    for (int i = 0; data.size() < (64 << 20); ++i)
+        data += (i % 64) ? line : sample;
+
+    enum { ChunkSize = 16384 };
+    QTextCodec *codec = QTextCodec::codecForMib(106);
+    qint64 total = 0;
+    QBENCHMARK {
+        QTextDecoder decoder(codec);
+        QString target;
+        QVarLengthArray<QChar, ChunkSize + 1> buffer(ChunkSize + 1);
+        for (int pos = 0; pos < data.size(); pos += ChunkSize) {
+            const int len = qMin<int>(ChunkSize, data.size() - pos);
+            switch (method) {
+            case ReturnString:
+                total += decoder.toUnicode(data.constData() + pos, len).size();
+                break;
+            case AppendToString:
+                target.resize(0);
+                decoder.appendToUnicode(&target, data.constData() + pos, len);
+                total += target.size();
+                break;
+            case FixedBuffer: {
+                int bytesRead;
+                total += decoder.toUnicode(buffer.data(), buffer.size(), data.constData() + pos, len, &bytesRead);
+                break;
+            }
+            }
+        }
+    }
+    QVERIFY(total > 0);
+}
 
 QTEST_MAIN(tst_QTextCodec)
 
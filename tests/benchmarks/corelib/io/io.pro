@@ -6,6 +6,7 @@ SUBDIRS = \
         qfileinfo \
         qiodevice \
         qprocess \
+        qsettings \
         qtemporaryfile \
         qtextstream
 
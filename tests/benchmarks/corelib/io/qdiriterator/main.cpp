@@ -45,6 +45,7 @@
 #endif
 
 #include <qtest.h>
+#include <QTemporaryDir>
 
 #include "qfilesystemiterator.h"
 
@@ -59,8 +60,74 @@ private slots:
     void fsiterator();
     void fsiterator_data() { data(); }
     void data();
+
+    void initTestCase();
+    void tree_data();
+    void tree();
+
+private:
+    QTemporaryDir treeDir;
 };
 
+// A synthetic tree like a source checkout: 5 levels of 4 subdirectories
+// with 24 files each, 32760 files in 1365 directories.
+static void createTree(const QString &path, int depth)
+{
+    QDir dir(path);
+    for (int i = 0; i < 24; ++i) {
+        QFile file(path + QString::fromLatin1("/file%1.cpp").arg(i));
+        file.open(QIODevice::WriteOnly);
+    }
+    if (depth == 0)
+        return;
+    for (int i = 0; i < 4; ++i) {
+        const QString name = QString::fromLatin1("dir%1").arg(i);
+        dir.mkdir(name);
+        createTree(path + QLatin1Char('/') + name, depth - 1);
+    }
+}
+
+void tst_qdiriterator::initTestCase()
+{
+    QVERIFY(treeDir.isValid());
+    createTree(treeDir.path(), 5);
+}
+
+void tst_qdiriterator::tree_data()
+{
+    QTest::addColumn<int>("filters");
+    QTest::addColumn<int>("flags");
+    QTest::addColumn<int>("expected");
+
+    const int sequential = QDirIterator::Subdirectories;
+    const int parallel = QDirIterator::Subdirectories | QDirIterator::ParallelTraversal;
+    const int files = QDir::Files;
+    const int all = QDir::AllEntries | QDir::NoDotAndDotDot;
+    QTest::newRow("files-sequential") << files << sequential << 32760;
+    QTest::newRow("files-parallel") << files << parallel << 32760;
+    QTest::newRow("all-sequential") << all << sequential << 32760 + 1364;
+    QTest::newRow("all-parallel") << all << parallel << 32760 + 1364;
+}
+
+void tst_qdiriterator::tree()
+{
+    QFETCH(int, filters);
+    QFETCH(int, flags);
+    QFETCH(int, expected);
+
+    int count = 0;
+    QBENCHMARK {
+        int c = 0;
+        QDirIterator dir(treeDir.path(), QDir::Filters(filters), QDirIterator::IteratorFlags(flags));
+        while (dir.hasNext()) {
+            dir.next();
+            ++c;
+        }
+        count = c;
+    }
+    QCOMPARE(count, expected);
+}
+
 
 void tst_qdiriterator::data()
 {
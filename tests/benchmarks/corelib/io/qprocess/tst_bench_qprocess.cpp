@@ -33,6 +33,7 @@
 
 #include <QtTest/QtTest>
 #include <QtCore/QProcess>
+#include <QtCore/QProcessPool>
 
 class tst_QProcess : public QObject
 {
@@ -42,6 +43,10 @@ class tst_QProcess : public QObject
 private slots:
 
     void echoTest_performance();
+    void startLatency_data();
+    void startLatency();
+    void batch_data();
+    void batch();
 
 #endif // QT_NO_PROCESS
 };
@@ -93,6 +98,93 @@ void tst_QProcess::echoTest_performance()
     QVERIFY(process.waitForFinished());
 }
 
+void tst_QProcess::startLatency_data()
+{
+    QTest::addColumn<int>("residentMegabytes");
+    QTest::addColumn<bool>("spawn");
+
+    static const int sizes[] = { 0, 256, 1024, 4096 };
+    for (size_t i = 0; i < sizeof sizes / sizeof *sizes; ++i) {
+        const QByteArray name = QByteArray::number(sizes[i]) + " MB";
+        QTest::newRow(name + ", fork") << sizes[i] << false;
+#if defined(Q_OS_UNIX) && !defined(Q_OS_QNX)
+        QTest::newRow(name + ", posix_spawn") << sizes[i] << true;
+#endif
+    }
+}
+
+void tst_QProcess::startLatency()
+{
+    QFETCH(int, residentMegabytes);
+    QFETCH(bool, spawn);
+
+    // Make the parent big: fork() has to copy the page tables for all of it.
+    const size_t size = size_t(residentMegabytes) << 20;
+    QScopedPointer<char, QScopedPointerPodDeleter> resident(static_cast<char *>(malloc(size)));
+    if (size && !resident)
+        QSKIP("Not enough memory for a parent of this size");
+    for (size_t i = 0; i < size; i += 4096)
+        resident.data()[i] = char(i);
+
+    QProcess process;
+    process.setChildProcessSetupEnabled(!spawn);
+    QBENCHMARK {
+        process.start("testProcessLoopback/testProcessLoopback");
+        QVERIFY2(process.waitForStarted(), qPrintable(process.errorString()));
+        process.closeWriteChannel();
+        QVERIFY(process.waitForFinished());
+    }
+}
+
+void tst_QProcess::batch_data()
+{
+    QTest::addColumn<bool>("pool");
+    QTest::addColumn<int>("concurrency");
+
+    QTest::newRow("QProcess, sequential") << false << 1;
+    QTest::newRow("QProcess, 4 at a time") << false << 4;
+    QTest::newRow("QProcessPool, 1 at a time") << true << 1;
+    QTest::newRow("QProcessPool, 4 at a time") << true << 4;
+}
+
+void tst_QProcess::batch()
+{
+    QFETCH(bool, pool);
+    QFETCH(int, concurrency);
+
+    // The loopback helper exits as soon as its standard input is closed,
+    // so this measures the cost of starting and reaping the commands.
+    const int count = 1000;
+    const QString program = QStringLiteral("testProcessLoopback/testProcessLoopback");
+    QElapsedTimer timer;
+    timer.start();
+    QBENCHMARK_ONCE {
+        if (pool) {
+            QProcessPool processPool;
+            processPool.setMaximumConcurrency(concurrency);
+            for (int i = 0; i < count; ++i)
+                processPool.start(program);
+            QVERIFY(processPool.waitForFinished());
+        } else {
+            QVector<QProcess *> processes(concurrency);
+            for (int i = 0; i < concurrency; ++i)
+                processes[i] = new QProcess;
+            for (int i = 0; i < count; i += concurrency) {
+                for (int j = 0; j < concurrency; ++j) {
+                    processes[j]->start(program);
+                    processes[j]->closeWriteChannel();
+                }
+                for (int j = 0; j < concurrency; ++j) {
+                    QVERIFY(processes[j]->waitForFinished());
+                    processes[j]->readAllStandardOutput();
+                }
+            }
+            qDeleteAll(processes);
+        }
+    }
+    qDebug() << "throughput:" << count * 1000.0 / qMax<qint64>(1, timer.elapsed()) << "commands/s";
+}
+
 #endif // QT_NO_PROCESS && Q_OS_WINCE
 
 QTEST_MAIN(tst_QProcess)
@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tst_bench_qsettings
+
+QT = core testlib
+
+CONFIG += release
+
+SOURCES += tst_qsettings.cpp
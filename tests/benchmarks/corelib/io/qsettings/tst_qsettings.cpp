@@ -0,0 +1,171 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QSettings>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+Q_DECLARE_METATYPE(QSettings::Format)
+
+class tst_QSettings : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void open_data() { formats(); }
+    void open();
+    void readAll_data() { formats(); }
+    void readAll();
+    void sync_data() { formats(); }
+    void sync();
+
+private:
+    void formats();
+    QString freshCopy(QSettings::Format format);
+
+    QTemporaryDir dir;
+    QString templates[3];
+    int copies;
+};
+
+enum { KeyCount = 20000, Runs = 5 };
+
+static QString keyName(int i)
+{
+    return QString::fromLatin1("section%1/key%2").arg(i % 100).arg(i);
+}
+
+void tst_QSettings::formats()
+{
+    QTest::addColumn<QSettings::Format>("format");
+    QTest::newRow("ini") << QSettings::IniFormat;
+    QTest::newRow("binary") << QSettings::BinaryFormat;
+}
+
+void tst_QSettings::initTestCase()
+{
+    QVERIFY(dir.isValid());
+    copies = 0;
+
+    const QSettings::Format formats[] = { QSettings::IniFormat, QSettings::BinaryFormat };
+    for (int f = 0; f < 2; ++f) {
+        const QSettings::Format format = formats[f];
+        QSettings settings(dir.path() + QString::fromLatin1("/template%1").arg(f), format);
+        for (int i = 0; i < KeyCount; ++i)
+            settings.setValue(keyName(i), QString::fromLatin1("value number %1").arg(i));
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+        templates[format] = settings.fileName();
+    }
+}
+
+// QSettings keeps the files it has read, so every run opens a file of its own
+QString tst_QSettings::freshCopy(QSettings::Format format)
+{
+    const QString fileName = dir.path() + QString::fromLatin1("/copy%1").arg(++copies);
+    if (!QFile::copy(templates[format], fileName))
+        return QString();
+    return fileName;
+}
+
+/*
+    The time it takes until the first value can be read.
+*/
+void tst_QSettings::open()
+{
+    QFETCH(QSettings::Format, format);
+
+    qint64 best = Q_INT64_C(0x7fffffffffffffff);
+    for (int run = 0; run < Runs; ++run) {
+        const QString fileName = freshCopy(format);
+        QVERIFY(!fileName.isEmpty());
+
+        QElapsedTimer timer;
+        timer.start();
+        QSettings settings(fileName, format);
+        const QVariant value = settings.value(keyName(KeyCount / 2));
+        best = qMin(best, timer.nsecsElapsed());
+        QCOMPARE(value.toString(), QString::fromLatin1("value number %1").arg(KeyCount / 2));
+    }
+    QTest::setBenchmarkResult(best / 1000000.0, QTest::WalltimeMilliseconds);
+}
+
+void tst_QSettings::readAll()
+{
+    QFETCH(QSettings::Format, format);
+
+    qint64 best = Q_INT64_C(0x7fffffffffffffff);
+    for (int run = 0; run < Runs; ++run) {
+        const QString fileName = freshCopy(format);
+        QVERIFY(!fileName.isEmpty());
+
+        QElapsedTimer timer;
+        timer.start();
+        QSettings settings(fileName, format);
+        const QStringList keys = settings.allKeys();
+        foreach (const QString &key, keys)
+            settings.value(key);
+        best = qMin(best, timer.nsecsElapsed());
+        QCOMPARE(keys.size(), int(KeyCount));
+    }
+    QTest::setBenchmarkResult(best / 1000000.0, QTest::WalltimeMilliseconds);
+}
+
+/*
+    Changing a single value and writing it to disk.
+*/
+void tst_QSettings::sync()
+{
+    QFETCH(QSettings::Format, format);
+
+    const QString fileName = freshCopy(format);
+    QVERIFY(!fileName.isEmpty());
+    QSettings settings(fileName, format);
+    settings.value(keyName(0));
+
+    int i = 0;
+    QBENCHMARK {
+        settings.setValue(keyName(i % KeyCount), i);
+        settings.sync();
+        ++i;
+    }
+    QCOMPARE(settings.status(), QSettings::NoError);
+}
+
+QTEST_MAIN(tst_QSettings)
+
+#include "tst_qsettings.moc"
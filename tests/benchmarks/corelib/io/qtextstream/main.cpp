@@ -51,6 +51,7 @@ class tst_qtextstream : public QObject
 private slots:
     void writeSingleChar_data();
     void writeSingleChar();
+    void readLines();
 
 private:
 };
@@ -128,6 +129,27 @@ void tst_qtextstream::writeSingleChar()
     QCOMPARE(result.left(10), QString("hhhhhhhhhh"));
 }
 
+// reads 64 MB of UTF-8 log lines from a device
+void tst_qtextstream::readLines()
+{
+    const QByteArray line = "2015-06-01 12:00:00 INFO [worker] r\xc3\xa9ponse en 12 ms, path=/index.html\n";
+    QByteArray data;
+    data.reserve(64 << 20);
+    while (data.size() < (64 << 20))
+        data += line;
+
+    qint64 total = 0;
+    QBENCHMARK {
+        QBuffer buffer(&data);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        QTextStream stream(&buffer);
+        stream.setCodec("UTF-8");
+        while (!stream.atEnd())
+            total += stream.readLine().size();
+    }
+    QVERIFY(total > 0);
+}
+
 QTEST_MAIN(tst_qtextstream)
 
 #include "main.moc"
@@ -34,6 +34,79 @@
 #include <QtTest>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qjsonarray.h>
+#include <qjsonstream.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+
+// track the heap memory in use while tracking is enabled
+static bool memoryTracking = false;
+static qint64 memoryInUse = 0;
+static qint64 memoryPeak = 0;
+
+static inline void trackAllocation(void *ptr)
+{
+    if (memoryTracking && ptr) {
+        memoryInUse += malloc_usable_size(ptr);
+        memoryPeak = qMax(memoryPeak, memoryInUse);
+    }
+}
+
+static inline void trackFree(void *ptr)
+{
+    if (memoryTracking && ptr)
+        memoryInUse -= malloc_usable_size(ptr);
+}
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size)
+{
+    void *ptr = __libc_malloc(size);
+    trackAllocation(ptr);
+    return ptr;
+}
+
+void *calloc(size_t count, size_t size)
+{
+    void *ptr = __libc_calloc(count, size);
+    trackAllocation(ptr);
+    return ptr;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    trackFree(ptr);
+    ptr = __libc_realloc(ptr, size);
+    trackAllocation(ptr);
+    return ptr;
+}
+
+void free(void *ptr)
+{
+    trackFree(ptr);
+    __libc_free(ptr);
+}
+}
+#endif
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+
+static qint64 residentSetSize()
+{
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (!statm.open(QFile::ReadOnly))
+        return 0;
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.size() > 1 ? fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE) : 0;
+}
+#endif
 
 class BenchmarkQtBinaryJson: public QObject
 {
@@ -56,6 +129,28 @@ private Q_SLOTS:
 
     void jsonObjectInsert();
     void variantMapInsert();
+
+    void readLargeFile_data();
+    void readLargeFile();
+    void readLargeFileMemory_data();
+    void readLargeFileMemory();
+    void writeLargeFile_data();
+    void writeLargeFile();
+
+    void openBinaryFile_data();
+    void openBinaryFile();
+    void openBinaryFileMemory_data();
+    void openBinaryFileMemory();
+
+    void parseCorpus_data();
+    void parseCorpus();
+
+private:
+    void readLargeFile(bool streaming);
+    QJsonDocument openBinaryFile(bool mapped);
+    QTemporaryFile largeFile;
+    QTemporaryFile largeBinaryFile;
+    QJsonArray largeArray;
 };
 
 BenchmarkQtBinaryJson::BenchmarkQtBinaryJson(QObject *parent) : QObject(parent)
@@ -65,7 +160,24 @@ BenchmarkQtBinaryJson::BenchmarkQtBinaryJson(QObject *parent) : QObject(parent)
 
 void BenchmarkQtBinaryJson::initTestCase()
 {
-
+    // a log of about 16 MB, one array of records
+    for (int i = 0; i < 100000; ++i) {
+        QJsonObject record;
+        record.insert("id", i);
+        record.insert("timestamp", QStringLiteral("2014-10-18T12:00:00.%1Z").arg(i % 1000, 3, 10, QLatin1Char('0')));
+        record.insert("level", i % 7 ? QStringLiteral("info") : QStringLiteral("warning"));
+        record.insert("message", QStringLiteral("request handled in %1 ms").arg(i % 97));
+        record.insert("duration", (i % 9973) / 7.0);
+        record.insert("success", i % 13 != 0);
+        record.insert("tags", QJsonArray() << QStringLiteral("http") << QStringLiteral("frontend") << i % 5);
+        largeArray.append(record);
+    }
+    QVERIFY(largeFile.open());
+    largeFile.write(QJsonDocument(largeArray).toJson());
+    largeFile.close();
+    QVERIFY(largeBinaryFile.open());
+    largeBinaryFile.write(QJsonDocument(largeArray).toBinaryData());
+    largeBinaryFile.close();
 }
 
 void BenchmarkQtBinaryJson::cleanupTestCase()
@@ -179,6 +291,202 @@ void BenchmarkQtBinaryJson::variantMapInsert()
     }
 }
 
+void BenchmarkQtBinaryJson::readLargeFile_data()
+{
+    QTest::addColumn<bool>("streaming");
+    QTest::newRow("fromJson") << false;
+    QTest::newRow("QJsonStreamReader") << true;
+}
+
+// reads the large file and sums up one member of each record
+void BenchmarkQtBinaryJson::readLargeFile(bool streaming)
+{
+    QFile file(largeFile.fileName());
+    QVERIFY(file.open(QFile::ReadOnly));
+    double sum = 0;
+    if (streaming) {
+        QJsonStreamReader reader(&file);
+        while (!reader.atEnd()) {
+            if (reader.readNext() == QJsonStreamReader::Double && reader.depth() == 2
+                    && reader.name() == QLatin1String("duration")) {
+                sum += reader.doubleValue();
+            }
+        }
+        QVERIFY(!reader.hasError());
+    } else {
+        const QJsonArray array = QJsonDocument::fromJson(file.readAll()).array();
+        for (QJsonArray::const_iterator it = array.begin(); it != array.end(); ++it)
+            sum += (*it).toObject().value(QLatin1String("duration")).toDouble();
+    }
+    QVERIFY(sum > 0);
+}
+
+void BenchmarkQtBinaryJson::readLargeFile()
+{
+    QFETCH(bool, streaming);
+    QBENCHMARK {
+        readLargeFile(streaming);
+    }
+}
+
+void BenchmarkQtBinaryJson::readLargeFileMemory_data()
+{
+    readLargeFile_data();
+}
+
+void BenchmarkQtBinaryJson::readLargeFileMemory()
+{
+#if !defined(__GLIBC__)
+    QSKIP("Tracking memory is only implemented for glibc");
+#else
+    QFETCH(bool, streaming);
+    memoryInUse = 0;
+    memoryPeak = 0;
+    memoryTracking = true;
+    readLargeFile(streaming);
+    memoryTracking = false;
+    QTest::setBenchmarkResult(memoryPeak, QTest::BytesAllocated);
+#endif
+}
+
+void BenchmarkQtBinaryJson::writeLargeFile_data()
+{
+    QTest::addColumn<bool>("streaming");
+    QTest::newRow("toJson") << false;
+    QTest::newRow("QJsonStreamWriter") << true;
+}
+
+void BenchmarkQtBinaryJson::writeLargeFile()
+{
+    QFETCH(bool, streaming);
+    QTemporaryFile output;
+    QVERIFY(output.open());
+    QBENCHMARK {
+        output.resize(0);
+        output.seek(0);
+        if (streaming) {
+            QJsonStreamWriter writer(&output);
+            writer.writeStartArray();
+            for (QJsonArray::const_iterator it = largeArray.begin(); it != largeArray.end(); ++it)
+                writer.writeValue(*it);
+            writer.writeEndDocument();
+        } else {
+            output.write(QJsonDocument(largeArray).toJson());
+        }
+    }
+}
+
+void BenchmarkQtBinaryJson::openBinaryFile_data()
+{
+    QTest::addColumn<bool>("mapped");
+    QTest::newRow("fromBinaryData") << false;
+    QTest::newRow("fromMappedFile") << true;
+}
+
+// opens the large file in binary format and looks at one record
+QJsonDocument BenchmarkQtBinaryJson::openBinaryFile(bool mapped)
+{
+    QJsonDocument doc;
+    if (mapped) {
+        doc = QJsonDocument::fromMappedFile(largeBinaryFile.fileName());
+    } else {
+        QFile file(largeBinaryFile.fileName());
+        if (file.open(QFile::ReadOnly))
+            doc = QJsonDocument::fromBinaryData(file.readAll());
+    }
+    const QJsonArray array = doc.array();
+    if (array.at(array.size() / 2).toObject().value(QLatin1String("id")).toInt() != array.size() / 2)
+        return QJsonDocument();
+    return doc;
+}
+
+void BenchmarkQtBinaryJson::openBinaryFile()
+{
+    QFETCH(bool, mapped);
+    QBENCHMARK {
+        QVERIFY(!openBinaryFile(mapped).isNull());
+    }
+}
+
+void BenchmarkQtBinaryJson::openBinaryFileMemory_data()
+{
+    openBinaryFile_data();
+}
+
+// the growth of the resident set while the document is open
+void BenchmarkQtBinaryJson::openBinaryFileMemory()
+{
+#if !defined(Q_OS_LINUX)
+    QSKIP("Measuring the resident set size is only implemented for Linux");
+#else
+    QFETCH(bool, mapped);
+    const qint64 before = residentSetSize();
+    QJsonDocument doc = openBinaryFile(mapped);
+    QVERIFY(!doc.isNull());
+    QTest::setBenchmarkResult(residentSetSize() - before, QTest::BytesAllocated);
+#endif
+}
+
+// typical payloads of web APIs, a few MB each
+static QByteArray apiResponse(QJsonDocument::JsonFormat format, bool unicode)
+{
+    const QString text = unicode
+            ? QString::fromUtf8("Qt est un framework d\xc3\xa9velopp\xc3\xa9 en C++, \xe2\x80\x9c" "cross-platform\xe2\x80\x9d, "
+                                "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e \xd0\xbf\xd1\x80\xd0\xb8\xd0\xbc\xd0\xb5\xd1\x80 ")
+            : QStringLiteral("Qt is a cross-platform application framework that is widely used for developing "
+                             "application software that can be run on various platforms. ");
+    QJsonArray items;
+    for (int i = 0; i < 20000; ++i) {
+        QJsonObject user;
+        user.insert("login", QStringLiteral("user%1").arg(i));
+        user.insert("id", 1000000 + i);
+        user.insert("avatar_url", QStringLiteral("https://avatars.example.com/u/%1?v=3").arg(i));
+        user.insert("site_admin", false);
+
+        QJsonObject item;
+        item.insert("id", i);
+        item.insert("title", QStringLiteral("Issue number %1 reported").arg(i));
+        item.insert("user", user);
+        item.insert("labels", QJsonArray() << QStringLiteral("bug") << QStringLiteral("help wanted"));
+        item.insert("state", i % 3 ? QStringLiteral("open") : QStringLiteral("closed"));
+        item.insert("comments", i % 17);
+        item.insert("created_at", QStringLiteral("2014-10-18T12:34:56Z"));
+        item.insert("score", i / 3.0);
+        item.insert("body", text.repeated(1 + i % 4) + QStringLiteral("\\n\"quoted\""));
+        items.append(item);
+    }
+    QJsonObject response;
+    response.insert("total_count", items.size());
+    response.insert("incomplete_results", false);
+    response.insert("items", items);
+    return QJsonDocument(response).toJson(format);
+}
+
+void BenchmarkQtBinaryJson::parseCorpus_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("indented") << apiResponse(QJsonDocument::Indented, false);
+    QTest::newRow("compact") << apiResponse(QJsonDocument::Compact, false);
+    QTest::newRow("indented-unicode") << apiResponse(QJsonDocument::Indented, true);
+    QTest::newRow("compact-unicode") << apiResponse(QJsonDocument::Compact, true);
+
+    QString testFile = QFINDTESTDATA("numbers.json");
+    QFile file(testFile);
+    QVERIFY(file.open(QFile::ReadOnly));
+    QTest::newRow("numbers") << file.readAll();
+}
+
+void BenchmarkQtBinaryJson::parseCorpus()
+{
+    QFETCH(QByteArray, json);
+    QBENCHMARK {
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+        QVERIFY(error.error == QJsonParseError::NoError);
+    }
+}
+
 QTEST_MAIN(BenchmarkQtBinaryJson)
 #include "tst_bench_qtbinaryjson.moc"
 
@@ -7,6 +7,8 @@ SUBDIRS = \
         qvariant \
         qcoreapplication
 
+unix:!nacl: SUBDIRS += qeventdispatcher
+
 !qtHaveModule(widgets): SUBDIRS -= \
     qmetaobject \
     qobject
@@ -34,12 +34,47 @@
 #include <qtest.h>
 #include <qcoreapplication.h>
 
+#if defined(__GLIBC__)
+// count the allocations done by all threads while counting is enabled
+static QBasicAtomicInt allocationCounting = Q_BASIC_ATOMIC_INITIALIZER(0);
+static QBasicAtomicInt allocationCount = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    if (allocationCounting.load())
+        allocationCount.ref();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    if (allocationCounting.load())
+        allocationCount.ref();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    if (allocationCounting.load())
+        allocationCount.ref();
+    return __libc_realloc(ptr, size);
+}
+}
+#endif
+
 class QCoreApplicationBenchmark : public QObject
 {
 Q_OBJECT
 private slots:
     void event_posting_benchmark_data();
     void event_posting_benchmark();
+    void queued_connection_allocations_data();
+    void queued_connection_allocations();
 };
 
 void QCoreApplicationBenchmark::event_posting_benchmark_data()
@@ -69,6 +104,127 @@ void QCoreApplicationBenchmark::event_posting_benchmark()
     }
 }
 
+class Producer : public QThread
+{
+    Q_OBJECT
+public:
+    Producer(QAtomicInt *go, int count) : go(go), count(count) { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        while (!go->load())
+            yieldCurrentThread();
+        for (int i = 0; i < count; ++i)
+            emit produced(i);
+    }
+
+signals:
+    void produced(int value);
+    void producedInts(int a, int b, int c);
+    void producedString(const QString &value);
+
+private:
+    QAtomicInt *go;
+    int count;
+};
+
+class Consumer : public QObject
+{
+    Q_OBJECT
+public:
+    Consumer(int expected, QEventLoop *loop) : received(0), expected(expected), loop(loop) { }
+
+    int received;
+
+public slots:
+    void consume(int)
+    {
+        if (++received == expected)
+            loop->quit();
+    }
+
+    void consumeInts(int, int, int) { consume(0); }
+    void consumeString(const QString &) { consume(0); }
+
+private:
+    int expected;
+    QEventLoop *loop;
+};
+
+class SignalEmitter : public QThread
+{
+    Q_OBJECT
+public:
+    SignalEmitter(Producer *producer, int signal, int count)
+        : producer(producer), signal(signal), count(count) { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        const QString string = QStringLiteral("queued");
+        for (int i = 0; i < count; ++i) {
+            switch (signal) {
+            case 0:
+                emit producer->produced(i);
+                break;
+            case 1:
+                emit producer->producedInts(i, i, i);
+                break;
+            case 2:
+                emit producer->producedString(string);
+                break;
+            }
+        }
+    }
+
+private:
+    Producer *producer;
+    int signal;
+    int count;
+};
+
+void QCoreApplicationBenchmark::queued_connection_allocations_data()
+{
+    QTest::addColumn<int>("signal");
+
+    QTest::newRow("int") << 0;
+    QTest::newRow("3 ints") << 1;
+    QTest::newRow("QString") << 2;
+}
+
+// reports the heap allocations per queued call, once caches are warm
+void QCoreApplicationBenchmark::queued_connection_allocations()
+{
+#if !defined(__GLIBC__)
+    QSKIP("Counting allocations is only implemented for glibc");
+#else
+    QFETCH(int, signal);
+
+    const int count = 100000;
+    QAtomicInt go;
+    Producer producer(&go, 0);
+    QEventLoop loop;
+    Consumer consumer(count, &loop);
+    connect(&producer, SIGNAL(produced(int)), &consumer, SLOT(consume(int)), Qt::QueuedConnection);
+    connect(&producer, SIGNAL(producedInts(int,int,int)), &consumer, SLOT(consumeInts(int,int,int)), Qt::QueuedConnection);
+    connect(&producer, SIGNAL(producedString(QString)), &consumer, SLOT(consumeString(QString)), Qt::QueuedConnection);
+
+    // warm up, then count
+    for (int round = 0; round < 2; ++round) {
+        consumer.received = 0;
+        SignalEmitter emitter(&producer, signal, count);
+        allocationCount.store(0);
+        allocationCounting.store(round);
+        emitter.start();
+        loop.exec();
+        allocationCounting.store(0);
+        emitter.wait();
+        QCOMPARE(consumer.received, count);
+    }
+
+    QTest::setBenchmarkResult(qreal(allocationCount.load()) / count, QTest::Events);
+#endif
+}
+
 QTEST_MAIN(QCoreApplicationBenchmark)
 
 #include "main.moc"
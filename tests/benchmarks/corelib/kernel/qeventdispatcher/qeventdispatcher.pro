@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_qeventdispatcher
+
+SOURCES += tst_bench_qeventdispatcher.cpp
+QT = core testlib
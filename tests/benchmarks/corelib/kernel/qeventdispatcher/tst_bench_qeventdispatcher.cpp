@@ -0,0 +1,206 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Keeps sockets registered with the current thread's event dispatcher. Sockets are
+// created in connected pairs with both ends watched. Busy pairs keep passing a byte
+// back and forth so that they are always readable, idle pairs are never written to.
+class SocketLoad : public QObject
+{
+    Q_OBJECT
+public:
+    ~SocketLoad()
+    {
+        qDeleteAll(notifiers);
+        for (int i = 0; i < fds.size(); ++i)
+            ::close(fds.at(i));
+    }
+
+    bool addSockets(int count, bool busy)
+    {
+        for (int i = 0; i < count; i += 2) {
+            int sv[2];
+            if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == -1)
+                return false;
+            for (int j = 0; j < 2; ++j) {
+                fds.append(sv[j]);
+                QSocketNotifier *notifier = new QSocketNotifier(sv[j], QSocketNotifier::Read);
+                connect(notifier, SIGNAL(activated(int)), this, SLOT(echo(int)));
+                notifiers.append(notifier);
+                if (busy && ::write(sv[j], "x", 1) != 1)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+public slots:
+    void echo(int fd)
+    {
+        char c;
+        if (::read(fd, &c, 1) == 1)
+            (void)::write(fd, &c, 1);
+    }
+
+private:
+    QVector<int> fds;
+    QList<QSocketNotifier *> notifiers;
+};
+
+class DispatcherThread : public QThread
+{
+public:
+    DispatcherThread(int idle, int busy)
+        : idleCount(idle), busyCount(busy), wakeUpsPerSecond(0), failed(false)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        SocketLoad load;
+        if (!load.addSockets(idleCount, false) || !load.addSockets(busyCount, true)) {
+            failed = true;
+            return;
+        }
+
+        QEventLoop loop;
+        qint64 wakeUps = 0;
+        QElapsedTimer timer;
+        timer.start();
+        while (timer.elapsed() < 1000) {
+            loop.processEvents(QEventLoop::WaitForMoreEvents);
+            ++wakeUps;
+        }
+        wakeUpsPerSecond = wakeUps * 1000.0 / timer.elapsed();
+    }
+
+    const int idleCount;
+    const int busyCount;
+    qreal wakeUpsPerSecond;
+    bool failed;
+};
+
+class tst_QEventDispatcher : public QObject
+{
+    Q_OBJECT
+private slots:
+    void socketNotifierWakeUps_data();
+    void socketNotifierWakeUps();
+    void timerChurn_data();
+    void timerChurn();
+};
+
+void tst_QEventDispatcher::socketNotifierWakeUps_data()
+{
+    QTest::addColumn<QByteArray>("backend");
+    QTest::addColumn<int>("idle");
+    QTest::addColumn<int>("busy");
+
+    // select() can't watch descriptors at or above FD_SETSIZE
+    QTest::newRow("select, 800 idle, 100 busy") << QByteArray("select") << 800 << 100;
+    QTest::newRow("poll, 800 idle, 100 busy") << QByteArray("poll") << 800 << 100;
+    QTest::newRow("epoll, 800 idle, 100 busy") << QByteArray("epoll") << 800 << 100;
+    QTest::newRow("poll, 10000 idle, 100 busy") << QByteArray("poll") << 10000 << 100;
+    QTest::newRow("epoll, 10000 idle, 100 busy") << QByteArray("epoll") << 10000 << 100;
+}
+
+void tst_QEventDispatcher::socketNotifierWakeUps()
+{
+    QFETCH(QByteArray, backend);
+    QFETCH(int, idle);
+    QFETCH(int, busy);
+
+    rlimit limit;
+    const rlim_t needed = rlim_t(idle + busy) + 64;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < needed) {
+        limit.rlim_cur = qMin(needed, limit.rlim_max);
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    if (::getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur < needed)
+        QSKIP("Not enough file descriptors available");
+
+    // the worker thread's event dispatcher picks its backend up when it is created
+    qputenv("QT_EVENTDISPATCHER_UNIX_BACKEND", backend);
+    DispatcherThread thread(idle, busy);
+    thread.start();
+    thread.wait();
+    qunsetenv("QT_EVENTDISPATCHER_UNIX_BACKEND");
+
+    QVERIFY(!thread.failed);
+    QTest::setBenchmarkResult(thread.wakeUpsPerSecond, QTest::Events);
+}
+
+void tst_QEventDispatcher::timerChurn_data()
+{
+    QTest::addColumn<int>("liveTimers");
+    QTest::addColumn<int>("timerType");
+
+    QTest::newRow("no other timers") << 0 << int(Qt::CoarseTimer);
+    QTest::newRow("1000 coarse timers") << 1000 << int(Qt::CoarseTimer);
+    QTest::newRow("1000 precise timers") << 1000 << int(Qt::PreciseTimer);
+    QTest::newRow("50000 coarse timers") << 50000 << int(Qt::CoarseTimer);
+    QTest::newRow("50000 precise timers") << 50000 << int(Qt::PreciseTimer);
+}
+
+void tst_QEventDispatcher::timerChurn()
+{
+    QFETCH(int, liveTimers);
+    QFETCH(int, timerType);
+
+    // one timeout timer per idle connection...
+    QObject idleConnections;
+    for (int i = 0; i < liveTimers; ++i)
+        idleConnections.startTimer(5000 + i % 1000, Qt::TimerType(timerType));
+
+    // ...and one connection restarting its timeout on activity
+    QObject connection;
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            const int id = connection.startTimer(5000 + i, Qt::TimerType(timerType));
+            connection.killTimer(id);
+        }
+    }
+}
+
+QTEST_MAIN(tst_QEventDispatcher)
+
+#include "tst_bench_qeventdispatcher.moc"
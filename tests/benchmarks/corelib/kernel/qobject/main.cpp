@@ -48,6 +48,8 @@ Q_OBJECT
 private slots:
     void signal_slot_benchmark();
     void signal_slot_benchmark_data();
+    void signal_slot_threads_benchmark_data();
+    void signal_slot_threads_benchmark();
     void qproperty_benchmark_data();
     void qproperty_benchmark();
     void dynamic_property_benchmark();
@@ -132,6 +134,60 @@ void QObjectBenchmark::signal_slot_benchmark()
     }
 }
 
+class EmitterThread : public QThread
+{
+public:
+    EmitterThread(QAtomicInt *go, int count) : go(go), count(count) { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        // every thread emits the signals of its own objects
+        Object sender;
+        Object receiver;
+        QObject::connect(&sender, SIGNAL(signal0()), &receiver, SLOT(slot0()));
+        while (!go->load())
+            yieldCurrentThread();
+        for (int i = 0; i < count; ++i)
+            sender.emitSignal0();
+    }
+
+private:
+    QAtomicInt *go;
+    int count;
+};
+
+void QObjectBenchmark::signal_slot_threads_benchmark_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    for (int threadCount = 1; threadCount <= 16; threadCount *= 2)
+        QTest::newRow(QByteArray::number(threadCount) + " threads") << threadCount;
+}
+
+// reports signals emitted per second by all threads together
+void QObjectBenchmark::signal_slot_threads_benchmark()
+{
+    QFETCH(int, threadCount);
+
+    const int count = 1000000;
+    QAtomicInt go;
+    QVector<EmitterThread *> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.append(new EmitterThread(&go, count));
+        threads.last()->start();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    go.store(1);
+    for (int i = 0; i < threadCount; ++i)
+        threads.at(i)->wait();
+    const qint64 elapsed = qMax(timer.nsecsElapsed(), Q_INT64_C(1));
+    qDeleteAll(threads);
+
+    QTest::setBenchmarkResult(qreal(count) * threadCount * 1e9 / elapsed, QTest::Events);
+}
+
 void QObjectBenchmark::qproperty_benchmark_data()
 {
     QTest::addColumn<QByteArray>("name");
@@ -0,0 +1,183 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+class tst_QReadWriteLock : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void uncontended_data();
+    void uncontended();
+    void readers_data();
+    void readers();
+};
+
+void tst_QReadWriteLock::uncontended_data()
+{
+    QTest::addColumn<int>("recursionMode");
+    QTest::addColumn<bool>("write");
+
+    QTest::newRow("read, non-recursive") << int(QReadWriteLock::NonRecursive) << false;
+    QTest::newRow("read, recursive") << int(QReadWriteLock::Recursive) << false;
+    QTest::newRow("write, non-recursive") << int(QReadWriteLock::NonRecursive) << true;
+    QTest::newRow("write, recursive") << int(QReadWriteLock::Recursive) << true;
+}
+
+void tst_QReadWriteLock::uncontended()
+{
+    QFETCH(int, recursionMode);
+    QFETCH(bool, write);
+
+    QReadWriteLock lock(static_cast<QReadWriteLock::RecursionMode>(recursionMode));
+    if (write) {
+        QBENCHMARK {
+            lock.lockForWrite();
+            lock.unlock();
+        }
+    } else {
+        QBENCHMARK {
+            lock.lockForRead();
+            lock.unlock();
+        }
+    }
+}
+
+class ReaderThread : public QThread
+{
+public:
+    ReaderThread(QReadWriteLock *lock, QAtomicInt *go, int iterations, const int *data)
+        : lock(lock), go(go), iterations(iterations), data(data), sum(0) { }
+
+    void run() Q_DECL_OVERRIDE {
+        while (!go->load())
+            yieldCurrentThread();
+        for (int i = 0; i < iterations; ++i) {
+            lock->lockForRead();
+            sum += *data;
+            lock->unlock();
+        }
+    }
+
+private:
+    QReadWriteLock *lock;
+    QAtomicInt *go;
+    int iterations;
+    const int *data;
+    int sum;
+};
+
+class WriterThread : public QThread
+{
+public:
+    WriterThread(QReadWriteLock *lock, QAtomicInt *stop, int *data)
+        : lock(lock), stop(stop), data(data) { }
+
+    void run() Q_DECL_OVERRIDE {
+        while (!stop->load()) {
+            lock->lockForWrite();
+            ++*data;
+            lock->unlock();
+            msleep(1);
+        }
+    }
+
+private:
+    QReadWriteLock *lock;
+    QAtomicInt *stop;
+    int *data;
+};
+
+void tst_QReadWriteLock::readers_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<int>("recursionMode");
+    QTest::addColumn<bool>("withWriter");
+
+    for (int threadCount = 1; threadCount <= 64; threadCount *= 2) {
+        const QByteArray threads = QByteArray::number(threadCount) + " readers";
+        QTest::newRow(threads + ", non-recursive")
+                << threadCount << int(QReadWriteLock::NonRecursive) << false;
+        QTest::newRow(threads + ", recursive")
+                << threadCount << int(QReadWriteLock::Recursive) << false;
+        QTest::newRow(threads + ", non-recursive, writer")
+                << threadCount << int(QReadWriteLock::NonRecursive) << true;
+    }
+}
+
+// reports read locks per second over all reader threads
+void tst_QReadWriteLock::readers()
+{
+    QFETCH(int, threadCount);
+    QFETCH(int, recursionMode);
+    QFETCH(bool, withWriter);
+
+    const int totalIterations = 2000000;
+    const int iterations = totalIterations / threadCount;
+
+    QReadWriteLock lock(static_cast<QReadWriteLock::RecursionMode>(recursionMode));
+    QAtomicInt go;
+    QAtomicInt stop;
+    int data = 0;
+
+    QVector<ReaderThread *> readers;
+    for (int i = 0; i < threadCount; ++i) {
+        readers.append(new ReaderThread(&lock, &go, iterations, &data));
+        readers.last()->start();
+    }
+    WriterThread writer(&lock, &stop, &data);
+    if (withWriter)
+        writer.start();
+
+    QElapsedTimer timer;
+    timer.start();
+    go.store(1);
+    for (int i = 0; i < threadCount; ++i)
+        readers.at(i)->wait();
+    const qint64 elapsed = qMax(timer.nsecsElapsed(), Q_INT64_C(1));
+
+    stop.store(1);
+    writer.wait();
+    qDeleteAll(readers);
+
+    QTest::setBenchmarkResult(qint64(iterations) * threadCount * 1e9 / elapsed, QTest::Events);
+}
+
+QTEST_MAIN(tst_QReadWriteLock)
+
+#include "tst_qreadwritelock.moc"
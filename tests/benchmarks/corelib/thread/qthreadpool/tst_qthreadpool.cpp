@@ -45,6 +45,8 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void scaling_data();
+    void scaling();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -80,5 +82,76 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+// Splits itself until each runnable covers a single task, so that most
+// runnables are started from the pool's own threads.
+class FanOutRunnable : public QRunnable
+{
+public:
+    FanOutRunnable(QThreadPool *pool, int count, QAtomicInt *done)
+        : pool(pool), count(count), done(done) { }
+
+    void run() Q_DECL_OVERRIDE {
+        while (count > 1) {
+            const int half = count / 2;
+            pool->start(new FanOutRunnable(pool, half, done));
+            count -= half;
+        }
+        done->ref();
+    }
+
+private:
+    QThreadPool *pool;
+    int count;
+    QAtomicInt *done;
+};
+
+class CountingRunnable : public QRunnable
+{
+public:
+    CountingRunnable(QAtomicInt *done) : done(done) { }
+    void run() Q_DECL_OVERRIDE { done->ref(); }
+
+private:
+    QAtomicInt *done;
+};
+
+void tst_QThreadPool::scaling_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("fanOut");
+
+    for (int threadCount = 1; threadCount <= 64; threadCount *= 2) {
+        const QByteArray threads = QByteArray::number(threadCount);
+        QTest::newRow("main thread, " + threads + " threads") << threadCount << false;
+        QTest::newRow("fan-out, " + threads + " threads") << threadCount << true;
+    }
+}
+
+// reports tasks per second
+void tst_QThreadPool::scaling()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, fanOut);
+
+    const int taskCount = 200000;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    QAtomicInt done;
+
+    QElapsedTimer timer;
+    timer.start();
+    if (fanOut) {
+        threadPool.start(new FanOutRunnable(&threadPool, taskCount, &done));
+    } else {
+        for (int i = 0; i < taskCount; ++i)
+            threadPool.start(new CountingRunnable(&done));
+    }
+    QVERIFY(threadPool.waitForDone());
+    const qint64 elapsed = qMax(timer.nsecsElapsed(), Q_INT64_C(1));
+
+    QCOMPARE(done.load(), taskCount);
+    QTest::setBenchmarkResult(taskCount * 1e9 / elapsed, QTest::Events);
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
@@ -3,4 +3,5 @@ SUBDIRS = \
         qmutex \
         qthreadstorage \
         qthreadpool \
+        qreadwritelock \
         qwaitcondition \
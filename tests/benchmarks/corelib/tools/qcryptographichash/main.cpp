@@ -31,9 +31,12 @@
 **
 ****************************************************************************/
 
+#include <QBuffer>
 #include <QByteArray>
 #include <QCryptographicHash>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QTemporaryFile>
 #include <QString>
 #include <QtTest>
 
@@ -63,6 +66,12 @@ private Q_SLOTS:
     void addData();
     void addDataChunked_data() { hash_data(); }
     void addDataChunked();
+    void throughput_data();
+    void throughput();
+    void hashList_data();
+    void hashList();
+    void addDataDevice_data();
+    void addDataDevice();
 };
 
 const int MaxCryptoAlgorithm = QCryptographicHash::Sha3_512;
@@ -173,6 +182,120 @@ void tst_bench_QCryptographicHash::addDataChunked()
     }
 }
 
+void tst_bench_QCryptographicHash::throughput_data()
+{
+    QTest::addColumn<int>("algorithm");
+    for (int algo = QCryptographicHash::Md4; algo <= MaxCryptoAlgorithm; ++algo)
+        QTest::newRow(QByteArray(algoname(algo)).replace('-', "")) << algo;
+}
+
+void tst_bench_QCryptographicHash::throughput()
+{
+    QFETCH(int, algorithm);
+
+    // hash the block over and over for a while and report the bytes per second
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QCryptographicHash hash(algo);
+    QElapsedTimer timer;
+    qint64 bytes = 0;
+    timer.start();
+    do {
+        hash.addData(blockOfData);
+        bytes += blockOfData.size();
+    } while (timer.elapsed() < 250);
+    hash.result();
+    QTest::setBenchmarkResult(bytes * 1e9 / timer.nsecsElapsed(), QTest::BytesPerSecond);
+}
+
+void tst_bench_QCryptographicHash::hashList_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("list");
+
+    static const int algorithms[] = {
+        QCryptographicHash::Md5, QCryptographicHash::Sha1, QCryptographicHash::Sha256
+    };
+    static const int sizes[] = { 16, 64, 200 };
+    for (uint i = 0; i < sizeof(algorithms)/sizeof(algorithms[0]); ++i) {
+        for (uint j = 0; j < sizeof(sizes)/sizeof(sizes[0]); ++j) {
+            const QByteArray name = algoname(algorithms[i]) + QByteArray::number(sizes[j]);
+            QTest::newRow(name + "-single") << algorithms[i] << sizes[j] << false;
+            QTest::newRow(name + "-list") << algorithms[i] << sizes[j] << true;
+        }
+    }
+}
+
+void tst_bench_QCryptographicHash::hashList()
+{
+    QFETCH(int, algorithm);
+    QFETCH(int, size);
+    QFETCH(bool, list);
+
+    // 1000 short messages, hashed one by one or all at once
+    QByteArrayList messages;
+    for (int i = 0; i < 1000; ++i)
+        messages << QByteArray(blockOfData.constData() + i, size);
+
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    if (list) {
+        QBENCHMARK {
+            QCryptographicHash::hash(messages, algo);
+        }
+    } else {
+        QBENCHMARK {
+            for (int i = 0; i < messages.size(); ++i)
+                QCryptographicHash::hash(messages.at(i), algo);
+        }
+    }
+}
+
+void tst_bench_QCryptographicHash::addDataDevice_data()
+{
+    QTest::addColumn<QString>("device");
+
+    QTest::newRow("file") << QString::fromLatin1("file");
+    QTest::newRow("buffer") << QString::fromLatin1("buffer");
+    QTest::newRow("file-read-1k") << QString::fromLatin1("file-read-1k");
+}
+
+void tst_bench_QCryptographicHash::addDataDevice()
+{
+    QFETCH(QString, device);
+
+    // 16 MB of data; the file is in the page cache after the first round
+    QByteArray data;
+    for (int i = 0; i < 256; ++i)
+        data += blockOfData;
+    QTemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    QCOMPARE(tempFile.write(data), qint64(data.size()));
+    QVERIFY(tempFile.flush());
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    QBENCHMARK {
+        hash.reset();
+        if (device == QLatin1String("buffer")) {
+            QBuffer buffer(&data);
+            buffer.open(QIODevice::ReadOnly);
+            hash.addData(&buffer);
+        } else {
+            QFile file(tempFile.fileName());
+            file.open(QIODevice::ReadOnly);
+            if (device == QLatin1String("file")) {
+                hash.addData(&file);
+            } else {
+                // what addData(QIODevice *) used to do
+                char buffer[1024];
+                qint64 length;
+                while ((length = file.read(buffer, sizeof(buffer))) > 0)
+                    hash.addData(buffer, int(length));
+            }
+        }
+        hash.result();
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_bench_QCryptographicHash)
 
 #include "main.moc"
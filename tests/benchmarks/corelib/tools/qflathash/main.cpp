@@ -0,0 +1,255 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QFlatHash>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <QTest>
+
+#include <unordered_map>
+
+// std::unordered_map uses the same hash functions as the Qt containers
+template <typename Key>
+struct QtHasher
+{
+    size_t operator()(const Key &key) const { return qHash(key); }
+};
+
+template <typename Key>
+struct StdHash : public std::unordered_map<Key, int, QtHasher<Key> >
+{
+    void insert(const Key &key, int value) { (*this)[key] = value; }
+    int value(const Key &key) const
+    {
+        typename StdHash::const_iterator it = this->find(key);
+        return it == this->end() ? 0 : it->second;
+    }
+};
+
+template <typename Container>
+static int sumOfValues(const Container &container)
+{
+    int sum = 0;
+    for (typename Container::const_iterator it = container.begin(), end = container.end(); it != end; ++it)
+        sum += it.value();
+    return sum;
+}
+
+template <typename Key>
+static int sumOfValues(const StdHash<Key> &container)
+{
+    int sum = 0;
+    for (typename StdHash<Key>::const_iterator it = container.begin(), end = container.end(); it != end; ++it)
+        sum += it->second;
+    return sum;
+}
+
+template <typename Container, typename Key>
+struct InsertTest
+{
+    static void run(const QVector<Key> &keys, const QVector<Key> &)
+    {
+        QBENCHMARK {
+            Container container;
+            for (int i = 0; i < keys.size(); ++i)
+                container.insert(keys.at(i), i);
+        }
+    }
+};
+
+template <typename Container, typename Key>
+struct LookupTest
+{
+    static void run(const QVector<Key> &keys, const QVector<Key> &)
+    {
+        Container container;
+        for (int i = 0; i < keys.size(); ++i)
+            container.insert(keys.at(i), i);
+
+        int sum = 0;
+        QBENCHMARK {
+            for (int i = 0; i < keys.size(); ++i)
+                sum += container.value(keys.at(i));
+        }
+        QVERIFY(sum != -1);
+    }
+};
+
+template <typename Container, typename Key>
+struct LookupMissTest
+{
+    static void run(const QVector<Key> &keys, const QVector<Key> &missing)
+    {
+        Container container;
+        for (int i = 0; i < keys.size(); ++i)
+            container.insert(keys.at(i), i + 1);
+
+        int sum = 0;
+        QBENCHMARK {
+            for (int i = 0; i < missing.size(); ++i)
+                sum += container.value(missing.at(i));
+        }
+        QCOMPARE(sum, 0);
+    }
+};
+
+template <typename Container, typename Key>
+struct IterateTest
+{
+    static void run(const QVector<Key> &keys, const QVector<Key> &)
+    {
+        Container container;
+        for (int i = 0; i < keys.size(); ++i)
+            container.insert(keys.at(i), i);
+
+        int sum = 0;
+        QBENCHMARK {
+            sum += sumOfValues(container);
+        }
+        QVERIFY(sum != -1);
+    }
+};
+
+enum ContainerType {
+    FlatHash,
+    Hash,
+    Map,
+    UnorderedMap
+};
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void insert_int_data() { data(); }
+    void insert_int() { run<int, InsertTest>(); }
+    void insert_string_data() { data(); }
+    void insert_string() { run<QString, InsertTest>(); }
+    void lookup_int_data() { data(); }
+    void lookup_int() { run<int, LookupTest>(); }
+    void lookup_string_data() { data(); }
+    void lookup_string() { run<QString, LookupTest>(); }
+    void lookupMiss_int_data() { data(); }
+    void lookupMiss_int() { run<int, LookupMissTest>(); }
+    void lookupMiss_string_data() { data(); }
+    void lookupMiss_string() { run<QString, LookupMissTest>(); }
+    void iterate_int_data() { data(); }
+    void iterate_int() { run<int, IterateTest>(); }
+
+private:
+    void data();
+    template <typename Key, template <typename, typename> class Test> void run();
+    template <typename Key> const QVector<Key> &keys() const;
+    template <typename Key> const QVector<Key> &missingKeys() const;
+
+    QVector<int> intKeys;
+    QVector<int> missingIntKeys;
+    QVector<QString> stringKeys;
+    QVector<QString> missingStringKeys;
+};
+
+static const int MaxSize = 1000000;
+
+void tst_QFlatHash::initTestCase()
+{
+    intKeys.reserve(MaxSize);
+    missingIntKeys.reserve(MaxSize);
+    stringKeys.reserve(MaxSize);
+    missingStringKeys.reserve(MaxSize);
+    // multiplying by an odd number permutes the integers, so the keys are
+    // distinct but scattered, and the even keys are never inserted
+    for (int i = 0; i < MaxSize; ++i) {
+        intKeys.append(int(uint(2 * i + 1) * 2654435761U));
+        missingIntKeys.append(int(uint(2 * i) * 2654435761U));
+        stringKeys.append(QStringLiteral("key-") + QString::number(intKeys.last(), 16));
+        missingStringKeys.append(QStringLiteral("key-") + QString::number(missingIntKeys.last(), 16));
+    }
+}
+
+void tst_QFlatHash::data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<int>("size");
+
+    static const int sizes[] = { 100, 10000, MaxSize };
+    for (uint i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        const QByteArray size = QByteArray::number(sizes[i]);
+        QTest::newRow("QFlatHash-" + size) << int(FlatHash) << sizes[i];
+        QTest::newRow("QHash-" + size) << int(Hash) << sizes[i];
+        QTest::newRow("QMap-" + size) << int(Map) << sizes[i];
+        QTest::newRow("std::unordered_map-" + size) << int(UnorderedMap) << sizes[i];
+    }
+}
+
+template <>
+const QVector<int> &tst_QFlatHash::keys<int>() const { return intKeys; }
+template <>
+const QVector<QString> &tst_QFlatHash::keys<QString>() const { return stringKeys; }
+template <>
+const QVector<int> &tst_QFlatHash::missingKeys<int>() const { return missingIntKeys; }
+template <>
+const QVector<QString> &tst_QFlatHash::missingKeys<QString>() const { return missingStringKeys; }
+
+template <typename Key, template <typename, typename> class Test>
+void tst_QFlatHash::run()
+{
+    QFETCH(int, type);
+    QFETCH(int, size);
+
+    const QVector<Key> present = keys<Key>().mid(0, size);
+    const QVector<Key> missing = missingKeys<Key>().mid(0, size);
+
+    switch (type) {
+    case FlatHash:
+        Test<QFlatHash<Key, int>, Key>::run(present, missing);
+        break;
+    case Hash:
+        Test<QHash<Key, int>, Key>::run(present, missing);
+        break;
+    case Map:
+        Test<QMap<Key, int>, Key>::run(present, missing);
+        break;
+    case UnorderedMap:
+        Test<StdHash<Key>, Key>::run(present, missing);
+        break;
+    }
+}
+
+QTEST_MAIN(tst_QFlatHash)
+
+#include "main.moc"
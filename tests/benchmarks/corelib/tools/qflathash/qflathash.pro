@@ -0,0 +1,4 @@
+TARGET = tst_bench_qflathash
+QT = core testlib
+SOURCES += main.cpp
+CONFIG += release c++11
@@ -33,6 +33,9 @@
 
 #include <QLocale>
 #include <QTest>
+#include <QVector>
+
+#include <math.h>
 
 class tst_QLocale : public QObject
 {
@@ -42,6 +45,10 @@ private Q_SLOTS:
     void toUpper_QLocale_1();
     void toUpper_QLocale_2();
     void toUpper_QString();
+    void toString_double_data();
+    void toString_double();
+    void toDouble_data();
+    void toDouble();
 };
 
 static QString data()
@@ -70,6 +77,73 @@ void tst_QLocale::toUpper_QString()
     QBENCHMARK { LOOP(s.toUpper()) }
 }
 
+static QVector<double> doubles()
+{
+    // a mix of short and long numbers over a wide range of magnitudes
+    QVector<double> result;
+    quint64 state = Q_UINT64_C(0x9e3779b97f4a7c15);
+    for (int i = 0; i < 1000; ++i) {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        const quint64 bits = state * Q_UINT64_C(2685821657736338717);
+        const double mantissa = double(bits >> 11) / (Q_UINT64_C(1) << 53);
+        const int exponent = int(bits % 61) - 30;
+        result.append(i % 4 ? mantissa * pow(10.0, exponent) : double(bits % 100000) / 100);
+    }
+    return result;
+}
+
+void tst_QLocale::toString_double_data()
+{
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+
+    QTest::newRow("g 6") << 'g' << 6;
+    QTest::newRow("g 17") << 'g' << 17;
+    QTest::newRow("g shortest") << 'g' << int(QLocale::FloatingPointShortest);
+    QTest::newRow("e 10") << 'e' << 10;
+    QTest::newRow("f 2") << 'f' << 2;
+}
+
+void tst_QLocale::toString_double()
+{
+    QFETCH(char, format);
+    QFETCH(int, precision);
+
+    const QVector<double> numbers = doubles();
+    const QLocale l = QLocale::c();
+    QBENCHMARK {
+        for (int i = 0; i < numbers.size(); ++i)
+            l.toString(numbers.at(i), format, precision);
+    }
+}
+
+void tst_QLocale::toDouble_data()
+{
+    QTest::addColumn<QStringList>("strings");
+
+    const QVector<double> numbers = doubles();
+    QStringList shortest, full;
+    for (int i = 0; i < numbers.size(); ++i) {
+        shortest.append(QString::number(numbers.at(i), 'g', QLocale::FloatingPointShortest));
+        full.append(QString::number(numbers.at(i), 'g', 17));
+    }
+    QTest::newRow("shortest") << shortest;
+    QTest::newRow("17 digits") << full;
+}
+
+void tst_QLocale::toDouble()
+{
+    QFETCH(QStringList, strings);
+
+    const QLocale l = QLocale::c();
+    QBENCHMARK {
+        for (int i = 0; i < strings.size(); ++i)
+            l.toDouble(strings.at(i));
+    }
+}
+
 QTEST_MAIN(tst_QLocale)
 
 #include "main.moc"
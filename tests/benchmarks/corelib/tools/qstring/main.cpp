@@ -54,7 +54,31 @@ private slots:
     void toCaseFolded_data();
     void toCaseFolded();
 
+    // the vectorized conversion and comparison kernels
+    void kernels_data();
+    void fromLatin1() { fromLatin1_impl(); }
+    void fromLatin1_data() { kernels_data(); }
+    void toLatin1() { toLatin1_impl(); }
+    void toLatin1_data() { kernels_data(); }
+    void fromUtf8() { fromUtf8_impl(); }
+    void fromUtf8_data() { kernels_data(); }
+    void toUtf8() { toUtf8_impl(); }
+    void toUtf8_data() { kernels_data(); }
+    void compare() { compare_impl(); }
+    void compare_data() { kernels_data(); }
+    void compareLatin1() { compareLatin1_impl(); }
+    void compareLatin1_data() { kernels_data(); }
+    void indexOfChar() { indexOfChar_impl(); }
+    void indexOfChar_data() { kernels_data(); }
+
 private:
+    void fromLatin1_impl();
+    void toLatin1_impl();
+    void fromUtf8_impl();
+    void toUtf8_impl();
+    void compare_impl();
+    void compareLatin1_impl();
+    void indexOfChar_impl();
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
 };
@@ -193,6 +217,93 @@ void tst_QString::toCaseFolded()
     }
 }
 
+// Run with QT_NO_CPU_FEATURE=avx2 to compare with the SSE2 code paths
+void tst_QString::kernels_data()
+{
+    QTest::addColumn<QByteArray>("ascii");
+
+    const int lengths[] = { 15, 64, 1024, 65536 };
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        QByteArray ascii(lengths[i], Qt::Uninitialized);
+        for (int j = 0; j < ascii.size(); ++j)
+            ascii[j] = char(' ' + j % 95);
+        QTest::newRow(QByteArray::number(lengths[i])) << ascii;
+    }
+}
+
+void tst_QString::fromLatin1_impl()
+{
+    QFETCH(QByteArray, ascii);
+    QBENCHMARK {
+        QString s = QString::fromLatin1(ascii);
+        Q_UNUSED(s);
+    }
+}
+
+void tst_QString::toLatin1_impl()
+{
+    QFETCH(QByteArray, ascii);
+    const QString s = QString::fromLatin1(ascii);
+    QBENCHMARK {
+        QByteArray latin1 = s.toLatin1();
+        Q_UNUSED(latin1);
+    }
+}
+
+void tst_QString::fromUtf8_impl()
+{
+    QFETCH(QByteArray, ascii);
+    QBENCHMARK {
+        QString s = QString::fromUtf8(ascii);
+        Q_UNUSED(s);
+    }
+}
+
+void tst_QString::toUtf8_impl()
+{
+    QFETCH(QByteArray, ascii);
+    const QString s = QString::fromLatin1(ascii);
+    QBENCHMARK {
+        QByteArray utf8 = s.toUtf8();
+        Q_UNUSED(utf8);
+    }
+}
+
+void tst_QString::compare_impl()
+{
+    QFETCH(QByteArray, ascii);
+    const QString s1 = QString::fromLatin1(ascii);
+    const QString s2 = QString::fromLatin1(ascii);
+    int result = 0;
+    QBENCHMARK {
+        result += s1.compare(s2);
+    }
+    QCOMPARE(result, 0);
+}
+
+void tst_QString::compareLatin1_impl()
+{
+    QFETCH(QByteArray, ascii);
+    const QString s = QString::fromLatin1(ascii);
+    const QLatin1String latin1(ascii.constData(), ascii.size());
+    int result = 0;
+    QBENCHMARK {
+        result += s.compare(latin1);
+    }
+    QCOMPARE(result, 0);
+}
+
+void tst_QString::indexOfChar_impl()
+{
+    QFETCH(QByteArray, ascii);
+    const QString s = QString::fromLatin1(ascii);
+    int result = 0;
+    QBENCHMARK {
+        result += s.indexOf(QChar(0x2022));
+    }
+    QVERIFY(result < 0);
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "main.moc"
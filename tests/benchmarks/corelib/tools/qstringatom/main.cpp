@@ -0,0 +1,260 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringAtom>
+#include <QTest>
+#include <QVariant>
+#include <QVector>
+#include <QXmlStreamReader>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#endif
+
+static const char * const names[] = {
+    "Alice", "Bob", "Carol", "Dave", "Erin", "Frank", "Grace", "Heidi"
+};
+static const char * const cities[] = {
+    "Berlin", "Oslo", "Lisbon", "Montreal", "Osaka", "Santiago"
+};
+
+// A document shaped like the output of a typical REST API: many records
+// with the same dozen keys, a nested object and an array of objects.
+static QByteArray jsonDataSet(int records)
+{
+    QJsonArray array;
+    for (int i = 0; i < records; ++i) {
+        QJsonObject address;
+        address.insert(QStringLiteral("street"), QString::fromLatin1("%1 Main Street").arg(i % 1000));
+        address.insert(QStringLiteral("city"), QLatin1String(cities[i % 6]));
+        address.insert(QStringLiteral("zip"), QString::number(10000 + i % 90000));
+
+        QJsonArray friends;
+        for (int j = 0; j < 3; ++j) {
+            QJsonObject friendObject;
+            friendObject.insert(QStringLiteral("id"), j);
+            friendObject.insert(QStringLiteral("name"), QLatin1String(names[(i + j) % 8]));
+            friends.append(friendObject);
+        }
+
+        QJsonObject record;
+        record.insert(QStringLiteral("id"), i);
+        record.insert(QStringLiteral("guid"), QString::fromLatin1("%1-4f2c-9a7e").arg(i, 8, 16, QLatin1Char('0')));
+        record.insert(QStringLiteral("isActive"), i % 3 != 0);
+        record.insert(QStringLiteral("balance"), i * 1.25);
+        record.insert(QStringLiteral("age"), 20 + i % 50);
+        record.insert(QStringLiteral("name"), QLatin1String(names[i % 8]));
+        record.insert(QStringLiteral("email"), QString::fromLatin1("user%1@example.com").arg(i));
+        record.insert(QStringLiteral("registered"), QStringLiteral("2014-06-01T12:00:00"));
+        record.insert(QStringLiteral("latitude"), 52.5 + i * 0.001);
+        record.insert(QStringLiteral("longitude"), 13.4 - i * 0.001);
+        record.insert(QStringLiteral("address"), address);
+        record.insert(QStringLiteral("friends"), friends);
+        array.append(record);
+    }
+    return QJsonDocument(array).toJson(QJsonDocument::Compact);
+}
+
+static QByteArray xmlDataSet(int records)
+{
+    QByteArray xml = "<?xml version=\"1.0\"?>\n<catalog xmlns:dc=\"http://purl.org/dc/elements/1.1/\">\n";
+    for (int i = 0; i < records; ++i) {
+        xml += "<book id=\"" + QByteArray::number(i) + "\" dc:language=\"en\" available=\"true\">"
+               "<dc:title>Title " + QByteArray::number(i) + "</dc:title>"
+               "<author role=\"primary\">" + names[i % 8] + "</author>"
+               "<price currency=\"EUR\">" + QByteArray::number(i % 100) + ".99</price>"
+               "</book>\n";
+    }
+    xml += "</catalog>\n";
+    return xml;
+}
+
+struct XmlItem
+{
+    QString name;
+    QVector<QPair<QString, QString> > attributes;
+};
+
+static QVector<XmlItem> readXml(const QByteArray &xml)
+{
+    QVector<XmlItem> items;
+    QXmlStreamReader reader(xml);
+    while (!reader.atEnd()) {
+        if (reader.readNext() != QXmlStreamReader::StartElement)
+            continue;
+        XmlItem item;
+        item.name = reader.qualifiedName().toString();
+        foreach (const QXmlStreamAttribute &attribute, reader.attributes())
+            item.attributes.append(qMakePair(attribute.qualifiedName().toString(), attribute.value().toString()));
+        items.append(item);
+    }
+    return items;
+}
+
+static qint64 heapInUse()
+{
+#if defined(__GLIBC__)
+    return mallinfo().uordblks;
+#else
+    return -1;
+#endif
+}
+
+class tst_QStringAtom : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void intern_data();
+    void intern();
+    void jsonKeys_data();
+    void jsonKeys();
+    void jsonMemory_data();
+    void jsonMemory();
+    void xmlMemory_data();
+    void xmlMemory();
+
+private:
+    QByteArray json;
+    QByteArray xml;
+};
+
+void tst_QStringAtom::initTestCase()
+{
+    json = jsonDataSet(20000);
+    xml = xmlDataSet(20000);
+}
+
+void tst_QStringAtom::cleanup()
+{
+    QStringAtom::setAutomaticInterning(0);
+}
+
+void tst_QStringAtom::intern_data()
+{
+    QTest::addColumn<bool>("hit");
+    QTest::newRow("hit") << true;
+    QTest::newRow("miss-copy") << false;
+}
+
+void tst_QStringAtom::intern()
+{
+    QFETCH(bool, hit);
+
+    QVector<QString> keys;
+    for (int i = 0; i < 1000; ++i)
+        keys.append(QString::fromLatin1("someKeyName%1").arg(i));
+    if (hit) {
+        foreach (const QString &key, keys)
+            QStringAtom::intern(key);
+    }
+
+    QBENCHMARK {
+        foreach (const QString &key, keys) {
+            if (hit)
+                QStringAtom::intern(key);
+            else
+                QString(key.constData(), key.size());
+        }
+    }
+}
+
+void tst_QStringAtom::jsonKeys_data()
+{
+    QTest::addColumn<bool>("interning");
+    QTest::newRow("plain") << false;
+    QTest::newRow("interned") << true;
+}
+
+void tst_QStringAtom::jsonKeys()
+{
+    QFETCH(bool, interning);
+    if (interning)
+        QStringAtom::setAutomaticInterning(QStringAtom::JsonObjectKeys);
+
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+    QBENCHMARK {
+        QVariant variant = doc.toVariant();
+    }
+}
+
+void tst_QStringAtom::jsonMemory_data()
+{
+    jsonKeys_data();
+}
+
+void tst_QStringAtom::jsonMemory()
+{
+    QFETCH(bool, interning);
+    if (heapInUse() < 0)
+        QSKIP("Heap statistics are not available on this platform");
+    if (interning)
+        QStringAtom::setAutomaticInterning(QStringAtom::JsonObjectKeys);
+
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+    const qint64 before = heapInUse();
+    const QVariant variant = doc.toVariant();
+    const qint64 after = heapInUse();
+    QCOMPARE(variant.toList().size(), 20000);
+    QTest::setBenchmarkResult(after - before, QTest::BytesAllocated);
+}
+
+void tst_QStringAtom::xmlMemory_data()
+{
+    jsonKeys_data();
+}
+
+void tst_QStringAtom::xmlMemory()
+{
+    QFETCH(bool, interning);
+    if (heapInUse() < 0)
+        QSKIP("Heap statistics are not available on this platform");
+    if (interning)
+        QStringAtom::setAutomaticInterning(QStringAtom::XmlStreamNames);
+
+    const qint64 before = heapInUse();
+    const QVector<XmlItem> items = readXml(xml);
+    const qint64 after = heapInUse();
+    QCOMPARE(items.size(), 4 * 20000 + 1);
+    QTest::setBenchmarkResult(after - before, QTest::BytesAllocated);
+}
+
+QTEST_MAIN(tst_QStringAtom)
+
+#include "main.moc"
@@ -6,6 +6,7 @@ SUBDIRS = \
         qcontiguouscache \
         qcryptographichash \
         qdatetime \
+        qflathash \
         qlist \
         qlocale \
         qmap \
@@ -13,6 +14,7 @@ SUBDIRS = \
         qregexp \
         qringbuffer \
         qstring \
+        qstringatom \
         qstringbuilder \
         qstringlist \
         qvector \
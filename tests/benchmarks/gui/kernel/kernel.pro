@@ -4,3 +4,4 @@ qtHaveModule(widgets): SUBDIRS = \
         qwidget \
         qguimetatype \
         qguivariant
+SUBDIRS += qhighdpiscaling
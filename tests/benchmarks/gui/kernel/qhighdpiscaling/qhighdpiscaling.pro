@@ -0,0 +1,4 @@
+TEMPLATE = app
+TARGET = tst_bench_qhighdpiscaling
+QT += gui-private testlib
+SOURCES += tst_qhighdpiscaling.cpp
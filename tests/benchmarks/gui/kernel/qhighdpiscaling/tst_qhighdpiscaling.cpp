@@ -0,0 +1,222 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtGui/QWindow>
+#include <QtGui/qpa/qwindowsysteminterface.h>
+#include <QtGui/private/qhighdpiscaling_p.h>
+
+class EventCountingWindow : public QWindow
+{
+public:
+    EventCountingWindow() : mouseMoves(0), exposes(0) { }
+
+    int mouseMoves;
+    int exposes;
+
+protected:
+    void mouseMoveEvent(QMouseEvent *) Q_DECL_OVERRIDE { ++mouseMoves; }
+    void exposeEvent(QExposeEvent *) Q_DECL_OVERRIDE { ++exposes; }
+};
+
+class tst_QHighDpiScaling : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void mouseMoveStorm_data();
+    void mouseMoveStorm();
+    void exposeStorm_data();
+    void exposeStorm();
+    void convertRegion_data();
+    void convertRegion();
+    void convertPoints_data();
+    void convertPoints();
+    void cleanup();
+
+private:
+    void scalingModes();
+    void setUpWindow(EventCountingWindow *window);
+};
+
+enum ScalingMode { Unscaled, GlobalFactor, WindowFactor };
+
+void tst_QHighDpiScaling::scalingModes()
+{
+    QTest::addColumn<int>("mode");
+
+    QTest::newRow("unscaled") << int(Unscaled);
+    QTest::newRow("global factor") << int(GlobalFactor);
+    QTest::newRow("window factor") << int(WindowFactor);
+}
+
+void tst_QHighDpiScaling::cleanup()
+{
+    QHighDpiScaling::setFactor(1);
+}
+
+// must be called before the window is constructed, as the global
+// factor can only be changed while no windows exist
+void tst_QHighDpiScaling::setUpWindow(EventCountingWindow *window)
+{
+    QFETCH(int, mode);
+
+    window->setGeometry(0, 0, 400, 400);
+    window->create();
+    if (mode == WindowFactor)
+        QHighDpiScaling::setWindowFactor(window, 2);
+    window->show();
+    QCoreApplication::processEvents();
+}
+
+void tst_QHighDpiScaling::mouseMoveStorm_data()
+{
+    scalingModes();
+}
+
+void tst_QHighDpiScaling::mouseMoveStorm()
+{
+    QFETCH(int, mode);
+    if (mode == GlobalFactor)
+        QHighDpiScaling::setFactor(2);
+
+    EventCountingWindow window;
+    setUpWindow(&window);
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            const QPointF pos(i % 400, i / 400);
+            QWindowSystemInterface::handleMouseEvent(&window, pos, pos, Qt::NoButton);
+        }
+        QWindowSystemInterface::flushWindowSystemEvents();
+    }
+    QVERIFY(window.mouseMoves > 0);
+}
+
+void tst_QHighDpiScaling::exposeStorm_data()
+{
+    scalingModes();
+}
+
+void tst_QHighDpiScaling::exposeStorm()
+{
+    QFETCH(int, mode);
+    if (mode == GlobalFactor)
+        QHighDpiScaling::setFactor(2);
+
+    EventCountingWindow window;
+    setUpWindow(&window);
+
+    // a region of 200 separate rects, as produced by scattered updates
+    QRegion region;
+    for (int i = 0; i < 200; ++i)
+        region += QRect((i % 20) * 20, (i / 20) * 20, 10, 10);
+
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i)
+            QWindowSystemInterface::handleExposeEvent(&window, region);
+        QWindowSystemInterface::flushWindowSystemEvents();
+    }
+    QVERIFY(window.exposes > 0);
+}
+
+void tst_QHighDpiScaling::convertRegion_data()
+{
+    QTest::addColumn<qreal>("factor");
+    QTest::addColumn<bool>("toDevicePixels");
+
+    QTest::newRow("factor 2, to device pixels") << qreal(2) << true;
+    QTest::newRow("factor 2, to device independent pixels") << qreal(2) << false;
+    QTest::newRow("factor 1.5, to device pixels") << qreal(1.5) << true;
+    QTest::newRow("factor 1.5, to device independent pixels") << qreal(1.5) << false;
+}
+
+void tst_QHighDpiScaling::convertRegion()
+{
+    QFETCH(qreal, factor);
+    QFETCH(bool, toDevicePixels);
+    QHighDpiScaling::setFactor(factor);
+
+    QRegion region;
+    for (int i = 0; i < 400; ++i)
+        region += QRect((i % 20) * 24, (i / 20) * 24, 12, 12);
+
+    // the rect by rect conversion the batch conversion has to match
+    QRegion expected;
+    foreach (const QRect &rect, region.rects()) {
+        expected += toDevicePixels ? qHighDpiToDevicePixels(rect)
+                                   : qHighDpiToDeviceIndependentPixels(rect);
+    }
+
+    QRegion converted;
+    if (toDevicePixels) {
+        QBENCHMARK {
+            converted = qHighDpiToDevicePixels(region);
+        }
+    } else {
+        QBENCHMARK {
+            converted = qHighDpiToDeviceIndependentPixels(region);
+        }
+    }
+    QCOMPARE(converted, expected);
+}
+
+void tst_QHighDpiScaling::convertPoints_data()
+{
+    QTest::addColumn<qreal>("factor");
+
+    QTest::newRow("factor 2") << qreal(2);
+    QTest::newRow("factor 1.5") << qreal(1.5);
+}
+
+// a multi-touch stream's raw positions, converted to device pixels
+void tst_QHighDpiScaling::convertPoints()
+{
+    QFETCH(qreal, factor);
+    QHighDpiScaling::setFactor(factor);
+
+    QVector<QPointF> points;
+    for (int i = 0; i < 1000; ++i)
+        points.append(QPointF(i * 0.75, i * 1.25));
+
+    QVector<QPointF> converted;
+    QBENCHMARK {
+        converted = qHighDpiToDevicePixels(points);
+    }
+    QCOMPARE(converted.size(), points.size());
+    QCOMPARE(converted.last(), points.last() * factor);
+}
+
+QTEST_MAIN(tst_QHighDpiScaling)
+
+#include "tst_qhighdpiscaling.moc"
@@ -1,6 +1,7 @@
 TEMPLATE = subdirs
 SUBDIRS = \
         qfile_vs_qnetworkaccessmanager \
+        qhttpheaderparsing \
         qnetworkreply \
         qnetworkreply_from_cache \
         qnetworkdiskcache
@@ -0,0 +1,296 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia. For licensing terms and
+** conditions see http://qt.digia.com/licensing. For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights. These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkCookie>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+#if defined(__GLIBC__) && !defined(QT_NO_DYNAMIC_LIBRARY)
+// Count the heap allocations made by the whole process, including the HTTP
+// thread of QNetworkAccessManager.
+#  define HAVE_ALLOCATION_COUNTER
+static QBasicAtomicInt allocations = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    allocations.ref();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    allocations.ref();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    allocations.ref();
+    return __libc_realloc(ptr, size);
+}
+}
+#endif
+
+// The header block of a typical response from a web application
+static const char typicalHeaders[] =
+    "Date: Mon, 18 May 2015 09:15:23 GMT\r\n"
+    "Server: Apache/2.4.7 (Ubuntu)\r\n"
+    "X-Powered-By: PHP/5.5.9-1ubuntu4.9\r\n"
+    "Expires: Thu, 19 Nov 1981 08:52:00 GMT\r\n"
+    "Cache-Control: no-store, no-cache, must-revalidate,\r\n"
+    " post-check=0, pre-check=0\r\n"
+    "Pragma: no-cache\r\n"
+    "Set-Cookie: PHPSESSID=q1o2sgg4lhc8d3mjlt4t9pjqk1; path=/; HttpOnly\r\n"
+    "Set-Cookie: lang=en; expires=Wed, 17-Jun-2015 09:15:23 GMT; Max-Age=2592000; path=/; domain=.example.com\r\n"
+    "Set-Cookie: tz=UTC; path=/; secure\r\n"
+    "Vary: Accept-Encoding\r\n"
+    "Vary: User-Agent\r\n"
+    "X-Frame-Options: SAMEORIGIN\r\n"
+    "X-XSS-Protection: 1; mode=block\r\n"
+    "X-Content-Type-Options: nosniff\r\n"
+    "Strict-Transport-Security: max-age=31536000\r\n"
+    "Access-Control-Allow-Origin: *\r\n"
+    "ETag: \"5f3a-51660e8cb3a40\"\r\n"
+    "Last-Modified: Sun, 17 May 2015 20:01:17 GMT\r\n"
+    "Accept-Ranges: bytes\r\n"
+    "Keep-Alive: timeout=5, max=100\r\n"
+    "Connection: Keep-Alive\r\n"
+    "Content-Type: text/html; charset=UTF-8\r\n";
+
+class HeaderServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    QByteArray response;
+
+    HeaderServer()
+    {
+        connect(this, SIGNAL(newConnection()), this, SLOT(accept()));
+    }
+
+private slots:
+    void accept()
+    {
+        while (QTcpSocket *socket = nextPendingConnection()) {
+            connect(socket, SIGNAL(readyRead()), this, SLOT(answer()));
+            connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        }
+    }
+
+    void answer()
+    {
+        QTcpSocket *socket = static_cast<QTcpSocket *>(sender());
+        QByteArray &request = requests[socket];
+        request += socket->readAll();
+        while (request.contains("\r\n\r\n")) {
+            request.remove(0, request.indexOf("\r\n\r\n") + 4);
+            socket->write(response);
+        }
+    }
+
+private:
+    QHash<QTcpSocket *, QByteArray> requests;
+};
+
+class tst_QHttpHeaderParsing : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cookies_data();
+    void cookies();
+    void cookieAllocations_data();
+    void cookieAllocations();
+    void replyAllocations_data();
+    void replyAllocations();
+    void reply_data();
+    void reply();
+
+private:
+    QNetworkReply *get(QNetworkAccessManager *manager, const QUrl &url);
+    HeaderServer server;
+};
+
+void tst_QHttpHeaderParsing::initTestCase()
+{
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+}
+
+void tst_QHttpHeaderParsing::cookies_data()
+{
+    QTest::addColumn<QByteArray>("header");
+
+    QTest::newRow("session") << QByteArray("PHPSESSID=q1o2sgg4lhc8d3mjlt4t9pjqk1; path=/; HttpOnly");
+    QTest::newRow("attributes") << QByteArray("lang=en; expires=Wed, 17-Jun-2015 09:15:23 GMT; Max-Age=2592000; path=/; domain=.example.com");
+    QTest::newRow("short") << QByteArray("tz=UTC; path=/; secure");
+}
+
+void tst_QHttpHeaderParsing::cookies()
+{
+    QFETCH(QByteArray, header);
+
+    QList<QNetworkCookie> cookies;
+    QBENCHMARK {
+        cookies = QNetworkCookie::parseCookies(header);
+    }
+    QCOMPARE(cookies.size(), 1);
+}
+
+void tst_QHttpHeaderParsing::cookieAllocations_data()
+{
+    cookies_data();
+}
+
+void tst_QHttpHeaderParsing::cookieAllocations()
+{
+#ifndef HAVE_ALLOCATION_COUNTER
+    QSKIP("Allocations can only be counted with glibc");
+#else
+    QFETCH(QByteArray, header);
+
+    const int iterations = 1000;
+    const int before = allocations.load();
+    for (int i = 0; i < iterations; ++i)
+        QNetworkCookie::parseCookies(header);
+    const int after = allocations.load();
+    QTest::setBenchmarkResult(qreal(after - before) / iterations, QTest::Events);
+#endif
+}
+
+QNetworkReply *tst_QHttpHeaderParsing::get(QNetworkAccessManager *manager, const QUrl &url)
+{
+    QNetworkReply *reply = manager->get(QNetworkRequest(url));
+    QEventLoop loop;
+    connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
+    if (!reply->isFinished())
+        loop.exec();
+    return reply;
+}
+
+// Returns a response with the given headers whose body is "ok" repeated
+// chunks times, sent in as many chunks, or just "ok" if chunks is 0.
+static QByteArray response(const QByteArray &headers, int chunks)
+{
+    if (!chunks)
+        return "HTTP/1.1 200 OK\r\n" + headers + "Content-Length: 2\r\n\r\nok";
+
+    QByteArray response = "HTTP/1.1 200 OK\r\n" + headers + "Transfer-Encoding: chunked\r\n\r\n";
+    for (int i = 0; i < chunks; ++i)
+        response += "2; name=value\r\nok\r\n";
+    return response + "0\r\n\r\n";
+}
+
+void tst_QHttpHeaderParsing::replyAllocations_data()
+{
+    QTest::addColumn<QByteArray>("headers");
+    QTest::addColumn<int>("chunks");
+
+    QTest::newRow("minimal") << QByteArray("Content-Type: text/plain\r\n") << 0;
+    QTest::newRow("typical") << QByteArray(typicalHeaders) << 0;
+    QTest::newRow("minimal-1-chunk") << QByteArray("Content-Type: text/plain\r\n") << 1;
+    QTest::newRow("minimal-65-chunks") << QByteArray("Content-Type: text/plain\r\n") << 65;
+}
+
+// Heap allocations per reply over a kept-alive connection. The difference
+// between the rows is what the header fields and the chunks cost.
+void tst_QHttpHeaderParsing::replyAllocations()
+{
+#ifndef HAVE_ALLOCATION_COUNTER
+    QSKIP("Allocations can only be counted with glibc");
+#else
+    QFETCH(QByteArray, headers);
+    QFETCH(int, chunks);
+    server.response = response(headers, chunks);
+    const QByteArray body = chunks ? QByteArray("ok").repeated(chunks) : QByteArray("ok");
+
+    QNetworkAccessManager manager;
+    const QUrl url(QString::fromLatin1("http://127.0.0.1:%1/").arg(server.serverPort()));
+
+    // warm up the connection, the cookie jar and the caches
+    for (int i = 0; i < 10; ++i)
+        delete get(&manager, url);
+
+    QNetworkReply *check = get(&manager, url);
+    QCOMPARE(check->header(QNetworkRequest::ContentTypeHeader).toByteArray(), headers.contains("UTF-8") ? QByteArray("text/html; charset=UTF-8") : QByteArray("text/plain"));
+    if (headers.contains("Vary")) {
+        QCOMPARE(check->rawHeader("Cache-Control"), QByteArray("no-store, no-cache, must-revalidate, post-check=0, pre-check=0"));
+        QCOMPARE(check->rawHeader("Vary"), QByteArray("Accept-Encoding, User-Agent"));
+        QCOMPARE(check->header(QNetworkRequest::SetCookieHeader).value<QList<QNetworkCookie> >().size(), 3);
+    }
+    delete check;
+
+    const int iterations = 200;
+    const int before = allocations.load();
+    for (int i = 0; i < iterations; ++i) {
+        QNetworkReply *reply = get(&manager, url);
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QCOMPARE(reply->readAll(), body);
+        delete reply;
+    }
+    const int after = allocations.load();
+    QTest::setBenchmarkResult(qreal(after - before) / iterations, QTest::Events);
+#endif
+}
+
+void tst_QHttpHeaderParsing::reply_data()
+{
+    replyAllocations_data();
+}
+
+void tst_QHttpHeaderParsing::reply()
+{
+    QFETCH(QByteArray, headers);
+    QFETCH(int, chunks);
+    server.response = response(headers, chunks);
+
+    QNetworkAccessManager manager;
+    const QUrl url(QString::fromLatin1("http://127.0.0.1:%1/").arg(server.serverPort()));
+    delete get(&manager, url);
+
+    QBENCHMARK {
+        delete get(&manager, url);
+    }
+}
+
+QTEST_MAIN(tst_QHttpHeaderParsing)
+
+#include "main.moc"
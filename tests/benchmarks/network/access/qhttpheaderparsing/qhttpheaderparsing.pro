@@ -0,0 +1,9 @@
+TEMPLATE = app
+TARGET = tst_bench_qhttpheaderparsing
+
+QT -= gui
+QT += network testlib
+
+CONFIG += release
+
+SOURCES += main.cpp